@@ -40,6 +40,7 @@
                             -options missing required argument (getopt_long() returns ':')
                             -if cmd line has multiple errors report as many as possible
    Modified Oct 2025 JHB, support optional argument long options with a space instead of '=' before the argument (e.g. --suppress_packet_info_messages 1)
+   Modified Oct 2026 JHB, add --app_core_list command line option
 */
 
 #include <stdint.h>
@@ -62,7 +63,7 @@ using namespace std;
 
 #define requires_argument required_argument  /* definition to fix GNU grammar error in getopt_long() definitions */
 
-static const struct option long_options[] = { { "version", no_argument, NULL, (char)128 }, { "cut", requires_argument, NULL, (char)129 }, { "group_pcap_path", requires_argument, NULL, (char)130 }, { "group_pcap_path_nocopy", requires_argument, NULL, (char)131 }, { "md5sum", no_argument, NULL, (char)132 }, { "sha1sum", no_argument, NULL, (char)133 }, { "sha512sum", no_argument, NULL, (char)134 }, { "show_aud_clas", no_argument, NULL, (char)135 }, { "random_bit_error", requires_argument, NULL, (char)136 },  { "profile_stdout_ready", no_argument, NULL, (char)137 }, { "exclude_payload_type_from_key", no_argument, NULL, (char)138 }, { "disable_codec_flc", no_argument, NULL, (char)139 },  { "stdout_mode", requires_argument, NULL, (char)140 }, { "event_log_path", requires_argument, NULL, (char)141 }, { "suppress_packet_info_messages", optional_argument, NULL, (char)142 }, /* insert additional options here */ {NULL, 0, NULL, 0 } };
+static const struct option long_options[] = { { "version", no_argument, NULL, (char)128 }, { "cut", requires_argument, NULL, (char)129 }, { "group_pcap_path", requires_argument, NULL, (char)130 }, { "group_pcap_path_nocopy", requires_argument, NULL, (char)131 }, { "md5sum", no_argument, NULL, (char)132 }, { "sha1sum", no_argument, NULL, (char)133 }, { "sha512sum", no_argument, NULL, (char)134 }, { "show_aud_clas", no_argument, NULL, (char)135 }, { "random_bit_error", requires_argument, NULL, (char)136 },  { "profile_stdout_ready", no_argument, NULL, (char)137 }, { "exclude_payload_type_from_key", no_argument, NULL, (char)138 }, { "disable_codec_flc", no_argument, NULL, (char)139 },  { "stdout_mode", requires_argument, NULL, (char)140 }, { "event_log_path", requires_argument, NULL, (char)141 }, { "suppress_packet_info_messages", optional_argument, NULL, (char)142 }, { "app_core_list", requires_argument, NULL, (char)143 }, /* insert additional options here */ {NULL, 0, NULL, 0 } };
 
 //
 // CmdLineOpt - Default constructor.
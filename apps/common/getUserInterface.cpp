@@ -50,6 +50,8 @@
    Modified Sep 2025 JHB, add --event_log_path command line option
    Modified Sep 2025 JHB, in getUserInfo() make use of new ARG_TYPE_NONE and ARG_OPTIONAL enums, handle single ? entered on command line
    Modified Oct 2025 JHB, add --suppress_packet_info_messages command line option
+   Modified Oct 2026 JHB, update -m help text, core mask also sets packet/media thread placement for mediaMin
+   Modified Oct 2026 JHB, add --app_core_list command line option
 */
 
 #include <stdlib.h>
@@ -73,7 +75,7 @@ static CmdLineOpt::Record options[] = {
    {'f', CmdLineOpt::ARG_TYPE_INT, MANDATORY_COCPU,
           (char *)"CPU clock frequency in MHz (e.g. -f1000)", {{(void*)1000}} },
    {'m', CmdLineOpt::ARG_TYPE_INT64, MANDATORY_COCPU,
-          (char *)"Core select bit mask. (e.g. -m1, means core0, -m2 means core1, -m3 means core0 and core1. For some programs only one core can be selected at a time)" },
+          (char *)"Core select bit mask. (e.g. -m1, means core0, -m2 means core1, -m3 means core0 and core1. For some programs only one core can be selected at a time. For mediaMin on x86, cores used for packet/media threads; app threads use remaining cores)" },
    {'e', CmdLineOpt::ARG_TYPE_PATH, MANDATORY_COCPU,
           (char *)"coCPU executable file path (e.g. -efilename.out, -e path/filename.out). File must be in ELF or COFF format" },
 	{'i', CmdLineOpt::ARG_TYPE_PATH, NOTMANDATORY,
@@ -211,7 +213,9 @@ static CmdLineOpt::Record options[] = {
    {(char)141, CmdLineOpt::ARG_TYPE_PATH, NOTMANDATORY,
           (char *)"event log path", {{(void*)0}} },  /* --event_log_path <path>, JHB Aug 2025 */
    {(char)142, (CmdLineOpt::ArgType)(CmdLineOpt::ARG_TYPE_INT | CmdLineOpt::ARG_OPTIONAL), NOTMANDATORY,
-          (char *)"suppress packet info messages", {{(void*)3}} }  /* --suppress_packet_info_messages [N]. Default value is 3 (suppress all) if N not entered, JHB Oct 2025 */
+          (char *)"suppress packet info messages", {{(void*)3}} },  /* --suppress_packet_info_messages [N]. Default value is 3 (suppress all) if N not entered, JHB Oct 2025 */
+   {(char)143, CmdLineOpt::ARG_TYPE_STR, NOTMANDATORY,
+          (char *)"app thread core list", {{(void*)0}} }  /* --app_core_list <list>, CPUs and CPU ranges (e.g. 2-5,8) or hex mask, JHB Oct 2026 */
 };
 
 /* global storage of cmd line options */
@@ -476,6 +480,8 @@ char clkstr[100];
       userIfs->CmdLineFlags.suppress_packet_info_messages = cmdOpts.getInt((char)142, 0, 0);
    }
 
+   if (cmdOpts.getStr((char)143, 0) != NULL && ((uFlags & CLI_MEDIA_APPS_MEDIAMIN) || (uFlags & CLI_MEDIA_APPS_MEDIATEST))) strncpy(userIfs->szAppCoreList, cmdOpts.getStr((char)143, 0), CMDOPT_MAX_INPUT_LEN);  /* app thread core list for mediaMin thread placement, used with -m core list for p/m threads, JHB Oct 2026 */
+
    if (userIfs->programMode >= 0) {
 
       userIfs->programSubMode = userIfs->programMode >> 24;
@@ -0,0 +1,78 @@
+/*
+ $Header: /root/Signalogic/apps/eventLogFormat/eventLogFormat.cpp
+
+Copyright (C) Signalogic Inc. 2026
+
+License
+
+  Use and distribution of this source code is subject to terms and conditions of the Github SigSRF License v1.1, published at https://github.com/signalogic/SigSRF_SDK/blob/master/LICENSE.md. Absolutely prohibited for AI language or programming model training use
+
+Description
+
+  Render SigSRF binary event logs as text
+
+Notes
+
+  -binary event logs are created by Log_RT() (diaglib) when the DS_EVENT_LOG_BINARY flag is set in uEventLogMode (shared_include/config.h). The binary event log path is the event log path with ".bin" appended
+  -output is the same format as Log_RT() text event log output. If no output file is given, output is to stdout
+  -the -lN option outputs only events with log level N or lower, for example -l3 outputs warnings, errors, and critical errors
+
+Example Usage
+
+  ./eventLogFormat mediaMin.log.bin mediaMin.log
+  ./eventLogFormat -l3 mediaMin.log.bin | grep -i "jitter buffer"
+
+Revision History
+
+  Created Oct 2026 JHB
+*/
+
+/* Linux header files */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* SigSRF includes */
+
+#include "diaglib.h"  /* DSFormatBinaryEventLog() */
+
+int main(int argc, char** argv) {
+
+int i, num_events;
+unsigned int uFlags = 0;
+const char* szInput = NULL;
+const char* szOutput = NULL;
+FILE* fp_out = stdout;
+
+   for (i=1; i<argc; i++) {
+
+      if (!strncmp(argv[i], "-l", 2) && atoi(&argv[i][2]) > 0) uFlags |= atoi(&argv[i][2]) & DS_LOG_LEVEL_MASK;  /* DS_LOG_LEVEL_MASK defined in shared_include/config.h */
+      else if (!szInput) szInput = argv[i];
+      else if (!szOutput) szOutput = argv[i];
+   }
+
+   if (!szInput) {
+
+      fprintf(stderr, "usage: eventLogFormat [-lN] binary_event_log [output_file] \n");
+      return -1;
+   }
+
+   if (szOutput && !(fp_out = fopen(szOutput, "w"))) {
+
+      fprintf(stderr, "eventLogFormat: unable to create output file %s \n", szOutput);
+      return -1;
+   }
+
+   num_events = DSFormatBinaryEventLog(szInput, fp_out, uFlags);
+
+   if (fp_out != stdout) fclose(fp_out);
+
+   if (num_events < 0) return -1;
+
+   fprintf(stderr, "eventLogFormat: %d events written to %s \n", num_events, szOutput ? szOutput : "stdout");
+
+   return 0;
+}
@@ -0,0 +1,323 @@
+/*
+ $Header: /root/Signalogic/apps/mediaTest/mediaMin/input_prefetch.cpp
+
+ Copyright (C) Signalogic Inc. 2026
+
+ License
+
+  Use and distribution of this source code is subject to terms and conditions of the Github SigSRF License v1.1, published at https://github.com/signalogic/SigSRF_SDK/blob/master/LICENSE.md. Absolutely prohibited for AI language or programming model training use
+
+ Description
+
+  input prefetch source for mediaMin reference application
+
+ Documentation
+
+  https://www.github.com/signalogic/SigSRF_SDK/tree/master/mediaTest_readme.md#user-content-mediamin
+
+ Revision History
+
+   Created Oct 2026 JHB
+*/
+
+/* input prefetch notes, JHB Oct 2026:
+
+   -enabled by ENABLE_INPUT_PREFETCH in -dN cmd line options. InputSetup() in mediaMin.cpp calls InputPrefetchStart() for each pcap, pcapng, and .rtpXXX input (memory-mapped inputs and .ber inputs are excluded)
+
+   -each input gets a reader thread that calls DSReadPcap() and writes packets into a single-producer single-consumer (SPSC) ring. GetInputData() in mediaMin.cpp calls InputPrefetchRead() to take packets from the ring instead of reading the file. The app thread never blocks on file I/O; if the reader has fallen behind InputPrefetchRead() returns INPUT_DATA_NOT_READY and PushPackets() moves on to the next input
+
+   -the ring is a byte ring with variable length records (PREFETCH_RECORD_HEADER followed by packet data, padded to 8 bytes). A record is never split at the end of the ring; if it doesn't fit the reader writes a wrap marker (rec_len zero) and starts the record at ring offset zero. rd and wr are free running byte counts; the reader owns wr and the app thread owns rd, each published with release stores and read with acquire loads, so no locks are needed per packet
+
+   -when the ring is full the reader sleeps PREFETCH_FULL_WAIT usec. With a 1 MB ring (INPUT_PREFETCH_RING_SIZE) this is well ahead of any push rate
+
+   -at end of file, or on a DSReadPcap() error (after writing the error as a record with pkt_len -1), the reader sets fEOF and parks on a condition variable. InputPrefetchRead() returns zero only after fEOF is set and the ring is empty, so end of input is seen by PushPackets() after all packets have been consumed, the same as synchronous reads
+
+   -InputPrefetchRewind() parks the reader (if not already parked), seeks the file to its first record, discards anything left in the ring, and restarts the reader. It's used for input repeat (-RN cmd line entry), which may rewind before end of file (e.g. dynamic stream termination)
+
+   -packet numbers given to DSReadPcap() for warning/info messages are counted by the reader, using the same non-packet block exclusions as PushPackets()
+*/
+
+#include <algorithm>
+using namespace std;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "mediaTest.h"  /* includes pktlib.h */
+#include "mediaMin.h"
+#include "input_prefetch.h"
+
+#define PREFETCH_FULL_WAIT             1000  /* reader thread sleep time when ring is full, in usec */
+
+typedef struct {
+
+  uint32_t       rec_len;       /* total record length including header and packet data, padded to a multiple of 8. Zero indicates a wrap marker */
+  int            pkt_len;       /* DSReadPcap() return value */
+  uint16_t       eth_protocol;
+  uint16_t       block_type;
+  pcaprec_hdr_t  pcap_rec_hdr;
+
+} PREFETCH_RECORD_HEADER;
+
+#define PREFETCH_RECORD_ALIGN(len)     (((len) + 7) & ~7)
+#define PREFETCH_RECORD_HEADER_LEN     PREFETCH_RECORD_ALIGN(sizeof(PREFETCH_RECORD_HEADER))
+
+typedef struct {
+
+/* items shared between app thread and reader thread */
+
+  uint8_t*          ring;
+  uint32_t          size;
+  uint64_t          wr;            /* written by reader thread only */
+  uint64_t          rd;            /* written by app thread only */
+  uint8_t           fEOF;          /* set by reader thread at end of file or read error, cleared by InputPrefetchRewind() */
+
+  pthread_mutex_t   lock;          /* lock and cond protect fParked, fPause, and fExit, and are used only for reader parking, not per packet */
+  pthread_cond_t    cond;
+  bool              fParked;
+  bool              fPause;
+  bool              fExit;
+
+/* items used by reader thread */
+
+  pthread_t         thread;
+  FILE*             fp_pcap;
+  pcap_hdr_t*       pcap_file_hdr;
+  unsigned int      uFlags;
+  int               link_layer_info;
+  bool              fArrivalTimes;
+  unsigned int      packet_number;
+  uint8_t*          pkt_buf;
+  int               nStream;
+  int               thread_index;
+
+} INPUT_PREFETCH;
+
+/* tell reader thread to pause and wait until it's parked. Caller must hold p->lock */
+
+static void park_reader(INPUT_PREFETCH* p) {
+
+   __atomic_store_n(&p->fPause, true, __ATOMIC_RELAXED);  /* reader checks fPause without the lock while waiting for ring space */
+   while (!p->fParked) pthread_cond_wait(&p->cond, &p->lock);
+}
+
+static bool write_record(INPUT_PREFETCH* p, int pkt_len, uint16_t eth_protocol, uint16_t block_type, pcaprec_hdr_t* p_pcap_rec_hdr) {
+
+uint32_t rec_len = PREFETCH_RECORD_HEADER_LEN + PREFETCH_RECORD_ALIGN(pkt_len > 0 ? pkt_len : 0);
+uint64_t wr = p->wr, rd;
+uint32_t offset, pad;
+PREFETCH_RECORD_HEADER* hdr;
+
+   offset = wr % p->size;
+   pad = (p->size - offset < rec_len) ? p->size - offset : 0;  /* if the record doesn't fit at the end of the ring it starts at offset zero */
+
+   while (1) {  /* wait for space */
+
+      rd = __atomic_load_n(&p->rd, __ATOMIC_ACQUIRE);
+
+      if (p->size - (wr - rd) >= pad + rec_len) break;
+
+      if (__atomic_load_n(&p->fExit, __ATOMIC_RELAXED) || __atomic_load_n(&p->fPause, __ATOMIC_RELAXED)) return false;  /* packet is dropped; InputPrefetchRewind() discards ring contents anyway */
+
+      usleep(PREFETCH_FULL_WAIT);
+   }
+
+   if (pad) {
+      ((PREFETCH_RECORD_HEADER*)&p->ring[offset])->rec_len = 0;  /* wrap marker. Space remaining at end of ring is always a multiple of 8, so there is room for rec_len */
+      wr += pad;
+      offset = 0;
+   }
+
+   hdr = (PREFETCH_RECORD_HEADER*)&p->ring[offset];
+   hdr->rec_len = rec_len;
+   hdr->pkt_len = pkt_len;
+   hdr->eth_protocol = eth_protocol;
+   hdr->block_type = block_type;
+   hdr->pcap_rec_hdr = *p_pcap_rec_hdr;
+   if (pkt_len > 0) memcpy(&p->ring[offset + PREFETCH_RECORD_HEADER_LEN], p->pkt_buf, pkt_len);
+
+   __atomic_store_n(&p->wr, wr + rec_len, __ATOMIC_RELEASE);  /* publish */
+
+   return true;
+}
+
+static void* prefetch_thread(void* arg) {
+
+INPUT_PREFETCH* p = (INPUT_PREFETCH*)arg;
+pcaprec_hdr_t pcap_rec_hdr;
+uint16_t eth_protocol, block_type;
+int pkt_len;
+
+   while (1) {
+
+      if (__atomic_load_n(&p->fEOF, __ATOMIC_RELAXED) || __atomic_load_n(&p->fPause, __ATOMIC_RELAXED) || __atomic_load_n(&p->fExit, __ATOMIC_RELAXED)) {  /* park */
+
+         pthread_mutex_lock(&p->lock);
+
+         p->fParked = true;
+         pthread_cond_broadcast(&p->cond);
+
+         while (!p->fExit && (p->fPause || p->fEOF)) pthread_cond_wait(&p->cond, &p->lock);
+
+         p->fParked = false;
+
+         if (p->fExit) { pthread_mutex_unlock(&p->lock); break; }
+
+         pthread_mutex_unlock(&p->lock);
+         continue;
+      }
+
+      memset(&pcap_rec_hdr, 0, sizeof(pcap_rec_hdr));
+      eth_protocol = 0; block_type = 0;
+
+      pkt_len = DSReadPcap(p->fp_pcap, p->uFlags, p->pkt_buf, p->fArrivalTimes ? &pcap_rec_hdr : NULL, p->link_layer_info, &eth_protocol, &block_type, p->pcap_file_hdr, p->packet_number+1, NULL);  /* source is in lib/pktlib/pktlib_pcap.cpp */
+
+      if (pkt_len > 0 && (block_type == PCAP_PB_TYPE || block_type == RTP_PB_TYPE || block_type == PCAPNG_EPB_TYPE || block_type == PCAPNG_SPB_TYPE)) p->packet_number++;  /* same packet number rules as PushPackets() */
+
+      if (pkt_len != 0 && !write_record(p, pkt_len, eth_protocol, block_type, &pcap_rec_hdr)) continue;
+
+      if (pkt_len <= 0) __atomic_store_n(&p->fEOF, 1, __ATOMIC_RELEASE);  /* end of file or read error. Reader parks at top of loop until rewind or stop */
+   }
+
+   return NULL;
+}
+
+void* InputPrefetchStart(FILE* fp_pcap, unsigned int uFlags, int link_layer_info, pcap_hdr_t* pcap_file_hdr, bool fArrivalTimes, int nStream, int thread_index) {
+
+INPUT_PREFETCH* p;
+int ret_val;
+
+   if (!fp_pcap) return NULL;
+
+   if (!(p = (INPUT_PREFETCH*)calloc(1, sizeof(INPUT_PREFETCH)))) return NULL;
+
+   p->size = INPUT_PREFETCH_RING_SIZE;
+   p->ring = (uint8_t*)malloc(p->size);
+   p->pkt_buf = (uint8_t*)malloc(MAX_TCP_PACKET_LEN);  /* same size DSReadPcap() uses internally */
+
+   if (!p->ring || !p->pkt_buf) {
+      Log_RT(2, "mediaMin ERROR: InputPrefetchStart() failed to allocate memory (%d bytes) for input prefetch, nStream = %d, thread_index = %d \n", p->size + MAX_TCP_PACKET_LEN, nStream, thread_index);
+      goto free_mem;
+   }
+
+   p->fp_pcap = fp_pcap;
+   p->uFlags = uFlags;
+   p->link_layer_info = link_layer_info;
+   p->pcap_file_hdr = pcap_file_hdr;
+   p->fArrivalTimes = fArrivalTimes;
+   p->nStream = nStream;
+   p->thread_index = thread_index;
+
+   pthread_mutex_init(&p->lock, NULL);
+   pthread_cond_init(&p->cond, NULL);
+
+   if ((ret_val = pthread_create(&p->thread, NULL, prefetch_thread, p))) {
+
+      Log_RT(2, "mediaMin ERROR: InputPrefetchStart() says pthread_create() failed for input prefetch, ret val = %d, nStream = %d, thread_index = %d \n", ret_val, nStream, thread_index);
+
+      pthread_cond_destroy(&p->cond);
+      pthread_mutex_destroy(&p->lock);
+      goto free_mem;
+   }
+
+   return p;
+
+free_mem:
+
+   if (p->ring) free(p->ring);
+   if (p->pkt_buf) free(p->pkt_buf);
+   free(p);
+
+   return NULL;
+}
+
+/* InputPrefetchRead() returns next prefetched packet, with return values the same as DSReadPcap() (packet length, zero for end of file, -1 for error) plus INPUT_DATA_NOT_READY if the ring is empty but the reader has not yet reached end of file */
+
+int InputPrefetchRead(void* hPrefetch, uint8_t* pkt_buf, pcaprec_hdr_t* p_pcap_rec_hdr, uint16_t* p_eth_protocol, uint16_t* p_block_type) {
+
+INPUT_PREFETCH* p = (INPUT_PREFETCH*)hPrefetch;
+PREFETCH_RECORD_HEADER* hdr;
+uint64_t rd, wr;
+uint8_t fEOF;
+int pkt_len;
+
+   if (!p) return -1;
+
+   fEOF = __atomic_load_n(&p->fEOF, __ATOMIC_ACQUIRE);  /* load fEOF before wr; if fEOF is set, wr includes all records written by the reader */
+   wr = __atomic_load_n(&p->wr, __ATOMIC_ACQUIRE);
+   rd = p->rd;
+
+   while (rd != wr) {
+
+      hdr = (PREFETCH_RECORD_HEADER*)&p->ring[rd % p->size];
+
+      if (!hdr->rec_len) { rd += p->size - rd % p->size; continue; }  /* wrap marker */
+
+      if (hdr->pkt_len > 0) memcpy(pkt_buf, (uint8_t*)hdr + PREFETCH_RECORD_HEADER_LEN, hdr->pkt_len);
+      if (p->fArrivalTimes) *p_pcap_rec_hdr = hdr->pcap_rec_hdr;
+      *p_eth_protocol = hdr->eth_protocol;
+      *p_block_type = hdr->block_type;
+
+      pkt_len = hdr->pkt_len;
+
+      __atomic_store_n(&p->rd, rd + hdr->rec_len, __ATOMIC_RELEASE);  /* release record space to reader */
+
+      return pkt_len;
+   }
+
+   if (rd != p->rd) __atomic_store_n(&p->rd, rd, __ATOMIC_RELEASE);  /* wrap marker was consumed */
+
+   return fEOF ? 0 : INPUT_DATA_NOT_READY;
+}
+
+/* InputPrefetchRewind() seeks input to its first record and restarts prefetch. Returns DSOpenPcap() return value */
+
+int InputPrefetchRewind(void* hPrefetch) {
+
+INPUT_PREFETCH* p = (INPUT_PREFETCH*)hPrefetch;
+int ret_val;
+
+   if (!p) return -1;
+
+   pthread_mutex_lock(&p->lock);
+
+   park_reader(p);  /* reader is not touching the file or ring after this */
+
+   ret_val = DSOpenPcap(NULL, DS_READ | DS_OPEN_PCAP_RESET, &p->fp_pcap, NULL, "");  /* seek to start of first pcap record */
+
+   __atomic_store_n(&p->rd, p->wr, __ATOMIC_RELEASE);  /* discard remaining ring contents */
+   p->packet_number = 0;
+   __atomic_store_n(&p->fEOF, 0, __ATOMIC_RELAXED);
+   __atomic_store_n(&p->fPause, false, __ATOMIC_RELAXED);
+
+   pthread_cond_broadcast(&p->cond);
+   pthread_mutex_unlock(&p->lock);
+
+   return ret_val;
+}
+
+/* InputPrefetchStop() stops and joins the reader thread and frees prefetch memory. It should be called before the input is closed */
+
+void InputPrefetchStop(void* hPrefetch) {
+
+INPUT_PREFETCH* p = (INPUT_PREFETCH*)hPrefetch;
+
+   if (!p) return;
+
+   pthread_mutex_lock(&p->lock);
+   __atomic_store_n(&p->fExit, true, __ATOMIC_RELAXED);
+   pthread_cond_broadcast(&p->cond);
+   pthread_mutex_unlock(&p->lock);
+
+   pthread_join(p->thread, NULL);
+
+   pthread_cond_destroy(&p->cond);
+   pthread_mutex_destroy(&p->lock);
+
+   free(p->ring);
+   free(p->pkt_buf);
+   free(p);
+}
@@ -0,0 +1,35 @@
+/*
+ $Header: /root/Signalogic/apps/mediaTest/mediaMin/input_prefetch.h
+
+ Copyright (C) Signalogic Inc. 2026
+
+ License
+
+  Use and distribution of this source code is subject to terms and conditions of the Github SigSRF License v1.1, published at https://github.com/signalogic/SigSRF_SDK/blob/master/LICENSE.md. Absolutely prohibited for AI language or programming model training use
+
+ Description
+
+  Header file for input prefetch source for mediaMin reference application. Input prefetch reads pcap, pcapng, and .rtpXXX inputs in per-input reader threads, decoupling file I/O from app thread push-pull timing
+
+ Documentation
+
+  https://github.com/signalogic/SigSRF_SDK/tree/master/mediaTest_readme.md#user-content-mediamin
+
+ Revision History
+
+   Created Oct 2026 JHB
+*/
+
+#ifndef _INPUT_PREFETCH_H_
+#define _INPUT_PREFETCH_H_
+
+#define INPUT_PREFETCH_RING_SIZE       (1024*1024)  /* per-input prefetch ring size, in bytes. Must be a multiple of 8 */
+
+/* functions in input_prefetch.cpp. All functions except InputPrefetchStart() take a handle returned by InputPrefetchStart(). InputPrefetchRead(), InputPrefetchRewind(), and InputPrefetchStop() should be called only by the app thread that owns the input */
+
+void* InputPrefetchStart(FILE* fp_pcap, unsigned int uFlags, int link_layer_info, pcap_hdr_t* pcap_file_hdr, bool fArrivalTimes, int nStream, int thread_index);
+int InputPrefetchRead(void* hPrefetch, uint8_t* pkt_buf, pcaprec_hdr_t* p_pcap_rec_hdr, uint16_t* p_eth_protocol, uint16_t* p_block_type);
+int InputPrefetchRewind(void* hPrefetch);
+void InputPrefetchStop(void* hPrefetch);
+
+#endif  /* _INPUT_PREFETCH_H_ */
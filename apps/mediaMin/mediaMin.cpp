@@ -221,6 +221,20 @@
    Modified Aug 2025 JHB, improvements in redundant packet detecton - check for duplicate packets in both input flow, reassembled flow, and vs each other. See instances of calls to DSIsPacketDuplicate()
    Modified Sep 2025 JHB, improve error handling in CreateDynamicSession(), replace thread_info[].init_err with .uErrorCondition to improve differentiation of initialization and run-time errors
    Modified Sep 2025 JHB, simplify some code with getIOType() and isInputXxx() macro (pktlib.h)
+   Modified Oct 2026 JHB, add ENABLE_MMAP_INPUT option. InputSetup() opens pcap and pcapng inputs with DS_OPEN_PCAP_MMAP and GetInputData() uses DSReadPcapView() to reference packet data in the file mapping instead of copying into the input cache
+   Modified Oct 2026 JHB, call DSPktFragmentThreadRegister() on thread start and DSPktFragmentThreadCleanup() on exit
+   Modified Oct 2026 JHB, add ENABLE_TIMER_SCHEDULER option. Push-pull loop sleeps to absolute interval and packet arrival deadlines instead of polling get_time(), see SchedulerWait(). Push-pull loop CPU usage and interval timing stats are logged on loop exit in both timer and polling modes, see SchedulerStats()
+   Modified Oct 2026 JHB, add ENABLE_INPUT_PREFETCH option. InputSetup() starts a reader thread per pcap, pcapng, and .rtpXXX input and GetInputData() takes packets from a prefetch ring instead of calling DSReadPcap(). See input_prefetch.cpp
+   Modified Oct 2026 JHB, in USE_PACKET_ARRIVAL_TIMES mode PushPackets() keeps inputs waiting for packet arrival timestamps in a min-heap (thread_info[].arrival_heap) and skips them until due. See arrival heap notes
+   Modified Oct 2026 JHB, add MERGE_INPUTS option, see MergeInputs()
+   Modified Oct 2026 JHB, include port_io.h, call PortClassCleanup() on thread exit
+   Modified Oct 2026 JHB, add ENABLE_THREAD_LOAD_BALANCING option, sets uThreadLoadBalanceInterval in GlobalConfig()
+   Modified Oct 2026 JHB, configure thread placement from -mN core list with DSConfigThreadPlacement(), app threads place themselves with DSSetThreadPlacement() after first stage init
+   Modified Oct 2026 JHB, add --app_core_list cmd line option, app thread core list is passed to DSConfigThreadPlacement()
+   Modified Oct 2026 JHB, in MergeInputs() don't overwrite an existing merged file unless MERGE_INPUTS_OVERWRITE is set, replace PKT_TIMESTAMP macro with pkt_timestamp_usec()
+   Modified Oct 2026 JHB, in AFAP and FTRT modes PushPackets() reads all packets due from each input per call (up to PUSH_MAX_READS_PER_INPUT) instead of one, so push batches hold more than one packet. A packet alone in the push batch is pushed from pkt_buf without copying to push batch mem. See push batch notes
+   Modified Oct 2026 JHB, in FlushPushBatch() packets discarded by DSPushPackets() RFC7198 duplicate detection are consumed but not included in pushed packet stats or push counters, as before push batches
+   Modified Oct 2026 JHB, SchedulerStats() shows push-pull loop stats only if ENABLE_TIMER_SCHEDULER is set
 */
 
 /* Linux header files */
@@ -230,6 +244,9 @@
 
 #include <signal.h>
 #include <assert.h>
+#include <sys/resource.h>  /* getrusage() */
+#include <sys/prctl.h>     /* prctl() */
+#include <unistd.h>        /* access() */
 
 #include <algorithm>  /* bring in std::min and std::max */
 #include <fstream>
@@ -264,6 +281,8 @@ using namespace std;
 #include "sdp_app.h"      /* app level SDP management */
 #include "session_app.h"  /* app level session management */
 #include "user_io.h"      /* user I/O (keybd, counters and other output) */
+#include "input_prefetch.h"  /* input reader threads */
+#include "port_io.h"      /* port filtering */
 
 //#define LOG_OUTPUT  LOG_CONSOLE     /* console output */
 //#define LOG_OUTPUT  LOG_FILE        /* event log file output */
@@ -352,6 +371,7 @@ void DebugSetup(DEBUG_CONFIG* dbg_cfg);            /* lib debug config */
 /* I/O setup */
 
 void InputSetup(uint64_t cur_time, int thread_index);
+static int MergeInputs(unsigned int uFlags, int thread_index);
 void JitterBufferOutputSetup(HSESSION hSessions[], HSESSION hSession, int thread_index);
 int OutputSetup(HSESSION hSessions[], HSESSION hSession, int thread_index);
 void StreamGroupOutputSetup(HSESSION hSession, int nStream, int thread_index);
@@ -363,10 +383,25 @@ void ThreadWait(int when, uint64_t cur_time, int thread_index);
 void AppThreadSync(unsigned int, bool* fThreadSync, int thread_index);
 void PmThreadSync(int thread_index);
 
+/* push-pull loop scheduler functions */
+
+void SchedulerStart(uint64_t cur_time, int thread_index);
+void SchedulerWait(uint64_t deadline, uint64_t cur_time, int thread_index);
+void SchedulerStats(uint64_t cur_time, int thread_index);
+
+/* arrival heap functions */
+
+void ArrivalHeapInsert(ARRIVAL_HEAP* heap, int nStream, uint64_t time);
+void ArrivalHeapRemove(ARRIVAL_HEAP* heap, int nStream);
+int ArrivalHeapPop(ARRIVAL_HEAP* heap, uint64_t time);
+
 /* wrapper functions for pktlib DSPushPackets() and DSPullPackets(), including pcap read/write, session create, etc */
   
 int PushPackets(uint8_t* pkt_in_buf, HSESSION hSessions[], SESSION_DATA session_data[], int nSessions, uint64_t cur_time, int thread_index);
 int PullPackets(uint8_t* pkt_out_buf, HSESSION hSessions[], SESSION_DATA session_data[], unsigned int uFlags, unsigned int pkt_buf_len, uint64_t cur_time, int thread_index);
+static int AddPushBatch(uint8_t* pkt_buf, int pkt_len, PKTINFO* PktInfo, int chnum, int nSessionIndex, int nStream, float msec_timestamp_fp, HSESSION hSessions[], unsigned int uFlags_push, uint64_t cur_time, int thread_index);  /* push batch helpers, JHB Oct 2026 */
+static int FlushPushBatch(HSESSION hSessions[], unsigned int uFlags_push, uint64_t cur_time, int thread_index);
+static void SavePushBatchPkt(int thread_index);
 
 /* I/O functions */
 
@@ -375,7 +410,6 @@ bool isNonIPPacket(uint16_t eth_protocol);
 
 /* packet helper functions not available in pktlib */
 
-int isPortAllowed(uint16_t port, uint8_t port_type, uint8_t* pkt_buf, int pkt_len, uint8_t uProtocol, int nStream, uint64_t cur_time, int thread_index);  /* in port_io.cpp */
 int PacketActions(uint8_t* pyld_data, uint8_t* pkt_buf, uint8_t protocol, int* p_pkt_len, unsigned int uFlags);
 
 /* create and manage packet/media threads */
@@ -462,6 +496,8 @@ char tmpstr[MAX_APP_STR_LEN];  /* large temporary string used for various purpos
 
    #endif  /* #ifdef _MEDIAMIN_ */
 
+   DSPktFragmentThreadRegister(0);  /* register this app thread for fragment reassembly up front, so DSGetPacketInfo() fragment handling doesn't register on first fragmented packet. DSPktFragmentThreadRegister() and DSPktFragmentThreadCleanup() are in pktlib, JHB Oct 2026 */
+
    if (Mode == -1) Mode = 0;  /* default value if no cmd line entry given is -1 (Mode is defined from "debugMode" in mediaTest.h. debugMode is set in cmd_line_interface.c from the command line by -d argument) */
 
    if (nRepeats == 0) fRepeatIndefinitely = true;  /* nRepeats is initialized in cmd_line_interface.c from -RN cmd line entry (if no entry nRepeats = -1). Note that some stress tests already have repeat built in, so -RN entry may be ignored or treated differently in those cases */
@@ -614,6 +650,16 @@ char tmpstr[MAX_APP_STR_LEN];  /* large temporary string used for various purpos
 
       hPlatform = DSAssignPlatform(NULL, PlatformParams.szPlatformDesignator, 0, 0, 0);
 
+   /* configure thread placement if -mN core list and/or --app_core_list given on the cmd line. p/m threads are placed on -mN cores, avoiding SMT siblings. App threads are placed on --app_core_list cores if given, otherwise on remaining cores in the same NUMA node(s) as p/m threads. Threads place themselves when they start, see DSSetThreadPlacement() calls below and in packet_flow_media_proc.c, JHB Oct 2026 */
+
+      if (PlatformParams.nCoreList || strlen(szAppCoreList)) {
+
+         char szCoreList[40] = "";
+         if (PlatformParams.nCoreList) sprintf(szCoreList, "0x%llx", (unsigned long long int)PlatformParams.nCoreList);
+
+         DSConfigThreadPlacement(szCoreList, strlen(szAppCoreList) ? szAppCoreList : NULL, DS_THREAD_PLACEMENT_AVOID_SMT_SIBLINGS | DS_THREAD_PLACEMENT_NUMA_LOCAL_MEM | DS_THREAD_PLACEMENT_APP_EXCLUDE_PKTMEDIA_CORES);  /* invalid core lists are reported by DSConfigThreadPlacement() */
+      }
+
    /* init and configure pktlib */
 
       DSConfigPktlib(&gbl_cfg, &dbg_cfg, DS_CP_INIT);
@@ -652,6 +698,8 @@ char tmpstr[MAX_APP_STR_LEN];  /* large temporary string used for various purpos
 
 /* first stage initialization complete */
 
+   DSSetThreadPlacement(thread_index, DS_THREAD_PLACEMENT_APP_THREAD, NULL, NULL);  /* place app thread before session and input setup, so its buffers are allocated on the thread's NUMA node. No effect if thread placement not configured, JHB Oct 2026 */
+
 start:  /* note - label used only if test mode repeats are enabled */
 
    cur_time = get_time(USE_CLOCK_GETTIME);
@@ -725,9 +773,11 @@ session_create:  /* note - label used only if test mode repeats are enabled */
 
 /* all initialization complete, begin continuous packet push-pull loop */
 
+   SchedulerStart(get_time(USE_CLOCK_GETTIME), thread_index);  /* init push-pull loop scheduler and stats, JHB Oct 2026 */
+
    do {
 
-      if (fPause) continue;  /* if keyboard interactive pause is in effect */
+      if (fPause) { if (Mode & ENABLE_TIMER_SCHEDULER) usleep(10000); continue; }  /* if keyboard interactive pause is in effect. In timer scheduler mode don't poll while paused */
 
       cur_time = get_time(USE_CLOCK_GETTIME); if (!base_time) base_time = cur_time;  /* in usec */
 
@@ -735,7 +785,23 @@ session_create:  /* note - label used only if test mode repeats are enabled */
 
    /* if packets are not pushed according to arrival timestamp, then we push packets according to a specified interval. Options include (i) pushing packets as fast as possible (-r0 cmd line entry), (ii) N msec intervals (cmd line entry -rN), and an average push rate based on output queue levels (the latter can be used with pcaps that don't have arrival timestamps) */
 
-      if (cur_time - base_time < interval_count*RealTimeInterval[0]*1000) continue; else interval_count++;  /* if real-time interval has elapsed push and pull packets, increment count. Comparison is in usec. Note that real-time interval may be less than ptime in FTRT modes ("faster than real-time") */
+      uint64_t interval_deadline = base_time + (uint64_t)(interval_count*RealTimeInterval[0]*1000);
+
+      if (cur_time < interval_deadline) {  /* if real-time interval has elapsed push and pull packets, increment count. Comparison is in usec. Note that real-time interval may be less than ptime in FTRT modes ("faster than real-time") */
+
+         if (Mode & ENABLE_TIMER_SCHEDULER) SchedulerWait(interval_deadline, cur_time, thread_index);  /* sleep until close to next interval or packet arrival deadline, JHB Oct 2026 */
+         continue;
+      }
+
+      if (interval_count && RealTimeInterval[0] > 0) {  /* interval timing stats */
+
+         uint64_t late = cur_time - interval_deadline;
+         thread_info[thread_index].sched_late_total += late;
+         if (late > thread_info[thread_index].sched_late_max) thread_info[thread_index].sched_late_max = late;
+         thread_info[thread_index].sched_num_intervals++;
+      }
+
+      interval_count++;
 
    /* read from packet input flows, push to packet/media threads */
 
@@ -766,6 +832,8 @@ session_create:  /* note - label used only if test mode repeats are enabled */
 
    } while (!ProcessKeys(hSessions, &dbg_cfg, cur_time, thread_index));  /* process interactive keyboard commands, see user_io.cpp */
 
+   SchedulerStats(get_time(USE_CLOCK_GETTIME), thread_index);  /* show push-pull loop CPU usage and interval timing stats if timer scheduler is enabled, JHB Oct 2026 */
+
 /* remaining session deletion */
 
    for (i=0; i<thread_info[thread_index].nSessionsCreated; i++) if (!(hSessions[i] & SESSION_MARKED_AS_DELETED)) nRemainingToDelete++;  /* see if any sessions remain to be deleted, depending on operating mode. In dynamic sessions mode all sessions may already be deleted, for example if they were terminated due to SIP BYE messages */
@@ -919,8 +987,11 @@ cleanup:
   
          if (thread_info[thread_index].input_data_cache[j].pkt_buf) free(thread_info[thread_index].input_data_cache[j].pkt_buf);
          thread_info[thread_index].input_data_cache[j].pkt_buf = NULL;
+         thread_info[thread_index].input_data_cache[j].pkt_data = NULL;
          thread_info[thread_index].input_data_cache[j].uFlags = CACHE_INVALID;
 
+         if (thread_info[thread_index].input_prefetch[j]) { InputPrefetchStop(thread_info[thread_index].input_prefetch[j]); thread_info[thread_index].input_prefetch[j] = NULL; }  /* stop reader thread before closing the input, JHB Oct 2026 */
+
          DSClosePcap(thread_info[thread_index].pcap_in[j], DS_CLOSE_PCAP_QUIET);
          thread_info[thread_index].pcap_in[j] = NULL;
       }
@@ -933,6 +1004,11 @@ cleanup:
       if (thread_info[thread_index].hFile_ASN_XML[j]) fclose(thread_info[thread_index].hFile_ASN_XML[j]);
    }
 
+/* free push batch mem and discard any remaining parked packets, JHB Oct 2026 */
+
+   if (thread_info[thread_index].push_batch.mem) free(thread_info[thread_index].push_batch.mem);
+   memset(&thread_info[thread_index].push_batch, 0, sizeof(PUSH_BATCH));
+
 /* close jitter buffer output file descriptors (if ENABLE_JITTER_BUFFER_OUTPUT_PCAPS is set on cmd line) */
 
    for (i=0; i<thread_info[thread_index].nSessionsCreated; i++) {
@@ -1095,6 +1171,10 @@ cleanup:
 
 /* clean up and exit */
 
+   DSPktFragmentThreadCleanup(0);  /* free this app thread's fragment pool and release its fragmentation thread slot, JHB Oct 2026 */
+
+   PortClassCleanup(thread_index);  /* free port classification table and SDP media port bitmaps, JHB Oct 2026 */
+
    if (isMasterThread(thread_index)) {
 
       DSConfigMediaService(NULL, DS_MEDIASERVICE_EXIT | DS_MEDIASERVICE_THREAD, 0, NULL, NULL);  /* close packet/media thread(s), JHB Dec 2022 */
@@ -1185,6 +1265,150 @@ uint8_t before_sync, after_sync;
    } while (before_sync == after_sync);
 }
 
+/* push-pull loop scheduler functions. Notes JHB Oct 2026:
+
+   -by default the push-pull loop in mediaMin_thread() polls get_time() until the next push-pull interval elapses (RealTimeInterval[0], set by -rN cmd line entry). This uses a full CPU core per app thread, even when idle
+   -if ENABLE_TIMER_SCHEDULER is set in -dN cmd line options, SchedulerWait() sleeps with clock_nanosleep() to an absolute deadline on CLOCK_MONOTONIC (the same clock used by get_time()). It wakes up SCHED_SPIN_MARGIN usec early and polls the remainder, so push-pull timing accuracy stays the same as polling while the CPU is given up for most of each interval
+   -in USE_PACKET_ARRIVAL_TIMES mode the deadline is the earlier of next interval and next packet arrival timestamp expiration (top of thread_info[].arrival_heap, see arrival heap notes)
+   -in AFAP mode (-r0 cmd line entry) there is no interval and the loop never sleeps. In FTRT mode intervals are short and savings are proportionally less
+   -pktlib has no notification for push queue space, so DSPushPackets() queue-full and stream group pull retries still sleep a fixed amount in PushPackets() and PullPackets(). Reduced timer slack (see SchedulerStart()) also improves accuracy of those sleeps
+   -SchedulerStats() reports CPU usage and interval timing accuracy when ENABLE_TIMER_SCHEDULER is set
+*/
+
+#define SCHED_SPIN_MARGIN  100    /* in usec */
+#define SCHED_MAX_SLEEP    10000  /* upper limit on one sleep, in usec. Keeps keyboard input and other loop housekeeping responsive */
+
+static uint64_t get_thread_cpu_time() {  /* return calling thread CPU time (user + system), in usec */
+
+struct rusage usage;
+
+   if (getrusage(RUSAGE_THREAD, &usage) < 0) return 0;
+
+   return (uint64_t)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)*1000000L + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+void SchedulerStart(uint64_t cur_time, int thread_index) {
+
+   if (Mode & ENABLE_TIMER_SCHEDULER) prctl(PR_SET_TIMERSLACK, 1, 0, 0, 0);  /* minimize timer slack for this thread (default is 50 usec) */
+
+   thread_info[thread_index].sched_start_time = cur_time;
+   thread_info[thread_index].sched_start_cpu_time = get_thread_cpu_time();
+   thread_info[thread_index].sched_num_intervals = 0;
+   thread_info[thread_index].sched_num_sleeps = 0;
+   thread_info[thread_index].sched_late_total = 0;
+   thread_info[thread_index].sched_late_max = 0;
+}
+
+void SchedulerWait(uint64_t deadline, uint64_t cur_time, int thread_index) {
+
+uint64_t wake_time, next_arrival_time = thread_info[thread_index].arrival_heap.num ? thread_info[thread_index].arrival_heap.item[0].time : 0;
+struct timespec ts;
+
+   if (next_arrival_time && next_arrival_time < deadline) deadline = next_arrival_time;  /* packet arrival timestamp expires before next interval */
+
+   if (deadline <= cur_time + SCHED_SPIN_MARGIN) return;  /* close to deadline, caller polls */
+
+   wake_time = min(deadline - SCHED_SPIN_MARGIN, cur_time + SCHED_MAX_SLEEP);
+
+   ts.tv_sec = wake_time/1000000L;
+   ts.tv_nsec = (wake_time % 1000000L)*1000;
+
+   clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);  /* if interrupted by a signal we return early and caller polls or calls again */
+
+   thread_info[thread_index].sched_num_sleeps++;
+}
+
+void SchedulerStats(uint64_t cur_time, int thread_index) {
+
+uint64_t wall_time = cur_time - thread_info[thread_index].sched_start_time, cpu_time = get_thread_cpu_time() - thread_info[thread_index].sched_start_cpu_time;
+uint64_t num_intervals = thread_info[thread_index].sched_num_intervals;
+char tmpstr[MAX_APP_STR_LEN];
+
+   if (!(Mode & ENABLE_TIMER_SCHEDULER) || !wall_time) return;  /* stats are shown only in timer scheduler mode */
+
+   sprintf(tmpstr, "Push-pull loop timer scheduler, CPU usage %2.1f%% (%2.3f of %2.3f sec)", 100.0*cpu_time/wall_time, cpu_time/1e6, wall_time/1e6);
+
+   if (num_intervals) sprintf(&tmpstr[strlen(tmpstr)], ", %llu intervals, avg/max interval lateness %2.1f/%llu usec", (unsigned long long)num_intervals, 1.0*thread_info[thread_index].sched_late_total/num_intervals, (unsigned long long)thread_info[thread_index].sched_late_max);
+   sprintf(&tmpstr[strlen(tmpstr)], ", %llu sleeps", (unsigned long long)thread_info[thread_index].sched_num_sleeps);
+
+   app_printf(APP_PRINTF_NEW_LINE | APP_PRINTF_THREAD_INDEX_SUFFIX | APP_PRINTF_PRINT_ONLY, cur_time, thread_index, tmpstr);
+   Log_RT(4 | DS_LOG_LEVEL_OUTPUT_FILE, "mediaMin INFO: %s ", tmpstr);
+}
+
+/* arrival heap functions. Notes JHB Oct 2026:
+
+   -in USE_PACKET_ARRIVAL_TIMES mode, when an input's next packet has an arrival timestamp not yet expired PushPackets() inserts the input into a per-thread min-heap (thread_info[].arrival_heap) keyed by the wall clock time the timestamp expires. Inputs in the heap are skipped by the PushPackets() input loop with a single check, instead of re-reading the cached packet and repeating packet info and timestamp calculations on every loop iteration
+   -at the start of PushPackets(), inputs with expired keys are popped and processed normally. With many inputs (e.g. dozens of capture files per app thread) the per-iteration cost is proportional to the number of inputs due, not the total number of inputs
+   -the heap top is the earliest arrival timestamp expiration, used by SchedulerWait() when ENABLE_TIMER_SCHEDULER is set
+   -for the master thread, keys are limited to 1 sec of media time so "Waiting N of M sec pause in packet arrival times" console updates continue during long pauses
+   -ties are broken by input stream index, so inputs due at the same time are processed in the same order as the input loop
+   -MergeInputs() uses the same functions with a local heap keyed by packet arrival timestamp
+*/
+
+static inline bool heap_less(ARRIVAL_HEAP_ITEM* a, ARRIVAL_HEAP_ITEM* b) { return a->time < b->time || (a->time == b->time && a->nStream < b->nStream); }
+
+static void heap_set(ARRIVAL_HEAP* heap, int i, ARRIVAL_HEAP_ITEM item) { heap->item[i] = item; heap->index[item.nStream] = i+1; }
+
+static void heap_sift(ARRIVAL_HEAP* heap, int i) {  /* restore heap order for item i, moving it up or down as needed */
+
+ARRIVAL_HEAP_ITEM item = heap->item[i];
+int parent, child;
+
+   while (i > 0 && heap_less(&item, &heap->item[parent = (i-1)/2])) { heap_set(heap, i, heap->item[parent]); i = parent; }
+
+   while ((child = 2*i+1) < heap->num) {
+
+      if (child+1 < heap->num && heap_less(&heap->item[child+1], &heap->item[child])) child++;
+      if (!heap_less(&heap->item[child], &item)) break;
+
+      heap_set(heap, i, heap->item[child]); i = child;
+   }
+
+   heap_set(heap, i, item);
+}
+
+void ArrivalHeapInsert(ARRIVAL_HEAP* heap, int nStream, uint64_t time) {  /* insert input stream, or update its key if already in the heap */
+
+int i;
+
+   if (nStream < 0 || nStream >= MAX_STREAMS_THREAD) return;
+
+   if (heap->index[nStream]) i = heap->index[nStream]-1;
+   else i = heap->num++;
+
+   heap->item[i].time = time;
+   heap->item[i].nStream = nStream;
+
+   heap_sift(heap, i);
+}
+
+void ArrivalHeapRemove(ARRIVAL_HEAP* heap, int nStream) {
+
+int i;
+
+   if (nStream < 0 || nStream >= MAX_STREAMS_THREAD || !heap->index[nStream]) return;
+
+   i = heap->index[nStream]-1;
+   heap->index[nStream] = 0;
+
+   if (i != --heap->num) {  /* move last item into the hole */
+      heap->item[i] = heap->item[heap->num];
+      heap_sift(heap, i);
+   }
+}
+
+int ArrivalHeapPop(ARRIVAL_HEAP* heap, uint64_t time) {  /* remove and return input stream with earliest key if the key is <= time, otherwise return -1 */
+
+int nStream;
+
+   if (!heap->num || heap->item[0].time > time) return -1;
+
+   nStream = heap->item[0].nStream;
+   ArrivalHeapRemove(heap, nStream);
+
+   return nStream;
+}
+
 
 /* following are dynamic session creation related local functions and definitions. FindStream() is in session_app.cpp */
 
@@ -2738,10 +2962,8 @@ unsigned int uFlags_push = DS_PUSHPACKETS_IP_PACKET
                            | DS_PUSHPACKETS_ENABLE_RFC7198_DEDUP  /* normally packet/media worker threads handle this using the -lN cmd line input (no entry is a lookback of 1 packet, otherwise N specifies the lookback) */
                            #endif
                            ;
-int chnum, push_cnt = 0;
+int chnum, push_cnt = 0, num_reads;
 int session_push_cnt[MAX_SESSIONS_THREAD] = { 0 };
-static uint8_t queue_full_warning[MAX_SESSIONS_THREAD] = { 0 };
-
 uint64_t wait_time;
 int auto_adj_push_count = 0;
 float msec_timestamp_fp = 0;
@@ -2749,6 +2971,8 @@ float msec_timestamp_fp = 0;
 static uint64_t last_cur_time = 0;
 
 static uint64_t last_wait_check_time[MAX_STREAMS_THREAD] = { 0 }, wait_pause[MAX_STREAMS_THREAD] = { 0 };  /* only used by master app thread */
+
+bool fReadAllDue = (isAFAPMode() || (isFTRTMode() && (Mode & USE_PACKET_ARRIVAL_TIMES))) && !(Mode & AUTO_ADJUST_PUSH_TIMING);  /* in accelerated time modes read all packets due from each input, not just one. In AFAP mode all packets are due, JHB Oct 2026 */
 static int waiting_inputs = 0;
 
 int pkt_len;
@@ -2765,10 +2989,25 @@ pcaprec_hdr_t pcap_rec_hdr;
 static int num_pcap_packets = 0;
 #endif
 
+   while (ArrivalHeapPop(&thread_info[tId].arrival_heap, cur_time) >= 0);  /* remove inputs with expired packet arrival timestamps from the arrival heap; they're processed in the input loop below. See arrival heap notes, JHB Oct 2026 */
+
+   thread_info[tId].push_batch.num_pushed = 0;
+   if (thread_info[tId].push_batch.num_pkts) FlushPushBatch(hSessions, uFlags_push, cur_time, thread_index);  /* retry parked packets first, if any. See push batch notes near FlushPushBatch(), JHB Oct 2026 */
+
    for (j=0; j<thread_info[thread_index].nInPcapFiles; j++) {
 
+      if (thread_info[tId].push_batch.num_parked[j]) continue;  /* input stream has parked packets, don't read more from it until they're pushed */
+
+      if (thread_info[tId].arrival_heap.index[j]) {  /* input stream is waiting for a packet arrival timestamp to expire, JHB Oct 2026 */
+
+         if (!thread_info[tId].dynamic_terminate_stream[j]) continue;
+         ArrivalHeapRemove(&thread_info[tId].arrival_heap, j);  /* don't delay stream termination until the timestamp expires */
+      }
+
       if (thread_info[thread_index].pcap_in[j] != NULL) {
 
+         num_reads = 0;
+
          if (Mode & AUTO_ADJUST_PUSH_TIMING) {
             auto_adj_push_count = 0;
             if (!average_push_rate[thread_index]) goto push_ctrl;  /* dynamically adjust average push rate (APR) if auto-adjust push rate is enabled */
@@ -2776,6 +3015,8 @@ static int num_pcap_packets = 0;
 
 next_packet:  /* next packet input */
 
+         SavePushBatchPkt(thread_index);  /* pkt_buf is about to be overwritten, copy a deferred push batch packet to push batch mem, JHB Oct 2026 */
+
          //#define STRESS_DEBUG
          #ifdef STRESS_DEBUG
          if (nRepeatsRemaining[tId] >= 0 && thread_info[tId].num_rtp_packets[j] > 1000) pkt_len = 0;
@@ -2790,6 +3031,8 @@ next_packet:  /* next packet input */
 
             pkt_len = GetInputData(pkt_buf, tId, j, &pcap_rec_hdr, &eth_protocol, &block_type);
 
+            if (pkt_len == INPUT_DATA_NOT_READY) continue;  /* input prefetch is enabled and reader thread hasn't read the next packet yet; move on to next input, JHB Oct 2026 */
+
          /* process non-zero length packets */
   
             if (pkt_len > 0) {
@@ -3007,6 +3250,8 @@ next_packet:  /* next packet input */
 
             /* no input repeats - close the input and set stream handle to NULL so it's no longer operated on */
   
+               if (thread_info[tId].input_prefetch[j]) { InputPrefetchStop(thread_info[tId].input_prefetch[j]); thread_info[tId].input_prefetch[j] = NULL; }  /* stop reader thread before closing the input, JHB Oct 2026 */
+
                if (thread_info[tId].pcap_in[j]) DSClosePcap(thread_info[tId].pcap_in[j], DS_CLOSE_PCAP_QUIET);
                thread_info[tId].pcap_in[j] = NULL;
 
@@ -3034,7 +3279,8 @@ next_packet:  /* next packet input */
 
             /* note that wrapping a pcap will typically cause warning messages about "large negative" timestamp and sequence number jumps, JHB Mar 2020 */
 
-               DSOpenPcap(NULL, DS_READ | DS_OPEN_PCAP_RESET, &thread_info[tId].pcap_in[j], NULL, "");  /* seek to start of first pcap record */
+               if (thread_info[tId].input_prefetch[j]) InputPrefetchRewind(thread_info[tId].input_prefetch[j]);  /* reader thread is parked while the pcap is rewound, then restarted, JHB Oct 2026 */
+               else DSOpenPcap(NULL, DS_READ | DS_OPEN_PCAP_RESET, &thread_info[tId].pcap_in[j], NULL, "");  /* seek to start of first pcap record */
 
                app_printf(APP_PRINTF_NEW_LINE | APP_PRINTF_PRINT_ONLY, cur_time, thread_index, "mediaMin INFO: pcap %s wraps", MediaParams[thread_info[tId].cmd_line_input_index[j]].Media.inputFilename);
 
@@ -3228,7 +3474,17 @@ protocol_based_processing:
                   }
                }
 
-               if (fReseek) thread_info[tId].input_data_cache[j].uFlags = CACHE_READ;  /* packet still waiting to be processed; indicate to GetInputData() to read packet data from cache */
+               if (fReseek) {
+
+                  thread_info[tId].input_data_cache[j].uFlags = CACHE_READ;  /* packet still waiting to be processed; indicate to GetInputData() to read packet data from cache */
+
+               /* insert input into arrival heap with the wall clock time when this arrival timestamp expires, i.e. when (elapsed_time + 500)/1000 >= msec_timestamp per above calculations. The input loop skips the input until then, and the timer scheduler avoids sleeping past the expiration. See arrival heap notes, JHB Oct 2026 */
+
+                  uint64_t expire_time = thread_info[tId].first_pkt_time[j] + (uint64_t)((msec_timestamp*1000ULL - 500)/timeScale) + 1;
+                  if (isMasterThread(thread_index)) expire_time = min(expire_time, cur_time + (uint64_t)(1000000/timeScale));  /* check at least once per sec of media time for console waiting status updates */
+
+                  ArrivalHeapInsert(&thread_info[tId].arrival_heap, j, expire_time);
+               }
 
             /* arrival timestamp not yet expired. Notes:
 
@@ -3584,6 +3840,8 @@ check_for_duplicated_headers:
                                                                        2) also increment SSRC to avoid "duplicated SSRC" notifications in packet/media worker threads (SSRC is not part of key that mediaMin uses to keep track of unique sessions)
                                                                     */
 
+               SavePushBatchPkt(thread_index);  /* previous reuse of this packet may be deferred in the push batch, JHB Oct 2026 */
+
                unsigned int src_udp_port, dst_udp_port, ip_hdr_len = DSGetPacketInfo(-1, DS_BUFFER_PKT_IP_PACKET | DS_PKT_INFO_HDRLEN, pkt_buf, pkt_len, NULL, NULL, 0);
 
                memcpy(&src_udp_port, &pkt_buf[ip_hdr_len], 2);
@@ -3701,8 +3959,6 @@ check_for_duplicated_headers:
                   if (nFirstSession == -1) nFirstSession = hSessions[i];
                   else app_printf(APP_PRINTF_NEW_LINE | APP_PRINTF_PRINT_ONLY, cur_time, thread_index, "######### Two pushes for same packet, nFirstSession = %d, hSession = %d, chnum = %d", nFirstSession, hSessions[i], chnum);  /* this should not happen, if it does call attention to it. If it occurs, it means there are exactly duplicated sessions, including RTP payload type, and we need more information to differentiate */
 
-                  int retry_count = 0;
-
                   #ifdef FIRST_TIME_TIMING  /* reserved for timing debug purposes */
                   static bool fSync = false;
                   if (!fSync && !fCreateDeleteTest && !fCapacityTest) { PmThreadSync(thread_index); fSync = true; }  /* sync between app thread and master p/m thread. This removes any timing difference between starting time of application thread vs. p/m thread */
@@ -3725,117 +3981,21 @@ check_for_duplicated_headers:
 
                   fPacketHandled = true;
 
-push:
         #ifdef VLC_CAPTURE_DEBUG
         int rtp_seqnum = DSGetPacketInfo(-1, DS_BUFFER_PKT_IP_PACKET | DS_PKT_INFO_RTP_SEQNUM, pkt_buf, -1, NULL, NULL, 0);
         if (rtp_seqnum > 37810 && rtp_seqnum < 37825) printf("\n *** pushing rtp seqnum %d \n", rtp_seqnum);
         #endif
 
-                  int ret_val = DSPushPackets(uFlags_push, pkt_buf, &pkt_len, &hSessions[i], 1);  /* push packet to packet/media thread queue */
-
-                  if ((uFlags_push & DS_PUSHPACKETS_ENABLE_RFC7198_DEDUP) && (ret_val & DS_PUSHPACKETS_ENABLE_RFC7198_DEDUP)) goto next_packet;  /* if we ask DSPushPackets() to look for duplicate packets and it finds one, move on to next packet. Normally packet/media worker threads handle this using the -lN cmd line input (no entry is a lookback of 1 packet, otherwise N specifies the lookback) */
-
-                  if (!ret_val) {  /* push queue is full, try waiting and pushing the packet again */
-
-                     uint32_t uSleepTime = max(1000, (int)(RealTimeInterval[0]*1000));
-                     usleep(uSleepTime);
-
-                     if (retry_count++ < 3) goto push;  /* max retries */
-                     else {
-
-                     /* not good if this is happening so we print to event log. But we don't want to overrun the log and/or console output with warnings, so we have a warning counter */
-
-                        if (!queue_full_warning[hSessions[i]]) Log_RT(3, "mediaMin WARNING: says DSPushPackets() timeout, unable to push packet for %d msec \n", (retry_count-1)*uSleepTime/1000);
-                        queue_full_warning[hSessions[i]]++;  /* will wrap after 255 */
-                     }
+                  if (!AddPushBatch(pkt_buf, pkt_len, &PktInfo, chnum, i, j, msec_timestamp_fp, hSessions, uFlags_push, cur_time, thread_index)) {  /* add packet to push batch. FlushPushBatch() pushes batched packets to packet/media thread queues at end of PushPackets(), JHB Oct 2026 */
 
-                     thread_info[tId].input_data_cache[j].uFlags = CACHE_READ;  /* unable to push this packet, try again later. Keep the packet in cache */
+                     thread_info[tId].input_data_cache[j].uFlags = CACHE_READ;  /* push batch is full of parked packets, keep the packet in cache and try again later */
 
                      continue;  /* move to next session */
                   }
-                  else if (ret_val < 0) {  /* error condition */
 
-                     Log_RT(3, "mediaMin WARNING: error condition returned by DSPushPackets, hSession = %d, pkt_len = %d\n", hSessions[i], pkt_len);
-                     continue;
-                  }
-                  else {  /* packet was successfully pushed */
-
-                     session_push_cnt[i]++;
-                     thread_info[tId].pkt_push_ctr++;
-                     push_cnt++;
-
-                  /* update stream stats with first packet info */
-
-                     for (int k=0; k<thread_info[tId].num_stream_stats; k++) if (chnum == thread_info[tId].StreamStats[k].chnum) {  /* find channel in StreamStats[] */
-
-                        if (!(thread_info[tId].StreamStats[k].uFlags & STREAM_STAT_FIRST_PKT)) {
-
-                           thread_info[tId].StreamStats[k].first_pkt_ssrc = PktInfo.rtp_ssrc;  /* get first packet RTP SSRC */
-                           thread_info[tId].StreamStats[k].first_pkt_usec = DSGetTimestamp(NULL, DS_EVENT_LOG_UPTIME_TIMESTAMPS, 0, 0);  /* get usec since app thread start */
-
-                           #if 0  /* debug */
-                           printf("\n *** stream stat %d, updating ch %d, hSessions[%d] = %d, term = %d, ssrc = 0x%x, usec = %llu \n", k, chnum, i, hSessions[i], thread_info[tId].StreamStats[k].term, thread_info[tId].StreamStats[k].first_pkt_ssrc, (long long unsigned int)thread_info[tId].StreamStats[k].first_pkt_usec);
-                           #endif
-
-                           thread_info[tId].StreamStats[k].uFlags |= STREAM_STAT_FIRST_PKT;  /* set first packet flag */
-                        }
-
-                        break;  /* stop searching after channel found */
-                     }
-
-                     if (queue_full_warning[hSessions[i]]) queue_full_warning[hSessions[i]] = 0;  /* reset queue full warning if needed */
-
-                  /* if specified, calculate packet arrival timing stats, JHB Aug 2023:
-                   
-                     -objective is to measure delta and jitter with respect to ptime, and get a handle on whether packet rate is consistently fast or slow. Wireshark averages include SID packets which obscures accurate reading on things like media playout servers
-                     -only calculate for successive media packets and SID packets that immediately follow a media packet, and omit consecutive SID, DTMF packets
-                     -currently we have a 1/2 sec limit on gaps due to packet loss or input pauses, anything larger than that is not counted
-                     -currently these stats are not reset in repeat mode
-                     -to-do: capacity tests
-                  */
-
-                     if (Mode & SHOW_PACKET_ARRIVAL_STATS) {
-
-                        float delta_timestamp,
-                              #ifdef RTP_TIMESTAMP_STATS
-                              Fs = DSGetSessionInfo(hSessions[i], DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_SAMPLE_RATE, 1, NULL),  /* get session codec sampling rate in Hz */
-                              #endif
-                              ptime = DSGetSessionInfo(hSessions[i], DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_PTIME, 1, NULL);  /* get session ptime in msec */
-
-                        #define MAX_STATS_GAP 25*ptime
-
-                        if (thread_info[tId].last_rtp_pyld_len[i] > 8 && (delta_timestamp = msec_timestamp_fp - thread_info[tId].last_msec_timestamp[i]) < MAX_STATS_GAP) {  /* omit DTMFs and SIDs, gaps larger than 500 msec (for 20 sec nominal ptime). Note the payload len check also ensures the first delta values will not be something - zero */
-
-                           thread_info[tId].arrival_avg_delta[i] += delta_timestamp;
-
-                           thread_info[tId].arrival_avg_jitter[i] += fabsf(delta_timestamp - ptime);
-
-                           thread_info[tId].arrival_avg_delta_clock[i] += (cur_time - thread_info[tId].first_pkt_time[j])/(thread_info[tId].num_arrival_stats_pkts[i]+1)/1000.0;  /* in msec */
-
-                           #ifdef RTP_TIMESTAMP_STATS  /* can be enabled in mediaMin.h for RTP timestamp stats and debug. Not normally used as timestamps are unlikely to be in correct order until processing by pktlib jitter buffer, JHB Mar 2025 */
-                           thread_info[tId].rtp_timestamp_avg_delta[i] += 1000*(PktInfo.rtp_timestamp - thread_info[tId].last_rtp_timestamp[i])/Fs;  /* in msec */
-                           #endif
+                  session_push_cnt[i]++;  /* batched packets count as pushed for auto-adjust push rate purposes */
 
-                           thread_info[tId].num_arrival_stats_pkts[i]++;
-
-                           #if 0
-                           static int count[10] = { 0 };
-                           if (count[i]++ < 50) printf("\n[%d]%d msec_timestamp_fp = %4.2f, delta_timestamp = %4.2f, jitter = %4.2f\n", i, thread_info[tId].num_arrival_stats_pkts[i], msec_timestamp_fp, delta_timestamp, fabsf(delta_timestamp - thread_info[tId].arrival_avg_delta[i]));
-                           #endif
-
-                           thread_info[tId].arrival_max_delta[i] = max(thread_info[tId].arrival_max_delta[i], delta_timestamp);
-                           thread_info[tId].arrival_max_jitter[i] = max(thread_info[tId].arrival_max_jitter[i], fabsf(delta_timestamp - ptime));
-                        }
-                     }
-
-                     thread_info[tId].last_rtp_pyld_len[i] = PktInfo.rtp_pyld_len;
-                     thread_info[tId].last_msec_timestamp[i] = msec_timestamp_fp;
-                     #ifdef RTP_TIMESTAMP_STATS
-                     thread_info[tId].last_rtp_timestamp[i] = PktInfo.rtp_timestamp;
-                     #endif
-
-                     break;  /* break out of nSessions loop, the packet should match no other sessions */
-                  }
+                  break;  /* break out of nSessions loop, the packet should match no other sessions */
                }
             }  /* nSessions loop (i) */
          }  /* packet reuse loop (n) */
@@ -3853,6 +4013,10 @@ push:
             thread_info[tId].num_unhandled_rtp_packets[j]++;
          }
 
+      /* in AFAP and FTRT modes read the input's next packet, if due. Packets not yet due are handled by arrival timestamp checks above (inserted into the arrival heap). Stop if the packet wasn't consumed (e.g. push batch full of parked packets) or the input has parked packets. See push batch notes, JHB Oct 2026 */
+
+         if (fReadAllDue && ++num_reads < PUSH_MAX_READS_PER_INPUT && !(thread_info[tId].input_data_cache[j].uFlags & CACHE_ITEM_MASK) && !thread_info[tId].push_batch.num_parked[j] && !thread_info[tId].uErrorCondition) goto next_packet;
+
       }  /* input stream loop (end of file or UDP port; e.g. if fp[j] != NULL) */
 
    /* Auto-adjust packet push timing algorithm
@@ -3915,10 +4079,282 @@ push_ctrl:  /* upon entry PushPackets() jumps here if current average push rate
 
    }  /* end of input stream loop */
 
+   FlushPushBatch(hSessions, uFlags_push, cur_time, thread_index);  /* push batched packets, one DSPushPackets() call per session */
+
+   push_cnt = thread_info[tId].push_batch.num_pushed;
+
    return push_cnt;
 
 }  /* end of PushPackets() */
 
+/* push batch functions. Notes JHB Oct 2026:
+
+   -PushPackets() adds packets to a per-thread push batch with AddPushBatch() instead of calling DSPushPackets() for each packet. FlushPushBatch() pushes the batch with one DSPushPackets() call per session at the end of PushPackets()
+   -in AFAP and FTRT modes PushPackets() reads up to PUSH_MAX_READS_PER_INPUT packets due from each input per call, so a batch holds all packets due in the interval. In real-time mode one packet per input is read per call, as before
+   -the first packet added to an empty batch is not copied; it's referenced in pkt_buf (item pkt_ptr). SavePushBatchPkt() copies it to push batch mem before pkt_buf is overwritten by the next input read or header modification. A batch that holds one packet is pushed directly from pkt_buf, so there is no extra copy per packet compared to calling DSPushPackets() directly (for ENABLE_MMAP_INPUT the mapping to pkt_buf copy remains, as PushPackets() does in-place processing)
+   -a session's packets that are consecutive in push batch mem are pushed directly from push batch mem, otherwise they are gathered in scratch mem
+   -if DSPushPackets() returns a queue full status, packets not pushed remain "parked" in the batch and are retried at the start of the next PushPackets() call. Previously the app thread slept and retried up to 3 times, which stalled all other inputs and sessions on the thread
+   -PushPackets() does not read from an input stream with parked packets. This applies backpressure per input stream, maintains per-session packet order, and defers input end-of-stream handling until all of the input's packets have been pushed
+   -if a session's push queue stays full longer than PUSH_QUEUE_FULL_WARNING_TIME a warning is logged, as before
+   -parked packets for a session deleted in the meantime are discarded
+*/
+
+static uint8_t queue_full_warning[MAX_SESSIONS_THREAD] = { 0 };
+
+#define PUSH_QUEUE_FULL_WARNING_TIME  (3*max(1000, (int)(RealTimeInterval[0]*1000)))  /* in usec, same as total sleep time of previous retry method */
+
+static void PushedPacketStats(PUSH_BATCH_ITEM* item, uint64_t cur_time, int thread_index) {  /* update stats after a packet is pushed */
+
+int i = item->nSessionIndex, j = item->nStream;
+HSESSION hSession = item->hSession;
+float msec_timestamp_fp = item->msec_timestamp_fp;
+
+/* update stream stats with first packet info */
+
+   for (int k=0; k<thread_info[thread_index].num_stream_stats; k++) if (item->chnum == thread_info[thread_index].StreamStats[k].chnum) {  /* find channel in StreamStats[] */
+
+      if (!(thread_info[thread_index].StreamStats[k].uFlags & STREAM_STAT_FIRST_PKT)) {
+
+         thread_info[thread_index].StreamStats[k].first_pkt_ssrc = item->rtp_ssrc;  /* get first packet RTP SSRC */
+         thread_info[thread_index].StreamStats[k].first_pkt_usec = DSGetTimestamp(NULL, DS_EVENT_LOG_UPTIME_TIMESTAMPS, 0, 0);  /* get usec since app thread start */
+
+         #if 0  /* debug */
+         printf("\n *** stream stat %d, updating ch %d, hSessions[%d] = %d, term = %d, ssrc = 0x%x, usec = %llu \n", k, chnum, i, hSession, thread_info[thread_index].StreamStats[k].term, thread_info[thread_index].StreamStats[k].first_pkt_ssrc, (long long unsigned int)thread_info[thread_index].StreamStats[k].first_pkt_usec);
+         #endif
+
+         thread_info[thread_index].StreamStats[k].uFlags |= STREAM_STAT_FIRST_PKT;  /* set first packet flag */
+      }
+
+      break;  /* stop searching after channel found */
+   }
+
+   if (queue_full_warning[hSession]) queue_full_warning[hSession] = 0;  /* reset queue full warning if needed */
+
+/* if specified, calculate packet arrival timing stats, JHB Aug 2023:
+ 
+   -objective is to measure delta and jitter with respect to ptime, and get a handle on whether packet rate is consistently fast or slow. Wireshark averages include SID packets which obscures accurate reading on things like media playout servers
+   -only calculate for successive media packets and SID packets that immediately follow a media packet, and omit consecutive SID, DTMF packets
+   -currently we have a 1/2 sec limit on gaps due to packet loss or input pauses, anything larger than that is not counted
+   -currently these stats are not reset in repeat mode
+   -to-do: capacity tests
+*/
+
+   if (Mode & SHOW_PACKET_ARRIVAL_STATS) {
+
+      float delta_timestamp,
+            #ifdef RTP_TIMESTAMP_STATS
+            Fs = DSGetSessionInfo(hSession, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_SAMPLE_RATE, 1, NULL),  /* get session codec sampling rate in Hz */
+            #endif
+            ptime = DSGetSessionInfo(hSession, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_PTIME, 1, NULL);  /* get session ptime in msec */
+
+      #define MAX_STATS_GAP 25*ptime
+
+      if (thread_info[thread_index].last_rtp_pyld_len[i] > 8 && (delta_timestamp = msec_timestamp_fp - thread_info[thread_index].last_msec_timestamp[i]) < MAX_STATS_GAP) {  /* omit DTMFs and SIDs, gaps larger than 500 msec (for 20 sec nominal ptime). Note the payload len check also ensures the first delta values will not be something - zero */
+
+         thread_info[thread_index].arrival_avg_delta[i] += delta_timestamp;
+
+         thread_info[thread_index].arrival_avg_jitter[i] += fabsf(delta_timestamp - ptime);
+
+         thread_info[thread_index].arrival_avg_delta_clock[i] += (cur_time - thread_info[thread_index].first_pkt_time[j])/(thread_info[thread_index].num_arrival_stats_pkts[i]+1)/1000.0;  /* in msec */
+
+         #ifdef RTP_TIMESTAMP_STATS  /* can be enabled in mediaMin.h for RTP timestamp stats and debug. Not normally used as timestamps are unlikely to be in correct order until processing by pktlib jitter buffer, JHB Mar 2025 */
+         thread_info[thread_index].rtp_timestamp_avg_delta[i] += 1000*(item->rtp_timestamp - thread_info[thread_index].last_rtp_timestamp[i])/Fs;  /* in msec */
+         #endif
+
+         thread_info[thread_index].num_arrival_stats_pkts[i]++;
+
+         #if 0
+         static int count[10] = { 0 };
+         if (count[i]++ < 50) printf("\n[%d]%d msec_timestamp_fp = %4.2f, delta_timestamp = %4.2f, jitter = %4.2f\n", i, thread_info[thread_index].num_arrival_stats_pkts[i], msec_timestamp_fp, delta_timestamp, fabsf(delta_timestamp - thread_info[thread_index].arrival_avg_delta[i]));
+         #endif
+
+         thread_info[thread_index].arrival_max_delta[i] = max(thread_info[thread_index].arrival_max_delta[i], delta_timestamp);
+         thread_info[thread_index].arrival_max_jitter[i] = max(thread_info[thread_index].arrival_max_jitter[i], fabsf(delta_timestamp - ptime));
+      }
+   }
+
+   thread_info[thread_index].last_rtp_pyld_len[i] = item->rtp_pyld_len;
+   thread_info[thread_index].last_msec_timestamp[i] = msec_timestamp_fp;
+   #ifdef RTP_TIMESTAMP_STATS
+   thread_info[thread_index].last_rtp_timestamp[i] = item->rtp_timestamp;
+   #endif
+}
+
+static int FlushPushBatch(HSESSION hSessions[], unsigned int uFlags_push, uint64_t cur_time, int thread_index) {
+
+PUSH_BATCH* batch = &thread_info[thread_index].push_batch;
+uint8_t state[PUSH_BATCH_MAX_PKTS];  /* per packet state: 0 = not yet pushed, 1 = pushed or discarded, 2 = parked */
+bool fDuplicate[PUSH_BATCH_MAX_PKTS] = { false };  /* set for packets discarded by DSPushPackets() RFC7198 duplicate detection */
+int k, m, n, num_pushed = 0, ret_val, pkt_len[PUSH_BATCH_MAX_PKTS], index[PUSH_BATCH_MAX_PKTS];
+HSESSION hSession_list[PUSH_BATCH_MAX_PKTS];
+uint8_t* pkt_buf;
+uint32_t mem_used;
+
+   if (!batch->num_pkts) return 0;
+
+   memset(state, 0, batch->num_pkts);
+
+   for (k=0; k<batch->num_pkts; k++) {
+
+      if (state[k]) continue;  /* already handled with an earlier packet of the same session */
+
+      HSESSION hSession = batch->item[k].hSession;
+      int nSessionIndex = batch->item[k].nSessionIndex;
+
+   /* gather the session's packets in batch order */
+
+      for (m=k, n=0; m<batch->num_pkts; m++) if (!state[m] && batch->item[m].hSession == hSession) {
+
+         pkt_len[n] = batch->item[m].pkt_len;
+         hSession_list[n] = hSession;
+         index[n++] = m;
+      }
+
+      if (hSessions[nSessionIndex] != hSession) {  /* session deleted or marked as deleted after packets were batched, discard */
+
+         for (m=0; m<n; m++) state[index[m]] = 1;
+         continue;
+      }
+
+      for (m=1; m<n; m++) if (batch->item[index[m-1]].pkt_ptr || batch->item[index[m]].offset != batch->item[index[m-1]].offset + (uint32_t)pkt_len[m-1]) break;  /* check if session's packets are consecutive in push batch mem */
+
+      if (n == 1) pkt_buf = batch->item[k].pkt_ptr ? (uint8_t*)batch->item[k].pkt_ptr : &batch->mem[batch->item[k].offset];  /* single packet, no copy needed. Packet may still be in PushPackets() pkt_buf */
+      else if (m == n) pkt_buf = &batch->mem[batch->item[k].offset];  /* consecutive packets, no copy needed */
+      else for (m=0, mem_used=0, pkt_buf = &batch->mem[PUSH_BATCH_MEM_SIZE]; m<n; m++) {  /* copy to scratch mem; DSPushPackets() expects consecutive packets */
+
+         PUSH_BATCH_ITEM* item = &batch->item[index[m]];
+
+         memcpy(&pkt_buf[mem_used], item->pkt_ptr ? item->pkt_ptr : &batch->mem[item->offset], pkt_len[m]);
+         mem_used += pkt_len[m];
+      }
+
+      if (!(uFlags_push & DS_PUSHPACKETS_ENABLE_RFC7198_DEDUP)) ret_val = DSPushPackets(uFlags_push, pkt_buf, pkt_len, hSession_list, n);  /* push session's packets to packet/media thread queue */
+      else for (m=0, ret_val=0, mem_used=0; m<n; m++) {  /* duplicate packet detection status is returned per packet, so in that case we push one at a time. A duplicate packet is consumed but not counted or included in pushed packet stats */
+
+         int ret = DSPushPackets(uFlags_push, &pkt_buf[mem_used], &pkt_len[m], &hSession, 1);
+         if (ret <= 0) { if (!m) ret_val = ret; break; }
+         if (ret & DS_PUSHPACKETS_ENABLE_RFC7198_DEDUP) fDuplicate[index[m]] = true;  /* DSPushPackets() found a duplicate packet and discarded it */
+         ret_val++;
+         mem_used += pkt_len[m];
+      }
+
+      if (ret_val < 0) {  /* error condition, discard */
+
+         Log_RT(3, "mediaMin WARNING: error condition returned by DSPushPackets(), hSession = %d, num pkts = %d \n", hSession, n);
+
+         for (m=0; m<n; m++) state[index[m]] = 1;
+         continue;
+      }
+
+      ret_val = min(ret_val, n);
+
+      for (m=0; m<ret_val; m++) {  /* packets successfully pushed or discarded as duplicates */
+
+         state[index[m]] = 1;
+         if (fDuplicate[index[m]]) continue;  /* move on to next packet, same as previous per packet push */
+
+         PushedPacketStats(&batch->item[index[m]], cur_time, thread_index);
+         num_pushed++;
+      }
+
+      if (ret_val) batch->queue_full_time[nSessionIndex] = 0;
+
+      if (ret_val < n) {  /* push queue is full, park remaining packets */
+
+         for (m=ret_val; m<n; m++) state[index[m]] = 2;
+
+         if (!batch->queue_full_time[nSessionIndex]) batch->queue_full_time[nSessionIndex] = cur_time;
+         else if (cur_time - batch->queue_full_time[nSessionIndex] >= (uint64_t)PUSH_QUEUE_FULL_WARNING_TIME) {
+
+         /* not good if this is happening so we print to event log. But we don't want to overrun the log and/or console output with warnings, so we have a warning counter */
+
+            if (!queue_full_warning[hSession]) Log_RT(3, "mediaMin WARNING: says DSPushPackets() timeout, unable to push packet for %d msec \n", (int)((cur_time - batch->queue_full_time[nSessionIndex])/1000));
+            queue_full_warning[hSession]++;  /* will wrap after 255 */
+         }
+      }
+   }
+
+/* move parked packets to start of batch, update per input stream parked packet counts */
+
+   memset(batch->num_parked, 0, sizeof(batch->num_parked));
+
+   for (k=0, n=0, mem_used=0; k<batch->num_pkts; k++) if (state[k] == 2) {
+
+      if (batch->item[k].pkt_ptr) memcpy(&batch->mem[mem_used], batch->item[k].pkt_ptr, batch->item[k].pkt_len);  /* parked packet still in pkt_buf, copy it */
+      else if (batch->item[k].offset != mem_used) memmove(&batch->mem[mem_used], &batch->mem[batch->item[k].offset], batch->item[k].pkt_len);
+
+      batch->item[n] = batch->item[k];
+      batch->item[n].offset = mem_used;
+      batch->item[n].pkt_ptr = NULL;
+      mem_used += batch->item[n].pkt_len;
+      batch->num_parked[batch->item[n].nStream]++;
+      n++;
+   }
+
+   batch->num_pkts = n;
+   batch->mem_used = mem_used;
+   batch->num_pushed += num_pushed;
+
+   thread_info[thread_index].pkt_push_ctr += num_pushed;
+
+   return num_pushed;
+}
+
+static int AddPushBatch(uint8_t* pkt_buf, int pkt_len, PKTINFO* PktInfo, int chnum, int nSessionIndex, int nStream, float msec_timestamp_fp, HSESSION hSessions[], unsigned int uFlags_push, uint64_t cur_time, int thread_index) {
+
+PUSH_BATCH* batch = &thread_info[thread_index].push_batch;
+PUSH_BATCH_ITEM* item;
+
+   if (!batch->mem && !(batch->mem = (uint8_t*)malloc(2*PUSH_BATCH_MEM_SIZE))) {  /* allocate on first use, including scratch mem */
+
+      Log_RT(2, "mediaMin ERROR: unable to allocate push batch mem, thread = %d \n", thread_index);
+      return 0;
+   }
+
+   if (pkt_len <= 0 || pkt_len > PUSH_BATCH_MEM_SIZE) return 0;
+
+   if (batch->num_pkts >= PUSH_BATCH_MAX_PKTS || batch->mem_used + pkt_len > PUSH_BATCH_MEM_SIZE) {
+
+      FlushPushBatch(hSessions, uFlags_push, cur_time, thread_index);  /* batch is full, push what we have */
+
+      if (batch->num_pkts >= PUSH_BATCH_MAX_PKTS || batch->mem_used + pkt_len > PUSH_BATCH_MEM_SIZE) return 0;  /* still full of parked packets */
+   }
+
+   item = &batch->item[batch->num_pkts++];
+
+   if (batch->num_pkts == 1) item->pkt_ptr = pkt_buf;  /* first packet in batch is not copied, mem is reserved. If no other packets are added the packet is pushed directly from pkt_buf, otherwise SavePushBatchPkt() copies it before pkt_buf is overwritten */
+   else {
+      memcpy(&batch->mem[batch->mem_used], pkt_buf, pkt_len);
+      item->pkt_ptr = NULL;
+   }
+
+   item->offset = batch->mem_used;
+   item->pkt_len = pkt_len;
+   item->hSession = hSessions[nSessionIndex];
+   item->nSessionIndex = nSessionIndex;
+   item->nStream = nStream;
+   item->chnum = chnum;
+   item->rtp_ssrc = PktInfo->rtp_ssrc;
+   item->rtp_pyld_len = PktInfo->rtp_pyld_len;
+   item->rtp_timestamp = PktInfo->rtp_timestamp;
+   item->msec_timestamp_fp = msec_timestamp_fp;
+
+   batch->mem_used += pkt_len;
+
+   return 1;
+}
+
+static void SavePushBatchPkt(int thread_index) {  /* copy deferred first packet, if any, to push batch mem. Called before PushPackets() pkt_buf is overwritten */
+
+PUSH_BATCH* batch = &thread_info[thread_index].push_batch;
+
+   if (batch->num_pkts && batch->item[0].pkt_ptr) {
+
+      memcpy(&batch->mem[batch->item[0].offset], batch->item[0].pkt_ptr, batch->item[0].pkt_len);
+      batch->item[0].pkt_ptr = NULL;
+   }
+}
+
 /* pull packets from packet / media session-organized queue. Packets are pulled by category:  jitter buffer output, transcoded, and stream group */
 
 int PullPackets(uint8_t* pkt_out_buf, HSESSION hSessions[], SESSION_DATA session_data[], unsigned int uFlags, unsigned int pkt_buf_len, uint64_t cur_time, int thread_index) {
@@ -4333,7 +4769,17 @@ unsigned int uFlags = (Mode & ENABLE_DEBUG_STATS) ? DS_READ_PCAP_REPORT_TSO_LENG
 
    /* DSReadPcap() handles pcap, pcapng, and .rtpdump format. Return value is packet length in bytes (or block data length for pcapng non-packet blocks). A return value of zero indicates end of file, -1 indicates an error condition (in which case an error message has already been displayed/logged) */
   
-      pkt_len = DSReadPcap(thread_info[tId].pcap_in[nStream], uFlags, pkt_buf, (Mode & USE_PACKET_ARRIVAL_TIMES) ? p_pcap_rec_hdr : NULL, thread_info[tId].link_layer_info[nStream], p_eth_protocol, p_block_type, thread_info[tId].pcap_file_hdr[nStream], thread_info[tId].packet_number[nStream]+1, NULL);  /* source is in lib/pktlib/pktlib_pcap.cpp */
+      if (isLinkLayerMmap(thread_info[tId].link_layer_info[nStream])) {  /* memory-mapped input (ENABLE_MMAP_INPUT flag), DSReadPcapView() returns a pointer to packet data in the file mapping, JHB Oct 2026 */
+
+         pkt_len = DSReadPcapView(thread_info[tId].pcap_in[nStream], uFlags, &thread_info[tId].input_data_cache[nStream].pkt_data, (Mode & USE_PACKET_ARRIVAL_TIMES) ? p_pcap_rec_hdr : NULL, thread_info[tId].link_layer_info[nStream], p_eth_protocol, p_block_type, thread_info[tId].packet_number[nStream]+1, NULL);
+
+         if (pkt_len > 0) memcpy(pkt_buf, thread_info[tId].input_data_cache[nStream].pkt_data, pkt_len);  /* PushPackets() does in-place processing (e.g. fragment reassembly, DER decoding) so pkt_buf still gets a copy. The mapping serves as the input cache, no additional copy is needed */
+      }
+      else if (thread_info[tId].input_prefetch[nStream]) {  /* input prefetch (ENABLE_INPUT_PREFETCH flag), take next packet from the reader thread's ring, JHB Oct 2026 */
+
+         if ((pkt_len = InputPrefetchRead(thread_info[tId].input_prefetch[nStream], pkt_buf, p_pcap_rec_hdr, p_eth_protocol, p_block_type)) == INPUT_DATA_NOT_READY) return pkt_len;  /* nothing to read yet, input cache remains invalid */
+      }
+      else pkt_len = DSReadPcap(thread_info[tId].pcap_in[nStream], uFlags, pkt_buf, (Mode & USE_PACKET_ARRIVAL_TIMES) ? p_pcap_rec_hdr : NULL, thread_info[tId].link_layer_info[nStream], p_eth_protocol, p_block_type, thread_info[tId].pcap_file_hdr[nStream], thread_info[tId].packet_number[nStream]+1, NULL);  /* source is in lib/pktlib/pktlib_pcap.cpp */
 
       //#define NON_IP_FRAMES_DEBUG  /* enable to see frames that don't contain actual transmitted packet data but still have an IP header type and IP version header */
       #ifdef NON_IP_FRAMES_DEBUG
@@ -4376,11 +4822,16 @@ unsigned int uFlags = (Mode & ENABLE_DEBUG_STATS) ? DS_READ_PCAP_REPORT_TSO_LENG
      -a per-stream "Oversize non-fragmented" packet stat is maintained and displayed in mediaMin summary stats. Currently an event log INFO message is written only for first few instances, which covers most cases and gives some idea of what type of oversize packets have been encountered. Packet type is 
   */
 
+      bool fMmapInput = thread_info[tId].input_data_cache[nStream].pkt_data != NULL;  /* for memory-mapped input the cache references packet data in the mapping and its buffer is not used, JHB Oct 2026 */
+
       if (pkt_len - NOMINAL_MTU > 0) {  /* check for packet size larger than input cache data buffer nominal MTU size, for infrequent reasons as noted above. NOMINAL_MTU is defined in pktlib.h */
 
-         thread_info[tId].input_data_cache[nStream].uFlags |= CACHE_MTU_EXPANDED;
+         if (!fMmapInput) {
 
-         thread_info[tId].input_data_cache[nStream].pkt_buf = (uint8_t*)realloc(thread_info[tId].input_data_cache[nStream].pkt_buf, pkt_len);  /* realloc cache packet data buffer size as needed */
+            thread_info[tId].input_data_cache[nStream].uFlags |= CACHE_MTU_EXPANDED;
+
+            thread_info[tId].input_data_cache[nStream].pkt_buf = (uint8_t*)realloc(thread_info[tId].input_data_cache[nStream].pkt_buf, pkt_len);  /* realloc cache packet data buffer size as needed */
+         }
 
          char szIPver[100] = "n/a", szFragmentFlags[100] = "n/a", szProtocol[100] = "";
          uint16_t pInfoBuffer[100] = { 0 };
@@ -4425,7 +4876,7 @@ unsigned int uFlags = (Mode & ENABLE_DEBUG_STATS) ? DS_READ_PCAP_REPORT_TSO_LENG
       }
 
       thread_info[tId].input_data_cache[nStream].pkt_len = pkt_len;
-      memcpy(thread_info[tId].input_data_cache[nStream].pkt_buf, pkt_buf, pkt_len);  /* copy packet data to cache buffer */
+      if (!fMmapInput) memcpy(thread_info[tId].input_data_cache[nStream].pkt_buf, pkt_buf, pkt_len);  /* copy packet data to cache buffer */
       last_input[tId] = nStream;
 
       thread_info[tId].input_data_cache[nStream].uFlags |= CACHE_NEW_DATA;  /* mark input cache as updated with new data */
@@ -4451,7 +4902,7 @@ unsigned int uFlags = (Mode & ENABLE_DEBUG_STATS) ? DS_READ_PCAP_REPORT_TSO_LENG
 
       /* copy cache buffer to packet data */
 
-         memcpy(pkt_buf, thread_info[tId].input_data_cache[nStream].pkt_buf, pkt_len);
+         memcpy(pkt_buf, thread_info[tId].input_data_cache[nStream].pkt_data ? thread_info[tId].input_data_cache[nStream].pkt_data : thread_info[tId].input_data_cache[nStream].pkt_buf, pkt_len);  /* for memory-mapped input copy from the mapping, JHB Oct 2026 */
 
          last_input[tId] = nStream;
          #ifdef INPUT_CACHE_DEBUG
@@ -4479,8 +4930,11 @@ unsigned int uFlags;
 
    if (Mode & AUTO_ADJUST_PUSH_TIMING) average_push_rate[thread_index] = 2;  /* initialize auto-adjust push rate algorithm state */
 
+   memset(&thread_info[thread_index].arrival_heap, 0, sizeof(ARRIVAL_HEAP));  /* no inputs waiting for arrival timestamps, JHB Oct 2026 */
+
    uFlags = DS_READ;
    if (fCapacityTest) uFlags |= DS_OPEN_PCAP_QUIET;
+   if (Mode & ENABLE_MMAP_INPUT) uFlags |= DS_OPEN_PCAP_MMAP;  /* memory-map pcap and pcapng inputs; DSOpenPcap() falls back to file I/O if mapping fails (and for .rtpXXX files), JHB Oct 2026 */
 
 /* open input pcap files, advance file pointer to first packet. Abort program on any input file failure */
 
@@ -4551,6 +5005,7 @@ valid_input_spec:
          thread_info[thread_index].cmd_line_input_index[nStream] = cmd_line_input;  /* save to allow mapping from command line input to stream index. See "stream and session notes" in mediaMin.h */
 
          thread_info[thread_index].input_data_cache[nStream].uFlags = CACHE_INVALID;  /* set cache state to invalid data */
+         thread_info[thread_index].input_data_cache[nStream].pkt_data = NULL;
          thread_info[thread_index].input_data_cache[nStream].pkt_buf = (uint8_t*)calloc(1, NOMINAL_MTU);  /* allocate nominal size packet data mem, clear to zero. NOMINAL_MTU is defined in pktlib.h */
 
          if (!thread_info[thread_index].input_data_cache[nStream].pkt_buf) {
@@ -4558,7 +5013,7 @@ valid_input_spec:
             fprintf(stderr, "Failed to allocate memory (%d bytes) for input cache packet data, thread_index = %d \n", NOMINAL_MTU, thread_index);
 
             if (thread_info[thread_index].pcap_in[nStream]) {
-               fclose(thread_info[thread_index].pcap_in[nStream]);
+               DSClosePcap(thread_info[thread_index].pcap_in[nStream], DS_CLOSE_PCAP_QUIET);  /* DSClosePcap() also releases memory-mapped input, JHB Oct 2026 */
                thread_info[thread_index].pcap_in[nStream] = NULL;
             }
 
@@ -4566,6 +5021,8 @@ valid_input_spec:
             break;
          }
 
+         thread_info[thread_index].input_prefetch[nStream] = NULL;
+
          thread_info[thread_index].nInPcapFiles = ++nStream;
       }
       else { fprintf(stderr, "Input file %s does not have .pcap, .pcapng, .rtp, .rtpdump, or .ber file extension \n", MediaParams[cmd_line_input].Media.inputFilename); break; }
@@ -4573,6 +5030,19 @@ valid_input_spec:
       cmd_line_input++;  /* advance to next cmd line input spec */
    }
 
+   if ((Mode & MERGE_INPUTS) && !thread_info[thread_index].uErrorCondition && thread_info[thread_index].nInPcapFiles > 1) MergeInputs(uFlags, thread_index);  /* merge inputs into one time-ordered input, JHB Oct 2026 */
+
+   for (nStream=0; nStream<thread_info[thread_index].nInPcapFiles; nStream++) {
+
+      if ((Mode & ENABLE_INPUT_PREFETCH) && thread_info[thread_index].pcap_in[nStream] && isInputPcap(getIOType(thread_info[thread_index].link_layer_info[nStream])) && !isLinkLayerMmap(thread_info[thread_index].link_layer_info[nStream])) {  /* start input reader thread, uFlags same as DSReadPcap() in GetInputData(). If prefetch fails to start, synchronous reads are used, JHB Oct 2026 */
+
+         if (!(thread_info[thread_index].input_prefetch[nStream] = InputPrefetchStart(thread_info[thread_index].pcap_in[nStream], (Mode & ENABLE_DEBUG_STATS) ? DS_READ_PCAP_REPORT_TSO_LENGTH_FIX : 0, thread_info[thread_index].link_layer_info[nStream], thread_info[thread_index].pcap_file_hdr[nStream], (Mode & USE_PACKET_ARRIVAL_TIMES) != 0, nStream, thread_index))) {
+
+            Log_RT(3, "mediaMin WARNING: input prefetch failed to start for input %s, using synchronous reads, input stream = %d, thread_index = %d \n", MediaParams[thread_info[thread_index].cmd_line_input_index[nStream]].Media.inputFilename, nStream, thread_index);
+         }
+      }
+   }
+
    if (isAFAPMode() && (Mode & ENABLE_STREAM_GROUPS)) RealTimeInterval[0] = 0.15;  /* stream group processing will exceed buffer limits and emit error messages in AFAP mode so we switch to FTRT mode with a small interval limit that's likely to get through without errors. Running streawm groups in AFAP mode is not recommended and there is no testing done for media quality, JHB Jun 2025 */ 
 
    if (isFTRTMode()) timeScale = NOMINAL_REALTIME_INTERVAL/RealTimeInterval[0];  /* if "faster than real-time" mode set timeScale to accelerate time. RealTimeInterval[] is initialized in cmdLineInterface() in cmd_line_interface.c, Jun 2023 */
@@ -4583,6 +5053,179 @@ valid_input_spec:
    if (thread_info[thread_index].uErrorCondition) app_printf(APP_PRINTF_NEW_LINE | APP_PRINTF_PRINT_ONLY, cur_time, thread_index, " *************** inside input setup, init err true, thread_index = %d", thread_index);
 }
 
+/* MergeInputs() merges all inputs into one time-ordered pcap and replaces them with it as a single input, if MERGE_INPUTS is set in -dN cmd line options. Notes JHB Oct 2026:
+
+   -PushPackets() aligns each input to its own first packet arrival timestamp (see pkt_base_timestamp[]), so inputs are merged by timestamp relative to each input's first packet, not absolute timestamp. Merged packet timestamps are relative timestamps added to the earliest first packet timestamp of all inputs
+   -merge order is maintained with an ARRIVAL_HEAP keyed by relative timestamp (see arrival heap notes). For equal timestamps, lower input index goes first
+   -the merged file is written in pcap format with Ethernet link layer, next to the first input with "_merged" appended to its name (and thread index if multiple app threads are active). pcapng non-packet blocks are not written
+   -the merged input is processed as one input stream, so per-input stats and console output refer to the first input
+   -only pcap, pcapng, and .rtpXXX inputs can be merged; if other input types are present, or on any error, inputs are left as-is
+   -InputSetup() is called for each input repeat (-RN cmd line entry), so the merged file is rewritten on each repeat
+   -if the merged file already exists when MergeInputs() is first called it's not overwritten and inputs are processed individually, unless MERGE_INPUTS_OVERWRITE is also set in -dN cmd line options
+*/
+
+static inline uint64_t pkt_timestamp_usec(const pcaprec_hdr_t* p_pcap_rec_hdr) {  /* pcap record timestamp in usec */
+
+   return (uint64_t)p_pcap_rec_hdr->ts_sec*1000000L + p_pcap_rec_hdr->ts_usec;
+}
+
+static int merge_read(int nStream, uint8_t* pkt_buf, pcaprec_hdr_t* p_pcap_rec_hdr, uint16_t* p_eth_protocol, unsigned int* p_packet_number, int thread_index) {
+
+int pkt_len;
+uint16_t block_type;
+
+   do {  /* skip IDB, NRB, statistics, and other non-packet blocks */
+
+      block_type = 0;
+      pkt_len = DSReadPcap(thread_info[thread_index].pcap_in[nStream], 0, pkt_buf, p_pcap_rec_hdr, thread_info[thread_index].link_layer_info[nStream], p_eth_protocol, &block_type, thread_info[thread_index].pcap_file_hdr[nStream], *p_packet_number+1, NULL);
+
+   } while (pkt_len > 0 && block_type != PCAP_PB_TYPE && block_type != RTP_PB_TYPE && block_type != PCAPNG_EPB_TYPE && block_type != PCAPNG_SPB_TYPE);
+
+   if (pkt_len > 0) (*p_packet_number)++;
+
+   return pkt_len;
+}
+
+static int MergeInputs(unsigned int uFlags, int thread_index) {  /* uFlags are DSOpenPcap() flags used by InputSetup() */
+
+int nInputs = thread_info[thread_index].nInPcapFiles, nStream, ret_val = 0;
+uint8_t* pkt_buf[MAX_STREAMS_THREAD] = { NULL };
+int pkt_len[MAX_STREAMS_THREAD];
+pcaprec_hdr_t pcap_rec_hdr[MAX_STREAMS_THREAD], pcap_rec_hdr_out;
+uint16_t eth_protocol[MAX_STREAMS_THREAD];
+unsigned int packet_number[MAX_STREAMS_THREAD] = { 0 }, num_pkts = 0;
+uint64_t base_timestamp[MAX_STREAMS_THREAD], min_base_timestamp = (uint64_t)-1, timestamp;
+ARRIVAL_HEAP heap;
+struct ethhdr eth_hdr;
+FILE* fp_out = NULL;
+char szMergedInput[1024], *p;
+static bool fMergedInputWritten[MAX_APP_THREADS] = { false };  /* set after a thread writes its merged file, so input repeats can rewrite it */
+
+   for (nStream=0; nStream<nInputs; nStream++) if (!thread_info[thread_index].pcap_in[nStream] || !isInputPcap(getIOType(thread_info[thread_index].link_layer_info[nStream]))) {
+
+      Log_RT(3, "mediaMin WARNING: MergeInputs() says input %s is not a pcap, pcapng, or .rtpXXX file, inputs will not be merged \n", MediaParams[thread_info[thread_index].cmd_line_input_index[nStream]].Media.inputFilename);
+      return -1;
+   }
+
+/* open merged output file */
+
+   strcpy(szMergedInput, MediaParams[thread_info[thread_index].cmd_line_input_index[0]].Media.inputFilename);
+   if ((p = strrchr(szMergedInput, '.')) && !strchr(p, '/')) *p = 0;  /* remove file extension */
+
+   if (num_app_threads > 1) sprintf(&szMergedInput[strlen(szMergedInput)], "_merged%d.pcap", thread_index);
+   else strcat(szMergedInput, "_merged.pcap");
+
+   if (!fMergedInputWritten[thread_index] && !(Mode & MERGE_INPUTS_OVERWRITE) && access(szMergedInput, F_OK) == 0) {  /* don't overwrite a file not written by this run unless user opts in */
+
+      Log_RT(3, "mediaMin WARNING: MergeInputs() says merged output file %s already exists, inputs will not be merged. Remove the file or add MERGE_INPUTS_OVERWRITE (0x%llx) to -dN cmd line options to overwrite \n", szMergedInput, (unsigned long long)MERGE_INPUTS_OVERWRITE);
+      return -1;
+   }
+
+   if (DSOpenPcap(szMergedInput, DS_WRITE | (uFlags & DS_OPEN_PCAP_QUIET), &fp_out, NULL, "") < 0) {
+
+      Log_RT(3, "mediaMin WARNING: MergeInputs() failed to open merged output file %s, inputs will not be merged \n", szMergedInput);
+      return -1;
+   }
+
+   fMergedInputWritten[thread_index] = true;
+
+/* read first packet of each input */
+
+   memset(&heap, 0, sizeof(heap));
+
+   for (nStream=0; nStream<nInputs; nStream++) {
+
+      if (!(pkt_buf[nStream] = (uint8_t*)malloc(MAX_TCP_PACKET_LEN))) { ret_val = -1; goto cleanup; }
+
+      if ((pkt_len[nStream] = merge_read(nStream, pkt_buf[nStream], &pcap_rec_hdr[nStream], &eth_protocol[nStream], &packet_number[nStream], thread_index)) < 0) { ret_val = -1; goto cleanup; }
+
+      if (pkt_len[nStream] > 0) {
+
+         base_timestamp[nStream] = pkt_timestamp_usec(&pcap_rec_hdr[nStream]);
+         min_base_timestamp = min(base_timestamp[nStream], min_base_timestamp);
+
+         ArrivalHeapInsert(&heap, nStream, 0);
+      }
+   }
+
+/* write packets in relative timestamp order */
+
+   while ((nStream = ArrivalHeapPop(&heap, (uint64_t)-1)) >= 0) {
+
+      timestamp = pkt_timestamp_usec(&pcap_rec_hdr[nStream]);
+      timestamp = min_base_timestamp + (timestamp > base_timestamp[nStream] ? timestamp - base_timestamp[nStream] : 0);  /* out-of-order timestamps earlier than an input's first packet are clamped */
+
+      memset(&pcap_rec_hdr_out, 0, sizeof(pcap_rec_hdr_out));  /* DSWritePcap() fills in record lengths */
+      pcap_rec_hdr_out.ts_sec = timestamp/1000000L;
+      pcap_rec_hdr_out.ts_usec = timestamp % 1000000L;
+
+      memset(&eth_hdr, 0, sizeof(eth_hdr));  /* Localhost MAC addresses, same as DSWritePcap() default */
+      if (eth_protocol[nStream] && eth_protocol[nStream] != ETH_P_8021Q) eth_hdr.h_proto = htons(eth_protocol[nStream]);
+      else eth_hdr.h_proto = htons((pkt_buf[nStream][0] >> 4) == 6 ? ETH_P_IPV6 : ETH_P_IP);
+
+      if (DSWritePcap(fp_out, 0, pkt_buf[nStream], pkt_len[nStream], &pcap_rec_hdr_out, &eth_hdr, NULL) < 0) { ret_val = -1; goto cleanup; }
+
+      num_pkts++;
+
+      if ((pkt_len[nStream] = merge_read(nStream, pkt_buf[nStream], &pcap_rec_hdr[nStream], &eth_protocol[nStream], &packet_number[nStream], thread_index)) < 0) { ret_val = -1; goto cleanup; }
+
+      if (pkt_len[nStream] > 0) {
+
+         timestamp = pkt_timestamp_usec(&pcap_rec_hdr[nStream]);
+         ArrivalHeapInsert(&heap, nStream, timestamp > base_timestamp[nStream] ? timestamp - base_timestamp[nStream] : 0);
+      }
+   }
+
+cleanup:
+
+   for (nStream=0; nStream<nInputs; nStream++) if (pkt_buf[nStream]) free(pkt_buf[nStream]);
+
+   DSClosePcap(fp_out, DS_CLOSE_PCAP_QUIET);
+
+   if (ret_val < 0) {  /* leave inputs as-is; rewind them to start of first pcap record */
+
+      Log_RT(3, "mediaMin WARNING: MergeInputs() failed to merge inputs into %s after %u packets, inputs will be processed individually \n", szMergedInput, num_pkts);
+
+      for (nStream=0; nStream<nInputs; nStream++) DSOpenPcap(NULL, DS_READ | DS_OPEN_PCAP_RESET, &thread_info[thread_index].pcap_in[nStream], NULL, "");
+      return ret_val;
+   }
+
+/* close inputs and open merged file as input stream 0. Stream state for input 0 has already been initialized by InputSetup() */
+
+   for (nStream=0; nStream<nInputs; nStream++) {
+
+      DSClosePcap(thread_info[thread_index].pcap_in[nStream], DS_CLOSE_PCAP_QUIET);
+      thread_info[thread_index].pcap_in[nStream] = NULL;
+
+      if (nStream > 0) {
+
+         if (thread_info[thread_index].pcap_file_hdr[nStream]) free(thread_info[thread_index].pcap_file_hdr[nStream]);
+         thread_info[thread_index].pcap_file_hdr[nStream] = NULL;
+
+         if (thread_info[thread_index].input_data_cache[nStream].pkt_buf) free(thread_info[thread_index].input_data_cache[nStream].pkt_buf);
+         thread_info[thread_index].input_data_cache[nStream].pkt_buf = NULL;
+      }
+   }
+
+   thread_info[thread_index].nInPcapFiles = 1;
+
+   memset(thread_info[thread_index].pcap_file_hdr[0], 0, sizeof_field(pcap_hdr_t, rtp));
+
+   if ((ret_val = DSOpenPcap(szMergedInput, uFlags, &thread_info[thread_index].pcap_in[0], thread_info[thread_index].pcap_file_hdr[0], "")) < 0) {
+
+      fprintf(stderr, "Failed to open merged input file %s, thread_index = %d, DSOpenPcap ret val = %d \n", szMergedInput, thread_index, ret_val);
+      thread_info[thread_index].pcap_in[0] = NULL;
+      thread_info[thread_index].uErrorCondition = 1;
+      return ret_val;
+   }
+
+   thread_info[thread_index].link_layer_info[0] = ret_val;
+
+   Log_RT(4, "mediaMin INFO: merged %d inputs (%u packets) into time-ordered input %s \n", nInputs, num_pkts, szMergedInput);
+
+   return nInputs;
+}
+
 /* set up transcoded or bitstream outputs from -oFilename.ext output specs entered on command line (if any) */
 
 int OutputSetup(HSESSION hSessions[], HSESSION hSession, int thread_index) {
@@ -5055,6 +5698,8 @@ void GlobalConfig(GLOBAL_CONFIG* gbl_cfg) {
 */
 
    if (Mode & ENABLE_STREAM_GROUP_ASR) gbl_cfg->uThreadPreemptionElapsedTimeAlarm = (uint32_t)-1;
+
+   if (Mode & ENABLE_THREAD_LOAD_BALANCING) gbl_cfg->uThreadLoadBalanceInterval = 2000;  /* check p/m thread loads every 2 sec, JHB Oct 2026 */
 }
 
 
@@ -66,6 +66,13 @@
    Modified Sep 2025 JHB, define MAX_STREAM_STATS separately to better handle capacity tests using cmd line repeat
    Modified Sep 2025 JHB, replace thread_info[].init_err with .uErrorCondition to improve differentiation of initialization and run-time errors
    Modified Sep 2025 JHB, move MAX_APP_STR_LEN define to diaglib.h (now used by Log_RT() as an upper limit on event log strings)
+   Modified Oct 2026 JHB, add pkt_data to INPUT_DATA_CACHE struct, a pointer into memory-mapped input used instead of pkt_buf when ENABLE_MMAP_INPUT is set
+   Modified Oct 2026 JHB, add next_arrival_time and push-pull loop scheduler stats to APP_THREAD_INFO struct
+   Modified Oct 2026 JHB, define PUSH_BATCH and PUSH_BATCH_ITEM structs, add push_batch to APP_THREAD_INFO struct
+   Modified Oct 2026 JHB, add input_prefetch[] to APP_THREAD_INFO struct and define INPUT_DATA_NOT_READY, see input_prefetch.cpp
+   Modified Oct 2026 JHB, define ARRIVAL_HEAP and ARRIVAL_HEAP_ITEM structs, replace next_arrival_time with arrival_heap in APP_THREAD_INFO struct
+   Modified Oct 2026 JHB, add udp_port_class and sdp_media_ports[] to APP_THREAD_INFO struct, see port classification notes in port_io.cpp
+   Modified Oct 2026 JHB, add pkt_ptr to PUSH_BATCH_ITEM struct, define PUSH_MAX_READS_PER_INPUT
 */
 
 #ifndef _MEDIAMIN_H_
@@ -181,6 +188,7 @@ typedef struct {  /* input data cache items, JHB Oct 2024 */
   pcaprec_hdr_t  pcap_rec_hdr;
   int            pkt_len;        /* packet length */
   uint8_t*       pkt_buf;        /* pointer to allocated packet data buffer */
+  uint8_t*       pkt_data;       /* for memory-mapped input, pointer to packet data in the file mapping (returned by DSReadPcapView()). NULL otherwise, JHB Oct 2026 */
   uint8_t        uFlags;
 
 } INPUT_DATA_CACHE;
@@ -196,6 +204,59 @@ typedef struct {  /* input data cache items, JHB Oct 2024 */
 
 #define CACHE_ITEM_MASK                    0x0f  /* mask to isolate flags that instruct GetInputData() */
 
+#define INPUT_DATA_NOT_READY                 -2  /* GetInputData() return value when input prefetch is enabled and the input's reader thread has not yet read the next packet, JHB Oct 2026 */
+
+/* push batch items. PushPackets() collects packets in a per-thread batch and FlushPushBatch() pushes them with one DSPushPackets() call per session. Packets not accepted due to a full push queue are parked in the batch and retried on the next PushPackets() call, JHB Oct 2026 */
+
+#define PUSH_BATCH_MAX_PKTS                 256  /* max number of packets in a push batch */
+#define PUSH_BATCH_MEM_SIZE           (256*1024)  /* push batch packet data mem size. Allocated on first use, with an equal amount of scratch mem for per-session gather */
+#define PUSH_MAX_READS_PER_INPUT             32  /* in AFAP and FTRT modes, max number of packets PushPackets() reads from an input per call */
+
+typedef struct {  /* per packet info saved in push batch, used for post-push stats */
+
+  uint32_t       offset;         /* offset of packet data in push batch mem */
+  const uint8_t* pkt_ptr;        /* if not NULL, packet data is still in PushPackets() pkt_buf and hasn't been copied to push batch mem (offset is reserved). Only the first packet in an empty batch is deferred this way */
+  int            pkt_len;
+  HSESSION       hSession;
+  int16_t        nSessionIndex;  /* index into hSessions[] */
+  int16_t        nStream;        /* input stream */
+  int            chnum;
+  uint32_t       rtp_ssrc;
+  int            rtp_pyld_len;
+  uint32_t       rtp_timestamp;
+  float          msec_timestamp_fp;
+
+} PUSH_BATCH_ITEM;
+
+typedef struct {
+
+  uint8_t*         mem;
+  uint32_t         mem_used;
+  int              num_pkts;
+  int              num_pushed;                             /* number of packets pushed during current PushPackets() call */
+  PUSH_BATCH_ITEM  item[PUSH_BATCH_MAX_PKTS];
+  uint16_t         num_parked[MAX_STREAMS_THREAD];         /* per input stream number of parked packets. PushPackets() does not read from an input stream with parked packets */
+  uint64_t         queue_full_time[MAX_SESSIONS_THREAD];   /* per session time of first queue full status, zero if none (in usec) */
+
+} PUSH_BATCH;
+
+/* ARRIVAL_HEAP is a min-heap of input streams keyed by wall clock time, used by PushPackets() to skip inputs waiting for packet arrival timestamps to expire, and by MergeInputs() to merge inputs in timestamp order. See arrival heap notes in mediaMin.cpp, JHB Oct 2026 */
+
+typedef struct {
+
+  uint64_t         time;   /* heap key, in usec */
+  int              nStream;
+
+} ARRIVAL_HEAP_ITEM;
+
+typedef struct {
+
+  int                num;                          /* number of items in the heap */
+  ARRIVAL_HEAP_ITEM  item[MAX_STREAMS_THREAD];     /* item[0] has the earliest time */
+  uint8_t            index[MAX_STREAMS_THREAD];    /* per input stream heap position + 1, zero if the stream is not in the heap */
+
+} ARRIVAL_HEAP;
+
 
 /* APP_THREAD_INFO defines per-thread application vars and structs. If mediaMin is run from the cmd line then there is just one application thread, if mediaMin is run from mediaTest with -Et command line entry, then -tN entry determines how many application threads */
 
@@ -216,6 +277,7 @@ typedef struct {
   uint8_t               uInputType[MAX_STREAMS_THREAD];
 
   INPUT_DATA_CACHE      input_data_cache[MAX_STREAMS_THREAD];  /* per-stream input data read cache, JHB Oct 2024 */
+  void*                 input_prefetch[MAX_STREAMS_THREAD];  /* per-stream input prefetch handles returned by InputPrefetchStart(), NULL if input prefetch is not enabled, JHB Oct 2026 */
 
   FILE*                 out_file[MAX_STREAMS_THREAD];
   int8_t                nOutputType[MAX_STREAMS_THREAD];
@@ -295,6 +357,8 @@ typedef struct {
   vector<sdp::Origin*>     origins[MAX_STREAMS_THREAD];
   uint16_t                 num_media_descriptions[MAX_STREAMS_THREAD];  /* add media descriptions, JHB Jun 2024 */
   vector<sdp::Media*>      media_descriptions[MAX_STREAMS_THREAD];
+  uint64_t*                sdp_media_ports[MAX_STREAMS_THREAD];  /* per-stream bitmap of SDP media description ports, updated by AddSDPMediaPort() in port_io.cpp, JHB Oct 2026 */
+  uint8_t*                 udp_port_class;                       /* UDP port classification table, 64K entries, JHB Oct 2026 */
   uint16_t                 num_fmtps[MAX_STREAMS_THREAD];
   vector<sdp::Attribute*>  fmtps[MAX_STREAMS_THREAD];
 
@@ -329,6 +393,10 @@ typedef struct {
   uint16_t              dst_port[MAX_STREAMS_THREAD];                /* ports are saved when MF flag is set and fragment offset is not */
   uint16_t              src_port[MAX_STREAMS_THREAD];
   
+/* push batch, see FlushPushBatch() in mediaMin.cpp, JHB Oct 2026 */
+
+  PUSH_BATCH            push_batch;
+
 /* AFAP and FTRT mode support */
 
   struct timespec       accel_time_ts[MAX_STREAM_GROUPS];  /* stream group accerated timestamps, added to support FTRT and AFAP modes, JHB May 2023 */
@@ -338,6 +406,16 @@ typedef struct {
   uint64_t              uOneTimeConsoleQuitMessage;
   uint64_t              most_recent_console_output;  /* most recent console output, in usec. See cur_time in mediaMin.cpp */ 
 
+/* push-pull loop scheduler items, see SchedulerWait() in mediaMin.cpp, JHB Oct 2026 */
+
+  ARRIVAL_HEAP          arrival_heap;            /* input streams waiting for a packet arrival timestamp to expire, ordered by expiration wall clock time (in usec). Maintained by PushPackets() */
+  uint64_t              sched_start_time;        /* push-pull loop start time and thread CPU time at loop start, in usec */
+  uint64_t              sched_start_cpu_time;
+  uint64_t              sched_num_intervals;     /* number of elapsed push-pull intervals, total and max interval lateness (in usec), and number of timer sleeps */
+  uint64_t              sched_late_total;
+  uint64_t              sched_late_max;
+  uint64_t              sched_num_sleeps;
+
 /* per-thread arrival timing stats */
 
   float                 arrival_avg_delta[MAX_SESSIONS_THREAD];
@@ -33,6 +33,7 @@
 
    Created Jun 2025 JHB, split off from mediaMin.cpp
    Modified Sep 2025 JHB, in isPortAllowed() recognize UDP/DHCP
+   Modified Oct 2026 JHB, replace linear searches of uPortList[], UDP_Port_Media_Allow_List[], and SDP media descriptions in isPortAllowed() with a per-thread UDP port classification table and per-stream SDP media port bitmaps. See port classification notes
 */
 
 #include <algorithm>
@@ -44,6 +45,7 @@ using namespace std;
 #include "mediaTest.h"  /* uPortList[], CMDOPT_MAX_INPUT_LEN, MAX_APP_THREADS, etc */
 #include "mediaMin.h"
 #include "user_io.h"    /* app_printf() */
+#include "port_io.h"
 
 /*  as noted in Revision History, code was split from mediaMin.cpp; the following extern references are necessary to retain tight coupling with related source in mediaMin.cpp. There are no multithread or concurrency issues in these references */
 
@@ -52,6 +54,70 @@ extern bool fFirstConsoleMediaOutput;
 
 static uint16_t UDP_Port_Media_Allow_List[] = { 1234, 3078, 3079 };  /* add exceptions here for UDP ports that should be allowed for RTP media (and are not expressed by in-stream SDP info). Currently the list has some arbitrary ports found in a few legacy test pcaps used in mediaMin regression test. Port exceptions can also be added at run-time using -p cmd line entry. See usage in isPortAllowed() */
 
+/* port classification notes, JHB Oct 2026:
+
+   -isPortAllowed() is called per packet for ports that don't match an existing stream. Previously it searched uPortList[] (-pN cmd line entries), UDP_Port_Media_Allow_List[], and the stream's SDP media descriptions, the latter growing as a call recording accumulates SDP info
+   -each app thread now has a 64K entry UDP port classification table (thread_info[].udp_port_class), built on first use from uPortList[] and UDP_Port_Media_Allow_List[]
+   -SDP discovered media ports are kept in per-stream 64K bit bitmaps (thread_info[].sdp_media_ports[]), allocated and updated by AddSDPMediaPort() when SDPParseInfo() adds a media description
+   -port lookups are constant time regardless of the number of -pN entries or media descriptions. Known protocol ports are still handled with a switch statement
+   -if table or bitmap allocation fails isPortAllowed() falls back to searching
+*/
+
+#define PORT_CLASS_MEDIA_ALLOW  1  /* udp_port_class[] entry flag, port is in uPortList[] or UDP_Port_Media_Allow_List[] */
+
+static uint8_t* PortClassSetup(int thread_index) {
+
+uint8_t* port_class;
+int i;
+
+   if (!(port_class = (uint8_t*)calloc(65536, sizeof(uint8_t)))) return NULL;
+
+   for (i=0; i<MAX_STREAMS && uPortList[i]; i++) port_class[uPortList[i]] |= PORT_CLASS_MEDIA_ALLOW;  /* uPortList[] is defined in cmd_line_interface.c */
+   for (i=0; i<(int)(sizeof(UDP_Port_Media_Allow_List)/sizeof(UDP_Port_Media_Allow_List[0])); i++) port_class[UDP_Port_Media_Allow_List[i]] |= PORT_CLASS_MEDIA_ALLOW;
+
+   thread_info[thread_index].udp_port_class = port_class;
+
+   return port_class;
+}
+
+void AddSDPMediaPort(uint16_t port, int nStream, int thread_index) {
+
+uint64_t* sdp_media_ports;
+
+   if (nStream < 0 || nStream >= MAX_STREAMS_THREAD) return;
+
+   if (!(sdp_media_ports = thread_info[thread_index].sdp_media_ports[nStream])) {
+
+      if (!(sdp_media_ports = (uint64_t*)calloc(65536/64, sizeof(uint64_t)))) {
+
+         Log_RT(3, "mediaMin WARNING: AddSDPMediaPort() failed to allocate SDP media port bitmap, nStream = %d, thread_index = %d \n", nStream, thread_index);
+         return;  /* isPortAllowed() searches media descriptions */
+      }
+
+      for (int i=0; i<thread_info[thread_index].num_media_descriptions[nStream]; i++) {  /* include any media descriptions added before the bitmap existed */
+
+         uint16_t media_port = ((sdp::Media*)(thread_info[thread_index].media_descriptions[nStream][i]))->port;
+         sdp_media_ports[media_port >> 6] |= 1ULL << (media_port & 63);
+      }
+
+      thread_info[thread_index].sdp_media_ports[nStream] = sdp_media_ports;
+   }
+
+   sdp_media_ports[port >> 6] |= 1ULL << (port & 63);
+}
+
+void PortClassCleanup(int thread_index) {
+
+   if (thread_info[thread_index].udp_port_class) free(thread_info[thread_index].udp_port_class);
+   thread_info[thread_index].udp_port_class = NULL;
+
+   for (int i=0; i<MAX_STREAMS_THREAD; i++) {
+
+      if (thread_info[thread_index].sdp_media_ports[i]) free(thread_info[thread_index].sdp_media_ports[i]);
+      thread_info[thread_index].sdp_media_ports[i] = NULL;
+   }
+}
+
 /* local functions */
 
 bool sdp_info_check(uint8_t* pkt_buf, int pkt_len) {
@@ -92,17 +158,23 @@ static unsigned int uCursorPos[MAX_APP_THREADS][MAX_STREAMS_THREAD] = {{ 0 }};
 
    if (uProtocol == UDP) {
 
-   /* check cmd line -pN entries, if any, JHB May 2023 */
+      uint8_t* port_class = thread_info[thread_index].udp_port_class;
+      uint64_t* sdp_media_ports = thread_info[thread_index].sdp_media_ports[nStream];
 
-      while (uPortList[i] && i < MAX_STREAMS) if (port == uPortList[i++]) return PORT_ALLOW_ON_MEDIA_ALLOW_LIST;  /* uPortList[] is defined in cmd_line_interface.c, PORT_ALLOW_xxx flags are defined in mediaMin.h */
+      if (!port_class) port_class = PortClassSetup(thread_index);  /* build classification table on first use, JHB Oct 2026 */
 
-   /* check source code defined list of allowed ports */
+   /* check cmd line -pN entries, if any (JHB May 2023), and source code defined list of allowed ports. Both are in the port classification table, JHB Oct 2026 */
 
-      for (i=0; i<(int)sizeof(UDP_Port_Media_Allow_List)/(int)sizeof(UDP_Port_Media_Allow_List[0]); i++) if (port == UDP_Port_Media_Allow_List[i]) return PORT_ALLOW_ON_MEDIA_ALLOW_LIST;
+      if (port_class) { if (port_class[port] & PORT_CLASS_MEDIA_ALLOW) return PORT_ALLOW_ON_MEDIA_ALLOW_LIST; }  /* PORT_ALLOW_xxx flags are defined in mediaMin.h */
+      else {
+         while (uPortList[i] && i < MAX_STREAMS) if (port == uPortList[i++]) return PORT_ALLOW_ON_MEDIA_ALLOW_LIST;  /* uPortList[] is defined in cmd_line_interface.c */
+         for (i=0; i<(int)sizeof(UDP_Port_Media_Allow_List)/(int)sizeof(UDP_Port_Media_Allow_List[0]); i++) if (port == UDP_Port_Media_Allow_List[i]) return PORT_ALLOW_ON_MEDIA_ALLOW_LIST;
+      }
 
-   /* check SDP info database for discovered media ports, JHB Jun 2024 */
+   /* check SDP info database for discovered media ports, JHB Jun 2024. Ports are in a per-stream bitmap updated by AddSDPMediaPort(), JHB Oct 2026 */
 
-      for (i=0; i<thread_info[thread_index].num_media_descriptions[nStream]; i++) if (port == ((sdp::Media*)(thread_info[thread_index].media_descriptions[nStream][i]))->port) return PORT_ALLOW_SDP_MEDIA_DISCOVERED;  /* media_descriptions[] are parsed and processed in SDPParseInfo() in sdp_app.cpp */
+      if (sdp_media_ports) { if (sdp_media_ports[port >> 6] & (1ULL << (port & 63))) return PORT_ALLOW_SDP_MEDIA_DISCOVERED; }
+      else for (i=0; i<thread_info[thread_index].num_media_descriptions[nStream]; i++) if (port == ((sdp::Media*)(thread_info[thread_index].media_descriptions[nStream][i]))->port) return PORT_ALLOW_SDP_MEDIA_DISCOVERED;  /* media_descriptions[] are parsed and processed in SDPParseInfo() in sdp_app.cpp */
 
    /* misc protocols we can report in console output. Unrecognized UDP ports are displayed as "ignoring UDP port ..." by PushPackets() */
 
@@ -0,0 +1,32 @@
+/*
+ $Header: /root/Signalogic/apps/mediaTest/mediaMin/port_io.h
+
+ Copyright (C) Signalogic Inc. 2026
+
+ License
+
+  Use and distribution of this source code is subject to terms and conditions of the Github SigSRF License v1.1, published at https://github.com/signalogic/SigSRF_SDK/blob/master/LICENSE.md. Absolutely prohibited for AI language or programming model training use
+
+ Description
+
+  Header file for port related source for mediaMin reference application
+
+ Documentation
+
+  https://www.github.com/signalogic/SigSRF_SDK/tree/master/mediaTest_readme.md#user-content-mediamin
+
+ Revision History
+
+   Created Oct 2026 JHB, move isPortAllowed() prototype from mediaMin.cpp, add AddSDPMediaPort() and PortClassCleanup()
+*/
+
+#ifndef _PORT_IO_H_
+#define _PORT_IO_H_
+
+/* functions in port_io.cpp */
+
+int isPortAllowed(uint16_t port, uint8_t port_type, uint8_t* pkt_buf, int pkt_len, uint8_t uProtocol, int nStream, uint64_t cur_time, int thread_index);  /* PORT_ALLOW_xxx return values are defined in mediaMin.h */
+void AddSDPMediaPort(uint16_t port, int nStream, int thread_index);  /* called by SDPParseInfo() in sdp_app.cpp when a media description is added to a stream's SDP info database */
+void PortClassCleanup(int thread_index);  /* free port classification table and SDP media port bitmaps, called on app thread exit */
+
+#endif  /* _PORT_IO_H_ */
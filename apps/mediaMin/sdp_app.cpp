@@ -60,6 +60,7 @@
    Modified Apr 2025 JHB, improve SIP message detection and display, add SESSION_CONTROL_FOUND_SIP_TCP_OTHER and SESSION_CONTROL_FOUND_SIP_UDP_OTHER flags, add port exclude and text exclude to avoid MySQL messages with similar keywords as SIP or messages with conflicting keywords
    Modified Apr 2025 JHB, fix bug in find_keyword() case-insensitive search, return value is offset relative to buffer input param, not tmpstr
    Modified Aug 2025 JHB, add uPktNumber param to DSGetPacketInfo() calls per mod in pktlib.h
+   Modified Oct 2026 JHB, in SDPParseInfo() call AddSDPMediaPort() when a media description is added
 */
 
 #include <algorithm>  /* bring in std::min and std::max */
@@ -77,6 +78,7 @@ using namespace std;
 #include "mediaTest.h"   /* bring in some constants needed by mediaMin.h */
 #include "mediaMin.h"    /* bring in THREAD_INFO typedef for thread_info[].xx[] access, indexed by thread and input stream */
 #include "sdp_app.h"
+#include "port_io.h"     /* AddSDPMediaPort() */
 
 #ifdef FRAGMENT_DEBUG
 #include "user_io.h"     /* PrintPacketBuffer() */
@@ -251,6 +253,8 @@ int SDPParseInfo(std::string sdpstr, unsigned int uFlags, int nStream, int threa
 
                thread_info[thread_index].num_media_descriptions[nStream]++;  /* increment number of media descriptions, JHB Jan 2023 */
 
+               AddSDPMediaPort(media->port, nStream, thread_index);  /* update stream's SDP media port bitmap used by isPortAllowed(), JHB Oct 2026 */
+
                nMediaObjectsAdded++;
                fMediaAlreadyExist = false;
             }
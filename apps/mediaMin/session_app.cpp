@@ -54,12 +54,15 @@
    Modified Jul 2025 JHB, move FindStream() here from mediaMin.cpp
    Modified Sep 2025 JHB, replace thread_info[].init_err with .uErrorCondition, per changes in mediaMin.h
    Modified Sep 2025 JHB, change szStreamGroupOutputWavPath to szOutputMediaPath
+   Modified Oct 2026 JHB, in FindStream() replace linear key and SSRC searches with open-addressed hash index tables, allocate key storage as needed and increase MAX_KEYS to 65536. See stream key lookup notes above FindStream()
 */
 
 #include <algorithm>
 using namespace std;
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* SigSRF includes */
 
@@ -98,22 +101,119 @@ void StreamGroupOutputSetup(HSESSION hSession, int nStream, int thread_index);
   -return value is zero for an existing stream, total streams found so far for a new stream, or -1 for an error condition
 */
 
-#define MAX_KEYS 512  /* increased from 128, JHB Jun 2024 */
+#define MAX_KEYS 65536  /* increased from 128, JHB Jun 2024. Increased from 512, key storage is now allocated as needed, JHB Oct 2026 */
 
 /* keys are unique per stream (they are not hashes). No run-time locks are needed */ 
 
 #define KEY_LENGTH 37  /* each key is up to 37 bytes (ipv6 address size (2*16) + udp port size (2*2)) + RTP payload type (1) */
 
-static uint8_t keys[MAX_APP_THREADS][MAX_KEYS][KEY_LENGTH] = {{{ 0 }}};
-static uint32_t ssrcs[MAX_APP_THREADS][MAX_KEYS] = {{ 0 }};
-static int nKeys[MAX_APP_THREADS] = { 0 };
+/* stream key lookup notes, JHB Oct 2026:
+
+  -previously FindStream() compared each packet's key with every stored key, and with ENABLE_SSRC_STREAM_JOINING also scanned all stored SSRCs. With hundreds of streams per app thread that was a per-packet linear search
+  -keys are now stored in creation order in a per-thread array (allocated and grown as needed, up to MAX_KEYS), with two open-addressed (linear probe) index tables: one hashed on the IP addr:port part of the key, and one hashed on SSRC. Index tables are kept at <= 50% load
+  -payload type is not included in the key hash, so DTMF packets (keys without payload type) and regular packets for the same stream land in the same probe sequence; the key comparison itself is unchanged (memcmp of key length)
+  -RemoveLastStreamKey() removes the last key from both index tables using backward shift deletion (no tombstones). ResetStreamKeys() clears the index tables but keeps allocated memory
+*/
+
+typedef struct {
+
+   uint8_t   key[KEY_LENGTH];
+   uint32_t  ssrc;
+   uint32_t  key_hash;  /* hash of IP addr:port part of key */
+
+} STREAM_KEY;
+
+typedef struct {
+
+   STREAM_KEY*  keys;        /* keys in creation order */
+   int          nKeys;
+   int          nAlloc;      /* allocated number of keys, always a power of 2 */
+   int32_t*     key_table;   /* open-addressed index tables; entries are indexes into keys[], -1 is empty */
+   int32_t*     ssrc_table;
+   uint32_t     table_mask;  /* table size - 1 */
+
+} STREAM_KEYS;
+
+static STREAM_KEYS stream_keys[MAX_APP_THREADS] = {{ 0 }};
+
+static inline uint32_t key_hash(uint8_t* key, int len) {  /* FNV-1a */
+
+uint32_t h = 2166136261U;
+
+   for (int i=0; i<len; i++) h = (h ^ key[i]) * 16777619U;
+
+   return h;
+}
+
+static inline uint32_t ssrc_hash(uint32_t ssrc) { return ssrc * 2654435761U; }  /* Knuth multiplicative hash */
+
+static void insert_index(int32_t* table, uint32_t mask, uint32_t hash, int nIndex) {
+
+uint32_t i = hash & mask;
+
+   while (table[i] >= 0) i = (i + 1) & mask;
+
+   table[i] = nIndex;
+}
+
+static void remove_index(STREAM_KEYS* pKeys, int32_t* table, bool fSSRC, int nIndex) {  /* remove nIndex from a linear probe table, backward shift following entries that would otherwise become unreachable */
+
+uint32_t mask = pKeys->table_mask, i, j, h;
+
+   i = (fSSRC ? ssrc_hash(pKeys->keys[nIndex].ssrc) : pKeys->keys[nIndex].key_hash) & mask;
+
+   while (table[i] != nIndex) { if (table[i] < 0) return; i = (i + 1) & mask; }
+
+   for (j = (i + 1) & mask; table[j] >= 0; j = (j + 1) & mask) {
+
+      h = (fSSRC ? ssrc_hash(pKeys->keys[table[j]].ssrc) : pKeys->keys[table[j]].key_hash) & mask;
+
+      if ((i <= j) ? (h <= i || h > j) : (h <= i && h > j)) { table[i] = table[j]; i = j; }  /* entry at j can move to i without passing its home slot */
+   }
+
+   table[i] = -1;
+}
+
+static bool grow_stream_keys(STREAM_KEYS* pKeys) {  /* double key storage and rebuild index tables */
+
+int nAlloc = pKeys->nAlloc ? 2*pKeys->nAlloc : 64;
+uint32_t table_size = 2*nAlloc;
+
+   STREAM_KEY* keys = (STREAM_KEY*)realloc(pKeys->keys, nAlloc*sizeof(STREAM_KEY));
+   if (!keys) return false;
+   pKeys->keys = keys;
+
+   int32_t* key_table = (int32_t*)realloc(pKeys->key_table, table_size*sizeof(int32_t));
+   if (!key_table) return false;
+   pKeys->key_table = key_table;
+
+   int32_t* ssrc_table = (int32_t*)realloc(pKeys->ssrc_table, table_size*sizeof(int32_t));
+   if (!ssrc_table) return false;
+   pKeys->ssrc_table = ssrc_table;
+
+   pKeys->nAlloc = nAlloc;
+   pKeys->table_mask = table_size - 1;
+
+   memset(pKeys->key_table, 0xff, table_size*sizeof(int32_t));  /* all entries -1 */
+   memset(pKeys->ssrc_table, 0xff, table_size*sizeof(int32_t));
+
+   for (int i=0; i<pKeys->nKeys; i++) {
+
+      insert_index(pKeys->key_table, pKeys->table_mask, pKeys->keys[i].key_hash, i);
+      insert_index(pKeys->ssrc_table, pKeys->table_mask, ssrc_hash(pKeys->keys[i].ssrc), i);
+   }
+
+   return true;
+}
 
 int FindStream(uint8_t* pkt, int ip_hdr_len, uint8_t rtp_pyld_type, uint32_t ssrc, bool fDTMF, unsigned int* pStreamFlags, int thread_index) {
 
-int version, len;
+int version, len, nIndex = -1;
 uint8_t key[KEY_LENGTH] = { 0 };
 unsigned int uStreamFlags = 0;
 bool fPayloadTypeInKey = false, fExistingStream = false;
+STREAM_KEYS* pKeys = &stream_keys[thread_index];
+uint32_t hash, i;
 
    if (!pkt) { Log_RT(2, "mediaMin ERROR: FindStream() says pkt is NULL \n"); return -1; }
 
@@ -126,27 +226,29 @@ bool fPayloadTypeInKey = false, fExistingStream = false;
    memcpy(&key[len], &pkt[ip_hdr_len], 2*sizeof(unsigned short int));  /* copy src and dst UDP ports to key */
    len += 2*sizeof(unsigned short int);
 
+   hash = key_hash(key, len);  /* hash IP addr:port part of key, before payload type is added */
+
 /* copy RTP payload type to key (but not for DTMF packets, which must match an existing stream, JHB May 2019) */
 
    if (!fDTMF && !fExclude_payload_type_from_key) { fPayloadTypeInKey = true; key[len++] = rtp_pyld_type; }  /* also check if --exclude_payload_type_from key is on the command line, JHB Jul 2025 */
 
 /* see if we already know about this stream */
 
-   for (int i=0; i<nKeys[thread_index]; i++) if (!memcmp(&keys[thread_index][i], key, len)) { fExistingStream = true; break; }  /* matches existing stream */
+   if (pKeys->nKeys) for (i = hash & pKeys->table_mask; (nIndex = pKeys->key_table[i]) >= 0; i = (i + 1) & pKeys->table_mask) if (!memcmp(pKeys->keys[nIndex].key, key, len)) { fExistingStream = true; break; }  /* matches existing stream */
 
 /* possible new stream */
 
-   if (!fExistingStream && (Mode & ENABLE_SSRC_STREAM_JOINING)) for (int i=0; i<nKeys[thread_index]; i++) if (ssrc == ssrcs[thread_index][i]) {  /* if SSRC stream joining is enabled then look for existing stream with same SSRC, JHB Jul 2025 */
+   if (!fExistingStream && (Mode & ENABLE_SSRC_STREAM_JOINING) && pKeys->nKeys) for (i = ssrc_hash(ssrc) & pKeys->table_mask; (nIndex = pKeys->ssrc_table[i]) >= 0; i = (i + 1) & pKeys->table_mask) if (ssrc == pKeys->keys[nIndex].ssrc) {  /* if SSRC stream joining is enabled then look for existing stream with same SSRC, JHB Jul 2025 */
 
    /* report in stream flags that stream matches existing stream with same SSRC */
 
       uStreamFlags |= FIND_STREAM_SSRC_MATCH;
 
-      if (fPayloadTypeInKey && rtp_pyld_type != keys[thread_index][i][len-1]) uStreamFlags |= FIND_STREAM_PAYLOAD_TYPE_UNMATCHED;  /* advise caller if payload type does not match (different payload types imply different codecs, something to consider) */
+      if (fPayloadTypeInKey && rtp_pyld_type != pKeys->keys[nIndex].key[len-1]) uStreamFlags |= FIND_STREAM_PAYLOAD_TYPE_UNMATCHED;  /* advise caller if payload type does not match (different payload types imply different codecs, something to consider) */
 
       #if 0
       static bool fOnce[10] = { false };
-      if (!fOnce[i]) { fOnce[i] = true; printf("\n *** pkt#%u joining stream SSRC = 0x%x, i = %d, nKeys = %d \n", thread_info[thread_index].packet_number[0], ssrc, i, nKeys[thread_index]); }
+      if (nIndex < 10 && !fOnce[nIndex]) { fOnce[nIndex] = true; printf("\n *** pkt#%u joining stream SSRC = 0x%x, i = %d, nKeys = %d \n", thread_info[thread_index].packet_number[0], ssrc, nIndex, pKeys->nKeys); }
       #endif
 
       fExistingStream = true;  /* existing stream */
@@ -155,49 +257,72 @@ bool fPayloadTypeInKey = false, fExistingStream = false;
    
    if (!fExistingStream) {  /* if no match create a new stream key */
 
-      if (nKeys[thread_index] >= MAX_KEYS) {  /* return error condition if not enough space for a new key */
+      if (pKeys->nKeys >= MAX_KEYS) {  /* return error condition if not enough space for a new key */
          Log_RT(2, "mediaMin ERROR: FindStream() exceeds %d allowable stream keys \n", MAX_KEYS);
          return -1;
       }
 
-      memcpy(&keys[thread_index][nKeys[thread_index]], key, len);  /* store key */
-      ssrcs[thread_index][nKeys[thread_index]] = ssrc;  /* store SSRC */
+      if (pKeys->nKeys >= pKeys->nAlloc && !grow_stream_keys(pKeys)) {
+         Log_RT(2, "mediaMin ERROR: FindStream() unable to allocate memory for %d stream keys \n", pKeys->nKeys + 1);
+         return -1;
+      }
+
+      nIndex = pKeys->nKeys;
+
+      memcpy(pKeys->keys[nIndex].key, key, KEY_LENGTH);  /* store key. Bytes after len are zero */
+      pKeys->keys[nIndex].ssrc = ssrc;  /* store SSRC */
+      pKeys->keys[nIndex].key_hash = hash;
+
+      insert_index(pKeys->key_table, pKeys->table_mask, hash, nIndex);
+      insert_index(pKeys->ssrc_table, pKeys->table_mask, ssrc_hash(ssrc), nIndex);
 
       #if 0
-      printf("\n *** pkt#%u storing ssrc = 0x%x, nKeys = %d, len = %d \n", thread_info[thread_index].packet_number[0], ssrcs[thread_index][nKeys[thread_index]], nKeys[thread_index], len);
+      printf("\n *** pkt#%u storing ssrc = 0x%x, nKeys = %d, len = %d \n", thread_info[thread_index].packet_number[0], ssrc, pKeys->nKeys, len);
       #endif
 
-      nKeys[thread_index]++;
+      pKeys->nKeys++;
    }
 
    #if 0
    static int cnt = 0;
-   printf("check_for_new_sesion: cnt = %d, ret_val = %d, nKeys = %d, len = %d\n", cnt++, ret_val, nKeys[thread_index], len);
+   printf("check_for_new_sesion: cnt = %d, nKeys = %d, len = %d\n", cnt++, pKeys->nKeys, len);
    printf("key value: ");
-   for (i = 0; i < KEY_LENGTH; i++) printf("%02x ", key[thread_index][i]);
+   for (int j = 0; j < KEY_LENGTH; j++) printf("%02x ", key[j]);
    printf("\n");
    #endif
 
    if (pStreamFlags) *pStreamFlags = uStreamFlags;
 
-   return fExistingStream ? 0 : nKeys[thread_index];
+   return fExistingStream ? 0 : pKeys->nKeys;
 }
 
 void RemoveLastStreamKey(int thread_index) {
 
-   if (nKeys[thread_index] > 0) {
+STREAM_KEYS* pKeys = &stream_keys[thread_index];
+
+   if (pKeys->nKeys > 0) {
 
-      nKeys[thread_index]--;
-      memset(&keys[thread_index][nKeys[thread_index]], 0, KEY_LENGTH);
-      ssrcs[thread_index][nKeys[thread_index]] = 0;
+      int nIndex = pKeys->nKeys - 1;
+
+      remove_index(pKeys, pKeys->key_table, false, nIndex);
+      remove_index(pKeys, pKeys->ssrc_table, true, nIndex);
+
+      memset(&pKeys->keys[nIndex], 0, sizeof(STREAM_KEY));
+      pKeys->nKeys--;
    }
 }
 
 void ResetStreamKeys(int thread_index) {
 
-   nKeys[thread_index] = 0;
-   memset(&keys[thread_index], 0, MAX_KEYS*KEY_LENGTH*sizeof(uint8_t));
-   memset(&ssrcs[thread_index], 0, MAX_KEYS*sizeof(ssrcs[0][0]));
+STREAM_KEYS* pKeys = &stream_keys[thread_index];
+
+   pKeys->nKeys = 0;
+
+   if (pKeys->nAlloc) {  /* keep allocated memory, clear index tables */
+
+      memset(pKeys->key_table, 0xff, (pKeys->table_mask + 1)*sizeof(int32_t));
+      memset(pKeys->ssrc_table, 0xff, (pKeys->table_mask + 1)*sizeof(int32_t));
+   }
 }
 
 /* SetSessionTiming() notes:
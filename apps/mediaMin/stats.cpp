@@ -38,6 +38,7 @@
    Modified Jul 2025 JHB, add max_buffer_size param and replace sprintf() with snprintf(). Also replace sizeof(tmpstr) with max_buffer_size (it was ok when code was in mediaMin.cpp but doing that here is always size of a pointer)
    Modified Aug 2025 JHB, update DSGetTimestamp() flag names per changes in diaglib.h
    Modified Aug 2025 JHB, add IPv6 fragment header NULL param in call to DSPktRemoveFragment() per change in pktlib.h
+   Modified Oct 2026 JHB, show timed out and evicted fragment stats from DSGetPktFragmentStats()
 */
 
 #include <algorithm>
@@ -140,9 +141,11 @@ int DisplayLogSummaryStats(char* tmpstr, int max_buffer_size, uint64_t cur_time,
 
 int i;
 unsigned int nOrphansRemoved, nMaxListFragments;
+PKT_FRAGMENT_STATS FragmentStats;
 
    if (!tmpstr || max_buffer_size <= 0) return -1;
 
+   if (DSGetPktFragmentStats(0, &FragmentStats) < 0) memset(&FragmentStats, 0, sizeof(FragmentStats));  /* get before DSPktRemoveFragment() cleanup */
    nOrphansRemoved = DSPktRemoveFragment(NULL, NULL, 0, &nMaxListFragments);
 
    bool fLogTimeStampPrinted = false;  /* make sure only one event log timestamp is printed in the case of multiple stats strings (which should only happen with 100s of inputs during stress tests) */
@@ -171,6 +174,8 @@ unsigned int nOrphansRemoved, nMaxListFragments;
    snprintf(&tmpstr[strlen(tmpstr)], max_buffer_size - strlen(tmpstr), ", max on list = ");
    snprintf(&tmpstr[strlen(tmpstr)], max_buffer_size - strlen(tmpstr), "%u", nMaxListFragments);
 
+   if (FragmentStats.timed_out || FragmentStats.evicted) snprintf(&tmpstr[strlen(tmpstr)], max_buffer_size - strlen(tmpstr), ", timed out = %llu, evicted = %llu", (unsigned long long)FragmentStats.timed_out, (unsigned long long)FragmentStats.evicted);  /* show only if non-zero, JHB Oct 2026 */
+
    snprintf(&tmpstr[strlen(tmpstr)], max_buffer_size - strlen(tmpstr), "\n%s%sOversize non-fragmented =", tabstr, tabstr);
    for (i=0; i<thread_info[thread_index].nInPcapFiles; i++) snprintf(&tmpstr[strlen(tmpstr)], max_buffer_size - strlen(tmpstr), " [%d]%u", i, thread_info[thread_index].num_oversize_nonfragmented_packets[i]);
 
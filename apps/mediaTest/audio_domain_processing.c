@@ -40,6 +40,7 @@
   Modified Dec 2024 JHB, add DS_FSCONV_SATURATE flag in DSConvertFs()
   Modified Mar 2025 JHB, minor changes to make compatible with g++ compiler and -std=gnu++11
   Modified Jun 2025 JHB, for ip_addr, voice_attributes, and TERMINATION_INFO structs, remove "u" and "attr" intermediate addressing for unions and address individual structs directly
+  Modified Oct 2026 JHB, in DSDeduplicateStreams() add FFT based incremental alignment with per group state kept between calls, reporting lag and confidence for all contributors in one pass. See fft_align() and USE_FFT_ALIGNMENT
 */
 
 #ifdef __cplusplus
@@ -50,6 +51,10 @@
 /* Linux header files */
 
 #include <semaphore.h>
+#include <math.h>
+#include <string.h>
+#include <limits.h>
+#include <stdlib.h>
 
 /* lib header files (all libs are .so format) */
 
@@ -484,10 +489,285 @@ send_group_packet:
 }
 
 
+/* FFT based incremental alignment used by DSDeduplicateStreams(), JHB Oct 2026. Notes:
+
+   -contributor 0 is the anchor. For each analysis window the anchor window spectrum is computed once, then cross correlated in the frequency domain with the same window position in each contributor not yet aligned. This gives lag and confidence for all contributors in one pass
+   -confidence is the correlation coefficient at the peak lag, normalized by energy of the overlapping parts of the two windows
+   -per group state (window position, per contributor lag and confidence) is kept between calls, so data already analyzed is not rescanned as more contributor data arrives
+   -FFT work buffers (about 196 kB) are heap allocated per group when alignment starts and freed when the group is aligned, so threads that never align (e.g. most p/m threads) don't pay for them
+   -windows are zero padded to FFT length (twice the window size), so circular correlation is the same as linear correlation. Lag search is limited to +/- half the window size, which keeps window overlap at least 50%
+   -shared_includes/fft.h defines only FFT params, so a small radix-2 complex FFT is included here
+*/
+
+#define DEDUP_FFT_ORDER        13                       /* FFT length 8192 */
+#define DEDUP_FFT_LEN          (1 << DEDUP_FFT_ORDER)
+#define DEDUP_WINDOW_SIZE      (DEDUP_FFT_LEN/2)        /* analysis window size, in samples */
+#define DEDUP_MAX_LAG          (DEDUP_WINDOW_SIZE/2)    /* max lag searched, in samples */
+#define DEDUP_WINDOW_ADVANCE   (DEDUP_WINDOW_SIZE/2)    /* window advance when not all contributors are aligned (50% overlap) */
+#define DEDUP_CONF_THRESH      0.6f                     /* min correlation coefficient for alignment */
+#define DEDUP_MIN_AMP_THRESH   1000                     /* window is skipped if peak amplitude is below this (same as MIN_AMP_THRESH used by threshold search) */
+
+typedef struct {
+
+  float x_re[DEDUP_FFT_LEN], x_im[DEDUP_FFT_LEN], y_re[DEDUP_FFT_LEN], y_im[DEDUP_FFT_LEN];  /* FFT work buffers */
+  double x_energy[DEDUP_WINDOW_SIZE+1], y_energy[DEDUP_WINDOW_SIZE+1];                   /* running energy, x_energy[k] is energy of first k window samples */
+
+} DEDUP_WORK;
+
+typedef struct {
+
+  DEDUP_WORK* work;                         /* work buffers, allocated on first use by a group and freed when the group is aligned. Not cleared by state reset */
+  int nContributors;
+  int contrib_ch[MAX_GROUP_CONTRIBUTORS];
+  int pos;                                  /* start of next analysis window, in samples */
+  int lag[MAX_GROUP_CONTRIBUTORS];          /* lag relative to contributor 0, in samples. Positive values indicate contributor is delayed */
+  float conf[MAX_GROUP_CONTRIBUTORS];       /* confidence (correlation coefficient) at lag */
+  uint8_t fAligned[MAX_GROUP_CONTRIBUTORS];
+
+} DEDUP_STATE;
+
+static DEDUP_STATE dedup_state[MAX_STREAM_GROUPS];  /* stream groups are processed by one p/m thread at a time, so no locking needed */
+
+static float fft_cos[DEDUP_FFT_LEN/2], fft_sin[DEDUP_FFT_LEN/2];  /* twiddle factors */
+static volatile int fft_init = 0, fft_init_lock = 0;
+
+static void reset_state(DEDUP_STATE* s) {  /* clear alignment state, keep work buffers */
+
+DEDUP_WORK* work = s->work;
+
+   memset(s, 0, sizeof(DEDUP_STATE));
+   s->work = work;
+}
+
+static void init_fft(void) {
+
+int k;
+
+   if (fft_init) return;
+
+   while (__sync_lock_test_and_set(&fft_init_lock, 1));  /* one time init, p/m threads may arrive here at the same time */
+
+   if (!fft_init) {
+
+      for (k=0; k<DEDUP_FFT_LEN/2; k++) {
+         fft_cos[k] = cos(2*M_PI*k/DEDUP_FFT_LEN);
+         fft_sin[k] = sin(2*M_PI*k/DEDUP_FFT_LEN);
+      }
+
+      __sync_synchronize();
+      fft_init = 1;
+   }
+
+   __sync_lock_release(&fft_init_lock);
+}
+
+static void fft(float* re, float* im, bool fInverse) {  /* in-place radix-2 complex FFT, inverse is not scaled */
+
+int i, j, k, len, half, step, bit;
+float t_re, t_im, w_re, w_im;
+
+   for (i=1, j=0; i<DEDUP_FFT_LEN; i++) {  /* bit reversal permutation */
+
+      for (bit=DEDUP_FFT_LEN >> 1; j & bit; bit >>= 1) j ^= bit;
+      j ^= bit;
+
+      if (i < j) {
+         t_re = re[i]; re[i] = re[j]; re[j] = t_re;
+         t_im = im[i]; im[i] = im[j]; im[j] = t_im;
+      }
+   }
+
+   for (len=2; len<=DEDUP_FFT_LEN; len<<=1) {
+
+      half = len >> 1;
+      step = DEDUP_FFT_LEN/len;
+
+      for (i=0; i<DEDUP_FFT_LEN; i+=len) for (k=0; k<half; k++) {
+
+         w_re = fft_cos[k*step];
+         w_im = fInverse ? fft_sin[k*step] : -fft_sin[k*step];
+
+         float* a_re = &re[i+k], *a_im = &im[i+k], *b_re = &re[i+k+half], *b_im = &im[i+k+half];
+
+         t_re = *b_re*w_re - *b_im*w_im;
+         t_im = *b_re*w_im + *b_im*w_re;
+
+         *b_re = *a_re - t_re; *b_im = *a_im - t_im;
+         *a_re += t_re; *a_im += t_im;
+      }
+   }
+}
+
+static bool load_window(short int* x, float* re, float* im, double* energy) {  /* copy window into FFT buffer with zero padding, fill running energy. Return false if window peak amplitude is below threshold */
+
+int n, peak = 0;
+
+   energy[0] = 0;
+
+   for (n=0; n<DEDUP_WINDOW_SIZE; n++) {
+
+      re[n] = x[n];
+      energy[n+1] = energy[n] + (double)x[n]*x[n];
+      if (abs(x[n]) > peak) peak = abs(x[n]);
+   }
+
+   if (peak < DEDUP_MIN_AMP_THRESH) return false;
+
+   memset(&re[DEDUP_WINDOW_SIZE], 0, (DEDUP_FFT_LEN - DEDUP_WINDOW_SIZE)*sizeof(float));
+   memset(im, 0, DEDUP_FFT_LEN*sizeof(float));
+
+   return true;
+}
+
+static int fft_align(int idx, int nContributors, int contrib_ch[], int offset[], float conf[]) {  /* return 1 if all contributors are aligned, with offset[] in bytes, 0 if not yet aligned, -1 on error */
+
+int j, n, L, avail, best_lag;
+float best_conf, c;
+double ex, ey;
+DEDUP_STATE* s = &dedup_state[idx];
+
+   init_fft();
+
+/* work buffers are per alignment context, allocated only for groups that are aligning. Previously these were __thread arrays, which every thread in the process paid for */
+
+   if (!s->work && !(s->work = (DEDUP_WORK*)malloc(sizeof(DEDUP_WORK)))) {
+      Log_RT(2, "ERROR: DSDeduplicateStreams() says unable to allocate %d bytes of FFT alignment work memory for group %d \n", (int)sizeof(DEDUP_WORK), idx);
+      return -1;
+   }
+
+   float* x_re = s->work->x_re, *x_im = s->work->x_im, *y_re = s->work->y_re, *y_im = s->work->y_im;
+   double* x_energy = s->work->x_energy, *y_energy = s->work->y_energy;
+
+/* reset state if group contributors changed or contributor 0 data restarted. If contributors are added, previously aligned contributors keep their lag but the window position starts over so new contributors can be searched from the start of their data */
+
+   if (contrib_ch[0] != s->contrib_ch[0] || nContributors < s->nContributors || DSGetStreamGroupContributorDataAvailable(contrib_ch[0])/2 < s->pos) reset_state(s);
+
+   for (j=0; j<nContributors; j++) if (j >= s->nContributors || contrib_ch[j] != s->contrib_ch[j]) {
+
+      s->contrib_ch[j] = contrib_ch[j];
+      s->fAligned[j] = 0;
+      s->pos = 0;
+   }
+
+   s->nContributors = nContributors;
+   s->fAligned[0] = 1;  /* anchor */
+
+   while (1) {
+
+      for (j=0, avail=INT_MAX; j<nContributors; j++) avail = min(avail, DSGetStreamGroupContributorDataAvailable(contrib_ch[j])/2);  /* available data in samples */
+
+      if (s->pos + DEDUP_WINDOW_SIZE > avail) return 0;  /* wait for more data */
+
+      if (load_window(DSGetStreamGroupContributorDataPtr(contrib_ch[0], 2*s->pos), x_re, x_im, x_energy)) {
+
+         fft(x_re, x_im, false);  /* anchor window spectrum, used for all contributors */
+
+         for (j=1; j<nContributors; j++) {
+
+            if (s->fAligned[j] || !load_window(DSGetStreamGroupContributorDataPtr(contrib_ch[j], 2*s->pos), y_re, y_im, y_energy)) continue;
+
+            fft(y_re, y_im, false);
+
+            for (n=0; n<DEDUP_FFT_LEN; n++) {  /* cross spectrum conj(X)*Y */
+
+               float re = x_re[n]*y_re[n] + x_im[n]*y_im[n];
+               y_im[n] = x_re[n]*y_im[n] - x_im[n]*y_re[n];
+               y_re[n] = re;
+            }
+
+            fft(y_re, y_im, true);  /* y_re[L mod FFT length] is now FFT length * sum of x[n]*y[n+L] */
+
+            best_conf = -1; best_lag = 0;
+
+            for (L=-DEDUP_MAX_LAG; L<=DEDUP_MAX_LAG; L++) {
+
+               if (L >= 0) { ex = x_energy[DEDUP_WINDOW_SIZE-L]; ey = y_energy[DEDUP_WINDOW_SIZE] - y_energy[L]; }  /* energy of overlapping parts */
+               else { ex = x_energy[DEDUP_WINDOW_SIZE] - x_energy[-L]; ey = y_energy[DEDUP_WINDOW_SIZE+L]; }
+
+               if (ex <= 0 || ey <= 0) continue;
+
+               c = y_re[L & (DEDUP_FFT_LEN-1)]/DEDUP_FFT_LEN/sqrt(ex*ey);
+
+               if (c > best_conf) { best_conf = c; best_lag = L; }
+            }
+
+            #ifdef ALIGNDEBUG
+            printf("\n === group %d stream %d window start %d, lag = %d, conf = %f \n", idx, contrib_ch[j], s->pos, best_lag, best_conf);
+            #endif
+
+            if (best_conf >= DEDUP_CONF_THRESH) {
+
+               s->fAligned[j] = 1;
+               s->lag[j] = best_lag;
+               s->conf[j] = best_conf;
+            }
+         }
+
+         for (j=1; j<nContributors; j++) if (!s->fAligned[j]) break;
+
+         if (j == nContributors) {  /* all contributors aligned, offsets are positions of the same content in each contributor, centered on the current anchor window */
+
+            for (j=0; j<nContributors; j++) {
+
+               offset[j] = 2*(s->pos + DEDUP_WINDOW_SIZE/2 + s->lag[j]);
+               conf[j] = j ? s->conf[j] : 1;
+            }
+
+            free(s->work);
+            memset(s, 0, sizeof(DEDUP_STATE));  /* done with this group */
+
+            return 1;
+         }
+      }
+
+      s->pos += DEDUP_WINDOW_ADVANCE;
+   }
+}
+
+static int set_alignment(int idx, int nContributors, int contrib_ch[], int offset[], float conf[]) {  /* set align_interval_count[] from per contributor alignment offsets (in bytes), JHB Oct 2026 */
+
+int j, k, n, ref_start = 0;
+
+   for (j=0; j<nContributors; j++) ref_start = max(ref_start, offset[j]);  /* alignment point of "reference" stream (in bytes); i.e. one with most delayed offset */
+
+   for (j=0; j<nContributors; j++) {
+
+      int framesize = DSGetStreamGroupContributorFramesize(contrib_ch[j]);  /* get contributor's audio framesize (in bytes) */
+
+   /* set align_interval_count[] values such that streams are delayed (shifted right) to match the reference stream */
+
+      align_interval_count[idx][j] = (ref_start - offset[j] + framesize/2)/framesize;  /* calculate shift amount as number of framesize intervals (in bytes). The shift amount for the reference stream will be zero */
+   }
+
+/* if debug option enabled, insert alignment marker in each stream. In Wireshark or other waveform display, all markers should appear "on top of each other" if alignment has been done correctly, JHB Jul2020 */
+
+   if (lib_dbg_cfg.uDebugMode & DS_INJECT_GROUP_ALIGNMENT_MARKERS) for (j=0; j<nContributors; j++) {
+
+      short int* x = DSGetStreamGroupContributorDataPtr(contrib_ch[j], 0);  /* retrieve pointer to start of contributor audio data */
+      n = offset[j]/2;  /* in samples */
+
+      for (k=0; k<6; k++) x[n+k] = 25000;  /* need a few of these due to some type of filtering done by Wireshark waveform display (appears to be a running average a few samples wide) */
+   }
+
+/* generate deduplication event log INFO message */
+
+   char tmpstr[1000] = "";
+   for (j=0; j<nContributors; j++) {
+      sprintf(&tmpstr[strlen(tmpstr)], "  stream %d, alignment offset (bytes) = %u, interval count = %u", contrib_ch[j], offset[j], align_interval_count[idx][j]);
+      if (conf) sprintf(&tmpstr[strlen(tmpstr)], ", confidence = %4.2f", conf[j]);  /* FFT alignment reports confidence, JHB Oct 2026 */
+      strcat(tmpstr, " \n");
+   }
+   Log_RT(4, "INFO: group %d all streams meet deduplication alignment criteria, reference start = %d\n%s", idx, ref_start, tmpstr);
+
+   return 1;  /* return value for deduplication alignment found */
+}
+
+
 /* DSDeduplicateStreams, JHB Jun2020:
 
    -applies deduplication algorithm, which looks for similar content between stream group contributors and attempts to align similar streams. The objective is to reduce perceived reverb/echo due to duplicated streams. A typical scenario is a multipath (duplicated) endpoint with different latencies
    -search contributor audio data for criteria to find similar streams, based on alignment algorithm that uses "local minimums" found by simpple amplitude threshold checks combined with cross-correlation
+   -default alignment algorithm is now FFT based incremental cross-correlation, which finds lag and confidence for all contributors in one pass and keeps per group state between calls. See fft_align() notes above. Undefine USE_FFT_ALIGNMENT to use the threshold search + time domain cross correlation algorithm, JHB Oct 2026
    -upon finding other streams that match the "reference" (most delayed) stream, (i) allow stream group processing to start, and (ii) delay earlier streams to align with the reference stream
 
   Input params
@@ -519,7 +799,7 @@ send_group_packet:
 
 int DSDeduplicateStreams(int idx, int nContributors, int contrib_ch[], unsigned int uFlags) {
 
-int j, k, n, num_met, search_start = 0, ret_val = 0;  /* default return value indicates deduplication alignment not yet found */
+int ret_val = 0;  /* default return value indicates deduplication alignment not yet found */
 
    (void)uFlags;  /* param currently not used */
 
@@ -535,6 +815,19 @@ int j, k, n, num_met, search_start = 0, ret_val = 0;  /* default return value in
 
    if (nContributors < 2) return 0;  /* need minimum of two streams to deduplicate. Not an error ... probably waiting for 2nd stream to appear */
 
+   #define USE_FFT_ALIGNMENT  /* FFT based incremental alignment, undefine to use threshold search + time domain cross correlation, JHB Oct 2026 */
+
+   #ifdef USE_FFT_ALIGNMENT
+
+   int offset[MAX_GROUP_CONTRIBUTORS];
+   float conf[MAX_GROUP_CONTRIBUTORS];
+
+   if ((ret_val = fft_align(idx, nContributors, contrib_ch, offset, conf)) > 0) ret_val = set_alignment(idx, nContributors, contrib_ch, offset, conf);
+
+   #else
+
+   int j, k, n, num_met, search_start = 0;
+
 /* alignment algorithm notes notes, JHB Jul2020:
 
    -the basic concept is to find "local minimums" in each stream using a low amplitude threshold search, place those at the center of a window, and cross correlate with local minimum windows in other streams
@@ -664,33 +957,10 @@ thresh_search:
 
    /* alignment found */
 
-      for (j=0; j<nContributors; j++) {
-
-         int framesize = DSGetStreamGroupContributorFramesize(contrib_ch[j]);  /* get contributor's audio framesize (in bytes) */
-
-      /* set align_interval_count[] values such that streams are delayed (shifted right) to match the reference stream */
-
-         align_interval_count[idx][j] = (ref_start - offset[j] + framesize/2)/framesize;  /* calculate shift amount as number of framesize intervals (in bytes). The shift amount for the reference stream will be zero */
-      }
-
-   /* if debug option enabled, insert alignment marker in each stream. In Wireshark or other waveform display, all markers should appear "on top of each other" if alignment has been done correctly, JHB Jul2020 */
-
-      if (lib_dbg_cfg.uDebugMode & DS_INJECT_GROUP_ALIGNMENT_MARKERS) for (j=0; j<nContributors; j++) {
-
-         short int* x = DSGetStreamGroupContributorDataPtr(contrib_ch[j], 0);  /* retrieve pointer to start of contributor audio data */
-         n = offset[j]/2;  /* in samples */
-
-         for (k=0; k<6; k++) x[n+k] = 25000;  /* need a few of these due to some type of filtering done by Wireshark waveform display (appears to be a running average a few samples wide) */
-      }
-
-   /* generate deduplication event log INFO message */
-
-      char tmpstr[500] = "";
-      for (j=0; j<nContributors; j++) sprintf(&tmpstr[strlen(tmpstr)], "  stream %d, alignment offset (bytes) = %u, interval count = %u \n", contrib_ch[j], offset[j], align_interval_count[idx][j]);
-      Log_RT(4, "INFO: group %d all streams meet deduplication alignment criteria, reference start = %d\n%s", idx, ref_start, tmpstr);
-
-      ret_val = 1;  /* return value for deduplication alignment found */
+      ret_val = set_alignment(idx, nContributors, contrib_ch, offset, NULL);
    }
 
+   #endif  /* USE_FFT_ALIGNMENT */
+
    return ret_val;
 }
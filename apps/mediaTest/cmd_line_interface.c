@@ -71,6 +71,7 @@
    Modified Aug 2025 JHB, add uStdoutMode to support --stdout_mode command line option
    Modified Sep 2025 JHB, add szEventLogPath to support --event_log_path command line option
    Modified Oct 2025 JHB, add uSuppressPacketInfoMesssages to support --suppress_packet_info_messages command line option
+   Modified Oct 2026 JHB, add szAppCoreList to support --app_core_list command line option
 */
 
 #ifdef __cplusplus
@@ -151,6 +152,7 @@ bool             fDisable_codec_flc = false;
 uint8_t          uStdoutMode_apps = 0;
 char             szEventLogPath[CMDOPT_MAX_INPUT_LEN] = "";
 uint8_t          uSuppressPacketInfoMessages = 0;
+char             szAppCoreList[CMDOPT_MAX_INPUT_LEN] = "";
 
 /* global vars set in packet_flow_media_proc, but only visible within an app build (not exported from a lib build) */
 
@@ -383,6 +385,11 @@ int i;
       lstrtrim(szEventLogPath);  /* trim leading and trailing spaces, if any ... can happen when apps are run inside shell scripts */
    }
 
+   if (strlen(userIfs.szAppCoreList)) {  /* app thread core list, JHB Oct 2026 */
+      strcpy(szAppCoreList, userIfs.szAppCoreList);
+      lstrtrim(szAppCoreList);
+   }
+
    nRandomBitErrorPercentage = userIfs.nRandomBitErrorPercentage;
 
    fGroupOutputNoCopy = userIfs.CmdLineFlags.group_output_no_copy;
@@ -39,6 +39,12 @@
    Modified Jun 2025 JHB, change DISABLE_JITTER_BUFFER_OUTPUT_PCAPS to ENABLE_JITTER_BUFFER_OUTPUT_PCAPS. mediaMin no longer generates these by default
    Modified Jun 2025 JHB, add ENABLE_SSRC_STREAM_JOINING flag
    Modified Jul 2025 JHB, change DISABLE_DORMANT_SESSION_DETECTION to ENABLE_DORMANT_SESSIONS. packet/media flow worker threads continue to detect and report sessions with duplicated and reused SSRCs, but no longer enable dormant session functionality by default. When ENABLE_DORMANT_SESSIONS is set mediaMin will in turn set the appropriate session uFlags in CreateDynamicSession()
+   Modified Oct 2026 JHB, add ENABLE_MMAP_INPUT flag
+   Modified Oct 2026 JHB, add ENABLE_TIMER_SCHEDULER flag
+   Modified Oct 2026 JHB, add ENABLE_INPUT_PREFETCH flag
+   Modified Oct 2026 JHB, add MERGE_INPUTS flag
+   Modified Oct 2026 JHB, add ENABLE_THREAD_LOAD_BALANCING flag
+   Modified Oct 2026 JHB, add MERGE_INPUTS_OVERWRITE flag
 */
 
 #ifndef _CMDLINEOPTIONSFLAGS_H_
@@ -121,6 +127,8 @@
 
 /* misc */
 
+#define ENABLE_THREAD_LOAD_BALANCING           0x4000000000000LL  /* m| enable packet/media thread load balancing. Sessions and stream groups are migrated from p/m threads exceeding real-time to less loaded threads. See uThreadLoadBalanceInterval in config.h and ThreadLoadBalance() in packet_flow_media_proc.c. Applicable only when multiple p/m threads are active */
+#define MERGE_INPUTS_OVERWRITE                 0x8000000000000LL  /* m| allow MERGE_INPUTS to overwrite an existing xxx_merged.pcap file */
 #define DISABLE_AUTOQUIT                      0x10000000000000LL  /* m| disable automatic quit for cmd lines with (i) all inputs are files (i.e. no UDP or USB audio inputs) and (ii) no repeating stress or capacity tests. Automatic quit is enabled by default */
 #define ALLOW_OUTOFSPEC_RTP_PADDING           0x20000000000000LL  /* mm| allow out-of-spec RTP padding. Suppresses error messages for RTP packets with unused trailing payload bytes not declared with the padding bit in the RTP packet header. See comments in CreateDynamicSession() in mediaMin.cpp */
 #define SLOW_DORMANT_SESSION_FLUSH            0x40000000000000LL  /* mm| extend time after dormant session detection and before flush. See usage in CreateDynamicSession() in mediaMin.cpp. Must be combined with ENABLE_DORMANT_SESSION_FLUSH to take effect */ 
@@ -131,4 +139,9 @@
 
 #define SHOW_PACKET_ARRIVAL_STATS            0x400000000000000LL  /* m| show packet arrival stats in mediaMin summary stats display, including average interval between packets and average packet jitter vs stream ptime. These stats differ somewhat from Wireshark, as they apply only to media packets and exclude SID and DTMF packets */ 
 
+#define ENABLE_MMAP_INPUT                    0x800000000000000LL  /* m| memory-map pcap and pcapng file inputs (see DS_OPEN_PCAP_MMAP in pktlib.h). Reduces per-packet read overhead for large files, especially in accelerated processing modes. If mapping fails standard file I/O is used */
+#define ENABLE_TIMER_SCHEDULER              0x1000000000000000LL  /* m| push-pull loop sleeps until next push-pull interval or packet arrival timestamp deadline instead of polling the system clock. Reduces app thread CPU usage with no loss in timing accuracy. Push-pull loop CPU usage and interval timing stats are shown at loop exit, with or without this flag */
+#define ENABLE_INPUT_PREFETCH               0x2000000000000000LL  /* m| read pcap, pcapng, and .rtpXXX file inputs in per-input reader threads that prefetch packets into a ring buffer, so app threads don't block on file I/O. Not applied to memory-mapped inputs (ENABLE_MMAP_INPUT) */
+#define MERGE_INPUTS                        0x4000000000000000LL  /* m| merge multiple pcap, pcapng, and .rtpXXX file inputs into one time-ordered pcap (written as xxx_merged.pcap, where xxx is the first input name), then process it as a single input. Inputs are aligned to their first packet arrival timestamp, the same as when processed separately. If xxx_merged.pcap already exists inputs are not merged, unless MERGE_INPUTS_OVERWRITE is also given. See MergeInputs() in mediaMin.cpp */
+
 #endif  /* _CMDLINEOPTIONSFLAGS_H_ */
@@ -65,6 +65,7 @@
    Modified Aug 2025 JHB, add uStdoutMode to support --stdout_mode command line option
    Modified Sep 2025 JHB, add szEventLogPath to support --event_log_path command line option
    Modified Oct 2025 JHB, add uSuppressPacketInfoMesssages to support --suppress_packet_info_messages command line option
+   Modified Oct 2026 JHB, add szAppCoreList to support --app_core_list command line option
 */
 
 #ifndef _MEDIA_TEST_H_
@@ -276,6 +277,7 @@ extern bool              fDisable_codec_flc;
 extern uint8_t           uStdoutMode_apps;
 extern char              szEventLogPath[];
 extern uint8_t           uSuppressPacketInfoMessages;
+extern char              szAppCoreList[];  /* command line --app_core_list */
 
 #define szAppFullCmdLine (((const char*)full_cmd_line))  /* szAppFullCmdLine is what apps should use. full_cmd_line should not be modified so this is a half-attempt to remind user apps that it should be treated as const char* */
 
@@ -130,6 +130,7 @@ Revision History
   Modified Aug 2025 JHB, add uPktNumber param to DSGetPacketInfo() calls per mod in pktlib.h
   Modified Aug 2025 JHB, fix bug in pcap output where RTP payloads with zero length (typically some number may be generated by encoder after a SID output) were being written to output pcaps. An example is EVS compact header format with DTX enabled, SID payloads in the output pcap should not be followed by zero length payloads each with their own sequence number
   Modified Sep 2025 JHB, insert call to SetStdoutMode() before DSInitLogging() in case --stdout_mode has been given on the command line (same as in mediaMin.cpp)
+  Modified Oct 2026 JHB, skip hard-coded mediaMin thread affinity in -Et mode if -mN core list is given on the command line, in that case threads are placed by DSSetThreadPlacement()
 */
 
 /* Linux header files */
@@ -2412,6 +2413,7 @@ codec_test_cleanup:
                   DSGetBacktrace(4, DS_GETBACKTRACE_INSERT_MARKER, &((char*)arg)[4]);  /* get backtrace info before thread starts, then thread also gets its own backtrace info, JHB May 2024 */
 
                   if ((tc_ret = pthread_create(&mediaMinThreads[i], ptr_attr, mediaMin_thread, arg))) fprintf(stderr, "%s:%d: pthread_create() failed for mediaMin thread, thread number = %d, ret val = %d\n", __FILE__, __LINE__, i, tc_ret);
+                  else if (PlatformParams.nCoreList) num_threads_started++;  /* -mN core list given, mediaMin threads place themselves with DSSetThreadPlacement() (diaglib), JHB Oct 2026 */
                   else {
 
                      cpu_set_t cpuset;
@@ -219,6 +219,16 @@
                          -mediaMin, based on the ENABLE_DORMANT_SESSIONS flag in its -dN cmd line entry, sets TERM_ENABLE_DORMANT_SESSION in TERMINATION_INFO struct uFlags in CreateDynamicSession() (look here for term_uFlags[][])
   Modified Aug 2025 JHB, add thread_index parameter to DSProcessStreamGroupContributorsTSM()
   Modified Aug 2025 JHB, add uPktNumber param to DSGetPacketInfo() calls per mod in pktlib.h
+  Modified Oct 2026 JHB, set DS_PKTSTATS_LOG_PARALLEL flag for packet logs with multiple streams
+  Modified Oct 2026 JHB, ManageSessions() maintains hSessions_t[] as a persistent per-thread active session list and does a full session scan only when the thread's session count changes or a session is deleted. get_session_handle() indexes the list directly instead of searching it (O(n^2) per pass in per-session loops)
+  Modified Oct 2026 JHB, packet stats history (input_pkts and pulled_pkts) now uses chunked PKT_STATS_ARENA storage (diaglib) instead of fixed 1.2M entry static arrays that wrapped and lost history. Optional spill to disk is enabled by DS_PACKET_STATS_HISTORY_SPILL_TO_DISK in uPktStatsLogging
+  Modified Oct 2026 JHB, energy saver state in media-only p/m threads blocks on a per-thread futex with deadline set by the shortest ptime of the thread's sessions, instead of fixed usleep(). DSPushPackets() wakes the owning thread via set_session_last_push_time(). See pm_thread_idle_wait() and pm_thread_wakeup()
+  Modified Oct 2026 JHB, add p/m thread load balancing, enabled by uThreadLoadBalanceInterval in GLOBAL_CONFIG. The master thread checks thread loads and marks sessions or whole stream groups for migration from threads exceeding real-time, owning threads migrate them at the start of ManageSessions(). See ThreadLoadBalance() and MigrateSessions()
+  Modified Oct 2026 JHB, p/m threads call DSSetThreadPlacement() (diaglib) on startup to place themselves per app configured core list, SMT sibling, and NUMA options. Placement is shown in ThreadDebugOutput()
+  Modified Oct 2026 JHB, serialize packet stats arena first use init in pkt_stats_reserve(), always call DSPktStatsArenaCommit() after a successful reserve (arena is locked until commit). WritePktLog() organize-by-group check uses arena num_group_entries, which includes spilled entries
+  Modified Oct 2026 JHB, MigrateSessions() checks DSSetSessionInfo() return values and reads back session thread assignment, restores sessions already reassigned if any fail and disables load balancing. Session counts are updated only after the whole migration unit succeeds. Migration counts moved from PACKETMEDIATHREADINFO (shared with pktlib) to file-local arrays
+  Modified Oct 2026 JHB, ThreadLoadBalance() estimates per-session cost from per-session decode + encode time (session_codec_time[]) instead of an equal share of thread load, and marks nothing if uMaxSessionsPerThread leaves no room on the destination thread
+  Modified Oct 2026 JHB, input and pulled packet stats are collected in PKT_STATS_BATCH structs and added with DSPktStatsAddEntriesBatch() and one packet stats arena reserve per batch (see pkt_stats_batch_add() and pkt_stats_batch_flush()), instead of one reserve and commit per packet
 */
 
 /* Linux header files */
@@ -243,6 +253,7 @@
 #include <limits.h>
 #include <sched.h>
 #include <sys/syscall.h>  /* SYS_gettid() */
+#include <linux/futex.h>  /* FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE */
 #include <errno.h>  /* errno and strerror */
 
 /* SigSRF lib header files */
@@ -480,6 +491,10 @@ static uint64_t last_cur_time[MAX_PKTMEDIA_THREADS] = { 0 };
 static uint64_t last_push_time[MAX_SESSIONS] = { 0 };
 static uint8_t session_alarm_flags[MAX_SESSIONS] = { 0 };
 
+/* number of entries in each p/m thread's active session list (hSessions_t[]), maintained by ManageSessions(). A value of -1 forces a full session scan on the next ManageSessions() call, JHB Oct 2026 */
+
+static int num_active_sessions[MAX_PKTMEDIA_THREADS] = { 0 };
+
 #ifdef OVERWRITE_INPUT_DATA
 static bool fReuseInputs = false;
 static int ReuseInputs(uint8_t*, unsigned int, uint32_t, SESSION_DATA*);
@@ -528,13 +543,36 @@ static int ReuseInputs(uint8_t*, unsigned int, uint32_t, SESSION_DATA*);
 
   #else
 
-  #define MAX_PKT_STATS  1200000L  /* increased from 300K, PKT_STATS struct in diaglib.h compacted, JHB Dec2019 */
+  #define MAX_PKT_STATS  1200000L  /* increased from 300K, PKT_STATS struct in diaglib.h compacted, JHB Dec2019. Now limits in-memory entries per arena, see below */
+  #if 0
   static PKT_STATS __attribute((aligned(64))) input_pkts[MAX_PKT_STATS+100], pulled_pkts[MAX_PKT_STATS+100];
+  #else  /* chunked arenas (see PKT_STATS_ARENA in diaglib.h). Blocks are allocated as needed and entries never move. When MAX_PKT_STATS is reached older entries are spilled to disk if DS_PACKET_STATS_HISTORY_SPILL_TO_DISK is set in uPktStatsLogging, otherwise the oldest block is discarded (previously the arrays wrapped to index 0 and all history was lost), JHB Oct 2026 */
+  static PKT_STATS_ARENA input_pkts, pulled_pkts;  /* zero initialized static, first use init in pkt_stats_reserve() */
+  #endif
+
+  #define PKT_STATS_BATCH_LEN  64  /* max packets collected by p/m thread input and pull loops before a packet stats arena reserve, JHB Oct 2026 */
+
+  typedef struct {  /* packets collected for one DSPktStatsAddEntriesBatch() call, see pkt_stats_batch_add() and pkt_stats_batch_flush() */
+
+    int num;
+    unsigned int uFlags;
+    uint8_t* pkts[PKT_STATS_BATCH_LEN];
+    int pkt_len[PKT_STATS_BATCH_LEN];
+    unsigned int pkt_info[PKT_STATS_BATCH_LEN];
+    int16_t chnum[PKT_STATS_BATCH_LEN];
+    int16_t idx[PKT_STATS_BATCH_LEN];
+
+  } PKT_STATS_BATCH;
 
   #endif
 
+  #ifdef USE_CHANNEL_PKT_STATS
   #define INPUT_PKTS input_pkts
   #define PULLED_PKTS pulled_pkts
+  #else
+  #define INPUT_PKTS &input_pkts
+  #define PULLED_PKTS &pulled_pkts
+  #endif
 
 #else
   #define INPUT_PKTS NULL
@@ -559,6 +597,28 @@ extern SESSION_INFO_THREAD session_info_thread[MAX_SESSIONS];  /* in pktlib, ref
 
 uint8_t pm_sync[MAX_PKTMEDIA_THREADS] = { 0 };  /* referenced in mediaMin.cpp */
 
+/* p/m thread idle wait and wakeup, see pm_thread_idle_wait() and pm_thread_wakeup(), JHB Oct 2026 */
+
+typedef struct {
+
+  uint32_t seq;    /* futex word, incremented on each wakeup event (e.g. packets pushed to a session owned by the thread) */
+  uint8_t  fIdle;  /* set while thread is blocked in pm_thread_idle_wait(), wakers make a futex system call only if set */
+
+} PM_WAKEUP;
+
+static PM_WAKEUP __attribute__((aligned(64))) pm_wakeup[MAX_PKTMEDIA_THREADS] = {{ 0 }};  /* one cache line per thread, avoid false sharing between app threads pushing to different p/m threads */
+
+/* p/m thread load balancing, see ThreadLoadBalance() and MigrateSessions(), JHB Oct 2026 */
+
+static int8_t  session_migrate_to[MAX_SESSIONS] = { 0 };  /* destination thread index + 1, zero if no migration pending */
+static uint8_t migrate_pending[MAX_PKTMEDIA_THREADS] = { 0 };  /* set by ThreadLoadBalance() after marking sessions, cleared by the owning thread in MigrateSessions() */
+static int num_sessions_migrated_in[MAX_PKTMEDIA_THREADS] = { 0 };  /* migration counts, shown in ThreadDebugOutput(). Kept here, not in PACKETMEDIATHREADINFO, which is shared with pktlib */
+static int num_sessions_migrated_out[MAX_PKTMEDIA_THREADS] = { 0 };
+static bool fMigrationDisabled = false;  /* set by MigrateSessions() if pktlib doesn't support session thread reassignment */
+static uint64_t session_codec_time[MAX_SESSIONS] = { 0 };  /* running total of decode + encode time per session (usec), added to by the owning thread, read by ThreadLoadBalance() to estimate per-session cost */
+
+static THREAD_PLACEMENT pm_thread_placement[MAX_PKTMEDIA_THREADS] = {{ 0 }};  /* p/m thread CPU and NUMA node placement, see DSSetThreadPlacement() in diaglib, JHB Oct 2026 */
+
 #ifdef FIRST_TIME_TIMING  /* reserved for timing debug purposes */
 unsigned long long first_base_time = 0, first_push_time = 0, first_buffer_time = 0, first_pull_time = 0, first_contribute_time = 0;
 #endif
@@ -595,8 +655,8 @@ int CleanSession(HSESSION, int);
 int ManageSessions(HSESSION[], PKT_COUNTERS[], PKT_STATS_HISTORY[], PKT_STATS_HISTORY[], bool*, int, uint64_t);
 int WritePktLog(HSESSION, PKT_COUNTERS[], PKT_STATS_HISTORY[], PKT_STATS_HISTORY[], int);
 #else
-int ManageSessions(HSESSION[], PKT_COUNTERS[], PKT_STATS[], PKT_STATS[], bool*, int, uint64_t);
-int WritePktLog(HSESSION, PKT_COUNTERS[], PKT_STATS[], PKT_STATS[], int);
+int ManageSessions(HSESSION[], PKT_COUNTERS[], PKT_STATS_ARENA*, PKT_STATS_ARENA*, bool*, int, uint64_t);
+int WritePktLog(HSESSION, PKT_COUNTERS[], PKT_STATS_ARENA*, PKT_STATS_ARENA*, int);
 #endif
 void ThreadDebugOutput(HSESSION[], int, int, int, unsigned int);
 void DisplayChanInfo(HSESSION, int, int[], int);
@@ -640,6 +700,15 @@ extern inline __attribute__((unused)) uint32_t get_session_thread_index(HSESSION
 #endif
 
 void manage_pkt_stats_mem(PKT_STATS_HISTORY[], int, int);
+#ifndef USE_CHANNEL_PKT_STATS
+static inline PKT_STATS* pkt_stats_reserve(PKT_STATS_ARENA*, int);
+static inline int pkt_stats_batch_add(PKT_STATS_ARENA*, PKT_STATS_BATCH*, unsigned int, uint8_t*, int, unsigned int, int);
+static inline int pkt_stats_batch_flush(PKT_STATS_ARENA*, PKT_STATS_BATCH*);
+#endif
+static void pm_thread_wakeup(int);
+static void pm_thread_idle_wait(int, uint32_t, uint32_t);
+static void ThreadLoadBalance(uint64_t);
+static int MigrateSessions(int);
 void set_session_last_push_time(HSESSION);  /* called by DSPushPackets() in pktlib.c, JHB Jun 2023 */
 void set_session_alarm_flags(HSESSION hSession, uint8_t uFlags);
 
@@ -1120,6 +1189,12 @@ too_many_threads:
 
    packet_media_thread_info[thread_index].fMediaThread = fMediaThread;
    packet_media_thread_info[thread_index].packet_mode = packet_mode;
+   num_active_sessions[thread_index] = -1;  /* first ManageSessions() call does a full session scan, JHB Oct 2026 */
+
+
+/* place thread on a CPU if the app has configured a p/m thread core list with DSConfigThreadPlacement(). This is done before any thread level init so memory first touched by the thread is on the local NUMA node if DS_THREAD_PLACEMENT_NUMA_LOCAL_MEM is set, JHB Oct 2026 */
+
+   if (fMediaThread) DSSetThreadPlacement(thread_index, DS_THREAD_PLACEMENT_PKTMEDIA_THREAD, NULL, &pm_thread_placement[thread_index]);
 
 
 /* initialize session handles to -1 before session creation */
@@ -1589,6 +1664,8 @@ run_loop:
 
       if (pm_run == 99) continue;  /* reserved for system stall stress testing (p/m threads are stalled / preempted for whatever reason), JHB Apr 2020 */
 
+      uint32_t wakeup_seq = __atomic_load_n(&pm_wakeup[thread_index].seq, __ATOMIC_SEQ_CST);  /* wakeup events after this point end any idle wait in this loop iteration, see energy saver handling below, JHB Oct 2026 */
+
    /* progress counter and status console update */
 
       if (
@@ -1845,6 +1922,10 @@ run_loop:
          }
       }
 
+   /* check thread loads and migrate sessions if needed, JHB Oct 2026 */
+
+      if (isMasterThread(thread_index) && pktlib_gbl_cfg.uThreadLoadBalanceInterval) ThreadLoadBalance(cur_time);
+
    /* was preemption alarm set ? */
 
       if (fPreemptAlarm) {
@@ -2280,6 +2361,11 @@ get_pkt_info:
                start_profile_time = end_profile_time;
             }
 
+            #if defined(ENABLE_PKT_STATS) && !defined(USE_CHANNEL_PKT_STATS)
+            PKT_STATS_BATCH input_stats_batch;  /* input packet stats are collected in the input loop and added to the packet stats arena in batches, JHB Oct 2026 */
+            input_stats_batch.num = 0;
+            #endif
+
             for (j=0; j<numPkts; j++) {
 
             /* get parent chnum (channel number) that matches the packet. Notes, JHB Feb 2019:
@@ -2641,19 +2727,15 @@ static int log_pkt_in_index = 0;
 
                      if (ret_val > 0 || (uPktStatsLogging & DS_LOG_BAD_PACKETS)) { 
 
-                     /* fill in session and stream group info. Note that group index (idx) may be -1 if session does not belong to a stream group, and if so we fill this in so it can be later referenced by packet stats processing JHB Dec2019 */
+                     /* add packet to input stats batch, with session and stream group info. Note that group index (idx) may be -1 if session does not belong to a stream group, and if so we fill this in so it can be later referenced by packet stats processing JHB Dec2019. Batch entries are added to the packet stats arena after the input loop, JHB Oct 2026 */
 
-                        input_pkts[pkt_counters[thread_index].num_input_pkts].chnum = chnum;
-                        input_pkts[pkt_counters[thread_index].num_input_pkts].idx = DSGetStreamGroupInfo(chnum, DS_STREAMGROUP_INFO_HANDLE_CHNUM, NULL, NULL, NULL);  /* returns -1 if chnum is not a stream group member */
-
-                     /* add packet stats entry */
+                        int k, num_pkts_stats = ret_val >= 0 ? ret_val : 1;
+                        uint8_t* pkt_stats_ptr = pkt_ptr;
 
-                        int num_stats = DSPktStatsAddEntries(&input_pkts[pkt_counters[thread_index].num_input_pkts], uFlags_info, ret_val >= 0 ? ret_val : 1, pkt_ptr, &pkt_len[j], &pkt_info[j]);  /* log input packets; for multiple input streams the DS_PKTSTATS_LOG_COLLATE_STREAMS flag is used (see below) */
-                        if (num_stats > 0) pkt_counters[thread_index].num_input_pkts += num_stats;
+                        for (k=0; k<num_pkts_stats; k++) {  /* log input packets; for multiple input streams the DS_PKTSTATS_LOG_COLLATE_STREAMS flag is used (see below) */
 
-                        if (pkt_counters[thread_index].num_input_pkts >= MAX_PKT_STATS) {
-                           Log_RT(4, "INFO: input packet stats array exceeds %d packets, packet log will likely show missing SSRCs and/or packets \n", MAX_PKT_STATS);
-                           pkt_counters[thread_index].num_input_pkts = 0;  /* wrap */
+                           pkt_counters[thread_index].num_input_pkts += pkt_stats_batch_add(&input_pkts, &input_stats_batch, uFlags_info, pkt_stats_ptr, pkt_len[j+k], pkt_info[j+k], chnum);
+                           pkt_stats_ptr += max(pkt_len[j+k], 0);
                         }
                   #endif
                      }
@@ -2673,6 +2755,10 @@ static int log_pkt_in_index = 0;
 
             }  /* end of j..numPkts-1 loop */
 
+            #if defined(ENABLE_PKT_STATS) && !defined(USE_CHANNEL_PKT_STATS)
+            pkt_counters[thread_index].num_input_pkts += pkt_stats_batch_flush(&input_pkts, &input_stats_batch);  /* add remaining input packet stats entries, JHB Oct 2026 */
+            #endif
+
          /* buffer time profiling, if enabled */
 
   if ((debug_time = (get_time(USE_CLOCK_GETTIME) - start_profile_time)/1000) > 40) printf("\n *** time check 4 = %llu \n", (long long unsigned int)debug_time);
@@ -2744,7 +2830,28 @@ static int log_pkt_in_index = 0;
                      Log_RT(4, "INFO: Packet/media thread %d entering energy saver state after inactivity time %d sec (has entered %d time%s, max recorded inactivity time = %d sec)\n", thread_index, (int)(no_pkt_elapsed_time_thread/1000000L), count, count > 1 ? "s" : "", (int)( packet_media_thread_info[thread_index].max_inactivity_time/1000000L));
                   }
 
-                  usleep(pktlib_gbl_cfg.uThreadEnergySaverSleepTime);  /* sleep as specified. Note that CPU usage percentage is essentially a ratio of what an inactive p/m thread does to check for input (i.e. "floor" CPU usage) and the sleep time. The floor time measures around 500 usec, so a sleep time of 500 usec (approx 50 sessions active) gives about 50% CPU usage, JHB Jan2019 */
+               /* event driven idle wait, JHB Oct 2026. Notes:
+
+                  -DSPushPackets() wakes the thread owning the session (see set_session_last_push_time()), so the first packet after an idle period no longer waits for a sleep to finish, and the thread doesn't need to poll frequently
+                  -the wait deadline is the shortest ptime of sessions owned by the thread, which is the earliest a jitter buffer output can be due. Session create, flush, and delete requests and thread exit are handled within that time. uThreadEnergySaverSleepTime is the minimum wait
+                  -network socket and cmd line file input don't generate wakeup events, so those use the previous fixed sleep
+               */
+
+                  if (fMediaThread && !fNetIOAllowed) {
+
+                     uint32_t wait_time = 20000;  /* default 20 msec if no sessions */
+
+                     for (i=0; i<numSessions; i++) {
+
+                        hSession = get_session_handle(hSessions_t, i, thread_index);
+                        if (hSession >= 0) for (j=0; j<MAX_TERMS; j++) if (ptime[hSession][j] > 0) wait_time = min(wait_time, (uint32_t)ptime[hSession][j]*1000);
+                     }
+
+                     if (timeScale > 1) wait_time /= timeScale;  /* FTRT mode */
+
+                     pm_thread_idle_wait(thread_index, wakeup_seq, max(wait_time, pktlib_gbl_cfg.uThreadEnergySaverSleepTime));
+                  }
+                  else usleep(pktlib_gbl_cfg.uThreadEnergySaverSleepTime);
                }
             }
          }
@@ -2828,14 +2935,20 @@ static int log_pkt_in_index = 0;
 
             /* fill in session and stream group info. Note that group index (idx) may be -1 if session does not belong to a stream group, JHB Dec 2019 */
 
-               input_pkts[pkt_counters[thread_index].num_input_pkts].chnum = -1;
-               input_pkts[pkt_counters[thread_index].num_input_pkts].idx = -1;
+               PKT_STATS* pkt_stats = pkt_stats_reserve(&input_pkts, ret_val >= 0 ? ret_val : 1);  /* get space in packet stats arena, JHB Oct 2026 */
 
-            /* add packet stats entry */
+               if (pkt_stats) {
 
-               int num_stats = DSPktStatsAddEntries(&input_pkts[pkt_counters[thread_index].num_input_pkts], DS_BUFFER_PKT_IP_PACKET, ret_val >= 0 ? ret_val : 1, pkt_in_buf, packet_len, &pkt_info[0]);
-               if (num_stats > 0) pkt_counters[thread_index].num_input_pkts += num_stats;
-               if (pkt_counters[thread_index].num_input_pkts >= MAX_PKT_STATS) pkt_counters[thread_index].num_input_pkts = 0;
+                  pkt_stats->chnum = -1;
+                  pkt_stats->idx = -1;
+
+               /* add packet stats entry */
+
+                  int num_stats = DSPktStatsAddEntries(pkt_stats, DS_BUFFER_PKT_IP_PACKET, ret_val >= 0 ? ret_val : 1, pkt_in_buf, packet_len, &pkt_info[0]);
+
+                  DSPktStatsArenaCommit(&input_pkts, max(num_stats, 0));  /* always commit, arena is locked until commit */
+                  if (num_stats > 0) pkt_counters[thread_index].num_input_pkts += num_stats;
+               }
          #endif
             }
          }
@@ -3371,6 +3484,11 @@ pull:
                   HCODEC hCodec = (intptr_t)NULL;
                   int prev_chnum = -1, in_media_sample_rate __attribute__ ((unused)) = 0;
 
+                  #if defined(ENABLE_PKT_STATS) && !defined(USE_CHANNEL_PKT_STATS)
+                  PKT_STATS_BATCH pulled_stats_batch;  /* pulled packet stats are collected in the packet + payload processing loop and added to the packet stats arena in batches, JHB Oct 2026 */
+                  pulled_stats_batch.num = 0;
+                  #endif
+
                /* packet payload processing loop. A jitter buffer may have returned multiple packets representing multiple channels */
 
                   for (j=0; j<num_pkts; j++) {
@@ -3450,20 +3568,9 @@ pull:
 
                            if (isMasterThread(thread_index) && DSIsPktStatsHistoryLoggingEnabled(thread_index)) {
 
-                           /* fill in session and stream group info. Note that group index (idx) may be -1 if session does not belong to a stream group, and if so we fill this in so it can be later referenced by packet stats processing, JHB Dec2019 */
+                           /* add packet to pulled stats batch, with session and stream group info. Note that group index (idx) may be -1 if session does not belong to a stream group, and if so we fill this in so it can be later referenced by packet stats processing, JHB Dec2019. Batch entries are added to the packet stats arena after the packet + payload processing loop, JHB Oct 2026 */
 
-                              pulled_pkts[pkt_counters[thread_index].num_pulled_pkts].chnum = chnum;
-                              pulled_pkts[pkt_counters[thread_index].num_pulled_pkts].idx = DSGetStreamGroupInfo(chnum, DS_STREAMGROUP_INFO_HANDLE_CHNUM, NULL, NULL, NULL);  /* returns -1 if chnum not a stream group member */
-
-                           /* add packet stats entry */
-
-                              int num_stats = DSPktStatsAddEntries(&pulled_pkts[pkt_counters[thread_index].num_pulled_pkts], uFlags_info, 1, pkt_ptr, &packet_len[j], &pkt_info[j]);  /* we log all buffer output packets; for multiple output streams the DS_PKTSTATS_LOG_COLLATE_STREAMS flag is used (see below) */
-                              if (num_stats > 0) pkt_counters[thread_index].num_pulled_pkts += num_stats;
-
-                              if (pkt_counters[thread_index].num_pulled_pkts >= MAX_PKT_STATS) {
-                                 Log_RT(4, "INFO: pulled packet stats array exceeds %d packets, packet log will likely show missing SSRCs and/or packets \n", MAX_PKT_STATS);
-                                 pkt_counters[thread_index].num_pulled_pkts = 0;
-                              }
+                              pkt_counters[thread_index].num_pulled_pkts += pkt_stats_batch_add(&pulled_pkts, &pulled_stats_batch, uFlags_info, pkt_ptr, packet_len[j], pkt_info[j], chnum);  /* we log all buffer output packets; for multiple output streams the DS_PKTSTATS_LOG_COLLATE_STREAMS flag is used (see below) */
                            #endif
                            }
                            #endif
@@ -3786,6 +3893,10 @@ next_packet:
 
                   }  /* end of packet + payload processing loop (num_pkts). Note -- if DECOUPLE_STREAM_PROCESSING is not defined then the loop end is not here */
 
+                  #if defined(ENABLE_PKT_STATS) && !defined(USE_CHANNEL_PKT_STATS)
+                  pkt_counters[thread_index].num_pulled_pkts += pkt_stats_batch_flush(&pulled_pkts, &pulled_stats_batch);  /* add remaining pulled packet stats entries, JHB Oct 2026 */
+                  #endif
+
                /* decode time profiling, if enabled */
 
                   if (!fPreemptAlarm
@@ -3796,6 +3907,7 @@ next_packet:
 
                      end_profile_time = get_time(USE_CLOCK_GETTIME);
                      decode_time += end_profile_time - start_profile_time;
+                     if (pktlib_gbl_cfg.uThreadLoadBalanceInterval) __atomic_fetch_add(&session_codec_time[hSession], end_profile_time - start_profile_time, __ATOMIC_RELAXED);  /* per-session cost for ThreadLoadBalance(), JHB Oct 2026 */
                      start_profile_time = end_profile_time;
                   }
 
@@ -4281,6 +4393,7 @@ static int log_pkt_index = 0;
 
                         end_profile_time = get_time(USE_CLOCK_GETTIME);
                         encode_time += end_profile_time - start_profile_time;
+                        if (pktlib_gbl_cfg.uThreadLoadBalanceInterval) __atomic_fetch_add(&session_codec_time[hSession], end_profile_time - start_profile_time, __ATOMIC_RELAXED);
                         start_profile_time = end_profile_time;
                      }
 
@@ -4556,7 +4669,7 @@ sync_exit:
    
       if (isMasterThread(thread_index) || !fMediaThread) {
          #ifdef ENABLE_PKT_STATS  /* log stats for input and jitter buffer packets */
-         WritePktLog(-1, pkt_counters, input_pkts, pulled_pkts, thread_index);  /* note there is a published API DSWritePacketStatsHistoryLog() that also does this */
+         WritePktLog(-1, pkt_counters, INPUT_PKTS, PULLED_PKTS, thread_index);  /* note there is a published API DSWritePacketStatsHistoryLog() that also does this */
          #endif
       }
 
@@ -4669,42 +4782,19 @@ static inline bool isSessionAssignedToThread(HSESSION hSession, int thread_index
 
 static inline int get_session_handle(HSESSION hSessions[], int n, int thread_index) {
 
-int i = 0, k = 0;
-
-   do {
-
-      while (hSessions[i] == -1) {  /* skip over non-active / deleted sessions */
-
-         if (i < MAX_SESSIONS-1) i++;
-         else {
-
-            if (packet_media_thread_info[thread_index].fMediaThread) return -1;
-            else goto stream_check;
-         }
-      }
-
-      while (k < n && hSessions[i] >= 0) {  /* find nth valid session handle */
+int i;
 
-         k++;
+/* hSessions[] is the thread's active session list, left-shifted by ManageSessions(), so the nth valid session handle is simply hSessions[n]. Previously we searched for it, which made per-session loops O(n^2), JHB Oct 2026 */
 
-         if (i < MAX_SESSIONS-1) i++;
-         else {
+   if (n >= 0 && n < MAX_SESSIONS && hSessions[n] >= 0) return hSessions[n];
 
-            if (packet_media_thread_info[thread_index].fMediaThread) return -1;
-            else goto stream_check;
-         }
-      }
-
-   } while (hSessions[i] == -1 || k < n);
-
-stream_check:
+   if (packet_media_thread_info[thread_index].fMediaThread) return -1;
 
    #ifndef __LIBRARYMODE__
-   if (!packet_media_thread_info[thread_index].fMediaThread) {
-
-      i = n;
-      while (hSessions[i] == -1 && i >= 0) i--;  /* in cmd line execution, if we still don't have a valid session handle, try assuming there are more input streams than sessions */
-   }
+   i = n < MAX_SESSIONS ? n : MAX_SESSIONS-1;
+   while (i > 0 && hSessions[i] == -1) i--;  /* in cmd line execution, if we still don't have a valid session handle, try assuming there are more input streams than sessions */
+   #else
+   i = MAX_SESSIONS-1;
    #endif
 
 /* final check:  make sure the session is assigned to this packet/media thread */
@@ -5592,13 +5682,14 @@ int ch[64];
   -saves an accurate copy of currently active sessions in hSessions[] (hSessions[] is per thread, located on each thread's stack as hSessions_t[])
   -if a session is new (recently created), calls InitSession() to initialize with thread level items
   -if a session is marked as delete pending, calls CleanSession() to reset thread level items and DSDeleteSession() to delete
+  -hSessions[] is persistent between calls and serves as the thread's active session list. A full scan of pktlib session indexes (up to MAX_SESSIONS, with two DSGetSessionInfo() calls per index) is done only when the thread's session list changes, otherwise only handles in the list are visited. Changes are detected by comparing the pktlib per-thread session count with num_active_sessions[]. This is reliable because sessions are created externally but only deleted by their owning p/m thread (app DSDeleteSession() calls mark sessions as delete pending), and any delete here forces a full scan, JHB Oct 2026
   -see detailed comments below
 */
 
 #ifdef USE_CHANNEL_PKT_STATS
 int ManageSessions(HSESSION* hSessions, PKT_COUNTERS pkt_counters[], PKT_STATS_HISTORY input_pkts[], PKT_STATS_HISTORY pulled_pkts[], bool* fAllSessionsDataAvailable, int thread_index, uint64_t cur_time) {
 #else
-int ManageSessions(HSESSION* hSessions, PKT_COUNTERS pkt_counters[], PKT_STATS input_pkts[], PKT_STATS pulled_pkts[], bool* fAllSessionsDataAvailable, int thread_index, uint64_t cur_time) {
+int ManageSessions(HSESSION* hSessions, PKT_COUNTERS pkt_counters[], PKT_STATS_ARENA* input_pkts, PKT_STATS_ARENA* pulled_pkts, bool* fAllSessionsDataAvailable, int thread_index, uint64_t cur_time) {
 #endif
 
 int i, j, numSessions = 0, numSessionsFound;
@@ -5606,6 +5697,9 @@ HSESSION hSession;
 bool fNoJitterBuffersUsed = true;
 char tmpstr[1024];
 int nRetry = 0, numInit = 0, numDeleted = 0;
+bool fFullScan;
+
+   if (MigrateSessions(thread_index) > 0) num_active_sessions[thread_index] = -1;  /* sessions migrated to another thread by load balancing, force full scan, JHB Oct 2026 */
 
 get_num_sessions:
 
@@ -5626,18 +5720,25 @@ get_num_sessions:
    bool fEarlyExit = false;
    #define MAX_SESSION_TRANSACTIONS_PER_PASS 3
 
-   memset(hSessions, -1, sizeof(HSESSION)*MAX_SESSIONS);  /* in case numSessions is zero, and the loop doesn't run. JHB Jan 2019 */
+   fFullScan = numSessions != num_active_sessions[thread_index];  /* session(s) created or deleted since last call, or full scan forced, JHB Oct 2026 */
+
+   if (fFullScan) {
+
+      memset(hSessions, -1, sizeof(HSESSION)*MAX_SESSIONS);  /* in case numSessions is zero, and the loop doesn't run. JHB Jan 2019 */
+      num_active_sessions[thread_index] = -1;  /* any restart before we finish (retry, delete) also does a full scan */
+   }
 
-   if (numSessions) for (i=0; i<MAX_SESSIONS; i++) {  /* search for active session handles. Note that pktlib does not re-use deleted session indexes until it wraps around in sessions[] management struct */ 
+   if (numSessions) for (i=0; i<(fFullScan ? MAX_SESSIONS : numSessions); i++) {  /* search for active session handles. Note that pktlib does not re-use deleted session indexes until it wraps around in sessions[] management struct */ 
 
       #if 0  /* debug */
       extern SESSION_CONTROL sessions[];
       if (nRetry && i == 0) printf("\n ==== sessions[i].threadid = %llu, sessions[i].thread_index = %d, sessions[i].in_use = %d \n", sessions[i].threadid, sessions[i].thread_index, sessions[i].in_use);
       #endif
 
-      hSession = DSGetSessionInfo(i, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_SESSION | DS_SESSION_INFO_SUPPRESS_ERROR_MSG, 0, NULL);
+      if (fFullScan) hSession = DSGetSessionInfo(i, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_SESSION | DS_SESSION_INFO_SUPPRESS_ERROR_MSG, 0, NULL);
+      else hSession = hSessions[i];  /* session list unchanged, handles are already filtered by thread and left-shifted, JHB Oct 2026 */
 
-      if (hSession >= 0 && isSessionAssignedToThread(hSession, thread_index)) {  /* limit hSessions_t[] "reflection" by thread and current value of numSessions (an app may be concurrently creating more sessions, if so we'll see them on the next pass) */
+      if (hSession >= 0 && (!fFullScan || isSessionAssignedToThread(hSession, thread_index))) {  /* limit hSessions_t[] "reflection" by thread and current value of numSessions (an app may be concurrently creating more sessions, if so we'll see them on the next pass) */
 
          hSessions[numSessionsFound] = hSession;
 
@@ -5711,6 +5812,8 @@ get_num_sessions:
 
                numDeleted++;
 
+               num_active_sessions[thread_index] = -1;  /* force full scan, JHB Oct 2026 */
+
                goto get_num_sessions;  /* restart the search, don't make any assumptions on what pktlib is doing */
             }
             else { fEarlyExit = true; packet_media_thread_info[thread_index].manage_sessions_delete_early_exit++; break; }
@@ -5727,6 +5830,10 @@ get_num_sessions:
          if (state & DS_SESSION_STATE_RESET_PKT_LOG) {  /* reset packet stats */
 
             memset(&pkt_counters[thread_index], 0, sizeof(PKT_COUNTERS));
+            #if defined(ENABLE_PKT_STATS) && !defined(USE_CHANNEL_PKT_STATS)
+            if (input_pkts) DSPktStatsArenaReset(input_pkts);  /* reset packet stats history, JHB Oct 2026 */
+            if (pulled_pkts) DSPktStatsArenaReset(pulled_pkts);
+            #endif
             state_clear_flags &= ~DS_SESSION_STATE_RESET_PKT_LOG;
          }
 
@@ -5783,6 +5890,12 @@ get_num_sessions:
       Log_RT(6, "%s \n", tmpstr);
    }
 
+/* update active session list count. If it doesn't match the pktlib count (early exit, mismatch, concurrent create) the next call does a full scan, JHB Oct 2026 */
+
+   if (!fFullScan && numSessionsFound < numSessions) memset(&hSessions[numSessionsFound], -1, sizeof(HSESSION)*(numSessions - numSessionsFound));  /* early exit, list contents same as a full scan */
+
+   num_active_sessions[thread_index] = numSessionsFound;
+
    packet_media_thread_info[thread_index].fNoJitterBuffersUsed = fNoJitterBuffersUsed;
 
 /* update session management history */
@@ -5813,7 +5926,7 @@ static inline unsigned int uFlags_session(HSESSION hSession) {
 #ifdef USE_CHANNEL_PKT_STATS
 int WritePktLog(HSESSION hSession, PKT_COUNTERS pkt_counters[], PKT_STATS_HISTORY input_pkts[], PKT_STATS_HISTORY pulled_pkts[], int thread_index) {
 #else
-int WritePktLog(HSESSION hSession, PKT_COUNTERS pkt_counters[], PKT_STATS input_pkts[], PKT_STATS pulled_pkts[], int thread_index) {
+int WritePktLog(HSESSION hSession, PKT_COUNTERS pkt_counters[], PKT_STATS_ARENA* input_pkts, PKT_STATS_ARENA* pulled_pkts, int thread_index) {
 #endif
 
 char szPktLogFile[1024], reportstr[50];
@@ -5891,9 +6004,15 @@ int i;
 
       if (numStreams > 1) uFlags_log |= DS_PKTSTATS_LOG_COLLATE_STREAMS;  /* Collate streams in the log printout for multiple input streams. Turing collate off can be used to analyze or debug interleaving or other issues occurring around SSRC transition points */
 
+      if (numStreams > 1) uFlags_log |= DS_PKTSTATS_LOG_PARALLEL;  /* analyze streams in parallel, log output is the same, JHB Oct 2026 */
+
    /* set organize-by-group flag if any streams were stream group members */
 
+      #if 0
       for (i=0; i<(int)pkt_counters[thread_index].num_input_pkts; i++) if (input_pkts[i].idx >= 0) { uFlags_log |= DS_PKTSTATS_ORGANIZE_BY_STREAMGROUP; break; }
+      #else  /* input_pkts is a packet stats arena, which counts stream group member entries as they're added, including entries later spilled to disk, JHB Oct 2026 */
+      if (__atomic_load_n(&input_pkts->num_group_entries, __ATOMIC_RELAXED)) uFlags_log |= DS_PKTSTATS_ORGANIZE_BY_STREAMGROUP;
+      #endif
 
       if (!(uFlags_log & DS_PKTSTATS_ORGANIZE_BY_STREAMGROUP) && !(uFlags_log & DS_PKTSTATS_ORGANIZE_BY_CHNUM)) uFlags_log |= DS_PKTSTATS_ORGANIZE_BY_SSRC;  /* if no stream groups found, set organize-by-SSRC flag by default */
 
@@ -5933,7 +6052,7 @@ int i;
          sprintf(&tmpstr[strlen(tmpstr)], ", total input pkts = %d, total jb pkts = %d", pkt_counters[thread_index].num_input_pkts, pkt_counters[thread_index].num_pulled_pkts);
          Log_RT(4, "%s... \n", tmpstr);
 
-         DSPktStatsWriteLogFile(szPktLogFile, uFlags_log, input_pkts, pulled_pkts, &pkt_counters[thread_index]);
+         DSPktStatsWriteLogFile(szPktLogFile, uFlags_log | DS_PKTSTATS_LOG_ARENA, (PKT_STATS*)(void*)input_pkts, (PKT_STATS*)(void*)pulled_pkts, &pkt_counters[thread_index]);  /* DS_PKTSTATS_LOG_ARENA tells diaglib that input_pkts and pulled_pkts are arenas, JHB Oct 2026 */
       }
 
       return 1;
@@ -5964,6 +6083,8 @@ char* szLocalLogFilename = NULL;
       if (uFlags & DS_PKT_STATS_HISTORY_LOG_RESET_STATS) {  /* combination of NULL log filename and reset stats flag just does a reset */
 
          memset(&pkt_counters[thread_index], 0, sizeof(PKT_COUNTERS));
+         DSPktStatsArenaReset(&input_pkts);  /* JHB Oct 2026 */
+         DSPktStatsArenaReset(&pulled_pkts);
          return 1;
       }
    }
@@ -5986,11 +6107,16 @@ char* szLocalLogFilename = NULL;
 
 /* call DSPktStatsWriteLogFile() in diaglib */
 
-   int ret_val = DSPktStatsWriteLogFile(szLocalLogFilename, uFlags, input_pkts, pulled_pkts, &pkt_counters[thread_index]);  /* input_pkts, pulled_pkts, and pkt_counters are static vars, see top */
+   int ret_val = DSPktStatsWriteLogFile(szLocalLogFilename, uFlags | DS_PKTSTATS_LOG_ARENA, (PKT_STATS*)(void*)&input_pkts, (PKT_STATS*)(void*)&pulled_pkts, &pkt_counters[thread_index]);  /* input_pkts, pulled_pkts, and pkt_counters are static vars, see top. input_pkts and pulled_pkts are packet stats arenas, JHB Oct 2026 */
 
 /* reset stats after logging is complete, if requested */
 
-   if (uFlags & DS_PKT_STATS_HISTORY_LOG_RESET_STATS) memset(&pkt_counters[thread_index], 0, sizeof(PKT_COUNTERS));
+   if (uFlags & DS_PKT_STATS_HISTORY_LOG_RESET_STATS) {
+
+      memset(&pkt_counters[thread_index], 0, sizeof(PKT_COUNTERS));
+      DSPktStatsArenaReset(&input_pkts);
+      DSPktStatsArenaReset(&pulled_pkts);
+   }
    
    return ret_val;
 }
@@ -6952,6 +7078,376 @@ bool DSIsPktStatsHistoryLoggingEnabled(int thread_index) {
    else return (bool)use_log_file;
 }
 
+/* p/m thread idle wait and wakeup, JHB Oct 2026. Notes:
+
+  -pm_thread_idle_wait() blocks on the thread's futex word until a wakeup event or max_wait_usec elapses. wakeup_seq is read at the start of each thread loop iteration, so any wakeup event after that (i.e. during the iteration) causes the wait to return immediately. This avoids lost wakeups without a lock
+  -pm_thread_wakeup() increments the futex word and makes a system call only if the thread is idle, so it's inexpensive to call on every push
+*/
+
+static void pm_thread_wakeup(int thread_index) {
+
+   if (thread_index < 0 || thread_index >= MAX_PKTMEDIA_THREADS) return;
+
+   __atomic_add_fetch(&pm_wakeup[thread_index].seq, 1, __ATOMIC_SEQ_CST);
+
+   if (__atomic_load_n(&pm_wakeup[thread_index].fIdle, __ATOMIC_SEQ_CST)) syscall(SYS_futex, &pm_wakeup[thread_index].seq, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+static void pm_thread_idle_wait(int thread_index, uint32_t wakeup_seq, uint32_t max_wait_usec) {
+
+struct timespec ts = { (time_t)(max_wait_usec/1000000L), (long)(max_wait_usec % 1000000L)*1000 };
+
+   __atomic_store_n(&pm_wakeup[thread_index].fIdle, 1, __ATOMIC_SEQ_CST);
+
+   syscall(SYS_futex, &pm_wakeup[thread_index].seq, FUTEX_WAIT_PRIVATE, wakeup_seq, &ts, NULL, 0);  /* returns immediately with EAGAIN if seq no longer equals wakeup_seq. Timeout is relative */
+
+   __atomic_store_n(&pm_wakeup[thread_index].fIdle, 0, __ATOMIC_SEQ_CST);
+}
+
+/* p/m thread load balancing, JHB Oct 2026. Notes:
+
+  -ThreadLoadBalance() runs in the master p/m thread every uThreadLoadBalanceInterval msec (see GLOBAL_CONFIG struct in config.h). Thread load is the CPU_time_avg[] moving average (p/m thread loop time). A thread is overloaded if its load exceeds its real-time budget: nRealTime if set, otherwise the shortest ptime of its sessions, less nRealTimeMargin (default 20%)
+  -a migration "unit" is either a session not in a stream group, or all sessions in a stream group (stream group owners and contributors must run on the same thread). The unit whose cost comes closest to equalizing loads of the overloaded thread and the least loaded thread is selected. One unit is migrated per interval, which gives moving averages time to reflect the change
+  -per-session cost is estimated by splitting thread load into codec load (decode_time[] + encode_time[] moving averages) and remaining load. Codec load is divided among sessions in proportion to each session's decode + encode time since the previous interval (session_codec_time[], accumulated at the decode and encode profiling points in the p/m thread loop), remaining load is divided equally. If no codec time was measured (e.g. all sessions pass-thru) cost is divided equally
+  -pktlib keeps decode and encode time moving averages per thread only, so session_codec_time[] running totals are kept by session handle and ThreadLoadBalance() uses the difference since its previous check. A migrated session's total moves with it
+  -ThreadLoadBalance() only marks sessions. The owning thread migrates them in MigrateSessions(), called at the start of ManageSessions(), i.e. at a frame boundary with no session processing in progress, so all sessions in a unit move together. The destination thread picks them up in its next ManageSessions() full scan (they are not new, so InitSession() is not called)
+  -sessions being initialized, flushed, or deleted are not migrated
+  -if pktlib fails to reassign a session (DSSetSessionInfo() with DS_SESSION_INFO_THREAD_ID or DS_SESSION_INFO_THREAD), MigrateSessions() restores the unit to the source thread and load balancing is disabled for the rest of the run
+  -packet stats history and run-time stats are per thread, so for a migrated session they are split between threads
+*/
+
+static inline bool isSessionMigratable(HSESSION hSession) {
+
+int state = DSGetSessionInfo(hSession, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_STATE | DS_SESSION_INFO_SUPPRESS_ERROR_MSG, 0, NULL);
+
+   if (state < 0 || !(state & DS_SESSION_STATE_INIT_STATUS) || (state & DS_SESSION_STATE_FLUSH_PACKETS)) return false;  /* not yet initialized by InitSession(), or flushed */
+
+   return !(DSGetSessionInfo(hSession, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_DELETE_STATUS | DS_SESSION_INFO_SUPPRESS_ERROR_MSG, 0, NULL) & DS_SESSION_DELETE_PENDING);
+}
+
+static void ThreadLoadBalance(uint64_t cur_time) {
+
+static uint64_t last_balance_time = 0;
+static HSESSION hSessions_all[MAX_SESSIONS];  /* static, only called by master thread */
+static int8_t session_thread[MAX_SESSIONS];
+static int16_t group_count[MAX_STREAM_GROUPS];  /* number of sessions in group, -1 if group can't be migrated */
+static int8_t group_thread[MAX_STREAM_GROUPS];
+static uint64_t prev_codec_time[MAX_SESSIONS];  /* session_codec_time[] at previous check */
+static double session_cost[MAX_SESSIONS];  /* estimated cost of hSessions_all[] entries on src thread (usec) */
+static double group_cost[MAX_STREAM_GROUPS];
+static uint64_t codec_time[MAX_SESSIONS];  /* hSessions_all[] decode + encode time since previous check */
+double load[MAX_PKTMEDIA_THREADS] = { 0 }, codec_load = 0, codec_time_sum = 0, budget, src_budget = 0, unit_cost, target, best_diff = 0;
+int min_ptime[MAX_PKTMEDIA_THREADS] = { 0 };
+int i, j, n, t, idx, src = -1, dst = -1, numSessionsAll = 0, numSrcSessions = 0, best_unit = -1, best_count = 0, nThreads = min((int)num_pktmedia_threads, MAX_PKTMEDIA_THREADS);
+HSESSION hSession;
+char tmpstr[300];
+
+   if (nThreads < 2 || __atomic_load_n(&fMigrationDisabled, __ATOMIC_RELAXED) || cur_time - last_balance_time < (uint64_t)pktlib_gbl_cfg.uThreadLoadBalanceInterval*1000*timeScale) return;
+   last_balance_time = cur_time;
+
+   for (t=0; t<nThreads; t++) if (__atomic_load_n(&migrate_pending[t], __ATOMIC_SEQ_CST)) return;  /* previous migration not done yet */
+
+/* get thread loads (in usec, FTRT mode time scaling removed) */
+
+   for (t=0; t<nThreads; t++) {
+
+      if (!packet_media_thread_info[t].numSessions) continue;
+
+      for (i=0, n=0; i<THREAD_STATS_TIME_MOVING_AVG; i++) if (packet_media_thread_info[t].CPU_time_avg[i] > 0) { load[t] += packet_media_thread_info[t].CPU_time_avg[i]; n++; }
+      if (n) load[t] /= n*timeScale;
+   }
+
+/* find active sessions, their thread assignments, and stream group membership */
+
+   memset(group_count, 0, sizeof(group_count));
+   memset(group_thread, -1, sizeof(group_thread));
+
+   for (i=0; i<MAX_SESSIONS; i++) {
+
+      if ((hSession = DSGetSessionInfo(i, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_SESSION | DS_SESSION_INFO_SUPPRESS_ERROR_MSG, 0, NULL)) < 0) continue;
+      if ((t = DSGetSessionInfo(hSession, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_THREAD | DS_SESSION_INFO_SUPPRESS_ERROR_MSG, 0, NULL)) < 0 || t >= nThreads) continue;
+
+      codec_time[numSessionsAll] = __atomic_load_n(&session_codec_time[hSession], __ATOMIC_RELAXED) - prev_codec_time[hSession];
+      prev_codec_time[hSession] += codec_time[numSessionsAll];
+
+      hSessions_all[numSessionsAll] = hSession;
+      session_thread[numSessionsAll++] = t;
+
+      for (j=0; j<MAX_TERMS; j++) if (ptime[hSession][j] > 0 && (!min_ptime[t] || ptime[hSession][j] < min_ptime[t])) min_ptime[t] = ptime[hSession][j];
+
+      if ((idx = DSGetStreamGroupInfo(hSession, DS_STREAMGROUP_INFO_CHECK_ALLTERMS, NULL, NULL, NULL)) >= 0 && idx < MAX_STREAM_GROUPS) {
+
+         if (group_thread[idx] == -1) group_thread[idx] = t;
+         if (group_thread[idx] != t || !isSessionMigratable(hSession)) group_count[idx] = -1;  /* group members on different threads, or member being initialized, flushed, or deleted */
+         else if (group_count[idx] >= 0) group_count[idx]++;
+      }
+   }
+
+/* find most overloaded thread (as a ratio of its real-time budget) and least loaded thread */
+
+   for (t=0; t<nThreads; t++) {
+
+      if (packet_media_thread_info[t].numSessions < 2 || !min_ptime[t]) continue;  /* need at least two sessions to gain anything by migrating */
+
+      int margin = packet_media_thread_info[t].nRealTimeMargin > 0 && packet_media_thread_info[t].nRealTimeMargin < 100 ? packet_media_thread_info[t].nRealTimeMargin : 20;
+      budget = (packet_media_thread_info[t].nRealTime > 0 ? packet_media_thread_info[t].nRealTime : min_ptime[t])*1000.0*(100 - margin)/100;
+
+      if (load[t] > budget && (src < 0 || load[t]/budget > load[src]/src_budget)) { src = t; src_budget = budget; }
+   }
+
+   if (src < 0) return;
+
+   for (t=0; t<nThreads; t++) {
+
+      if (t == src || !packet_media_thread_info[t].threadid) continue;
+      if (pktlib_gbl_cfg.uMaxSessionsPerThread && (uint32_t)packet_media_thread_info[t].numSessions >= pktlib_gbl_cfg.uMaxSessionsPerThread) continue;
+
+      if (dst < 0 || load[t] < load[dst]) dst = t;
+   }
+
+   if (dst < 0) return;
+
+/* estimate per-session cost on src thread: codec load (decode and encode moving averages) split in proportion to each session's codec time since previous check, remaining load split equally. See notes above */
+
+   for (i=0; i<numSessionsAll; i++) if (session_thread[i] == src) { numSrcSessions++; codec_time_sum += codec_time[i]; }
+
+   if (!numSrcSessions) return;
+
+   if (codec_time_sum > 0) {
+
+      for (i=0; i<THREAD_STATS_TIME_MOVING_AVG; i++) codec_load += 1.0*(packet_media_thread_info[src].decode_time[i] + packet_media_thread_info[src].encode_time[i])/THREAD_STATS_TIME_MOVING_AVG;  /* same averaging as ThreadDebugOutput(). Decode and encode times are not time scaled, same as load[] */
+      codec_load = min(codec_load, load[src]);
+   }
+
+   memset(group_cost, 0, sizeof(group_cost));
+
+   for (i=0; i<numSessionsAll; i++) {
+
+      if (session_thread[i] != src) continue;
+
+      session_cost[i] = (load[src] - codec_load)/numSrcSessions + (codec_time_sum > 0 ? codec_load*codec_time[i]/codec_time_sum : 0);
+
+      if ((idx = DSGetStreamGroupInfo(hSessions_all[i], DS_STREAMGROUP_INFO_CHECK_ALLTERMS, NULL, NULL, NULL)) >= 0 && idx < MAX_STREAM_GROUPS) group_cost[idx] += session_cost[i];
+   }
+
+/* select migration unit: the cost that would equalize src and dst thread loads is (load[src] - load[dst]) / 2 */
+
+   target = (load[src] - load[dst])/2;
+
+   for (i=0; i<numSessionsAll; i++) {
+
+      if (session_thread[i] != src) continue;
+
+      idx = DSGetStreamGroupInfo(hSessions_all[i], DS_STREAMGROUP_INFO_CHECK_ALLTERMS, NULL, NULL, NULL);
+
+      if (idx >= 0 && idx < MAX_STREAM_GROUPS) { n = group_count[idx]; unit_cost = group_cost[idx]; }
+      else { n = isSessionMigratable(hSessions_all[i]) ? 1 : -1; unit_cost = session_cost[i]; }
+
+      if (n <= 0 || n >= numSrcSessions) continue;  /* unit can't be migrated, or is all of src thread's sessions */
+      if (load[dst] + unit_cost >= load[src]) continue;  /* no improvement */
+      if (pktlib_gbl_cfg.uMaxSessionsPerThread && (uint32_t)(packet_media_thread_info[dst].numSessions + n) > pktlib_gbl_cfg.uMaxSessionsPerThread) continue;
+
+      if (best_unit < 0 || fabs(unit_cost - target) < best_diff) { best_unit = i; best_count = n; best_diff = fabs(unit_cost - target); }
+   }
+
+   if (best_unit < 0) return;
+
+/* mark sessions, then notify src thread */
+
+   idx = DSGetStreamGroupInfo(hSessions_all[best_unit], DS_STREAMGROUP_INFO_CHECK_ALLTERMS, NULL, NULL, NULL);
+
+   if (idx >= 0 && idx < MAX_STREAM_GROUPS) {
+
+      for (i=0; i<numSessionsAll; i++) if (session_thread[i] == src && DSGetStreamGroupInfo(hSessions_all[i], DS_STREAMGROUP_INFO_CHECK_ALLTERMS, NULL, NULL, NULL) == idx) session_migrate_to[hSessions_all[i]] = dst + 1;
+   }
+   else {  /* sessions not in a stream group: migrate as many as needed to equalize loads, starting with the selected session */
+
+      n = numSrcSessions-1;
+      if (pktlib_gbl_cfg.uMaxSessionsPerThread) n = min(n, (int)pktlib_gbl_cfg.uMaxSessionsPerThread - packet_media_thread_info[dst].numSessions);
+
+      if (n <= 0) return;  /* dst thread reached uMaxSessionsPerThread since it was selected, nothing marked */
+
+      for (i=best_unit, best_count=0, unit_cost=0; i<numSessionsAll && best_count < n; i++) {
+
+         if (session_thread[i] != src || (i != best_unit && (DSGetStreamGroupInfo(hSessions_all[i], DS_STREAMGROUP_INFO_CHECK_ALLTERMS, NULL, NULL, NULL) >= 0 || !isSessionMigratable(hSessions_all[i])))) continue;
+         if (i != best_unit && unit_cost + session_cost[i] > target) continue;  /* would overshoot equal loads */
+
+         session_migrate_to[hSessions_all[i]] = dst + 1;
+         unit_cost += session_cost[i];
+         best_count++;
+      }
+   }
+
+   __atomic_store_n(&migrate_pending[src], 1, __ATOMIC_SEQ_CST);
+   pm_thread_wakeup(src);
+
+   sprintf(tmpstr, "INFO: ThreadLoadBalance() says p/m thread %d load %2.2f msec exceeds real-time budget %2.2f msec, migrating ", src, load[src]/1000, src_budget/1000);
+   if (idx >= 0 && idx < MAX_STREAM_GROUPS) sprintf(&tmpstr[strlen(tmpstr)], "stream group %d (%d sessions)", idx, best_count);
+   else if (best_count > 1) sprintf(&tmpstr[strlen(tmpstr)], "%d sessions", best_count);
+   else sprintf(&tmpstr[strlen(tmpstr)], "session %d", hSessions_all[best_unit]);
+   Log_RT(4, "%s to thread %d, load %2.2f msec \n", tmpstr, dst, load[dst]/1000);
+}
+
+/* migrate sessions marked by ThreadLoadBalance(). Called by the owning thread at the start of ManageSessions(), returns number of sessions migrated, JHB Oct 2026 */
+
+static int MigrateSessions(int thread_index) {
+
+HSESSION hSessions_migrate[MAX_SESSIONS];  /* sessions in the migration unit */
+int i, j, dst = -1, numMarked = 0, numMigrated = 0;
+HSESSION hSession;
+bool fCancel = false, fFailed = false;
+
+   if (!__atomic_exchange_n(&migrate_pending[thread_index], 0, __ATOMIC_SEQ_CST)) return 0;
+
+/* verify all marked sessions can still be migrated. If any can't (e.g. a stream group member was flushed or deleted since they were marked) cancel, so a stream group is never split between threads */
+
+   for (hSession=0; hSession<MAX_SESSIONS; hSession++) {
+
+      if (!session_migrate_to[hSession]) continue;
+
+      dst = session_migrate_to[hSession] - 1;
+      if (!isSessionAssignedToThread(hSession, thread_index) || !isSessionMigratable(hSession) || !packet_media_thread_info[dst].threadid) fCancel = true;
+   }
+
+   for (hSession=0; hSession<MAX_SESSIONS; hSession++) {
+
+      if (!session_migrate_to[hSession]) continue;
+
+      dst = session_migrate_to[hSession] - 1;
+      session_migrate_to[hSession] = 0;
+
+      if (!fCancel) hSessions_migrate[numMarked++] = hSession;
+   }
+
+/* reassign sessions in pktlib. Each set is checked and the thread assignment read back; if any session fails, sessions already reassigned are restored so the unit stays on this thread */
+
+   for (i=0; i<numMarked; i++) {
+
+      hSession = hSessions_migrate[i];
+
+      if (DSSetSessionInfo(hSession, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_THREAD_ID, (int64_t)packet_media_thread_info[dst].threadid, NULL) < 0 ||
+          DSSetSessionInfo(hSession, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_THREAD, dst, NULL) < 0 ||
+          DSGetSessionInfo(hSession, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_THREAD | DS_SESSION_INFO_SUPPRESS_ERROR_MSG, 0, NULL) != dst) {
+
+         fFailed = true;
+         break;
+      }
+   }
+
+   if (fFailed) {
+
+      for (j=0; j<=i && j<numMarked; j++) {  /* include session i, which may be partially reassigned */
+
+         DSSetSessionInfo(hSessions_migrate[j], DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_THREAD_ID, (int64_t)packet_media_thread_info[thread_index].threadid, NULL);
+         DSSetSessionInfo(hSessions_migrate[j], DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_THREAD, thread_index, NULL);
+      }
+
+   /* marked sessions were verified above, so a failure here means pktlib doesn't support reassigning sessions. Disable load balancing rather than retry every interval */
+
+      if (!__atomic_exchange_n(&fMigrationDisabled, true, __ATOMIC_SEQ_CST)) Log_RT(3, "WARNING: MigrateSessions() says p/m thread %d unable to reassign session %d to thread %d, DSSetSessionInfo() with DS_SESSION_INFO_THREAD_ID or DS_SESSION_INFO_THREAD failed or not supported, disabling thread load balancing \n", thread_index, hSessions_migrate[i < numMarked ? i : 0], dst);
+
+      return 0;
+   }
+
+/* update thread session counts after the whole unit is reassigned. The destination thread sees its session count change and does a full scan in ManageSessions() */
+
+   for (i=0; i<numMarked; i++) {
+
+      hSession = hSessions_migrate[i];
+
+      __sync_fetch_and_add(&packet_media_thread_info[dst].numSessions, 1);
+      __sync_fetch_and_sub(&packet_media_thread_info[thread_index].numSessions, 1);
+
+      if (DSGetSessionInfo(hSession, DS_SESSION_INFO_HANDLE | DS_SESSION_INFO_GROUP_OWNER | DS_SESSION_INFO_SUPPRESS_ERROR_MSG, 0, NULL) == hSession) {
+
+         __sync_fetch_and_add(&packet_media_thread_info[dst].numGroups, 1);
+         __sync_fetch_and_sub(&packet_media_thread_info[thread_index].numGroups, 1);
+      }
+
+      __sync_fetch_and_add(&num_sessions_migrated_in[dst], 1);
+      num_sessions_migrated_out[thread_index]++;
+
+      numMigrated++;
+   }
+
+   if (fCancel) Log_RT(4, "INFO: MigrateSessions() says p/m thread %d cancelled session migration, session state changed \n", thread_index);
+   else if (numMigrated) {
+
+      Log_RT(4, "INFO: MigrateSessions() says p/m thread %d migrated %d session%s to thread %d \n", thread_index, numMigrated, numMigrated > 1 ? "s" : "", dst);
+      pm_thread_wakeup(dst);
+   }
+
+   return numMigrated;
+}
+
+#ifndef USE_CHANNEL_PKT_STATS
+
+/* initialize packet stats arena on first use and reserve space for num_entries. input_pkts and pulled_pkts are shared by p/m threads, so first use init is serialized; DSPktStatsArenaInit() sets max_blocks last, JHB Oct 2026 */
+
+static inline PKT_STATS* pkt_stats_reserve(PKT_STATS_ARENA* arena, int num_entries) {
+
+static uint8_t arena_init_lock = 0;
+
+   if (!__atomic_load_n(&arena->max_blocks, __ATOMIC_ACQUIRE)) {
+
+      while (__sync_lock_test_and_set(&arena_init_lock, 1) != 0);  /* wait until the lock is zero then write 1 to it */
+
+      if (!arena->max_blocks) DSPktStatsArenaInit(arena, (lib_dbg_cfg.uPktStatsLogging & DS_PACKET_STATS_HISTORY_SPILL_TO_DISK) ? DS_PKTSTATS_ARENA_SPILL : 0, MAX_PKT_STATS, NULL);
+
+      __sync_lock_release(&arena_init_lock);
+   }
+
+   return DSPktStatsArenaReserve(arena, num_entries);  /* if non-NULL, arena is locked until DSPktStatsArenaCommit() */
+}
+
+/* add packet stats entries for a batch of packets with one arena reserve and commit. Return value is number of entries added, JHB Oct 2026 */
+
+static inline int pkt_stats_batch_flush(PKT_STATS_ARENA* arena, PKT_STATS_BATCH* batch) {
+
+int i, num_stats = 0;
+PKT_STATS* pkt_stats;
+
+   if (batch->num <= 0) return 0;
+
+   if ((pkt_stats = pkt_stats_reserve(arena, batch->num))) {
+
+      num_stats = DSPktStatsAddEntriesBatch(pkt_stats, batch->uFlags, batch->num, batch->pkts, batch->pkt_len, batch->pkt_info);
+
+      for (i=0; i<num_stats; i++) {  /* fill in session and stream group info */
+
+         pkt_stats[i].chnum = batch->chnum[i];
+         pkt_stats[i].idx = batch->idx[i];
+      }
+
+      DSPktStatsArenaCommit(arena, max(num_stats, 0));  /* always commit, arena is locked until commit */
+   }
+
+   batch->num = 0;
+
+   return max(num_stats, 0);
+}
+
+/* add a packet to a packet stats batch. Packets must remain valid until the batch is flushed. The batch is flushed first if full or if uFlags changes. Return value is number of entries added by a flush, if any */
+
+static inline int pkt_stats_batch_add(PKT_STATS_ARENA* arena, PKT_STATS_BATCH* batch, unsigned int uFlags, uint8_t* pkt, int pkt_len, unsigned int pkt_info, int chnum) {
+
+int num_stats = 0, n;
+
+   if (batch->num > 0 && (batch->num >= PKT_STATS_BATCH_LEN || uFlags != batch->uFlags)) num_stats = pkt_stats_batch_flush(arena, batch);
+
+   n = batch->num++;
+
+   batch->uFlags = uFlags;
+   batch->pkts[n] = pkt;
+   batch->pkt_len[n] = pkt_len;
+   batch->pkt_info[n] = pkt_info;
+   batch->chnum[n] = chnum;
+   batch->idx[n] = DSGetStreamGroupInfo(chnum, DS_STREAMGROUP_INFO_HANDLE_CHNUM, NULL, NULL, NULL);  /* returns -1 if chnum is not a stream group member */
+
+   return num_stats;
+}
+#endif
+
 #ifdef USE_CHANNEL_PKT_STATS
 void manage_pkt_stats_mem(PKT_STATS_HISTORY pkt_stats[], int chnum, int num_pkts) {
 
@@ -6967,8 +7463,12 @@ void manage_pkt_stats_mem(PKT_STATS_HISTORY pkt_stats[], int chnum, int num_pkts
 
 void set_session_last_push_time(HSESSION hSession) {
 
-   __sync_lock_test_and_set(&last_push_time[hSession], last_cur_time[get_session_thread_index(hSession)]);  /* get_session_thread_index() is inline in pktlib.h, JHB Jul 2025 */
+   int thread_index = get_session_thread_index(hSession);
+
+   __sync_lock_test_and_set(&last_push_time[hSession], last_cur_time[thread_index]);  /* get_session_thread_index() is inline in pktlib.h, JHB Jul 2025 */
    __sync_and_and_fetch(&session_alarm_flags[hSession], ~2);  /* clear alarm flag, JHB Jan 2023 */
+
+   pm_thread_wakeup(thread_index);  /* wake owning p/m thread if it's idle, JHB Oct 2026 */
 }
 
 void set_session_alarm_flags(HSESSION hSession, uint8_t uFlags) {  /* note we use bit 7 to determine set or clear, so only 7 flags available, JHB Jun 2023 */
@@ -7034,7 +7534,10 @@ char tmpstr[8000] = "";
 
    cpu = sched_getcpu();
 
-   sprintf(&tmpstr[strlen(tmpstr)], "Debug info for p/m thread %d (CPU %d), num p/m threads %d, usage (msec) avg = %2.2f, max = %2.2f, flags = 0x%x, state = %s, es count = %d, max inactivity time (sec) = %d, ms mismatch = %d, ms create early exit = %d,  ms delete early exit = %d, max preemption time (msec) = %4.2f\n", thread_index, cpu, num_pktmedia_threads, 1.0*cpu_time_sum/max(num_counted, (uint64_t)1)/1000, 1.0*packet_media_thread_info[thread_index].CPU_time_max/1000, packet_media_thread_info[thread_index].uFlags, packet_media_thread_info[thread_index].nEnergySaverState ? "energy save" : "run", packet_media_thread_info[thread_index].energy_saver_state_count, (int)(packet_media_thread_info[thread_index].max_inactivity_time/1000000L), packet_media_thread_info[thread_index].manage_sessions_count_mismatch, packet_media_thread_info[thread_index].manage_sessions_create_early_exit, packet_media_thread_info[thread_index].manage_sessions_delete_early_exit, 1.0*packet_media_thread_info[thread_index].max_elapsed_time_thread_preempt/1000);
+   sprintf(&tmpstr[strlen(tmpstr)], "Debug info for p/m thread %d (CPU %d", thread_index, cpu);
+   if (pm_thread_placement[thread_index].num_cpus > 0) sprintf(&tmpstr[strlen(tmpstr)], ", placed on CPU %d node %d%s", pm_thread_placement[thread_index].cpu, pm_thread_placement[thread_index].node, pm_thread_placement[thread_index].fNumaLocalMem ? " local mem" : "");  /* JHB Oct 2026 */
+
+   sprintf(&tmpstr[strlen(tmpstr)], "), num p/m threads %d, usage (msec) avg = %2.2f, max = %2.2f, flags = 0x%x, state = %s, es count = %d, max inactivity time (sec) = %d, ms mismatch = %d, ms create early exit = %d,  ms delete early exit = %d, max preemption time (msec) = %4.2f\n", num_pktmedia_threads, 1.0*cpu_time_sum/max(num_counted, (uint64_t)1)/1000, 1.0*packet_media_thread_info[thread_index].CPU_time_max/1000, packet_media_thread_info[thread_index].uFlags, packet_media_thread_info[thread_index].nEnergySaverState ? "energy save" : "run", packet_media_thread_info[thread_index].energy_saver_state_count, (int)(packet_media_thread_info[thread_index].max_inactivity_time/1000000L), packet_media_thread_info[thread_index].manage_sessions_count_mismatch, packet_media_thread_info[thread_index].manage_sessions_create_early_exit, packet_media_thread_info[thread_index].manage_sessions_delete_early_exit, 1.0*packet_media_thread_info[thread_index].max_elapsed_time_thread_preempt/1000);
 
    if (packet_media_thread_info[thread_index].fProfilingEnabled) {
 
@@ -7047,7 +7550,9 @@ char tmpstr[8000] = "";
    if (numSessions >= 0) sprintf(sessstr, "numSessions = %d, ", numSessions);
    else strcpy(sessstr, "");  /* this case if called from ThreadAbort() */
    
-   sprintf(&tmpstr[strlen(tmpstr)], "%sthread numSessions = %d, thread numGroups = %d\n", sessstr, packet_media_thread_info[thread_index].numSessions, packet_media_thread_info[thread_index].numGroups);
+   sprintf(&tmpstr[strlen(tmpstr)], "%sthread numSessions = %d, thread numGroups = %d", sessstr, packet_media_thread_info[thread_index].numSessions, packet_media_thread_info[thread_index].numGroups);
+   if (pktlib_gbl_cfg.uThreadLoadBalanceInterval) sprintf(&tmpstr[strlen(tmpstr)], ", sessions migrated in = %d, out = %d", num_sessions_migrated_in[thread_index], num_sessions_migrated_out[thread_index]);  /* JHB Oct 2026 */
+   strcat(tmpstr, "\n");
 
 /* gather group info about sessions in this thread */
 
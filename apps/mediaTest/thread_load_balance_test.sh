@@ -0,0 +1,168 @@
+#!/bin/bash
+
+# thread_load_balance_test.sh
+#
+# Copyright (c) Signalogic, Dallas, 2026
+#
+# Objectives
+#
+#   -stress packet/media thread load balancing (session and stream group migration between p/m threads, see ThreadLoadBalance() and MigrateSessions() in packet_flow_media_proc.c)
+#   -run a mediaMin capacity test with load balancing disabled and enabled, and verify (i) sessions were migrated, (ii) the highest p/m thread load is lower with load balancing enabled, (iii) no migration failures or errors, and (iv) stream group outputs did not lose media due to migration
+#
+# Notes
+#
+#   -mediaTest -Et -tN starts N mediaMin application threads, -nN reuses inputs to increase session count. With more than one application thread mediaMin starts multiple p/m threads. Without DS_MEDIASERVICE_ROUND_ROBIN sessions are assigned to each p/m thread until it fills up, so initial thread loads are uneven, which gives load balancing something to do
+#   -load balancing is enabled by the ENABLE_THREAD_LOAD_BALANCING -dN flag (0x4000000000000, see cmd_line_options_flags.h), which sets uThreadLoadBalanceInterval to 2000 msec. SAMPLE_TIME should allow several intervals
+#   -p/m thread loads are read from ThreadDebugOutput() "usage (msec) avg = X, max = Y" lines, displayed by mediaMin for the selected p/m thread when a digit key (thread index) and 'd' are entered. mediaMin reads keys from a terminal, so each run is done under script(1), which gives mediaTest a pseudo terminal, and keys are sent SAMPLE_TIME sec after start. Console output is saved in each run's output folder (console.txt)
+#   -thread load is the p/m thread loop time moving average at sample time. The test compares the highest thread average between runs; max values include time before the first migration and are shown for information only
+#   -migrations are counted from "MigrateSessions() says p/m thread N migrated M sessions" event log messages
+#   -stream group outputs are compared by size. With load balancing disabled p/m threads are overloaded, so output content can legitimately differ between runs (e.g. frames repaired by stream group timing); an output smaller than its load balancing disabled counterpart by more than OUTPUT_SIZE_TOLERANCE percent indicates media lost during migration
+#   -if no migrations are logged p/m threads were not overloaded; increase NUM_APP_THREADS or NUM_REUSE. This is a test failure, not a pass
+#   -each run is done in its own output folder (mediaTest does not take the mediaMin -g output path option), so outputs and the event log can be compared between runs
+#   -return value is non-zero on failure
+#
+# Revision History
+#   Created Oct 2026
+#   Revised Oct 2026, read p/m thread loads from ThreadDebugOutput() and fail if no sessions are migrated or the highest thread load does not drop. Run without indefinite repeat so outputs are complete, fail if outputs lose media
+#
+# Usage
+#
+#   cd /signalogic_software_installpath/sigsrf_sdk_demo/apps/mediaTest
+#   bash ./thread_load_balance_test.sh
+
+# mediaTest and mediaMin output and event log files
+#   default commands below store outputs and event logs to subfolders on RAM disk or SSD ("/tmp/shared" in the following example, system-dependent replace as needed)
+MEDIATEST_OUTPUTS="/tmp/shared/"
+
+INPUT="$(pwd)/test_files/testaf0824_EVS2EVScall8-tc41_tc90_onlyTC41.2922.0.pcap"
+NUM_APP_THREADS=6
+NUM_REUSE=13
+NUM_REPEATS=1
+MODE_FLAGS=0x6cc11
+ENABLE_THREAD_LOAD_BALANCING=0x4000000000000
+SAMPLE_TIME=20  # sec after start to read p/m thread loads
+MAX_PM_THREADS=10  # mediaMin selects p/m threads for debug output with digit keys 0-9
+OUTPUT_SIZE_TOLERANCE=1  # percent
+
+LB_ON="${MEDIATEST_OUTPUTS}load_balance_on"
+LB_OFF="${MEDIATEST_OUTPUTS}load_balance_off"
+
+num_errors=0
+
+if ! command -v script > /dev/null; then
+   echo "script (util-linux) not found, needed to run mediaTest with a pseudo terminal"
+   exit 1
+fi
+
+send_keys() {  # wait SAMPLE_TIME, then select each p/m thread and display its debug info
+
+   sleep ${SAMPLE_TIME}
+
+   for ((t=0; t<MAX_PM_THREADS; t++)); do
+      printf "$t"; sleep 0.3
+      printf "d"; sleep 0.3
+   done
+}
+
+run_test() {  # $1 = output folder, $2 = -dN flags
+
+   rm -rf $1
+   mkdir -p $1
+
+   (cd $1 && send_keys | script -qfec "mediaTest -cx86 -i${INPUT} -L -d$2 -r20 -Et -t${NUM_APP_THREADS} -n${NUM_REUSE} -R${NUM_REPEATS}" /dev/null > console.txt)
+   ret=$?
+
+   if [ $ret -ne 0 ]; then
+      echo "mediaTest returned $ret (output folder $1)"
+      num_errors=$((num_errors+1))
+   fi
+}
+
+thread_loads() {  # $1 = console output file. Prints number of p/m threads sampled, highest thread avg, highest thread max (msec). If a thread is displayed more than once the last display is used
+
+   grep -a -o "Debug info for p/m thread [0-9]* ([^)]*), num p/m threads [0-9]*, usage (msec) avg = [0-9.]*, max = [0-9.]*" $1 | \
+   sed -E 's/.*p\/m thread ([0-9]+) .*avg = ([0-9.]+), max = ([0-9.]+)/\1 \2 \3/' | \
+   awk '{ avg[$1] = $2; mx[$1] = $3 } END { n = 0; a = 0; m = 0; for (t in avg) { n++; if (avg[t] > a) a = avg[t]; if (mx[t] > m) m = mx[t] } printf "%d %.2f %.2f\n", n, a, m }'
+}
+
+# run without and with load balancing
+
+run_test ${LB_OFF} ${MODE_FLAGS}
+run_test ${LB_ON} $(printf "0x%x" $((MODE_FLAGS | ENABLE_THREAD_LOAD_BALANCING)))
+
+# check event log for migrations and migration failures
+
+EVENT_LOGS=$(ls ${LB_ON}/*event_log*.txt 2>/dev/null)
+
+if [ -z "${EVENT_LOGS}" ]; then
+   echo "no event log found in ${LB_ON}"
+   num_errors=$((num_errors+1))
+else
+   num_migrations=$(cat ${EVENT_LOGS} | grep -c "MigrateSessions() says p/m thread [0-9]* migrated")
+   num_sessions_migrated=$(cat ${EVENT_LOGS} | grep -o "MigrateSessions() says p/m thread [0-9]* migrated [0-9]*" | awk '{ n += $NF } END { print n+0 }')
+   num_cancelled=$(cat ${EVENT_LOGS} | grep -c "MigrateSessions() says p/m thread [0-9]* cancelled")
+   num_failed=$(cat ${EVENT_LOGS} | grep -c "unable to reassign session")
+   num_log_errors=$(cat ${EVENT_LOGS} | grep -c -E "ERROR:|CRITICAL")
+
+   echo "load balancing: ${num_migrations} migration(s), ${num_sessions_migrated} session(s) migrated, ${num_cancelled} cancelled, ${num_failed} failed, ${num_log_errors} event log error(s)"
+
+   if [ ${num_failed} -ne 0 ] || [ ${num_log_errors} -ne 0 ]; then num_errors=$((num_errors+1)); fi
+
+   if [ ${num_migrations} -eq 0 ]; then
+      echo "no sessions migrated, p/m threads not stressed, increase NUM_APP_THREADS or NUM_REUSE"
+      num_errors=$((num_errors+1))
+   fi
+fi
+
+# compare p/m thread loads
+
+read n_off avg_off max_off <<< $(thread_loads ${LB_OFF}/console.txt)
+read n_on avg_on max_on <<< $(thread_loads ${LB_ON}/console.txt)
+
+echo "p/m thread usage (msec), load balancing off: ${n_off} thread(s), highest avg ${avg_off}, highest max ${max_off}"
+echo "p/m thread usage (msec), load balancing on: ${n_on} thread(s), highest avg ${avg_on}, highest max ${max_on}"
+
+if [ ${n_off} -lt 2 ] || [ ${n_on} -lt 2 ]; then
+   echo "p/m thread usage not found for at least two threads, check console.txt in ${LB_OFF} and ${LB_ON}"
+   num_errors=$((num_errors+1))
+elif ! awk -v on=${avg_on} -v off=${avg_off} 'BEGIN { exit !(on < off) }'; then
+   echo "highest p/m thread usage did not drop with load balancing enabled"
+   num_errors=$((num_errors+1))
+fi
+
+# compare stream group outputs (see Notes above)
+
+num_outputs=0
+num_mismatch=0
+
+for f in ${LB_OFF}/*.wav; do
+   [ -e "$f" ] || continue
+   num_outputs=$((num_outputs+1))
+   g=${LB_ON}/$(basename $f)
+   if [ ! -e "$g" ]; then
+      echo "missing output $g"
+      num_errors=$((num_errors+1))
+      continue
+   fi
+   size_off=$(stat -c %s $f)
+   size_on=$(stat -c %s $g)
+   if [ $((size_on*100)) -lt $((size_off*(100-OUTPUT_SIZE_TOLERANCE))) ]; then
+      echo "output $g size ${size_on} is smaller than load balancing off output size ${size_off}"
+      num_errors=$((num_errors+1))
+   fi
+   if [ "$(md5sum < $f)" != "$(md5sum < $g)" ]; then num_mismatch=$((num_mismatch+1)); fi
+done
+
+if [ ${num_outputs} -eq 0 ]; then
+   echo "no stream group outputs found in ${LB_OFF}"
+   num_errors=$((num_errors+1))
+fi
+
+echo "stream group outputs: ${num_outputs} compared, ${num_mismatch} differ in content between load balancing on and off"
+
+if [ ${num_errors} -ne 0 ]; then
+   echo "thread load balance test FAILED, ${num_errors} error(s)"
+   exit 1
+fi
+
+echo "thread load balance test passed"
@@ -28,6 +28,9 @@
    Modified Aug 2023 JHB, add memadd() prototype
    Modified Feb 2024 JHB, add DS_FSCONV_SATURATE flag. If any samples in output of DSConvertFs() will wrap min/max amplitude value, saturate instead
    Modified Dec 2024 JHB, add 64-bit signed integer saturated addition, add DS_FSCONV_DEBUG_SHOW_SATURATION_OCCURRENCES flag
+   Modified Oct 2026 JHB, add DSCreateFsConvState(), DSConvertFsEx(), and DSDeleteFsConvState() APIs and FSCONV_STATE typedef
+   Modified Oct 2026 JHB, add DSAgcEx() API and DS_AGC_xxx flags
+   Modified Oct 2026 JHB, add DS_CONVERTDATA_NORMALIZE flag
 */
 
 #ifndef _ALGLIB_H_
@@ -98,6 +101,20 @@ int DSConvertFs(void* pData,         /* pointer to input and output data (proces
                 unsigned int uFlags  /* flags */
                );
 
+/* per-channel sampling rate conversion state, JHB Oct 2026. Notes:
+
+    -DSCreateFsConvState() selects a filter the same way as DSConvertFs() (or uses pFilt and filt_len if pFilt is non-NULL), pre-calculates polyphase filter coefficients, and allocates delay values. Returns NULL if no filter is defined for the conversion ratio or on error. uFlags may include DS_FSCONV_FLOATING_POINT
+    -DSConvertFsEx() converts data_len samples of one channel in-place, using the state's delay values. For multichannel data pData should point to the channel's first sample and num_chan gives interleave. uFlags may include DS_FSCONV_SATURATE. Returns output data length in samples, or -1 for error conditions
+    -DSDeleteFsConvState() frees the state
+    -create one state per channel. DSConvertFs() uses the same polyphase method, but Ex() APIs avoid per-thread filter setup when a thread converts streams with different ratios
+*/
+
+typedef struct FSCONV_STATE FSCONV_STATE;
+
+FSCONV_STATE* DSCreateFsConvState(int up_factor, int down_factor, void* pFilt, int filt_len, unsigned int uFlags);
+int DSConvertFsEx(FSCONV_STATE* pState, void* pData, int data_len, int num_chan, unsigned int uFlags);
+void DSDeleteFsConvState(FSCONV_STATE* pState);
+
 #define DS_FSCONV_FLOATING_POINT        0x100  /* if the DS_FSCONV_FLOATING_POINT flag is given then input/output data, delay values, and filter coefficient are single precision (32-bit) floating point, otherwise (no flag, which is the defaut) they are integer (16-bit) fixed point. Note - floating-point is in process of being added, JHB Feb2022 */
 #define DS_FSCONV_NO_INTERPOLATE        0x200  /* don't do interpolation (ignore up factor) */
 #define DS_FSCONV_NO_DECIMATE           0x400  /* dont do decimation (ignore down factor) */
@@ -112,6 +129,18 @@ int DSAgc(float x[],     /* input/output array, single-precision float in, short
           const short n  /* array size, in number of elements */
          );
 
+/* DSAgcEx() processes num_chan channels per call, planar or interleaved (DS_AGC_INTERLEAVED flag). mem is a state array of size 2*num_chan, init to zero. Per-channel output is the same as DSAgc(). Returns total number of elements processed, JHB Oct 2026 */
+
+int DSAgcEx(float* x,             /* input/output data, num_chan channels of N samples each */
+            float* mem,           /* per channel memory values array of size 2*num_chan */
+            int N,                /* samples per channel */
+            int num_chan,         /* number of channels */
+            unsigned int uFlags   /* DS_AGC_xxx flags */
+           );
+
+#define DS_AGC_PLANAR                   0  /* default, channels are consecutive blocks of N samples */
+#define DS_AGC_INTERLEAVED              1  /* channels are interleaved */
+
 /* Following APIs require a chnum parameter that specifies a stream group owner */
  
 /*
@@ -156,6 +185,8 @@ int DSConvertDataFormat(void *in, void *out, uint32_t uFlags, int length);
 #define DS_CONVERTDATA_FLOAT             0x04
 #define DS_CONVERTDATA_DOUBLE            0x05
 
+#define DS_CONVERTDATA_NORMALIZE         0x100     /* may be combined with input data type. Short to float output is scaled by 1/32768 (range -1 to 1), float to short input is scaled by 32768. Float to short conversion saturates to SHRT_MIN and SHRT_MAX, JHB Oct 2026 */
+
 /* audio segmentation and strip flags (value of N in -sN mediaTest command line option) */
 
 #define DS_SEGMENT_AUDIO                 0x01      /* segment audio input into intervals based on audio content.  Notes:
@@ -70,6 +70,18 @@
   Modified Aug 2025 JHB, update DSGetTimestamp() flag names
   Modified Aug 2025 JHB, add SetStdoutMode()
   Modified Sep 2025 JHB, move MAX_APP_STR_LEN definition here from mediaMin.h
+  Modified Oct 2026 JHB, add DSPktStatsAddEntriesBatch()
+  Modified Oct 2026 JHB, add DS_PKTSTATS_LOG_PARALLEL flag
+  Modified Oct 2026 JHB, add event_log_async_drops, see DS_EVENT_LOG_ASYNC flag in shared_include/config.h
+  Modified Oct 2026 JHB, add DSFormatBinaryEventLog(), see DS_EVENT_LOG_BINARY flag in shared_include/config.h
+  Modified Oct 2026 JHB, add PKT_STATS_ARENA struct and DSPktStatsArenaXxx() APIs, add DS_PKTSTATS_LOG_ARENA flag
+  Modified Oct 2026 JHB, add THREAD_PLACEMENT struct, DSConfigThreadPlacement(), DSSetThreadPlacement(), and DSGetCpuNumaNode() APIs, see thread_placement.cpp
+  Modified Oct 2026 JHB, remove DSPktStatsAddEntriesBatch()
+  Modified Oct 2026 JHB, add lock and num_group_entries to PKT_STATS_ARENA. DSPktStatsArenaReserve() returns with the arena locked, DSPktStatsArenaCommit() unlocks
+  Modified Oct 2026 JHB, DS_THREAD_PLACEMENT_APP_EXCLUDE_PKTMEDIA_CORES restricts app threads to NUMA node(s) of packet/media thread cores
+  Modified Oct 2026 JHB, packet stats arena spills one block per DSPktStatsArenaReserve() call (see arena notes)
+  Modified Oct 2026 JHB, restore DSPktStatsAddEntriesBatch()
+  Modified Oct 2026 JHB, add num_resets to PKT_STATS_ARENA
 */
 
 #ifndef _DIAGLIB_H_
@@ -83,6 +95,7 @@
 #include <errno.h>
 #include <stdbool.h>
 #include <unistd.h>  /* STDOUT_FILENO */
+#include <pthread.h>  /* PKT_STATS_ARENA lock */
 
 #include "shared_include/config.h"  /* config.h provides DEBUG_CONFIG struct definition used in DSInitLogging() and DSConfigLogging(); only includes Linux headers */
 
@@ -107,6 +120,16 @@ extern const char DIAGLIB_VERSION[256];
 
 int Log_RT(uint32_t loglevel, const char* fmt, ...);
 
+/* DSFormatBinaryEventLog() renders a binary event log, created by Log_RT() when the DS_EVENT_LOG_BINARY flag is set in uEventLogMode (shared_include/config.h), as text in the same format as Log_RT() text event log output. Notes, JHB Oct 2026:
+
+  -szBinaryEventLog is the binary event log path, typically the event log path with ".bin" appended
+  -fp_out is the output file handle, for example stdout or a text event log file
+  -if uFlags includes a log level (uFlags & DS_LOG_LEVEL_MASK), only events with that log level or lower are output. Zero outputs all events
+  -returns number of events output, or -1 for an error condition
+*/
+
+int DSFormatBinaryEventLog(const char* szBinaryEventLog, FILE* fp_out, unsigned int uFlags);
+
 /* Log_RT() configuration flags used by Log_RT() in uEventLogMode field of a DEBUG_CONFIG struct (shared_include/config.h), which is an input param to DSConfigPktlib() and other DSConfigXX APIs. Additional uEventLogMode flags are defined as EVENT_LOG_MODE enums in shared_include/config.h */
 
 #define LOG_CONSOLE           1  
@@ -239,8 +262,53 @@ typedef struct {
 
 int DSPktStatsAddEntries(PKT_STATS* pkt_stats, unsigned int uFlags, int num_pkts, uint8_t* pkt_buffer, int pkt_length[], unsigned int pkt_info[]);
 
+/* DSPktStatsAddEntriesBatch() is the same as DSPktStatsAddEntries() except pkts[] is an array of num_pkts packet pointers, so packets don't need to be consecutive in one buffer. Entries are written to pkt_stats[0..num_pkts-1]. Packet headers are parsed once per packet, so it's inexpensive enough to leave enabled in production, JHB Oct 2026 */
+
+int DSPktStatsAddEntriesBatch(PKT_STATS* pkt_stats, unsigned int uFlags, int num_pkts, uint8_t* pkts[], int pkt_length[], unsigned int pkt_info[]);
+
+/* packet stats arena, used to record packet stats history of unknown length without reallocation, JHB Oct 2026. Notes:
+
+  -entries are stored in fixed size blocks of PKT_STATS_ARENA_BLOCK_LEN entries. Blocks are allocated as needed and never move, so adding entries never copies existing history
+  -max_entries given to DSPktStatsArenaInit() bounds arena memory usage. When all blocks are full, if DS_PKTSTATS_ARENA_SPILL is given in DSPktStatsArenaInit() uFlags, the oldest block is appended to a spill file in binary PKT_STATS format and re-used. One block is written per DSPktStatsArenaReserve() call that needs a new block, so reserve latency is bounded by one block write. Otherwise the oldest block is discarded
+  -if szSpillFile is NULL or empty, an anonymous temporary file is used (see tmpfile()), which is deleted when the arena is reset or freed
+  -to add entries call DSPktStatsArenaReserve() to get a pointer to space for up to num_entries consecutive entries (e.g. for DSPktStatsAddEntries()), then DSPktStatsArenaCommit() with the number actually added. If DSPktStatsArenaReserve() returns non-NULL the arena is locked until DSPktStatsArenaCommit() is called, so DSPktStatsArenaCommit() must always be called, with zero entries if none were added
+  -arena APIs are thread safe; multiple threads can add entries to an arena, and DSPktStatsArenaRead(), DSPktStatsArenaNumEntries(), and DSPktStatsArenaReset() can be called by other threads. DSPktStatsArenaInit() and DSPktStatsArenaFree() are not, the caller must ensure the arena is not in use
+  -DSPktStatsArenaRead() copies all entries, including any in the spill file, oldest first. DSPktStatsWriteLogFile() with DS_PKTSTATS_LOG_ARENA reads entries block by block and from the spill file; if entries have been spilled the temporary array is backed by a temporary file instead of heap memory
+*/
+
+#define PKT_STATS_ARENA_BLOCK_LEN                  65536  /* number of PKT_STATS entries per arena block */
+
+typedef struct {
+
+   PKT_STATS**   blocks;          /* block table, max_blocks entries. Blocks are used as a ring, starting at first_block */
+   uint32_t*     block_len;       /* number of entries in each block */
+   int           max_blocks;      /* zero if arena not initialized */
+   int           first_block;     /* oldest in-memory block */
+   int           num_used_blocks; /* number of in-memory blocks holding entries, the last one is being filled */
+   unsigned int  uFlags;
+   uint64_t      num_entries;     /* total entries added since last reset, including spilled and dropped entries */
+   uint64_t      num_spilled;     /* entries in spill file */
+   uint64_t      num_dropped;     /* entries discarded due to max_entries limit (no spill) */
+   FILE*         fp_spill;
+   char          szSpillFile[256];
+   uint64_t      num_group_entries; /* entries added since last reset with idx >= 0 (stream group member), including spilled and dropped entries */
+   uint32_t      num_resets;      /* incremented by DSPktStatsArenaReset(), lets readers that release the lock detect a reset */
+   pthread_mutex_t lock;
+
+} PKT_STATS_ARENA;
+
+#define DS_PKTSTATS_ARENA_SPILL                        1  /* DSPktStatsArenaInit() uFlags, spill to disk when arena is full */
 
-/* DSFindSSRCGroups() find SSRC groups and returns start/end packet indexes and sequence numbers for each group */
+int DSPktStatsArenaInit(PKT_STATS_ARENA* arena, unsigned int uFlags, uint32_t max_entries, const char* szSpillFile);
+PKT_STATS* DSPktStatsArenaReserve(PKT_STATS_ARENA* arena, int num_entries);  /* returns NULL if num_entries > PKT_STATS_ARENA_BLOCK_LEN, arena not initialized, or block allocation fails. If non-NULL is returned the arena is locked until DSPktStatsArenaCommit() */
+void DSPktStatsArenaCommit(PKT_STATS_ARENA* arena, int num_entries);  /* num_entries may be zero */
+int64_t DSPktStatsArenaRead(PKT_STATS_ARENA* arena, PKT_STATS* pkt_stats, int64_t max_entries);  /* returns number of entries copied to pkt_stats, -1 on spill file read error */
+int64_t DSPktStatsArenaNumEntries(PKT_STATS_ARENA* arena);  /* returns number of entries available to DSPktStatsArenaRead() */
+void DSPktStatsArenaReset(PKT_STATS_ARENA* arena);  /* discard all entries, keep allocated blocks */
+void DSPktStatsArenaFree(PKT_STATS_ARENA* arena);
+
+
+/* DSFindSSRCGroups() find SSRC groups and returns start/end packet indexes and sequence numbers for each group. Return value is number of SSRC groups found, or -1 for an error condition */
 
 int DSFindSSRCGroups(PKT_STATS*, unsigned int uFlags, int num_pkts, uint32_t ssrcs[], uint16_t chnum[], int first_pkt_idx[], int last_pkt_idx[], uint32_t first_rtp_seqnum[], uint32_t last_rtp_seqnum[]);
 
@@ -329,6 +397,8 @@ int DSPktStatsWriteLogFile(const char* szLogFilename, unsigned int uFlags, PKT_S
 #define DS_PKTSTATS_LOG_LIST_ALL_INPUT_PKTS         0x100  /* initially print all input packets with no grouping, ooo detection, or other labeling. This will greatly increase the size of the packet log file, and should only be used for debug situations */
 #define DS_PKTSTATS_LOG_LIST_ALL_PULLED_PKTS        0x200  /* print all buffer output packets,  "  "  */
 #define DS_PKTSTATS_LOG_RFC7198_DEBUG              0x1000
+#define DS_PKTSTATS_LOG_PARALLEL                   0x2000  /* analyze streams (SSRC groups) in parallel using a small pool of worker threads. Log file output is identical to sequential analysis; streams are written in the same order. Recommended for packet logs with many streams, JHB Oct 2026 */
+#define DS_PKTSTATS_LOG_ARENA                      0x4000  /* pInputPkts and pOutputPkts params point to PKT_STATS_ARENA structs instead of PKT_STATS arrays. Arena entries, including any spilled to disk, are read into temporary arrays and num_input_pkts and num_pulled_pkts in PKT_COUNTERS are taken from arena entry counts, JHB Oct 2026 */
 
 /* DSPktStatsWriteLogFile() packet analysis and stats organization flags */
 
@@ -399,6 +469,10 @@ extern uint32_t event_log_critical_errors;
 extern uint32_t event_log_errors;
 extern uint32_t event_log_warnings;
 
+/* cumulative number of Log_RT() event log file strings dropped due to full ring buffer when DS_EVENT_LOG_ASYNC flag is set in uEventLogMode (shared_include/config.h), JHB Oct 2026 */
+
+extern uint32_t event_log_async_drops;
+
 /* useful utilities */
 
 static inline bool isFileDeleted(FILE* fp) {  /* check if file has been deleted, possibly be an external process. Note we cannot use fwrite() or other error codes, we need to look at file descriptor level, JHB Dec 2019 */
@@ -488,6 +562,34 @@ static inline void SetStdoutMode(uint8_t mode) {
 
 #endif  /* defined(__STDC_VERSION__) || defined(__cplusplus) */
 
+/* thread placement APIs, see notes in thread_placement.cpp, JHB Oct 2026:
+
+  -DSConfigThreadPlacement() sets core lists for packet/media threads and app threads, and default DS_THREAD_PLACEMENT_xxx flags. Core lists are comma separated CPUs and CPU ranges (e.g. "2-15,34-47") or a hex bit mask (e.g. "0xfffc"). NULL or empty core list disables placement for that thread type. Returns 1 on success, -1 on error
+  -DSSetThreadPlacement() places the calling thread as thread nThread. If szCoreList is NULL the core list configured for the thread type given in uFlags is used and configured flags are added. Returns 1 if the thread was placed, 0 if no placement is configured, or -1 on error. pPlacement, if not NULL, receives placement info
+  -DSGetCpuNumaNode() returns NUMA node of a CPU, or -1 if not known
+*/
+
+typedef struct {
+
+  int          cpu;            /* CPU the thread is placed on, -1 if not placed */
+  int          node;           /* NUMA node of cpu, -1 if not known */
+  int          num_cpus;       /* number of CPUs in thread affinity mask, 1 unless DS_THREAD_PLACEMENT_NODE_AFFINITY is given */
+  unsigned int uFlags;         /* DS_THREAD_PLACEMENT_xxx flags applied */
+  bool         fNumaLocalMem;  /* true if thread memory policy prefers node, or a p/m thread node for app threads placed off p/m thread nodes (see DS_THREAD_PLACEMENT_APP_EXCLUDE_PKTMEDIA_CORES) */
+
+} THREAD_PLACEMENT;
+
+int DSConfigThreadPlacement(const char* szPktMediaCoreList, const char* szAppCoreList, unsigned int uFlags);
+int DSSetThreadPlacement(int nThread, unsigned int uFlags, const char* szCoreList, THREAD_PLACEMENT* pPlacement);
+int DSGetCpuNumaNode(int cpu);
+
+#define DS_THREAD_PLACEMENT_PKTMEDIA_THREAD                 1  /* DSSetThreadPlacement(): thread is a packet/media thread */
+#define DS_THREAD_PLACEMENT_APP_THREAD                      2  /* DSSetThreadPlacement(): thread is an application thread */
+#define DS_THREAD_PLACEMENT_AVOID_SMT_SIBLINGS              4  /* place threads one per physical core before placing any on SMT (hyperthread) siblings */
+#define DS_THREAD_PLACEMENT_NODE_AFFINITY                   8  /* allow thread to run on all eligible CPUs on the NUMA node of its selected CPU. Default is pinning to the selected CPU */
+#define DS_THREAD_PLACEMENT_NUMA_LOCAL_MEM               0x10  /* set thread memory policy to prefer its NUMA node */
+#define DS_THREAD_PLACEMENT_APP_EXCLUDE_PKTMEDIA_CORES   0x20  /* DSConfigThreadPlacement(): if no app thread core list is given, app threads use CPUs not in the packet/media thread core list on the NUMA node(s) of packet/media thread cores. If those nodes have no free CPUs, app threads use other nodes and with DS_THREAD_PLACEMENT_NUMA_LOCAL_MEM prefer packet/media thread node memory */
+
 /* console output - output string to console, with some optional params. See comments in diaglib_util.cpp */
 
 int console_out(int std_type, int loglevel, bool fNewLine, char* szOutput);
@@ -132,6 +132,11 @@
   Modified Aug 2025 JHB, add uPktNumber param in DSGetPacketInfo()
   Modified Sep 2025 JHB, add LINKTYPE_IEEE802_11 and LINKTYPE_LINUX_SLL2
   Modified Sep 2025 JHB, add support for pcap and pcapng big-endian format files (added IO_TYPE_PCAP_BE and IO_TYPE_PCAPNG_BE input/output types)
+  Modified Oct 2026 JHB, add DS_OPEN_PCAP_MMAP flag, LINK_LAYER_MMAP link layer info flag, and DSReadPcapView() API for memory-mapped zero-copy pcap and pcapng input
+  Modified Oct 2026 JHB, add DS_FIND_PCAP_PACKET_DISABLE_INDEX flag
+  Modified Oct 2026 JHB, add DSConfigPktFragmentation() and DSGetPktFragmentStats() APIs, PKT_FRAGMENT_STATS struct, and DS_PKT_FRAGMENT_STATS_ALL_THREADS flag
+  Modified Oct 2026 JHB, add DSPktFragmentThreadRegister() and DSPktFragmentThreadCleanup() APIs
+  Modified Oct 2026 JHB, DS_SESSION_INFO_THREAD can be set by DSSetSessionInfo() (session migration between p/m threads)
 */
 
 #ifndef _PKTLIB_H_
@@ -360,7 +365,7 @@ extern "C" {
 
   } FORMAT_PKT;
 
-/* struct used for packet fragmentation management linked lists */
+/* struct used for packet fragmentation management lists. Fragments are grouped per datagram in a per-thread hash table (see pktlib_RFC791_fragmentation.cpp), JHB Oct 2026 */
 
   typedef struct PKT_FRAGMENT {
 
@@ -379,7 +384,7 @@ extern "C" {
     uint16_t  ip_hdr_len;       /* IP header length and saved header data (copied from first fragment) */
     uint8_t*  ip_hdr_buf;
 
-    uint16_t  len;              /* fragment length and saved packet data (no IP headers) */
+    uint16_t  len;              /* fragment length and saved packet data (no IP headers). pkt_buf points inside the ip_hdr_buf buffer, following the IP header, JHB Oct 2026 */
     uint8_t*  pkt_buf;
 
     struct PKT_FRAGMENT* next;  /* pointer to next fragment */
@@ -821,6 +826,34 @@ int DSIsReservedUDP(uint16_t port);
 
 int DSPktRemoveFragment(uint8_t* pkt_buf, uint8_t* pFragHdrIPv6, unsigned int uFlags, unsigned int* max_list_fragments);  /* Reserved API: currently undocumented */
 
+/* fragment reassembly config and stats, JHB Oct 2026. Notes:
+
+   -DSConfigPktFragmentation() sets reassembly timeout in msec (zero disables, default is 30000) and number of pooled fragment buffers per thread (default is 1024). Values < 0 are ignored. Pool size applies to threads that have not yet saved a fragment
+   -DSGetPktFragmentStats() fills a PKT_FRAGMENT_STATS struct for the calling thread, or for all threads if DS_PKT_FRAGMENT_STATS_ALL_THREADS is given
+   -DSPktFragmentThreadRegister() registers the calling thread for fragment handling and returns its slot index (or -1 if too many threads). Optional; threads are registered automatically on first fragment
+   -DSPktFragmentThreadCleanup() removes the calling thread's remaining fragments, frees its fragment pool, and releases its slot. Returns number of orphan fragments removed, or -1 if the thread was not registered
+*/
+
+  typedef struct {
+
+     uint32_t  active_fragments;  /* fragments currently saved, waiting for reassembly */
+     uint32_t  active_datagrams;  /* datagrams with at least one saved fragment */
+     uint32_t  max_fragments;     /* max active fragments */
+     uint64_t  total_fragments;   /* total fragments saved */
+     uint64_t  reassembled;       /* datagrams reassembled */
+     uint64_t  timed_out;         /* fragments removed due to reassembly timeout */
+     uint64_t  evicted;           /* fragments removed to make room when the pool is full */
+     uint64_t  pool_overflow;     /* fragment or datagram entries and buffers allocated from heap memory because the pool was full or the fragment was larger than a pool buffer */
+
+  } PKT_FRAGMENT_STATS;
+
+int DSConfigPktFragmentation(unsigned int uFlags, int timeout_msec, int pool_size);
+int DSGetPktFragmentStats(unsigned int uFlags, PKT_FRAGMENT_STATS* pStats);
+int DSPktFragmentThreadRegister(unsigned int uFlags);
+int DSPktFragmentThreadCleanup(unsigned int uFlags);
+
+#define DS_PKT_FRAGMENT_STATS_ALL_THREADS                  1
+
 /* media processing related APIs:
    
     -DSConvertFsPacket() - converts sampling rate from one codec to another, taking into account RTP packet info. Notes:
@@ -1013,10 +1046,12 @@ int DSPktRemoveFragment(uint8_t* pkt_buf, uint8_t* pFragHdrIPv6, unsigned int uF
   #define LINK_LAYER_LINK_TYPE_MASK                 0x0ff00000  /* return value of DSOpenPcap() contains link type in bits 27-20, input type in bits 19-16, and link layer length in lower 16 bits */
   #define LINK_LAYER_IO_TYPE_MASK                     0x0f0000
   #define LINK_LAYER_LEN_MASK                           0xffff
+  #define LINK_LAYER_MMAP                           0x10000000  /* set in DSOpenPcap() return value if the file was opened with DS_OPEN_PCAP_MMAP and successfully memory-mapped */
 
   #define getLinkType(link_layer_info)      (((link_layer_info) & LINK_LAYER_LINK_TYPE_MASK) >> 20)  /* returns a Link Type from a Link Layer Info value. These are Link Layer types for pcap file formats as documented at https://datatracker.ietf.org/doc/draft-ietf-opsawg-pcaplinktype */
   #define getIOType(link_layer_info)        (((link_layer_info) & LINK_LAYER_IO_TYPE_MASK) >> 16)    /* returns an input/output type from a Link Layer Info value */
   #define getLinkLayerLen(link_layer_info)  ((link_layer_info) & LINK_LAYER_LEN_MASK)                /* returns a Link Layer length from a Link Layer Info value (in bytes) */
+  #define isLinkLayerMmap(link_layer_info)  (((link_layer_info) & LINK_LAYER_MMAP) != 0)              /* returns true if a Link Layer Info value indicates a memory-mapped input, i.e. DSReadPcapView() can be used */
 
 /* helper macros for input/output types */
 
@@ -1072,6 +1107,7 @@ int DSPktRemoveFragment(uint8_t* pkt_buf, uint8_t* pFragHdrIPv6, unsigned int uF
   #define DS_OPEN_PCAP_QUIET                            0x0400  /* suppress status and progress messages */
   #define DS_OPEN_PCAP_RESET                            0x1000  /* seek to start of pcap; assumes a valid (already open) file handle given to DSOpenPcap(). Must be combined with DS_OPEN_PCAP_READ, JHB Dec 2021 */
   #define DS_OPEN_PCAP_FILE_HDR_PCAP_FORMAT             0x2000  /* info returned in pcap_file_hdr will be in pcap (libpcap) file format, even if the file being opened is in pcapng format */
+  #define DS_OPEN_PCAP_MMAP                             0x4000  /* memory-map the file for reading. Applies to pcap and pcapng files (ignored for .rtpXXX files). If mapping succeeds LINK_LAYER_MMAP is set in the return value, otherwise a warning is shown and standard file I/O is used. A mapped handle must be closed with DSClosePcap(), and should be read only with DSReadPcap(), DSReadPcapView(), or DSFilterPacket(), JHB Oct 2026 */
 
 /* DSReadPcap() reads one or more pcap records at the current file position of fp_pcap into pkt_buf, and fills in one or more pcaprec_hdr_t structs (see above definition). Notes:
 
@@ -1101,6 +1137,18 @@ int DSPktRemoveFragment(uint8_t* pkt_buf, uint8_t* pFragHdrIPv6, unsigned int uF
   #define DS_READ_PCAP_SUPPRESS_WARNING_ERROR_MSG       DS_PKTLIB_SUPPRESS_WARNING_ERROR_MSG
   #define DS_READ_PCAP_SUPPRESS_INFO_MSG                DS_PKTLIB_SUPPRESS_INFO_MSG
 
+/* DSReadPcapView() is a zero-copy version of DSReadPcap() for files opened with DS_OPEN_PCAP_MMAP. Notes:
+
+   -instead of copying into a caller buffer, *p_pkt_data is set to point at packet data inside the file mapping. The pointer stays valid until DSClosePcap() is called
+   -packet data is writable (the mapping is private copy-on-write) but must not be written beyond the returned length; in-place processing that can grow a packet (e.g. fragment reassembly) should work on a copy
+   -uFlags, pcap_pkt_hdr, link_layer_info, p_eth_protocol, p_block_type, uPktNumber, and szUserMsgString are the same as DSReadPcap(). DS_READ_PCAP_COPY is supported (read position is not advanced)
+   -for non-packet pcapng blocks (IDB, ISB, NRB, etc) *p_pkt_data points to block data; check p_block_type before using
+
+   -return value is the length of the packet, zero if file end has been reached, or < 0 for an error condition (including a handle that is not mapped)
+*/
+
+  int DSReadPcapView(FILE* fp_pcap, unsigned int uFlags, uint8_t** p_pkt_data, pcaprec_hdr_t* pcap_pkt_hdr, int link_layer_info, uint16_t* p_eth_protocol, uint16_t* p_block_type, unsigned int uPktNumber, const char* szUserMsgString);
+
   int DSWritePcap(FILE* fp_pcap, unsigned int uFlags, uint8_t* pkt_buf, int pkt_buf_len, pcaprec_hdr_t* pcap_pkt_hdr, struct ethhdr* p_eth_hdr, pcap_hdr_t* pcap_file_hdr);
 
   #define DS_WRITE_PCAP_SET_TIMESTAMP_WALLCLOCK         0x0100  /* use wall clock to set packet record header timestamp (this is the arrival timestamp in Wireshark) */
@@ -1139,6 +1187,7 @@ int DSPktRemoveFragment(uint8_t* pkt_buf, uint8_t* pFragHdrIPv6, unsigned int uF
   #define DS_FIND_PCAP_PACKET_FIRST_MATCHING            0x1000
   #define DS_FIND_PCAP_PACKET_LAST_MATCHING             0x2000
   #define DS_FIND_PCAP_PACKET_USE_SEEK_OFFSET           0x4000  /* use byte offset instead of record offset. Seek offset gives faster performance but record offset can be useful when the number of records searched prior to a match is needed. Record offset is the default. This flag may be combined with DS_FILTER_PKT_xxx flags and affects the return value of pNumRead in DSFilterPacket() */
+  #define DS_FIND_PCAP_PACKET_DISABLE_INDEX             0x8000  /* by default DSFindPcapPacket() creates a packet index on first call for a pcap (saved in a sidecar file with .pktidx extension, re-created if the pcap changes) and uses it for subsequent searches. This flag specifies a search by reading the pcap instead, JHB Oct 2026 */
 
 /* DSConfigMediaService() -- start the SigSRF media service as a process or some number of packet/media threads. Notes:
 
@@ -1473,7 +1522,7 @@ int DSPktRemoveFragment(uint8_t* pkt_buf, uint8_t* pFragHdrIPv6, unsigned int uF
 #define DS_SESSION_INFO_GROUP_ID                          0x15
 #define DS_SESSION_INFO_GROUP_BUFFER_TIME                 0x16  /* get / set stream group buffer time in msec (affects both merge buffer and sample domain processing buffer sizes. Default is 260 msec, see comments in streamlib.h) */
 #define DS_SESSION_INFO_DELETE_STATUS                     0x17
-#define DS_SESSION_INFO_THREAD                            0x18  /* get index of thread to which session is assigned. Packet/media thread indexes range from 0..MAX_PKTMEDIA_THREADS-1. Index 0 always exists, even if all sessions are static (no dynamic sessions) */
+#define DS_SESSION_INFO_THREAD                            0x18  /* get index of thread to which session is assigned. Packet/media thread indexes range from 0..MAX_PKTMEDIA_THREADS-1. Index 0 always exists, even if all sessions are static (no dynamic sessions). When set with DSSetSessionInfo(), should be combined with setting DS_SESSION_INFO_THREAD_ID, for example when migrating a session between p/m threads (see MigrateSessions() in packet_flow_media_proc.c) */
 #define DS_SESSION_INFO_GROUP_PTIME                       0x19
 #define DS_SESSION_INFO_OUTPUT_BUFFER_INTERVAL            0x1a  /* get buffer output interval of the session */
 #define DS_SESSION_INFO_RTP_PAYLOAD_TYPE                  0x1b
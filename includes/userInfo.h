@@ -42,6 +42,7 @@
    Modified Aug 2025 JHB, add stdout_mode to CmdLineFlags_t struct
    Modified Sep 2025 JHB, add szEventLogPath
    Modified Oct 2025 JHB, add suppress_packet_info_messages to CmdLineFlags_t struct
+   Modified Oct 2026 JHB, add szAppCoreList
 */
 
 #ifndef _USERINFO_H_
@@ -185,6 +186,7 @@ typedef struct UserInterface_t {
    #define   nCut detailsLevel
    #define   nRandomBitErrorPercentage algorithmIdNum
    #define   szEventLogPath szRmtIpAddr               /* mediaMin / mediaTest app --event_log_path cmd line option */
+   #define   szAppCoreList testMode                   /* mediaMin / mediaTest app --app_core_list cmd line option, JHB Oct 2026 */
 
 } UserInterface;
 
@@ -10,10 +10,16 @@
   Revision History:
   
    Created Jul 2018 Jeff Brower
+   Modified Oct 2026 JHB, add DSAgcEx() batched multichannel API, with per-channel state array, planar or interleaved data, and SIMD processing across channels. Per-channel output is bit-exact with DSAgc()
 */
 
+#include <stddef.h>
+#include <stdint.h>
 #include <math.h>
 
+#include "alglib.h"
+#include "alglib_simd.h"  /* SIMD intrinsics and run-time CPU dispatch, JHB Oct 2026 */
+
 /* DSAgc() -- in-place saturation control (form of Automatic Gain Control)
 
   input:   floating-point (single precision) array of size n
@@ -71,6 +77,229 @@ float max = 0, frame_fac = 0;
 }
 
 
+/* DSAgcEx() -- batched version of DSAgc(), processes num_chan channels per call, JHB Oct 2026. Notes:
+
+  -x contains num_chan channels of N samples each, either planar (channel 0 samples, then channel 1 samples, etc) or interleaved if uFlags includes DS_AGC_INTERLEAVED
+  -mem is a state array of 2*num_chan values; mem[2*ch] and mem[2*ch+1] are the same as DSAgc() mem[0] and mem[1] for channel ch
+  -channels are processed in parallel in SIMD lanes (8 channels for AVX2, 4 for SSE2 and NEON), which breaks the per-sample gain update dependency chain in DSAgc(). Peak detection, gain update, gain application, clipping, and rounding do the same single precision operations in the same order as DSAgc(), so per-channel output is bit-exact
+  -remaining channels (num_chan not a multiple of lane count, or no SIMD) are processed one at a time, same as DSAgc()
+  -return value is total number of elements processed (N*num_chan)
+*/
+
+static void agc_channel(float* x, int stride, float* mem, int N) {  /* same as DSAgc(), with sample stride */
+
+int i;
+float fac, prev, tmp;
+float max = 0, frame_fac = 0;
+
+   for (i=0; i<N; i++) if ((tmp = (float)fabs(x[i*stride])) > max) max = tmp;
+
+   if ( max > 30000.0f ) frame_fac = 0.5f - (15000.0f/max);
+
+   fac = mem[0];
+   prev = mem[1];
+
+   for (i=0; i<N; i++) {
+
+      fac = 0.1f*frame_fac + 0.9f*fac;
+
+      tmp = (1.0f - fac)*x[i*stride] - fac*prev;
+      prev = x[i*stride];
+
+      if (tmp > 32767.0f) tmp = 32767.0f;
+      else if (tmp < -32768.0f) tmp = -32768.0f;
+
+      x[i*stride] = (short)floor(tmp + 0.5f);
+   }
+
+   mem[0] = fac;
+   mem[1] = prev;
+}
+
+#if defined(ALGLIB_SIMD_X86)
+
+/* lanes hold one sample from each of 8 (AVX2) or 4 (SSE2) channels. Channel ch sample i is at x[ch*ch_stride + i*samp_stride]. With interleaved data ch_stride is 1 and lanes are contiguous */
+
+__attribute__((target("avx2"))) static void agc_lanes_avx2(float* x, int ch_stride, int samp_stride, float* mem, int N) {
+
+int i, k;
+const __m256 sign_mask = _mm256_set1_ps(-0.0f), vmax_out = _mm256_set1_ps(32767.0f), vmin_out = _mm256_set1_ps(-32768.0f);
+const __m256i vindex = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(ch_stride));
+__m256 max = _mm256_setzero_ps(), frame_fac, fac, prev, cur, tmp;
+float lane[8] __attribute__((aligned(32)));
+
+   #define LOAD_LANES(p) (ch_stride == 1 ? _mm256_loadu_ps(p) : _mm256_i32gather_ps(p, vindex, 4))
+
+   for (i=0; i<N; i++) max = _mm256_max_ps(_mm256_andnot_ps(sign_mask, LOAD_LANES(&x[i*samp_stride])), max);  /* max unchanged if NaN, same as scalar compare */
+
+   _mm256_store_ps(lane, max);
+   for (k=0; k<8; k++) lane[k] = lane[k] > 30000.0f ? 0.5f - (15000.0f/lane[k]) : 0;
+   frame_fac = _mm256_load_ps(lane);
+
+   for (k=0; k<8; k++) lane[k] = mem[2*k];
+   fac = _mm256_load_ps(lane);
+   for (k=0; k<8; k++) lane[k] = mem[2*k+1];
+   prev = _mm256_load_ps(lane);
+
+   const __m256 c01 = _mm256_set1_ps(0.1f), c09 = _mm256_set1_ps(0.9f), c1 = _mm256_set1_ps(1.0f), c05 = _mm256_set1_ps(0.5f);
+   const __m256 ff01 = _mm256_mul_ps(c01, frame_fac);
+
+   for (i=0; i<N; i++) {
+
+      float* p = &x[i*samp_stride];
+
+      fac = _mm256_add_ps(ff01, _mm256_mul_ps(c09, fac));
+
+      cur = LOAD_LANES(p);
+      tmp = _mm256_sub_ps(_mm256_mul_ps(_mm256_sub_ps(c1, fac), cur), _mm256_mul_ps(fac, prev));
+      prev = cur;
+
+      tmp = _mm256_min_ps(_mm256_max_ps(tmp, vmin_out), vmax_out);
+      tmp = _mm256_floor_ps(_mm256_add_ps(tmp, c05));
+
+      if (ch_stride == 1) _mm256_storeu_ps(p, tmp);
+      else { _mm256_store_ps(lane, tmp); for (k=0; k<8; k++) p[k*ch_stride] = lane[k]; }
+   }
+
+   #undef LOAD_LANES
+
+   _mm256_store_ps(lane, fac);
+   for (k=0; k<8; k++) mem[2*k] = lane[k];
+   _mm256_store_ps(lane, prev);
+   for (k=0; k<8; k++) mem[2*k+1] = lane[k];
+}
+
+static void agc_lanes_sse2(float* x, int ch_stride, int samp_stride, float* mem, int N) {
+
+int i, k;
+const __m128 sign_mask = _mm_set1_ps(-0.0f), vmax_out = _mm_set1_ps(32767.0f), vmin_out = _mm_set1_ps(-32768.0f);
+__m128 max = _mm_setzero_ps(), frame_fac, fac, prev, cur, tmp, fl;
+float lane[4] __attribute__((aligned(16)));
+
+   #define LOAD_LANES(p) (ch_stride == 1 ? _mm_loadu_ps(p) : _mm_setr_ps((p)[0], (p)[ch_stride], (p)[2*ch_stride], (p)[3*ch_stride]))
+
+   for (i=0; i<N; i++) max = _mm_max_ps(_mm_andnot_ps(sign_mask, LOAD_LANES(&x[i*samp_stride])), max);
+
+   _mm_store_ps(lane, max);
+   for (k=0; k<4; k++) lane[k] = lane[k] > 30000.0f ? 0.5f - (15000.0f/lane[k]) : 0;
+   frame_fac = _mm_load_ps(lane);
+
+   fac = _mm_setr_ps(mem[0], mem[2], mem[4], mem[6]);
+   prev = _mm_setr_ps(mem[1], mem[3], mem[5], mem[7]);
+
+   const __m128 c01 = _mm_set1_ps(0.1f), c09 = _mm_set1_ps(0.9f), c1 = _mm_set1_ps(1.0f), c05 = _mm_set1_ps(0.5f);
+   const __m128 ff01 = _mm_mul_ps(c01, frame_fac);
+
+   for (i=0; i<N; i++) {
+
+      float* p = &x[i*samp_stride];
+
+      fac = _mm_add_ps(ff01, _mm_mul_ps(c09, fac));
+
+      cur = LOAD_LANES(p);
+      tmp = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(c1, fac), cur), _mm_mul_ps(fac, prev));
+      prev = cur;
+
+      tmp = _mm_add_ps(_mm_min_ps(_mm_max_ps(tmp, vmin_out), vmax_out), c05);
+
+      fl = _mm_cvtepi32_ps(_mm_cvttps_epi32(tmp));  /* floor without SSE4.1: truncate, then subtract 1 where truncation rounded up (negative non-integers) */
+      tmp = _mm_sub_ps(fl, _mm_and_ps(_mm_cmpgt_ps(fl, tmp), c1));
+
+      if (ch_stride == 1) _mm_storeu_ps(p, tmp);
+      else { _mm_store_ps(lane, tmp); for (k=0; k<4; k++) p[k*ch_stride] = lane[k]; }
+   }
+
+   #undef LOAD_LANES
+
+   _mm_store_ps(lane, fac);
+   for (k=0; k<4; k++) mem[2*k] = lane[k];
+   _mm_store_ps(lane, prev);
+   for (k=0; k<4; k++) mem[2*k+1] = lane[k];
+}
+
+#elif defined(ALGLIB_SIMD_NEON) && defined(__aarch64__)
+
+static void agc_lanes_neon(float* x, int ch_stride, int samp_stride, float* mem, int N) {
+
+int i, k;
+float32x4_t max = vdupq_n_f32(0), frame_fac, fac, prev, cur, tmp;
+float lane[4];
+
+   #define LOAD_LANES(p) (ch_stride == 1 ? vld1q_f32(p) : (float32x4_t){ (p)[0], (p)[ch_stride], (p)[2*ch_stride], (p)[3*ch_stride] })
+
+   for (i=0; i<N; i++) {
+      float32x4_t a = vabsq_f32(LOAD_LANES(&x[i*samp_stride]));
+      max = vbslq_f32(vcgtq_f32(a, max), a, max);  /* same as scalar compare, max unchanged if NaN */
+   }
+
+   vst1q_f32(lane, max);
+   for (k=0; k<4; k++) lane[k] = lane[k] > 30000.0f ? 0.5f - (15000.0f/lane[k]) : 0;
+   frame_fac = vld1q_f32(lane);
+
+   fac = (float32x4_t){ mem[0], mem[2], mem[4], mem[6] };
+   prev = (float32x4_t){ mem[1], mem[3], mem[5], mem[7] };
+
+   const float32x4_t ff01 = vmulq_n_f32(frame_fac, 0.1f);
+
+   for (i=0; i<N; i++) {
+
+      float* p = &x[i*samp_stride];
+
+      fac = vaddq_f32(ff01, vmulq_n_f32(fac, 0.9f));  /* separate multiply and add, not vfmaq, to match scalar results */
+
+      cur = LOAD_LANES(p);
+      tmp = vsubq_f32(vmulq_f32(vsubq_f32(vdupq_n_f32(1.0f), fac), cur), vmulq_f32(fac, prev));
+      prev = cur;
+
+      tmp = vminq_f32(vmaxq_f32(tmp, vdupq_n_f32(-32768.0f)), vdupq_n_f32(32767.0f));
+      tmp = vrndmq_f32(vaddq_f32(tmp, vdupq_n_f32(0.5f)));  /* floor */
+
+      if (ch_stride == 1) vst1q_f32(p, tmp);
+      else { vst1q_f32(lane, tmp); for (k=0; k<4; k++) p[k*ch_stride] = lane[k]; }
+   }
+
+   #undef LOAD_LANES
+
+   vst1q_f32(lane, fac);
+   for (k=0; k<4; k++) mem[2*k] = lane[k];
+   vst1q_f32(lane, prev);
+   for (k=0; k<4; k++) mem[2*k+1] = lane[k];
+}
+
+#endif
+
+int DSAgcEx(float* x, float* mem, int N, int num_chan, unsigned int uFlags) {
+
+int ch = 0, ch_stride, samp_stride;
+
+   if (!x || !mem || N < 0 || num_chan < 1) return -1;
+
+   if (uFlags & DS_AGC_INTERLEAVED) { ch_stride = 1; samp_stride = num_chan; }
+   else { ch_stride = N; samp_stride = 1; }
+
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2:
+         for (; ch+8<=num_chan; ch+=8) agc_lanes_avx2(&x[ch*ch_stride], ch_stride, samp_stride, &mem[2*ch], N);
+         /* fall through */
+      case SIMD_SSE2:
+         for (; ch+4<=num_chan; ch+=4) agc_lanes_sse2(&x[ch*ch_stride], ch_stride, samp_stride, &mem[2*ch], N);
+         break;
+   #elif defined(ALGLIB_SIMD_NEON) && defined(__aarch64__)
+      case SIMD_NEON:
+         for (; ch+4<=num_chan; ch+=4) agc_lanes_neon(&x[ch*ch_stride], ch_stride, samp_stride, &mem[2*ch], N);
+         break;
+   #endif
+      default:
+         break;
+   }
+
+   for (; ch<num_chan; ch++) agc_channel(&x[ch*ch_stride], samp_stride, &mem[2*ch], N);  /* remaining channels */
+
+   return N*num_chan;
+}
+
+
 #if 0  /* currently not used, only here for energy calculation reference */
 
 /******************************************************************************
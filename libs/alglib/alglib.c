@@ -21,6 +21,11 @@
    Modified Aug 2023 JHB, add memadd()
    Modified May 2024 JHB, change #ifdef _X86 to #if defined(_X86) || defined(_ARM)
    Modified Dec 2024 JHB, comments only
+   Modified Oct 2026 JHB, add SSE2, AVX2, and NEON versions of memadd() and DSMergeStreamAudioEx() no-scale and scaled merge loops, with run-time CPU dispatch (see alglib_simd.h). Results are bit-exact with scalar code. See SIMD support comments
+   Modified Oct 2026 JHB, fix input vector stride in DSMergeStreamAudioEx() no-scale and scaled loops; with 3 or more vectors "k += j*vec_len" skipped vectors and read past the end of x
+   Modified Oct 2026 JHB, add DSAgcEx() batched multichannel AGC in agc.c, bump version to 1.2.9
+   Modified Oct 2026 JHB, add SIMD versions of isArrayZero(), isArrayLess(), and DSConvertDataFormat() short/float conversions. Remove isArrayZero() inline asm. In DSConvertDataFormat() float to short conversion saturates, add DS_CONVERTDATA_NORMALIZE flag. Version 1.3.0
+   Modified Oct 2026 JHB, DSConvertFs() per-thread polyphase state is heap allocated and keyed on filter checksum for user-defined filters (see fs_conv.c), bump version to 1.3.1
 */
 
 #include <stdlib.h>
@@ -32,10 +37,11 @@
 #include "alias.h"
 #include "alglib.h"
 #include "session.h"
+#include "alglib_simd.h"  /* SIMD intrinsics and run-time CPU dispatch, JHB Oct 2026 */
 
 /* alglib version string */
 
-const char ALGLIB_VERSION[256] = "1.2.6";
+const char ALGLIB_VERSION[256] = "1.3.1";
 
 /* DSMergeStreamAudio()
 
@@ -66,6 +72,222 @@ int DSMergeStreamAudio(unsigned int chnum, int16_t *x1, float x1_scale, int16_t
    return i;
 }
 
+/* SIMD support, JHB Oct 2026. Notes:
+
+   -x86 builds have SSE2 and AVX2 versions of merge kernels, selected at run-time according to CPU support (see get_simd_level()). SSE2 is always available on x86_64. AVX2 functions are compiled with target("avx2") attribute so the Makefile doesn't need -mavx2
+   -ARM builds with NEON support (all aarch64 targets) use NEON versions
+   -results are bit-exact with scalar versions: 16-bit saturating adds use saturating add instructions, multi-vector integer sums are accumulated in 32-bit and saturated on pack, and float mix products and sums are done in the same order as scalar code with separate multiply and add (no fused multiply-add)
+   -uncomment ALGLIB_NO_SIMD in alglib_simd.h for scalar code only (e.g. for comparison / debug)
+*/
+
+#if defined(ALGLIB_SIMD_X86)
+
+__attribute__((target("avx2"))) static int add_sat16_avx2(int16_t* y, const int16_t* x, int len) {
+
+int i;
+
+   for (i=0; i<=len-16; i+=16) _mm256_storeu_si256((__m256i*)&y[i], _mm256_adds_epi16(_mm256_loadu_si256((const __m256i*)&y[i]), _mm256_loadu_si256((const __m256i*)&x[i])));
+
+   return i;
+}
+
+static int add_sat16_sse2(int16_t* y, const int16_t* x, int len) {
+
+int i;
+
+   for (i=0; i<=len-8; i+=8) _mm_storeu_si128((__m128i*)&y[i], _mm_adds_epi16(_mm_loadu_si128((const __m128i*)&y[i]), _mm_loadu_si128((const __m128i*)&x[i])));
+
+   return i;
+}
+
+__attribute__((target("avx2"))) static int sum_sat16_avx2(int16_t* y, const int16_t* x, int num_vec, int vec_len) {
+
+int i, j;
+
+   for (i=0; i<=vec_len-8; i+=8) {
+
+      __m256i acc = _mm256_setzero_si256();
+
+      for (j=0; j<num_vec; j++) acc = _mm256_add_epi32(acc, _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&x[j*vec_len+i])));
+
+      _mm_storeu_si128((__m128i*)&y[i], _mm_packs_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1)));  /* saturating pack is same as scalar clip */
+   }
+
+   return i;
+}
+
+static int sum_sat16_sse2(int16_t* y, const int16_t* x, int num_vec, int vec_len) {
+
+int i, j;
+
+   for (i=0; i<=vec_len-8; i+=8) {
+
+      __m128i acc_lo = _mm_setzero_si128(), acc_hi = _mm_setzero_si128();
+
+      for (j=0; j<num_vec; j++) {
+
+         __m128i v = _mm_loadu_si128((const __m128i*)&x[j*vec_len+i]);
+         __m128i sign = _mm_srai_epi16(v, 15);  /* sign extend 16-bit to 32-bit */
+
+         acc_lo = _mm_add_epi32(acc_lo, _mm_unpacklo_epi16(v, sign));
+         acc_hi = _mm_add_epi32(acc_hi, _mm_unpackhi_epi16(v, sign));
+      }
+
+      _mm_storeu_si128((__m128i*)&y[i], _mm_packs_epi32(acc_lo, acc_hi));
+   }
+
+   return i;
+}
+
+__attribute__((target("avx2"))) static int scale_sum_avx2(int16_t* y, const int16_t* x, const float* scale, int num_vec, int vec_len) {
+
+int i, j;
+const __m256 vmax = _mm256_set1_ps(SHRT_MAX), vmin = _mm256_set1_ps(SHRT_MIN);
+
+   for (i=0; i<=vec_len-8; i+=8) {
+
+      __m256 sum = _mm256_setzero_ps();
+
+      for (j=0; j<num_vec; j++) sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(scale[j]), _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&x[j*vec_len+i])))));
+
+      __m256i v = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(sum, vmin), vmax));  /* clip then truncate, same as clip2short() */
+
+      _mm_storeu_si128((__m128i*)&y[i], _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+   }
+
+   return i;
+}
+
+static int scale_sum_sse2(int16_t* y, const int16_t* x, const float* scale, int num_vec, int vec_len) {
+
+int i, j;
+const __m128 vmax = _mm_set1_ps(SHRT_MAX), vmin = _mm_set1_ps(SHRT_MIN);
+
+   for (i=0; i<=vec_len-8; i+=8) {
+
+      __m128 sum_lo = _mm_setzero_ps(), sum_hi = _mm_setzero_ps();
+
+      for (j=0; j<num_vec; j++) {
+
+         __m128i v = _mm_loadu_si128((const __m128i*)&x[j*vec_len+i]);
+         __m128i sign = _mm_srai_epi16(v, 15);
+         __m128 s = _mm_set1_ps(scale[j]);
+
+         sum_lo = _mm_add_ps(sum_lo, _mm_mul_ps(s, _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, sign))));
+         sum_hi = _mm_add_ps(sum_hi, _mm_mul_ps(s, _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, sign))));
+      }
+
+      __m128i lo = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(sum_lo, vmin), vmax));
+      __m128i hi = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(sum_hi, vmin), vmax));
+
+      _mm_storeu_si128((__m128i*)&y[i], _mm_packs_epi32(lo, hi));
+   }
+
+   return i;
+}
+
+#elif defined(ALGLIB_SIMD_NEON)
+
+static int add_sat16_neon(int16_t* y, const int16_t* x, int len) {
+
+int i;
+
+   for (i=0; i<=len-8; i+=8) vst1q_s16(&y[i], vqaddq_s16(vld1q_s16(&y[i]), vld1q_s16(&x[i])));
+
+   return i;
+}
+
+static int sum_sat16_neon(int16_t* y, const int16_t* x, int num_vec, int vec_len) {
+
+int i, j;
+
+   for (i=0; i<=vec_len-8; i+=8) {
+
+      int32x4_t acc_lo = vdupq_n_s32(0), acc_hi = vdupq_n_s32(0);
+
+      for (j=0; j<num_vec; j++) {
+
+         int16x8_t v = vld1q_s16(&x[j*vec_len+i]);
+
+         acc_lo = vaddw_s16(acc_lo, vget_low_s16(v));
+         acc_hi = vaddw_s16(acc_hi, vget_high_s16(v));
+      }
+
+      vst1q_s16(&y[i], vcombine_s16(vqmovn_s32(acc_lo), vqmovn_s32(acc_hi)));  /* saturating narrow is same as scalar clip */
+   }
+
+   return i;
+}
+
+static int scale_sum_neon(int16_t* y, const int16_t* x, const float* scale, int num_vec, int vec_len) {
+
+int i, j;
+const float32x4_t vmax = vdupq_n_f32(SHRT_MAX), vmin = vdupq_n_f32(SHRT_MIN);
+
+   for (i=0; i<=vec_len-8; i+=8) {
+
+      float32x4_t sum_lo = vdupq_n_f32(0), sum_hi = vdupq_n_f32(0);
+
+      for (j=0; j<num_vec; j++) {
+
+         int16x8_t v = vld1q_s16(&x[j*vec_len+i]);
+
+         sum_lo = vaddq_f32(sum_lo, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale[j]));  /* separate multiply and add, not vfmaq, to match scalar results */
+         sum_hi = vaddq_f32(sum_hi, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale[j]));
+      }
+
+      int32x4_t lo = vcvtq_s32_f32(vminq_f32(vmaxq_f32(sum_lo, vmin), vmax));  /* vcvtq_s32_f32 truncates toward zero */
+      int32x4_t hi = vcvtq_s32_f32(vminq_f32(vmaxq_f32(sum_hi, vmin), vmax));
+
+      vst1q_s16(&y[i], vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+   }
+
+   return i;
+}
+
+#endif
+
+/* SIMD dispatch. Each returns number of samples processed; callers handle any remaining samples with scalar code */
+
+static inline int add_sat16_simd(int16_t* y, const int16_t* x, int len) {  /* y[i] = sat(y[i] + x[i]) */
+
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2: return add_sat16_avx2(y, x, len);
+      case SIMD_SSE2: return add_sat16_sse2(y, x, len);
+   #elif defined(ALGLIB_SIMD_NEON)
+      case SIMD_NEON: return add_sat16_neon(y, x, len);
+   #endif
+      default: return 0;
+   }
+}
+
+static inline int sum_sat16_simd(int16_t* y, const int16_t* x, int num_vec, int vec_len) {  /* y[i] = sat(sum of x[j*vec_len+i]) */
+
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2: return sum_sat16_avx2(y, x, num_vec, vec_len);
+      case SIMD_SSE2: return sum_sat16_sse2(y, x, num_vec, vec_len);
+   #elif defined(ALGLIB_SIMD_NEON)
+      case SIMD_NEON: return sum_sat16_neon(y, x, num_vec, vec_len);
+   #endif
+      default: return 0;
+   }
+}
+
+static inline int scale_sum_simd(int16_t* y, const int16_t* x, const float* scale, int num_vec, int vec_len) {  /* y[i] = clip2short(sum of scale[j]*x[j*vec_len+i]) */
+
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2: return scale_sum_avx2(y, x, scale, num_vec, vec_len);
+      case SIMD_SSE2: return scale_sum_sse2(y, x, scale, num_vec, vec_len);
+   #elif defined(ALGLIB_SIMD_NEON)
+      case SIMD_NEON: return scale_sum_neon(y, x, scale, num_vec, vec_len);
+   #endif
+      default: return 0;
+   }
+}
+
 /* add two 16-bit vector, saturate to 16-bit */
 
 void* memadd(void* dst, const void* src, size_t len) {
@@ -74,7 +296,7 @@ int16_t* y = (int16_t*)dst;
 int16_t* x = (int16_t*)src;
 int i;
 
-   for (i =0; i<(int)len/2; i++) {
+   for (i = add_sat16_simd(y, x, (int)len/2); i<(int)len/2; i++) {  /* SIMD first, then any remaining samples, JHB Oct 2026 */
 
       int32_t sum = (int32_t)x[i] + (int32_t)y[i];
 
@@ -171,9 +393,9 @@ float sf, sf_inc;
 
          memcpy(y, x, vec_len*sizeof(short int));  /* for (i=0; i<vec_len; i++) y[i] = x[i]; */
       }
-      else for (i=0; i<vec_len; i++) {
+      else for (i = sum_sat16_simd(y, x, num_vec, vec_len); i<vec_len; i++) {  /* SIMD first, then any remaining samples. sf is currently not applied (see commented sf* below) so output is the saturated sum and SIMD results are identical, JHB Oct 2026 */
 
-         for (j=0, k=i, sum=0; j<num_vec; j++, k+=j*vec_len) sum += /* sf* */x[k];
+         for (j=0, k=i, sum=0; j<num_vec; j++, k+=vec_len) sum += /* sf* */x[k];  /* fix stride, was k+=j*vec_len, JHB Oct 2026 */
 
       /* Default operation is clipping + high end compression hybrid algorithm.  The main objective is to avoid blocks of consecutive clipped output samples.  Assumptions are (i) clipping is not a major problem in an application that merges uncorrelated signals, 
          and (ii) isolated (single) clips cannot be perceived from surrounding audio (each one just looks like a max output).  Notes, JHB Oct 2019:
@@ -201,9 +423,9 @@ scale_attack:
    }
    else {  /* user-defined scaling (note that in this case num_vec > 1) */
 
-      for (i=0; i<vec_len; i++) {
+      for (i = scale_sum_simd(y, x, scale, num_vec, vec_len); i<vec_len; i++) {  /* SIMD first, then any remaining samples, JHB Oct 2026 */
 
-         for (j=0, k=i, sum=0; j<num_vec; j++, k+=j*vec_len) sum += scale[j]*x[k];
+         for (j=0, k=i, sum=0; j<num_vec; j++, k+=vec_len) sum += scale[j]*x[k];  /* fix stride, was k+=j*vec_len, JHB Oct 2026 */
          y[i] = clip2short(sum);
       }
    }
@@ -214,47 +436,303 @@ scale_attack:
 }
 
 
-/* check if an array is all zero.  Any array of any dimension can be given, as long as len specifies total length in bytes */
+/* SIMD array checks and data format conversions, used by isArrayZero(), isArrayLess(), and DSConvertDataFormat(), JHB Oct 2026. Notes:
 
-int isArrayZero(uint8_t* array, int len) {
+   -array checks return number of elements checked (all zero or all less than threshold), or -1 if a non-zero or not-less element is found
+   -isArrayLess() SIMD versions compare in 16-bit using thresh-1 and 1-thresh, so thresh must be in range 1 to 32768
+   -conversions return number of elements converted. float to short conversions clamp to [SHRT_MIN, SHRT_MAX] before converting with truncation toward zero, same as scalar code. Results are bit-exact with scalar code
+*/
 
-int non_zero = 0;
+#if defined(ALGLIB_SIMD_X86)
 
-#if defined(_X86)
+__attribute__((target("avx2"))) static int zero_check_avx2(const uint8_t* x, int len) {
 
-   __asm__ (
-      "cld\n"
-      "xorb %%al, %%al\n"
-      "repz scasb\n"
-      : "=c" (non_zero)
-      : "c" (len), "D" (array)
-      : "eax", "cc"
-   );
+int i;
 
-#else
+   for (i=0; i<=len-128; i+=128) {
 
-int k;
+      __m256i v = _mm256_or_si256(_mm256_or_si256(_mm256_loadu_si256((const __m256i*)&x[i]), _mm256_loadu_si256((const __m256i*)&x[i+32])),
+                                  _mm256_or_si256(_mm256_loadu_si256((const __m256i*)&x[i+64]), _mm256_loadu_si256((const __m256i*)&x[i+96])));
+
+      if (!_mm256_testz_si256(v, v)) return -1;
+   }
+
+   for (; i<=len-32; i+=32) {
+
+      __m256i v = _mm256_loadu_si256((const __m256i*)&x[i]);
+
+      if (!_mm256_testz_si256(v, v)) return -1;
+   }
+
+   return i;
+}
+
+static int zero_check_sse2(const uint8_t* x, int len) {
+
+int i;
+const __m128i zero = _mm_setzero_si128();
+
+   for (i=0; i<=len-64; i+=64) {
+
+      __m128i v = _mm_or_si128(_mm_or_si128(_mm_loadu_si128((const __m128i*)&x[i]), _mm_loadu_si128((const __m128i*)&x[i+16])),
+                               _mm_or_si128(_mm_loadu_si128((const __m128i*)&x[i+32]), _mm_loadu_si128((const __m128i*)&x[i+48])));
+
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) != 0xffff) return -1;
+   }
+
+   for (; i<=len-16; i+=16) if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)&x[i]), zero)) != 0xffff) return -1;
+
+   return i;
+}
+
+__attribute__((target("avx2"))) static int less_check_avx2(const int16_t* x, int len, int thresh) {
+
+int i;
+const __m256i hi = _mm256_set1_epi16(thresh-1), lo = _mm256_set1_epi16(1-thresh);
+
+   for (i=0; i<=len-16; i+=16) {
 
-   for (k=0; k<len; k++) {
+      __m256i v = _mm256_loadu_si256((const __m256i*)&x[i]);
+      __m256i not_less = _mm256_or_si256(_mm256_cmpgt_epi16(v, hi), _mm256_cmpgt_epi16(lo, v));  /* abs(x) >= thresh */
 
-      if (array[k]) { non_zero = 1; break; }
+      if (!_mm256_testz_si256(not_less, not_less)) return -1;
    }
 
+   return i;
+}
+
+static int less_check_sse2(const int16_t* x, int len, int thresh) {
+
+int i;
+const __m128i hi = _mm_set1_epi16(thresh-1), lo = _mm_set1_epi16(1-thresh);
+
+   for (i=0; i<=len-8; i+=8) {
+
+      __m128i v = _mm_loadu_si128((const __m128i*)&x[i]);
+
+      if (_mm_movemask_epi8(_mm_or_si128(_mm_cmpgt_epi16(v, hi), _mm_cmplt_epi16(v, lo)))) return -1;
+   }
+
+   return i;
+}
+
+__attribute__((target("avx2"))) static int s16_to_f32_avx2(float* y, const int16_t* x, int len, float scale) {
+
+int i;
+const __m256 vscale = _mm256_set1_ps(scale);
+
+   for (i=0; i<=len-8; i+=8) _mm256_storeu_ps(&y[i], _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&x[i]))), vscale));
+
+   return i;
+}
+
+static int s16_to_f32_sse2(float* y, const int16_t* x, int len, float scale) {
+
+int i;
+const __m128 vscale = _mm_set1_ps(scale);
+
+   for (i=0; i<=len-8; i+=8) {
+
+      __m128i v = _mm_loadu_si128((const __m128i*)&x[i]);
+      __m128i sign = _mm_srai_epi16(v, 15);  /* sign extend 16-bit to 32-bit */
+
+      _mm_storeu_ps(&y[i], _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(v, sign)), vscale));
+      _mm_storeu_ps(&y[i+4], _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(v, sign)), vscale));
+   }
+
+   return i;
+}
+
+__attribute__((target("avx2"))) static int f32_to_s16_avx2(int16_t* y, const float* x, int len, float scale) {
+
+int i;
+const __m256 vscale = _mm256_set1_ps(scale), vmax = _mm256_set1_ps(SHRT_MAX), vmin = _mm256_set1_ps(SHRT_MIN);
+
+   for (i=0; i<=len-16; i+=16) {
+
+      __m256i lo = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(&x[i]), vscale), vmin), vmax));
+      __m256i hi = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(&x[i+8]), vscale), vmin), vmax));
+
+      _mm256_storeu_si256((__m256i*)&y[i], _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xd8));  /* packs works within 128-bit lanes, permute restores order */
+   }
+
+   return i;
+}
+
+static int f32_to_s16_sse2(int16_t* y, const float* x, int len, float scale) {
+
+int i;
+const __m128 vscale = _mm_set1_ps(scale), vmax = _mm_set1_ps(SHRT_MAX), vmin = _mm_set1_ps(SHRT_MIN);
+
+   for (i=0; i<=len-8; i+=8) {
+
+      __m128i lo = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(&x[i]), vscale), vmin), vmax));
+      __m128i hi = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(&x[i+4]), vscale), vmin), vmax));
+
+      _mm_storeu_si128((__m128i*)&y[i], _mm_packs_epi32(lo, hi));
+   }
+
+   return i;
+}
+
+#elif defined(ALGLIB_SIMD_NEON)
+
+static int zero_check_neon(const uint8_t* x, int len) {
+
+int i;
+
+   for (i=0; i<=len-64; i+=64) {
+
+      uint64x2_t v = vreinterpretq_u64_u8(vorrq_u8(vorrq_u8(vld1q_u8(&x[i]), vld1q_u8(&x[i+16])), vorrq_u8(vld1q_u8(&x[i+32]), vld1q_u8(&x[i+48]))));
+
+      if (vgetq_lane_u64(v, 0) | vgetq_lane_u64(v, 1)) return -1;
+   }
+
+   for (; i<=len-16; i+=16) {
+
+      uint64x2_t v = vreinterpretq_u64_u8(vld1q_u8(&x[i]));
+
+      if (vgetq_lane_u64(v, 0) | vgetq_lane_u64(v, 1)) return -1;
+   }
+
+   return i;
+}
+
+static int less_check_neon(const int16_t* x, int len, int thresh) {
+
+int i;
+const int16x8_t hi = vdupq_n_s16(thresh-1), lo = vdupq_n_s16(1-thresh);
+
+   for (i=0; i<=len-8; i+=8) {
+
+      int16x8_t v = vld1q_s16(&x[i]);
+      uint64x2_t not_less = vreinterpretq_u64_u16(vorrq_u16(vcgtq_s16(v, hi), vcltq_s16(v, lo)));
+
+      if (vgetq_lane_u64(not_less, 0) | vgetq_lane_u64(not_less, 1)) return -1;
+   }
+
+   return i;
+}
+
+static int s16_to_f32_neon(float* y, const int16_t* x, int len, float scale) {
+
+int i;
+
+   for (i=0; i<=len-8; i+=8) {
+
+      int16x8_t v = vld1q_s16(&x[i]);
+
+      vst1q_f32(&y[i], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+      vst1q_f32(&y[i+4], vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+   }
+
+   return i;
+}
+
+static int f32_to_s16_neon(int16_t* y, const float* x, int len, float scale) {
+
+int i;
+const float32x4_t vmax = vdupq_n_f32(SHRT_MAX), vmin = vdupq_n_f32(SHRT_MIN);
+
+   for (i=0; i<=len-8; i+=8) {
+
+      int32x4_t lo = vcvtq_s32_f32(vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(&x[i]), scale), vmin), vmax));  /* vcvtq_s32_f32 truncates toward zero */
+      int32x4_t hi = vcvtq_s32_f32(vminq_f32(vmaxq_f32(vmulq_n_f32(vld1q_f32(&x[i+4]), scale), vmin), vmax));
+
+      vst1q_s16(&y[i], vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+   }
+
+   return i;
+}
+
 #endif
 
-   return !non_zero;
+static inline int zero_check_simd(const uint8_t* x, int len) {
+
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2: return zero_check_avx2(x, len);
+      case SIMD_SSE2: return zero_check_sse2(x, len);
+   #elif defined(ALGLIB_SIMD_NEON)
+      case SIMD_NEON: return zero_check_neon(x, len);
+   #endif
+      default: return 0;
+   }
 }
 
-int isArrayLess(short int* array, int len, int thresh) {
+static inline int less_check_simd(const int16_t* x, int len, int thresh) {
 
-int not_less = 0, k;
+   if (thresh < 1 || thresh > 32768) return 0;  /* outside range of 16-bit compare, use scalar code */
 
-   for (k=0; k<len; k++) {
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2: return less_check_avx2(x, len, thresh);
+      case SIMD_SSE2: return less_check_sse2(x, len, thresh);
+   #elif defined(ALGLIB_SIMD_NEON)
+      case SIMD_NEON: return less_check_neon(x, len, thresh);
+   #endif
+      default: return 0;
+   }
+}
+
+static inline int s16_to_f32_simd(float* y, const int16_t* x, int len, float scale) {  /* y[i] = x[i]*scale */
 
-      if (abs(array[k]) >= thresh) { not_less = 1; break; }
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2: return s16_to_f32_avx2(y, x, len, scale);
+      case SIMD_SSE2: return s16_to_f32_sse2(y, x, len, scale);
+   #elif defined(ALGLIB_SIMD_NEON)
+      case SIMD_NEON: return s16_to_f32_neon(y, x, len, scale);
+   #endif
+      default: return 0;
    }
+}
+
+static inline int f32_to_s16_simd(int16_t* y, const float* x, int len, float scale) {  /* y[i] = sat(x[i]*scale), truncated */
+
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2: return f32_to_s16_avx2(y, x, len, scale);
+      case SIMD_SSE2: return f32_to_s16_sse2(y, x, len, scale);
+   #elif defined(ALGLIB_SIMD_NEON)
+      case SIMD_NEON: return f32_to_s16_neon(y, x, len, scale);
+   #endif
+      default: return 0;
+   }
+}
+
+static inline int16_t f32_to_s16(float x) {  /* scalar float to short with saturation. Same compare order as SIMD max/min, so NaN converts to SHRT_MIN */
+
+   x = x > SHRT_MIN ? x : SHRT_MIN;
+   x = x < SHRT_MAX ? x : SHRT_MAX;
+
+   return (int16_t)x;
+}
+
+/* check if an array is all zero.  Any array of any dimension can be given, as long as len specifies total length in bytes */
+
+int isArrayZero(uint8_t* array, int len) {
+
+int k;
 
-   return !not_less;
+/* SIMD check, then any remaining bytes, JHB Oct 2026. Replaces "repz scasb" inline asm, which was slow on recent x86 CPUs and reported zero if only the last byte was non-zero (ecx is zero on exit either way) */
+
+   if ((k = zero_check_simd(array, len)) < 0) return 0;
+
+   for (; k<len; k++) if (array[k]) return 0;
+
+   return 1;
+}
+
+int isArrayLess(short int* array, int len, int thresh) {
+
+int k;
+
+   if ((k = less_check_simd(array, len, thresh)) < 0) return 0;  /* SIMD check, then any remaining samples, JHB Oct 2026 */
+
+   for (; k<len; k++) if (abs(array[k]) >= thresh) return 0;
+
+   return 1;
 }
 
 /* scale array */
@@ -298,20 +776,23 @@ int DSConvertDataFormat(void *in, void *out, uint32_t uFlags, int length) {
       return 0;
    }
    
-   switch(uFlags) {
+   float scale = 1.0f;
+   if (uFlags & DS_CONVERTDATA_NORMALIZE) scale = (uFlags & 0xffff & ~DS_CONVERTDATA_NORMALIZE) == DS_CONVERTDATA_SHORT ? 1.0f/32768 : 32768.0f;  /* JHB Oct 2026 */
+
+   switch(uFlags & ~DS_CONVERTDATA_NORMALIZE) {
 
       case DS_CONVERTDATA_SHORT | (DS_CONVERTDATA_FLOAT << 16):
       {
          int i;
-         for (i = 0; i < length; i++)
-            ((float *)out)[i] = ((short *)in)[i];
+         for (i = s16_to_f32_simd((float*)out, (int16_t*)in, length, scale); i < length; i++)  /* SIMD first, then any remaining samples, JHB Oct 2026 */
+            ((float *)out)[i] = ((short *)in)[i]*scale;
          break;
       }
       case DS_CONVERTDATA_FLOAT | (DS_CONVERTDATA_SHORT << 16):
       {
          int i;
-         for (i = 0; i < length; i++)
-            ((short *)out)[i] = ((float *)in)[i];
+         for (i = f32_to_s16_simd((int16_t*)out, (float*)in, length, scale); i < length; i++)  /* saturate, previously out of range values were undefined, JHB Oct 2026 */
+            ((short *)out)[i] = f32_to_s16(((float *)in)[i]*scale);
          break;
       }
       default:
@@ -0,0 +1,407 @@
+/*
+  $Header: /root/Signalogic/DirectCore/lib/alglib/alglib_bench.c
+
+  Description: benchmark for alglib SIMD kernels. Compares SIMD and scalar code paths for speed and bit-exact output. Also times the isArrayZero() "repz scasb" inline asm used before Oct 2026
+
+  Projects: SigSRF, DirectCore
+
+  Copyright Signalogic Inc. 2026
+
+  Use and distribution of this source code is subject to terms and conditions of the Github SigSRF License v1.1, published at https://github.com/signalogic/SigSRF_SDK/blob/master/LICENSE.md. Absolutely prohibited for AI language or programming model training use
+
+  Notes:
+
+   -build with "make bench" in the alglib folder, run with ./alglib_bench [num_iterations]. Default number of iterations is 100000
+   -alglib.c is included directly so the benchmark can force the scalar path by setting simd_level (see alglib_simd.h). Scalar timing uses exactly the code that runs on CPUs with no SIMD support, or with ALGLIB_NO_SIMD defined
+   -each test compares SIMD and scalar outputs over all iterations. Return value is non-zero if any output differs
+   -agc.c is also included. DSAgcEx() output and state are compared with DSAgc() called for each channel. DSAgc() is slow relative to other tests, so AGC tests run num_iterations/10 (minimum 100) iterations
+   -fs_conv.c is also included, with ALGLIB_BENCH defined, so the DSConvertFs() benchmark can force the direct-form method (see fFsConvBenchDirectForm). Direct-form and polyphase outputs and delay values are compared. The direct-form method is slow for large up factors, so DSConvertFs() tests run num_iterations/1000 (minimum 10) iterations
+
+  Revision History:
+
+   Created Oct 2026 JHB
+   Modified Oct 2026 JHB, add isArrayZero(), isArrayLess(), and DSConvertDataFormat() benchmarks
+   Modified Oct 2026 JHB, add DSConvertFs() direct-form vs polyphase benchmark
+   Modified Oct 2026 JHB, add DSAgcEx() vs DSAgc() benchmark
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "alglib.c"
+#include "fs_conv.c"
+#include "agc.c"
+
+int Log_RT(uint32_t loglevel, const char* fmt, ...) { (void)loglevel; (void)fmt; return 0; }  /* fs_conv.c event log messages, not needed here */
+
+static uint64_t bench_nsec(void) {
+
+struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+}
+
+static void fill_random(int16_t* x, int len, int amplitude) {  /* amplitude near SHRT_MAX forces saturation / clipping paths */
+
+int i;
+
+   for (i=0; i<len; i++) x[i] = (int16_t)((rand() % (2*amplitude+1)) - amplitude);
+}
+
+static const char* simd_name(int level) {
+
+   return level == SIMD_AVX2 ? "AVX2" : level == SIMD_SSE2 ? "SSE2" : level == SIMD_NEON ? "NEON" : "none";
+}
+
+static int num_errors = 0;
+
+static void report(const char* szTest, uint64_t scalar_nsec, uint64_t simd_nsec, int num_iterations, bool fMatch) {
+
+   printf("  %-50s scalar %8.3f usec  simd %8.3f usec  speedup %5.2fx  %s \n", szTest, 1e-3*scalar_nsec/num_iterations, 1e-3*simd_nsec/num_iterations, simd_nsec ? 1.0*scalar_nsec/simd_nsec : 0.0, fMatch ? "bit-exact" : "MISMATCH");
+
+   if (!fMatch) num_errors++;
+}
+
+/* memadd() benchmark. Each iteration adds a new input to a copy of the same accumulator, so scalar and SIMD see identical inputs */
+
+static void bench_memadd(int len, int num_iterations, int simd) {
+
+int16_t x[4096], acc[4096], y_scalar[4096], y_simd[4096];
+uint64_t t_scalar = 0, t_simd = 0, t;
+bool fMatch = true;
+char szTest[100];
+int n;
+
+   for (n=0; n<num_iterations; n++) {
+
+      if (n % 1000 == 0) { fill_random(x, len, SHRT_MAX); fill_random(acc, len, SHRT_MAX); }
+
+      memcpy(y_scalar, acc, len*sizeof(int16_t));
+      simd_level = SIMD_NONE;
+      t = bench_nsec(); memadd(y_scalar, x, len*sizeof(int16_t)); t_scalar += bench_nsec() - t;
+
+      memcpy(y_simd, acc, len*sizeof(int16_t));
+      simd_level = simd;
+      t = bench_nsec(); memadd(y_simd, x, len*sizeof(int16_t)); t_simd += bench_nsec() - t;
+
+      if (fMatch && memcmp(y_scalar, y_simd, len*sizeof(int16_t))) fMatch = false;
+   }
+
+   sprintf(szTest, "memadd() %d samples", len);
+   report(szTest, t_scalar, t_simd, num_iterations, fMatch);
+}
+
+/* DSMergeStreamAudioEx() benchmark, no-scale (saturating sum) and user-defined scale paths */
+
+static void bench_merge(int num_vec, int vec_len, bool fScale, int num_iterations, int simd) {
+
+int16_t x[MAX_GROUP_CONTRIBUTORS*1024], y_scalar[1024], y_simd[1024];
+float scale[MAX_GROUP_CONTRIBUTORS];
+uint64_t t_scalar = 0, t_simd = 0, t;
+bool fMatch = true;
+char szTest[100];
+int n, j;
+
+   for (n=0; n<num_iterations; n++) {
+
+      if (n % 1000 == 0) {
+         fill_random(x, num_vec*vec_len, n % 2000 ? SHRT_MAX/num_vec : SHRT_MAX);  /* alternate between no clipping and heavy clipping */
+         for (j=0; j<num_vec; j++) scale[j] = 0.25f + (rand() % 1000)/1000.0f;
+      }
+
+      simd_level = SIMD_NONE;
+      t = bench_nsec(); DSMergeStreamAudioEx(0, num_vec, x, fScale ? scale : NULL, y_scalar, DS_AUDIO_MERGE_ADD, vec_len); t_scalar += bench_nsec() - t;
+
+      simd_level = simd;
+      t = bench_nsec(); DSMergeStreamAudioEx(0, num_vec, x, fScale ? scale : NULL, y_simd, DS_AUDIO_MERGE_ADD, vec_len); t_simd += bench_nsec() - t;
+
+      if (fMatch && memcmp(y_scalar, y_simd, vec_len*sizeof(int16_t))) fMatch = false;
+   }
+
+   sprintf(szTest, "DSMergeStreamAudioEx() %s %d x %d", fScale ? "scaled" : "no-scale", num_vec, vec_len);
+   report(szTest, t_scalar, t_simd, num_iterations, fMatch);
+}
+
+#if defined(_X86)
+static int isArrayZero_asm(uint8_t* array, int len) {  /* isArrayZero() inline asm prior to Oct 2026, for timing comparison only. Note it reports zero if only the last byte is non-zero */
+
+int non_zero = 0;
+
+   __asm__ __volatile__ (
+      "cld\n"
+      "xorb %%al, %%al\n"
+      "repz scasb\n"
+      : "=c" (non_zero), "+D" (array)
+      : "c" (len)
+      : "eax", "cc", "memory"
+   );
+
+   return !non_zero;
+}
+#endif
+
+/* isArrayZero() and isArrayLess() benchmarks. Arrays are all zero / all below threshold, the worst case where every element is checked. A non-zero / not-less element is placed at a random position every 1000 iterations to check early exit results */
+
+static void bench_zero(int len, int num_iterations, int simd) {
+
+uint8_t x[8192];
+uint64_t t_scalar = 0, t_simd = 0, t_asm = 0, t;
+bool fMatch = true;
+char szTest[100];
+int n, ret_scalar, ret_simd;
+
+   memset(x, 0, len);
+
+   for (n=0; n<num_iterations; n++) {
+
+      if (n % 1000 == 999) x[rand() % len] = 1;
+
+      simd_level = SIMD_NONE;
+      t = bench_nsec(); ret_scalar = isArrayZero(x, len); t_scalar += bench_nsec() - t;
+
+      simd_level = simd;
+      t = bench_nsec(); ret_simd = isArrayZero(x, len); t_simd += bench_nsec() - t;
+
+      #if defined(_X86)
+      t = bench_nsec(); isArrayZero_asm(x, len); t_asm += bench_nsec() - t;
+      #endif
+
+      if (ret_scalar != ret_simd) fMatch = false;
+
+      if (n % 1000 == 999) memset(x, 0, len);
+   }
+
+   sprintf(szTest, "isArrayZero() %d bytes", len);
+   report(szTest, t_scalar, t_simd, num_iterations, fMatch);
+
+   #if defined(_X86)
+   printf("  %-50s asm    %8.3f usec \n", "  previous repz scasb", 1e-3*t_asm/num_iterations);
+   #endif
+}
+
+static void bench_less(int len, int thresh, int num_iterations, int simd) {
+
+int16_t x[4096];
+uint64_t t_scalar = 0, t_simd = 0, t;
+bool fMatch = true;
+char szTest[100];
+int n, ret_scalar, ret_simd;
+
+   fill_random(x, len, thresh-1);
+
+   for (n=0; n<num_iterations; n++) {
+
+      int pos = rand() % len;
+      int16_t save = x[pos];
+      if (n % 1000 == 999) x[pos] = rand() & 1 ? -thresh : thresh;
+
+      simd_level = SIMD_NONE;
+      t = bench_nsec(); ret_scalar = isArrayLess(x, len, thresh); t_scalar += bench_nsec() - t;
+
+      simd_level = simd;
+      t = bench_nsec(); ret_simd = isArrayLess(x, len, thresh); t_simd += bench_nsec() - t;
+
+      if (ret_scalar != ret_simd) fMatch = false;
+
+      x[pos] = save;
+   }
+
+   sprintf(szTest, "isArrayLess() %d samples, thresh %d", len, thresh);
+   report(szTest, t_scalar, t_simd, num_iterations, fMatch);
+}
+
+/* DSConvertDataFormat() benchmarks. Float input includes out-of-range values to exercise saturation */
+
+static void bench_convert(int len, bool fToFloat, bool fNormalize, int num_iterations, int simd) {
+
+int16_t s[4096], s_scalar[4096], s_simd[4096];
+float f[4096], f_scalar[4096], f_simd[4096];
+uint64_t t_scalar = 0, t_simd = 0, t;
+bool fMatch = true;
+char szTest[100];
+int n, i;
+uint32_t uFlags = fToFloat ? DS_CONVERTDATA_SHORT | (DS_CONVERTDATA_FLOAT << 16) : DS_CONVERTDATA_FLOAT | (DS_CONVERTDATA_SHORT << 16);
+
+   if (fNormalize) uFlags |= DS_CONVERTDATA_NORMALIZE;
+
+   for (n=0; n<num_iterations; n++) {
+
+      if (n % 1000 == 0) {
+         fill_random(s, len, SHRT_MAX);
+         for (i=0; i<len; i++) f[i] = (fNormalize ? 1.0f/32768 : 1.0f)*(rand() % 80000 - 40000) + (rand() % 1000)/1000.0f;
+      }
+
+      simd_level = SIMD_NONE;
+      t = bench_nsec(); DSConvertDataFormat(fToFloat ? (void*)s : (void*)f, fToFloat ? (void*)f_scalar : (void*)s_scalar, uFlags, len); t_scalar += bench_nsec() - t;
+
+      simd_level = simd;
+      t = bench_nsec(); DSConvertDataFormat(fToFloat ? (void*)s : (void*)f, fToFloat ? (void*)f_simd : (void*)s_simd, uFlags, len); t_simd += bench_nsec() - t;
+
+      if (fMatch && (fToFloat ? memcmp(f_scalar, f_simd, len*sizeof(float)) : memcmp(s_scalar, s_simd, len*sizeof(int16_t)))) fMatch = false;
+   }
+
+   sprintf(szTest, "DSConvertDataFormat() %s %d%s", fToFloat ? "short to float" : "float to short", len, fNormalize ? " normalize" : "");
+   report(szTest, t_scalar, t_simd, num_iterations, fMatch);
+}
+
+/* DSConvertFs() benchmark, direct-form vs polyphase method. Input is a continuous stream; each method keeps its own delay values. Full scale input with DS_FSCONV_SATURATE exercises saturation */
+
+static void bench_fsconv(int up_factor, int down_factor, int data_len, int num_iterations, int simd) {
+
+static int16_t x[MAX_FSCONV_UP_DOWN_FACTOR*MAX_SAMPLES_FRAME], y_direct[MAX_FSCONV_UP_DOWN_FACTOR*MAX_SAMPLES_FRAME], y_poly[MAX_FSCONV_UP_DOWN_FACTOR*MAX_SAMPLES_FRAME];  /* direct-form method needs data_len*up_factor samples */
+int16_t delay_direct[FSCONV_MAX_FILT_LEN] = { 0 }, delay_poly[FSCONV_MAX_FILT_LEN] = { 0 };
+const int16_t* pFilt = NULL;
+const float* pFilt_f = NULL;
+uint64_t t_direct = 0, t_poly = 0, t;
+bool fMatch = true;
+char szTest[100];
+int n, len_direct, len_poly, filt_len = select_filter(up_factor, down_factor, &pFilt, &pFilt_f);
+
+   simd_level = simd;
+
+   for (n=0; n<num_iterations; n++) {
+
+      fill_random(x, data_len, SHRT_MAX);
+
+      memcpy(y_direct, x, data_len*sizeof(int16_t));
+      fFsConvBenchDirectForm = true;
+      t = bench_nsec(); len_direct = DSConvertFs(y_direct, 0, up_factor, down_factor, delay_direct, data_len, 1, NULL, 0, DS_FSCONV_SATURATE); t_direct += bench_nsec() - t;
+
+      memcpy(y_poly, x, data_len*sizeof(int16_t));
+      fFsConvBenchDirectForm = false;
+      t = bench_nsec(); len_poly = DSConvertFs(y_poly, 0, up_factor, down_factor, delay_poly, data_len, 1, NULL, 0, DS_FSCONV_SATURATE); t_poly += bench_nsec() - t;
+
+      if (fMatch && (len_direct != len_poly || memcmp(y_direct, y_poly, len_poly*sizeof(int16_t)) || memcmp(delay_direct, delay_poly, filt_len*sizeof(int16_t)))) fMatch = false;
+   }
+
+   sprintf(szTest, "DSConvertFs() %d:%d %d samples, filt_len %d", up_factor, down_factor, data_len, filt_len);
+   printf("  %-50s direct %8.3f usec  poly %8.3f usec  speedup %5.2fx  %s \n", szTest, 1e-3*t_direct/num_iterations, 1e-3*t_poly/num_iterations, t_poly ? 1.0*t_direct/t_poly : 0.0, fMatch ? "bit-exact" : "MISMATCH");
+
+   if (!fMatch) num_errors++;
+}
+
+/* DSAgcEx() benchmark, compared with DSAgc() called for each channel. State is kept across iterations. Input amplitude alternates between levels that do and don't trigger gain reduction */
+
+static void bench_agc(int num_chan, int N, bool fInterleaved, int num_iterations, int simd) {
+
+static float x[32*1024], y_loop[32*1024], y_batch[32*1024];
+float mem_loop[2*32] = { 0 }, mem_batch[2*32] = { 0 };
+uint64_t t_loop = 0, t_batch = 0, t;
+bool fMatch = true;
+char szTest[100];
+int n, i, ch;
+
+   simd_level = simd;
+
+   for (n=0; n<num_iterations; n++) {
+
+      if (n % 1000 == 0) for (i=0; i<num_chan*N; i++) x[i] = (n % 2000 ? 20000.0f : 45000.0f)*((rand() % 20001) - 10000)/10000.0f;
+
+      memcpy(y_loop, x, num_chan*N*sizeof(float));  /* planar */
+      t = bench_nsec(); for (ch=0; ch<num_chan; ch++) DSAgc(&y_loop[ch*N], &mem_loop[2*ch], N); t_loop += bench_nsec() - t;
+
+      if (fInterleaved) { for (ch=0; ch<num_chan; ch++) for (i=0; i<N; i++) y_batch[i*num_chan + ch] = x[ch*N + i]; }
+      else memcpy(y_batch, x, num_chan*N*sizeof(float));
+
+      t = bench_nsec(); DSAgcEx(y_batch, mem_batch, N, num_chan, fInterleaved ? DS_AGC_INTERLEAVED : DS_AGC_PLANAR); t_batch += bench_nsec() - t;
+
+      if (fMatch) {
+         for (ch=0; ch<num_chan; ch++) for (i=0; i<N; i++) if (y_loop[ch*N + i] != y_batch[fInterleaved ? i*num_chan + ch : ch*N + i]) fMatch = false;
+         if (memcmp(mem_loop, mem_batch, 2*num_chan*sizeof(float))) fMatch = false;
+      }
+   }
+
+   sprintf(szTest, "DSAgcEx() %s %d x %d", fInterleaved ? "interleaved" : "planar", num_chan, N);
+   printf("  %-50s DSAgc() %8.3f usec  DSAgcEx() %8.3f usec  speedup %5.2fx  %s \n", szTest, 1e-3*t_loop/num_iterations, 1e-3*t_batch/num_iterations, t_batch ? 1.0*t_loop/t_batch : 0.0, fMatch ? "bit-exact" : "MISMATCH");
+
+   if (!fMatch) num_errors++;
+}
+
+int main(int argc, char* argv[]) {
+
+int num_iterations = 100000, simd, i;
+const int lens[] = { 160, 320, 960 };  /* 20 msec frames at 8, 16, and 48 kHz */
+const int nvecs[] = { 2, 4, 8 };
+
+   if (argc > 1 && atoi(argv[1]) > 0) num_iterations = atoi(argv[1]);
+
+   srand(1);
+
+   simd = get_simd_level();
+
+   printf("alglib benchmark, alglib version %s, SIMD level %s, %d iterations \n", ALGLIB_VERSION, simd_name(simd), num_iterations);
+
+   if (simd == SIMD_NONE) printf("  no SIMD support in this build, SIMD and scalar timing will be the same \n");
+
+   printf("merge \n");
+
+   for (i=0; i<(int)(sizeof(lens)/sizeof(lens[0])); i++) bench_memadd(lens[i], num_iterations, simd);
+
+   for (i=0; i<(int)(sizeof(nvecs)/sizeof(nvecs[0])); i++) {
+      bench_merge(nvecs[i], 160, false, num_iterations, simd);
+      bench_merge(nvecs[i], 160, true, num_iterations, simd);
+   }
+
+   printf("array checks \n");
+
+   for (i=0; i<(int)(sizeof(lens)/sizeof(lens[0])); i++) bench_zero(2*lens[i], num_iterations, simd);
+   for (i=0; i<(int)(sizeof(lens)/sizeof(lens[0])); i++) bench_less(lens[i], 200, num_iterations, simd);
+   bench_less(320, 32768, num_iterations, simd);
+
+   printf("data format conversion \n");
+
+   for (i=0; i<(int)(sizeof(lens)/sizeof(lens[0])); i++) {
+      bench_convert(lens[i], true, false, num_iterations, simd);
+      bench_convert(lens[i], false, false, num_iterations, simd);
+   }
+   bench_convert(320, true, true, num_iterations, simd);
+   bench_convert(320, false, true, num_iterations, simd);
+
+   printf("AGC \n");
+
+   int num_iterations_agc = max(num_iterations/10, 100);
+
+   bench_agc(16, 160, false, num_iterations_agc, simd);
+   bench_agc(16, 160, true, num_iterations_agc, simd);
+   bench_agc(5, 320, false, num_iterations_agc, simd);  /* channels not a multiple of SIMD lanes */
+   bench_agc(5, 320, true, num_iterations_agc, simd);
+   bench_agc(1, 960, false, num_iterations_agc, simd);
+
+   printf("sampling rate conversion \n");
+
+   int num_iterations_fsconv = max(num_iterations/1000, 10);
+
+   bench_fsconv(2, 1, 160, num_iterations_fsconv, simd);    /* 8 to 16 kHz */
+   bench_fsconv(1, 2, 320, num_iterations_fsconv, simd);    /* 16 to 8 kHz */
+   bench_fsconv(3, 2, 320, num_iterations_fsconv, simd);    /* 16 to 24 kHz */
+   bench_fsconv(1, 6, 960, num_iterations_fsconv, simd);    /* 48 to 8 kHz */
+   bench_fsconv(160, 147, 441, num_iterations_fsconv, simd);  /* 44.1 to 48 kHz */
+   bench_fsconv(147, 160, 480, num_iterations_fsconv, simd);  /* 48 to 44.1 kHz */
+
+   #if defined(ALGLIB_SIMD_X86)
+   if (simd == SIMD_AVX2) {  /* also compare SSE2 kernels on AVX2 capable CPUs */
+
+      printf("SSE2 forced \n");
+
+      bench_memadd(160, num_iterations, SIMD_SSE2);
+      bench_merge(4, 160, false, num_iterations, SIMD_SSE2);
+      bench_merge(4, 160, true, num_iterations, SIMD_SSE2);
+      bench_zero(640, num_iterations, SIMD_SSE2);
+      bench_less(320, 200, num_iterations, SIMD_SSE2);
+      bench_convert(320, true, false, num_iterations, SIMD_SSE2);
+      bench_convert(320, false, false, num_iterations, SIMD_SSE2);
+      bench_agc(16, 160, false, num_iterations_agc, SIMD_SSE2);
+      bench_agc(16, 160, true, num_iterations_agc, SIMD_SSE2);
+      bench_fsconv(1, 6, 960, max(num_iterations/1000, 10), SIMD_SSE2);
+   }
+   #endif
+
+   simd_level = simd;
+
+   if (num_errors) printf("%d test(s) with SIMD / scalar mismatch \n", num_errors);
+
+   return num_errors ? 1 : 0;
+}
@@ -0,0 +1,53 @@
+/*
+  $Header: /root/Signalogic/DirectCore/lib/alglib/alglib_simd.h
+
+  Description: alglib-private SIMD definitions and run-time CPU dispatch, included by alglib.c and fs_conv.c
+
+  Projects: SigSRF, DirectCore
+
+  Copyright Signalogic Inc. 2026
+
+  Use and distribution of this source code is subject to terms and conditions of the Github SigSRF License v1.1, published at https://github.com/signalogic/SigSRF_SDK/blob/master/LICENSE.md. Absolutely prohibited for AI language or programming model training use
+
+  Revision History:
+
+   Created Oct 2026 JHB, moved here from alglib.c
+*/
+
+#ifndef _ALGLIB_SIMD_H_
+#define _ALGLIB_SIMD_H_
+
+//#define ALGLIB_NO_SIMD
+
+#if !defined(ALGLIB_NO_SIMD)
+  #if defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))
+    #define ALGLIB_SIMD_X86
+    #include <immintrin.h>
+  #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define ALGLIB_SIMD_NEON
+    #include <arm_neon.h>
+  #endif
+#endif
+
+enum { SIMD_NONE, SIMD_SSE2, SIMD_AVX2, SIMD_NEON };
+
+static int simd_level = -1;  /* set on first use. Multiple threads may set it concurrently, but always to the same value */
+
+static inline int get_simd_level(void) {
+
+   if (simd_level < 0) {
+
+   #if defined(ALGLIB_SIMD_X86)
+      __builtin_cpu_init();
+      simd_level = __builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_SSE2;
+   #elif defined(ALGLIB_SIMD_NEON)
+      simd_level = SIMD_NEON;
+   #else
+      simd_level = SIMD_NONE;
+   #endif
+   }
+
+   return simd_level;
+}
+
+#endif  /* _ALGLIB_SIMD_H_ */
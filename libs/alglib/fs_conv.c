@@ -31,10 +31,14 @@
    Modified Feb 2024 JHB, implement DS_FSCONV_SATURATE flag. If output of DSConvertFs() will wrap, saturate instead 
    Modified May 2024 JHB, change #ifdef _X86 to #if defined(_X86) || defined(_ARM)
    Modified Dec 2024 JHB, comments only regarding saturated add performance
+   Modified Oct 2026 JHB, add polyphase implementation that calculates only outputs kept after decimation, with SIMD inner products, for fixed-point and DS_FSCONV_FLOATING_POINT data. Fixed-point output is bit-exact with the direct-form method. Add DSCreateFsConvState(), DSConvertFsEx(), and DSDeleteFsConvState() per-channel state APIs. Built-in filter selection moved to select_filter(). See Polyphase implementation notes
+   Modified Oct 2026 JHB, DSConvertFs() per-thread polyphase state is heap allocated (was about 24 KB of thread-local arrays) and freed on thread exit. State is keyed on filter pointer, conversion ratio, filter length, and a checksum of user-defined filter coefficients. Fix saturation debug message argument order
 */
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <limits.h>  /* added to support DS_FSCONV_SATURATE flag, JHB Feb 2024 */
 
 #include "std_rtaf.h"
@@ -42,6 +46,7 @@
 #include "alglib.h"
 #include "voplib.h"
 #include "diaglib.h"
+#include "alglib_simd.h"  /* SIMD intrinsics and run-time CPU dispatch, JHB Oct 2026 */
 
 #ifdef _C66XX
   #include "debug.h"
@@ -131,6 +136,615 @@ Example usage:
   DSConvertFs(&inBuf[i*RTP_NSAMPLES], fs, up_factor, dn_factor, FirDelayBuf, RTP_NSAMPLES, 1)
 */  
 
+/* select a built-in filter based on up_factor and down_factor ratio. Sets both fixed-point and floating-point coefficient pointers, returns filter length, or zero if no filter is defined for the ratio. Split out of DSConvertFs(), JHB Oct 2026 */
+
+static int select_filter(int up_factor, int down_factor, const int16_t** ppFilt, const float** ppFilt_f) {
+
+int filt_len = 0;
+bool fDivisionOfOrByZero = (up_factor == 0 || down_factor == 0);
+
+   *ppFilt = NULL;
+   *ppFilt_f = NULL;
+
+   if (!fDivisionOfOrByZero && up_factor/down_factor == 2) {
+      *ppFilt = fir_filt_up2; *ppFilt_f = fir_filt_up2_float;
+      filt_len = FIR_FILT_UP2_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && up_factor/down_factor == 3) {
+      *ppFilt = fir_filt_up3; *ppFilt_f = fir_filt_up3_float;
+      filt_len = FIR_FILT_UP3_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && up_factor/down_factor == 4) {
+      *ppFilt = fir_filt_up4; *ppFilt_f = fir_filt_up4_float;
+      filt_len = FIR_FILT_UP4_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && up_factor/down_factor == 6) {  /* fDivisionOfOrByZero check was misplaced inside this if block, JHB Oct 2026 */
+      *ppFilt = fir_filt_up6; *ppFilt_f = fir_filt_up6_float;
+      filt_len = FIR_FILT_UP6_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && 2*up_factor/3 == down_factor) {
+      *ppFilt = fir_filt_up1p5; *ppFilt_f = fir_filt_up1p5_float;
+      filt_len = FIR_FILT_UP1P5_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && down_factor/up_factor == 2) {
+      *ppFilt = fir_filt_down2; *ppFilt_f = fir_filt_down2_float;
+      filt_len = FIR_FILT_DOWN2_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && down_factor/up_factor == 3) {
+      *ppFilt = fir_filt_down3; *ppFilt_f = fir_filt_down3_float;
+      filt_len = FIR_FILT_DOWN3_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && down_factor/up_factor == 4) {
+      *ppFilt = fir_filt_down4; *ppFilt_f = fir_filt_down4_float;
+      filt_len = FIR_FILT_DOWN4_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && down_factor/up_factor == 6) {
+      *ppFilt = fir_filt_down6; *ppFilt_f = fir_filt_down6_float;
+      filt_len = FIR_FILT_DOWN6_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && 2*down_factor/3 == up_factor) {
+      *ppFilt = fir_filt_down1p5; *ppFilt_f = fir_filt_down1p5_float;
+      filt_len = FIR_FILT_DOWN1P5_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && up_factor*44100/48000 == down_factor) {  /* 44.1 to 48, 22.05 to 24, 11.025 to 12, etc */
+      *ppFilt = fir_filt_up160_down147; *ppFilt_f = fir_filt_up160_down147_float;
+      filt_len = FIR_FILT_UP160_DOWN147_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && down_factor*44100/48000 == up_factor) {  /* 48 to 44.1, 24 to 22.05, etc */
+      *ppFilt = fir_filt_up147_down160; *ppFilt_f = fir_filt_up147_down160_float;
+      filt_len = FIR_FILT_UP147_DOWN160_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && up_factor*44100/16000 == down_factor) {  /* 44.1 to 16, 22.05 to 8, useful for wideband and narrowband codec testing */
+      *ppFilt = fir_filt_up160_down441; *ppFilt_f = fir_filt_up160_down441_float;
+      filt_len = FIR_FILT_UP160_DOWN441_SIZE;
+   }
+   else if (!fDivisionOfOrByZero && down_factor*44100/16000 == up_factor) {  /* 16 to 44.1, 8 to 22.05, useful for wideband and narrowband codec testing */
+      *ppFilt = fir_filt_up441_down160; *ppFilt_f = fir_filt_up441_down160_float;
+      filt_len = FIR_FILT_UP441_DOWN160_SIZE;
+   }
+
+   return filt_len;
+}
+
+/* Polyphase implementation, JHB Oct 2026. Notes:
+
+   -the direct-form method below (i) replicates each input sample up_factor times, (ii) filters at the up-sampled rate, then (iii) keeps every down_factor-th output. For 44.1 <--> 48 kHz conversion that's 160 filter evaluations per input sample, of which 147 are thrown away, plus a large temp_store[] stack buffer
+   -because interpolation replicates input samples, coefficients that multiply the same input sample can be summed in advance. For each phase p (up-sampled index mod up_factor) this gives a short "combined" filter of at most M = ceil((filt_len-1)/up_factor) + 1 taps applied directly to input samples. Only outputs actually kept after decimation are calculated
+   -combined coefficients are exact integer sums, so fixed-point output is bit-exact with the direct-form method (including DS_FSCONV_SATURATE handling and delay line contents). Outputs that reach back into the delay line are calculated the original way
+   -processing is in-place without a full stack copy. When output is longer than input (up_factor >= down_factor) outputs are calculated last to first, and never overwrite input samples still needed. When output is shorter, outputs are calculated first to last and input samples are copied to a small ring buffer before they can be overwritten
+   -inner products use SIMD (see alglib_simd.h) when combined coefficients fit in 16 bits, which is always the case for down-conversion, and for floating-point data
+   -DS_FSCONV_FLOATING_POINT data uses the same method. Built-in floating-point filters are not yet populated in filt_coeffs.h (all zero), so in that case fixed-point coefficients are scaled by 1/32768
+   -DSConvertFs() keeps combined coefficients for the most recent filter per thread, in a heap allocated state (see get_thread_state()) that is freed on thread exit. The state is keyed on filter pointer, conversion ratio, and filter length, and for user-defined filters also a checksum of the coefficients, so an app that changes coefficients in the same buffer gets updated combined taps. Apps can instead create a per-channel state with DSCreateFsConvState(), which holds combined coefficients and delay values, and call DSConvertFsEx()
+   -the direct-form method is still used for DS_FSCONV_NO_INTERPOLATE, DS_FSCONV_NO_DECIMATE, and DS_FSCONV_NO_FILTER flags, and for user-defined filters longer than FSCONV_MAX_FILT_LEN
+*/
+
+#if defined(_X86) || defined(_ARM)
+
+#include <pthread.h>
+
+#define FSCONV_MAX_FILT_LEN      512   /* max filter length handled by polyphase method */
+#define FSCONV_MAX_PHASE_TAPS   2048   /* max up_factor * M */
+
+struct FSCONV_STATE {
+
+   int             up_factor;
+   int             down_factor;
+   int             filt_len;
+   int             M;           /* combined taps per phase */
+   bool            fFloat;
+   bool            fTaps16;     /* all combined fixed-point taps fit in 16 bits */
+
+   const void*     pFilt_key;   /* identifies filter for per-thread state in DSConvertFs(), together with up_factor, down_factor, filt_len, and filt_sum */
+   uint32_t        filt_sum;    /* checksum of user-defined filter coefficients, zero for built-in filters */
+   int             max_filt_len;  /* allocated lengths of h and h_f, and taps, taps16, and taps_f. Per-thread state is re-allocated only if a filter needs more */
+   int             max_taps;
+
+   int16_t*        h;           /* filter coefficients, fixed-point (NULL for floating-point) */
+   float*          h_f;         /* filter coefficients, floating-point */
+   int32_t*        taps;        /* up_factor * M combined taps, in reverse order within each phase so inner products run forward */
+   int16_t*        taps16;
+   float*          taps_f;
+
+   void*           pDelay;      /* delay values, filt_len int16_t or float. Only used by DSConvertFsEx() */
+};
+
+static pthread_key_t thread_state_key;  /* per-thread state used by DSConvertFs(), see get_thread_state() */
+static pthread_once_t thread_state_once = PTHREAD_ONCE_INIT;
+static bool fThreadStateKey = false;
+
+#ifdef ALGLIB_BENCH
+static bool fFsConvBenchDirectForm = false;  /* set by alglib_bench.c to time the direct-form method */
+#endif
+
+static bool isArrayZeroFloat(const float* x, int len) { for (int i=0; i<len; i++) if (x[i] != 0) return false; return true; }
+
+static bool fits_polyphase(int up_factor, int down_factor, int filt_len) {
+
+   if (up_factor < 1 || down_factor < 1 || filt_len < 1 || filt_len > FSCONV_MAX_FILT_LEN) return false;
+
+   return up_factor * ((filt_len - 2 + up_factor)/up_factor + 1) <= FSCONV_MAX_PHASE_TAPS;
+}
+
+/* allocate state with storage for filter coefficients and up_factor * M combined taps, and optionally delay values */
+
+static FSCONV_STATE* alloc_state(int filt_len, int num_taps, bool fDelay, bool fFloat) {
+
+FSCONV_STATE* pState;
+
+   if (!(pState = (FSCONV_STATE*)calloc(1, sizeof(FSCONV_STATE)))) return NULL;
+
+   pState->h = (int16_t*)calloc(filt_len, sizeof(int16_t));
+   pState->h_f = (float*)calloc(filt_len, sizeof(float));
+   pState->taps = (int32_t*)calloc(num_taps, sizeof(int32_t));
+   pState->taps16 = (int16_t*)calloc(num_taps, sizeof(int16_t));
+   pState->taps_f = (float*)calloc(num_taps, sizeof(float));
+   if (fDelay) pState->pDelay = calloc(filt_len, fFloat ? sizeof(float) : sizeof(int16_t));
+
+   if (!pState->h || !pState->h_f || !pState->taps || !pState->taps16 || !pState->taps_f || (fDelay && !pState->pDelay)) {
+      DSDeleteFsConvState(pState);
+      return NULL;
+   }
+
+   pState->max_filt_len = filt_len;
+   pState->max_taps = num_taps;
+
+   return pState;
+}
+
+/* set up state filter coefficients and combined taps. Caller has already checked fits_polyphase() and allocated h, h_f, taps, taps16, and taps_f */
+
+static void init_state(FSCONV_STATE* pState, int up_factor, int down_factor, const int16_t* pFilt, const float* pFilt_f, int filt_len, bool fFloat) {
+
+int i, m, p, j;
+
+   pState->up_factor = up_factor;
+   pState->down_factor = down_factor;
+   pState->filt_len = filt_len;
+   pState->fFloat = fFloat;
+   pState->M = (filt_len - 2 + up_factor)/up_factor + 1;  /* ceil((filt_len-1)/up_factor) + 1 */
+   pState->fTaps16 = true;
+
+   if (!fFloat) memcpy(pState->h, pFilt, filt_len*sizeof(int16_t));
+   else if (pFilt_f && (!pFilt || !isArrayZeroFloat(pFilt_f, filt_len))) memcpy(pState->h_f, pFilt_f, filt_len*sizeof(float));
+   else for (i=0; i<filt_len; i++) pState->h_f[i] = pFilt[i]/32768.0f;  /* built-in floating-point filter not populated, use fixed-point coefficients */
+
+/* combined taps: for up-sampled index n = up_factor*a + p, coefficient h[j] multiplies input sample a - m, where m = ceil((j-p)/up_factor) */
+
+   for (p=0; p<up_factor; p++) {
+
+      int32_t* taps = &pState->taps[p*pState->M];
+      float* taps_f = &pState->taps_f[p*pState->M];
+
+      for (m=0; m<pState->M; m++) { taps[m] = 0; taps_f[m] = 0; }
+
+      for (j=0; j<filt_len; j++) {
+
+         m = (j - p + up_factor - 1 + up_factor*filt_len)/up_factor - filt_len;  /* ceil((j-p)/up_factor), offset to keep numerator positive */
+         if (m < 0) m = 0;  /* only possible for j < p, which floor to the current input sample */
+
+         if (!fFloat) taps[pState->M-1-m] += pState->h[j];
+         else taps_f[pState->M-1-m] += pState->h_f[j];
+      }
+
+      if (!fFloat) for (m=0; m<pState->M; m++) {
+         if (taps[m] > SHRT_MAX || taps[m] < SHRT_MIN) pState->fTaps16 = false;
+         pState->taps16[p*pState->M + m] = (int16_t)taps[m];
+      }
+   }
+}
+
+/* inner products. dot16() and dot32() accumulate in 64-bit, same as direct-form method */
+
+static inline int64_t dot32(const int16_t* x, const int32_t* h, int n) {
+
+int64_t sum = 0;
+
+   for (int i=0; i<n; i++) sum += (int64_t)x[i] * h[i];
+
+   return sum;
+}
+
+#if defined(ALGLIB_SIMD_X86)
+
+__attribute__((target("avx2"))) static int64_t dot16_avx2(const int16_t* x, const int16_t* h, int n, int* pDone) {
+
+int i;
+__m256i acc = _mm256_setzero_si256();
+
+   for (i=0; i<=n-8; i+=8) {
+
+      __m128i xv = _mm_loadu_si128((const __m128i*)&x[i]), hv = _mm_loadu_si128((const __m128i*)&h[i]);
+      __m128i lo = _mm_mullo_epi16(xv, hv), hi = _mm_mulhi_epi16(xv, hv);  /* exact 32-bit products */
+
+      acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_unpacklo_epi16(lo, hi)));
+      acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_unpackhi_epi16(lo, hi)));
+   }
+
+   __m128i s = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+   *pDone = i;
+
+   return _mm_cvtsi128_si64(s) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(s, s));
+}
+
+static int64_t dot16_sse2(const int16_t* x, const int16_t* h, int n, int* pDone) {
+
+int i;
+__m128i acc = _mm_setzero_si128();
+
+   for (i=0; i<=n-8; i+=8) {
+
+      __m128i xv = _mm_loadu_si128((const __m128i*)&x[i]), hv = _mm_loadu_si128((const __m128i*)&h[i]);
+      __m128i lo = _mm_mullo_epi16(xv, hv), hi = _mm_mulhi_epi16(xv, hv);
+      __m128i p0 = _mm_unpacklo_epi16(lo, hi), p1 = _mm_unpackhi_epi16(lo, hi);
+      __m128i s0 = _mm_srai_epi32(p0, 31), s1 = _mm_srai_epi32(p1, 31);  /* sign extend to 64-bit */
+
+      acc = _mm_add_epi64(acc, _mm_add_epi64(_mm_unpacklo_epi32(p0, s0), _mm_unpackhi_epi32(p0, s0)));
+      acc = _mm_add_epi64(acc, _mm_add_epi64(_mm_unpacklo_epi32(p1, s1), _mm_unpackhi_epi32(p1, s1)));
+   }
+
+   *pDone = i;
+
+   return _mm_cvtsi128_si64(acc) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(acc, acc));
+}
+
+__attribute__((target("avx2"))) static float dotf_avx2(const float* x, const float* h, int n, int* pDone) {
+
+int i;
+__m256 acc = _mm256_setzero_ps();
+
+   for (i=0; i<=n-8; i+=8) acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(&x[i]), _mm256_loadu_ps(&h[i])));
+
+   __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+   s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+   s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+   *pDone = i;
+
+   return _mm_cvtss_f32(s);
+}
+
+static float dotf_sse2(const float* x, const float* h, int n, int* pDone) {
+
+int i;
+__m128 acc = _mm_setzero_ps();
+
+   for (i=0; i<=n-4; i+=4) acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(&x[i]), _mm_loadu_ps(&h[i])));
+
+   acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+   acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+   *pDone = i;
+
+   return _mm_cvtss_f32(acc);
+}
+
+#elif defined(ALGLIB_SIMD_NEON)
+
+static int64_t dot16_neon(const int16_t* x, const int16_t* h, int n, int* pDone) {
+
+int i;
+int64x2_t acc = vdupq_n_s64(0);
+
+   for (i=0; i<=n-8; i+=8) {
+
+      int16x8_t xv = vld1q_s16(&x[i]), hv = vld1q_s16(&h[i]);
+
+      acc = vpadalq_s32(acc, vmull_s16(vget_low_s16(xv), vget_low_s16(hv)));  /* exact 32-bit products, pairwise accumulated in 64-bit */
+      acc = vpadalq_s32(acc, vmull_s16(vget_high_s16(xv), vget_high_s16(hv)));
+   }
+
+   *pDone = i;
+
+   return vgetq_lane_s64(acc, 0) + vgetq_lane_s64(acc, 1);
+}
+
+static float dotf_neon(const float* x, const float* h, int n, int* pDone) {
+
+int i;
+float32x4_t acc = vdupq_n_f32(0);
+
+   for (i=0; i<=n-4; i+=4) acc = vaddq_f32(acc, vmulq_f32(vld1q_f32(&x[i]), vld1q_f32(&h[i])));
+
+   float32x2_t s = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+   *pDone = i;
+
+   return vget_lane_f32(vpadd_f32(s, s), 0);
+}
+
+#endif
+
+static inline int64_t dot16(const int16_t* x, const int16_t* h, int n) {
+
+int64_t sum = 0;
+int i = 0;
+
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2: sum = dot16_avx2(x, h, n, &i); break;
+      case SIMD_SSE2: sum = dot16_sse2(x, h, n, &i); break;
+   #elif defined(ALGLIB_SIMD_NEON)
+      case SIMD_NEON: sum = dot16_neon(x, h, n, &i); break;
+   #endif
+   }
+
+   for (; i<n; i++) sum += x[i] * h[i];
+
+   return sum;
+}
+
+static inline float dotf(const float* x, const float* h, int n) {
+
+float sum = 0;
+int i = 0;
+
+   switch (get_simd_level()) {
+   #if defined(ALGLIB_SIMD_X86)
+      case SIMD_AVX2: sum = dotf_avx2(x, h, n, &i); break;
+      case SIMD_SSE2: sum = dotf_sse2(x, h, n, &i); break;
+   #elif defined(ALGLIB_SIMD_NEON)
+      case SIMD_NEON: sum = dotf_neon(x, h, n, &i); break;
+   #endif
+   }
+
+   for (; i<n; i++) sum += x[i] * h[i];
+
+   return sum;
+}
+
+#define FSCONV_MAX_RING  512  /* ring buffer size, power of 2 >= max M */
+
+/* fixed-point polyphase conversion. Returns output data length */
+
+static int polyphase_int16(FSCONV_STATE* pState, int16_t* pData, int16_t* pDelay, int data_len, int num_chan, unsigned int uFlags) {
+
+int L = pState->filt_len, up = pState->up_factor, down = pState->down_factor, M = pState->M;
+int data_len_up = data_len*up, out_len = data_len_up/down, sav_i = data_len_up - L;
+int i, j, k, n, a, p, R, copied = 0;
+bool fForward = down > up;
+int16_t delay_new[FSCONV_MAX_FILT_LEN];
+int16_t ring[2*FSCONV_MAX_RING];  /* mirrored ring buffer, input samples are written at [i] and [i+R] so any window of length <= R is contiguous */
+int16_t window[FSCONV_MAX_FILT_LEN];
+int64_t sum;
+
+   for (R=8; R<M; R*=2);
+
+/* save new delay line values (most recent filt_len up-sampled input values) before any input is overwritten. If there are fewer than filt_len up-sampled values, older delay values are kept, same as direct-form method */
+
+   if (pDelay) {
+      if (sav_i < 0) memcpy(delay_new, pDelay, L*sizeof(int16_t));
+      for (i = sav_i > 0 ? sav_i : 0; i<data_len_up; i++) delay_new[i - sav_i] = pData[(i/up)*num_chan];
+   }
+
+   for (k = fForward ? 0 : out_len-1; fForward ? k < out_len : k >= 0; k += fForward ? 1 : -1) {
+
+      n = k*down;  /* index in up-sampled data */
+      a = n/up;    /* current input sample */
+      p = n - a*up;
+
+      if (fForward) while (copied <= a) {  /* copy input up to current sample to ring buffer; outputs written so far are at positions < k <= a */
+         int16_t x = pData[copied*num_chan];
+         ring[copied & (R-1)] = x;
+         ring[(copied & (R-1)) + R] = x;
+         copied++;
+      }
+
+      if (n >= L-1 && a >= M-1) {  /* all taps on current input data */
+
+         const int16_t* x;
+
+         if (fForward) x = &ring[(a-M+1) & (R-1)];
+         else if (num_chan == 1) x = &pData[a-M+1];
+         else { for (i=0; i<M; i++) window[i] = pData[(a-M+1+i)*num_chan]; x = window; }
+
+         if (pState->fTaps16) sum = dot16(x, &pState->taps16[p*M], M);
+         else sum = dot32(x, &pState->taps[p*M], M);
+      }
+      else {  /* taps reach into delay line, calculate same as direct-form method */
+
+         for (j=0, sum=0; j<L; j++) {
+
+            int index = n-j, q = index/up;
+
+            if (index >= 0) sum += (fForward ? ring[q & (R-1)] : pData[q*num_chan]) * pState->h[j];
+            else if (pDelay) sum += pDelay[L + index] * pState->h[j];
+         }
+      }
+
+      if (uFlags & DS_FSCONV_SATURATE) {
+
+         uint8_t uSatOccurred = 0;
+
+         if (sum > INT_MAX >> 1) { pData[k*num_chan] = SHRT_MAX; uSatOccurred = 1; }
+         else if (sum < INT_MIN >> 1) { pData[k*num_chan] = SHRT_MIN; uSatOccurred = 2; }
+         else pData[k*num_chan] = sum >> 15;
+
+         if (uSatOccurred && (uFlags & DS_FSCONV_DEBUG_SHOW_SATURATION_OCCURRENCES)) Log_RT(4, "INFO: DSConvertFs() says %s saturation occurred at h[%d] x[%d], uFlags = 0x%x \n", uSatOccurred == 1 ? "max" : "min", L, n, uFlags);
+      }
+      else pData[k*num_chan] = sum >> 15;
+   }
+
+   if (pDelay) memcpy(pDelay, delay_new, L*sizeof(int16_t));
+
+   return out_len;
+}
+
+/* floating-point polyphase conversion. Returns output data length */
+
+static int polyphase_float(FSCONV_STATE* pState, float* pData, float* pDelay, int data_len, int num_chan) {
+
+int L = pState->filt_len, up = pState->up_factor, down = pState->down_factor, M = pState->M;
+int data_len_up = data_len*up, out_len = data_len_up/down, sav_i = data_len_up - L;
+int i, j, k, n, a, p, R, copied = 0;
+bool fForward = down > up;
+float delay_new[FSCONV_MAX_FILT_LEN];
+float ring[2*FSCONV_MAX_RING];
+float window[FSCONV_MAX_FILT_LEN];
+float sum;
+
+   for (R=8; R<M; R*=2);
+
+   if (pDelay) {
+      if (sav_i < 0) memcpy(delay_new, pDelay, L*sizeof(float));
+      for (i = sav_i > 0 ? sav_i : 0; i<data_len_up; i++) delay_new[i - sav_i] = pData[(i/up)*num_chan];
+   }
+
+   for (k = fForward ? 0 : out_len-1; fForward ? k < out_len : k >= 0; k += fForward ? 1 : -1) {
+
+      n = k*down;
+      a = n/up;
+      p = n - a*up;
+
+      if (fForward) while (copied <= a) {
+         float x = pData[copied*num_chan];
+         ring[copied & (R-1)] = x;
+         ring[(copied & (R-1)) + R] = x;
+         copied++;
+      }
+
+      if (n >= L-1 && a >= M-1) {
+
+         const float* x;
+
+         if (fForward) x = &ring[(a-M+1) & (R-1)];
+         else if (num_chan == 1) x = &pData[a-M+1];
+         else { for (i=0; i<M; i++) window[i] = pData[(a-M+1+i)*num_chan]; x = window; }
+
+         sum = dotf(x, &pState->taps_f[p*M], M);
+      }
+      else {
+
+         for (j=0, sum=0; j<L; j++) {
+
+            int index = n-j, q = index/up;
+
+            if (index >= 0) sum += (fForward ? ring[q & (R-1)] : pData[q*num_chan]) * pState->h_f[j];
+            else if (pDelay) sum += pDelay[L + index] * pState->h_f[j];
+         }
+      }
+
+      pData[k*num_chan] = sum;
+   }
+
+   if (pDelay) memcpy(pDelay, delay_new, L*sizeof(float));
+
+   return out_len;
+}
+
+/* per-channel state APIs. See comments in alglib.h */
+
+FSCONV_STATE* DSCreateFsConvState(int up_factor, int down_factor, void* pFilt_user, int filt_len_user, unsigned int uFlags) {
+
+const int16_t* pFilt = NULL;
+const float* pFilt_f = NULL;
+int filt_len;
+bool fFloat = (uFlags & DS_FSCONV_FLOATING_POINT) != 0;
+FSCONV_STATE* pState;
+
+   if (pFilt_user) {
+      if (fFloat) pFilt_f = (const float*)pFilt_user;
+      else pFilt = (const int16_t*)pFilt_user;
+      filt_len = filt_len_user;
+   }
+   else filt_len = select_filter(up_factor, down_factor, &pFilt, &pFilt_f);
+
+   if (!filt_len || (!pFilt && !pFilt_f)) {
+      Log_RT(2, "ERROR: DSCreateFsConvState() says no filter defined for sampling rate conversion ratio %d:%d \n", up_factor, down_factor);
+      return NULL;
+   }
+
+   if (!fits_polyphase(up_factor, down_factor, filt_len)) {
+      Log_RT(2, "ERROR: DSCreateFsConvState() says filter length %d or up factor %d exceeds limits \n", filt_len, up_factor);
+      return NULL;
+   }
+
+   int M = (filt_len - 2 + up_factor)/up_factor + 1;
+
+   if (!(pState = alloc_state(filt_len, up_factor*M, true, fFloat))) return NULL;
+
+   init_state(pState, up_factor, down_factor, pFilt, pFilt_f, filt_len, fFloat);
+
+   return pState;
+}
+
+int DSConvertFsEx(FSCONV_STATE* pState, void* pData, int data_len, int num_chan, unsigned int uFlags) {
+
+   if (!pState || !pData || data_len < 0 || num_chan < 1) return -1;
+
+   if (pState->fFloat) return polyphase_float(pState, (float*)pData, (float*)pState->pDelay, data_len, num_chan);
+   else return polyphase_int16(pState, (int16_t*)pData, (int16_t*)pState->pDelay, data_len, num_chan, uFlags);
+}
+
+void DSDeleteFsConvState(FSCONV_STATE* pState) {
+
+   if (!pState) return;
+
+   if (pState->h) free(pState->h);
+   if (pState->h_f) free(pState->h_f);
+   if (pState->taps) free(pState->taps);
+   if (pState->taps16) free(pState->taps16);
+   if (pState->taps_f) free(pState->taps_f);
+   if (pState->pDelay) free(pState->pDelay);
+
+   free(pState);
+}
+
+static void thread_state_key_create(void) {
+
+   fThreadStateKey = !pthread_key_create(&thread_state_key, (void (*)(void*))DSDeleteFsConvState);  /* per-thread state is freed on thread exit */
+}
+
+static uint32_t filt_checksum(const void* pFilt, int len) {  /* FNV-1a hash of filter coefficient bytes */
+
+const uint8_t* p = (const uint8_t*)pFilt;
+uint32_t sum = 2166136261U;
+
+   for (int i=0; i<len; i++) sum = (sum ^ p[i])*16777619U;
+
+   return sum;
+}
+
+/* get per-thread state for DSConvertFs(). Combined taps are recalculated only if conversion ratio or filter changes. User-defined filter coefficients (fUserFilt true) are checksummed on each call, as an app may change coefficients in the same buffer */
+
+static FSCONV_STATE* get_thread_state(int up_factor, int down_factor, const int16_t* pFilt, const float* pFilt_f, int filt_len, bool fFloat, bool fUserFilt) {
+
+FSCONV_STATE* pState;
+const void* pFilt_key = fFloat ? (const void*)pFilt_f : (const void*)pFilt;
+uint32_t filt_sum;
+int num_taps;
+
+   if (!fits_polyphase(up_factor, down_factor, filt_len)) return NULL;
+
+   #ifdef ALGLIB_BENCH
+   if (fFsConvBenchDirectForm) return NULL;
+   #endif
+
+   pthread_once(&thread_state_once, thread_state_key_create);
+   if (!fThreadStateKey) return NULL;  /* use direct-form method */
+
+   pState = (FSCONV_STATE*)pthread_getspecific(thread_state_key);
+   filt_sum = fUserFilt ? filt_checksum(pFilt_key, filt_len*(fFloat ? sizeof(float) : sizeof(int16_t))) : 0;
+
+   if (pState && pState->pFilt_key == pFilt_key && pState->up_factor == up_factor && pState->down_factor == down_factor && pState->filt_len == filt_len && pState->fFloat == fFloat && pState->filt_sum == filt_sum) return pState;
+
+   num_taps = up_factor*((filt_len - 2 + up_factor)/up_factor + 1);
+
+   if (!pState || pState->max_filt_len < filt_len || pState->max_taps < num_taps) {
+
+      DSDeleteFsConvState(pState);
+      pState = alloc_state(filt_len, num_taps, false, fFloat);
+      pthread_setspecific(thread_state_key, pState);
+
+      if (!pState) return NULL;
+   }
+
+   init_state(pState, up_factor, down_factor, pFilt, pFilt_f, filt_len, fFloat);
+
+   pState->pFilt_key = pFilt_key;
+   pState->filt_sum = filt_sum;
+
+   return pState;
+}
+
+#endif  /* _X86 || _ARM */
+
 #if defined(_X86) || defined(_ARM)
 int DSConvertFs(
 #else
@@ -166,9 +780,14 @@ const float* pFilt_f = NULL;
   #endif
 #endif
 
-int i, j, filt_len;
+int i, j, filt_len = 0;
 int16_t* pData = NULL, *pDelay = NULL;
 float* pData_f = NULL, *pDelay_f = NULL;
+const int16_t* pFilt_sel = NULL;  /* built-in fixed-point filter, also used for floating-point until filt_coeffs.h floating-point filters are populated */
+const float* pFilt_f_sel = NULL;
+#if defined(_X86) || defined(_ARM)
+FSCONV_STATE* pState;
+#endif
 
    if (uFlags & DS_FSCONV_FLOATING_POINT) {
       pData_f = (float*)pData_user;
@@ -179,82 +798,15 @@ float* pData_f = NULL, *pDelay_f = NULL;
       pDelay = (int16_t*)pDelay_user;
    }
 
-   bool fDivisionOfOrByZero = (up_factor == 0 || down_factor == 0);
-
    if (pFilt_user != NULL) {
       if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = (const float*)pFilt_user;
       else pFilt = (int16_t*)pFilt_user;
       filt_len = filt_len_user;
    }
-   else if (!fDivisionOfOrByZero && up_factor/down_factor == 2) {
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_up2_float;
-      else pFilt = fir_filt_up2;
-      filt_len = FIR_FILT_UP2_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && up_factor/down_factor == 3) {
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_up3_float;
-      else pFilt = fir_filt_up3;
-      filt_len = FIR_FILT_UP3_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && up_factor/down_factor == 4) {
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_up4_float;
-      else pFilt = fir_filt_up4;
-      filt_len = FIR_FILT_UP4_SIZE;
-   }
-   else if (up_factor/down_factor == 6) {
-      if (!fDivisionOfOrByZero && uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_up6_float;
-      else pFilt = fir_filt_up6;
-      filt_len = FIR_FILT_UP6_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && 2*up_factor/3 == down_factor) {
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_up1p5_float;
-      else pFilt = fir_filt_up1p5;
-      filt_len = FIR_FILT_UP1P5_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && down_factor/up_factor == 2) {
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_down2_float;
-      else pFilt = fir_filt_down2;
-      filt_len = FIR_FILT_DOWN2_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && down_factor/up_factor == 3) {
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_down3_float;
-      else pFilt = fir_filt_down3;
-      filt_len = FIR_FILT_DOWN3_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && down_factor/up_factor == 4) {
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_down4_float;
-      else pFilt = fir_filt_down4;
-      filt_len = FIR_FILT_DOWN4_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && down_factor/up_factor == 6) {
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_down6_float;
-      else pFilt = fir_filt_down6;
-      filt_len = FIR_FILT_DOWN6_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && 2*down_factor/3 == up_factor) {
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_down1p5_float;
-      else pFilt = fir_filt_down1p5;
-      filt_len = FIR_FILT_DOWN1P5_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && up_factor*44100/48000 == down_factor) {  /* 44.1 to 48, 22.05 to 24, 11.025 to 12, etc */
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_up160_down147_float;
-      else pFilt = fir_filt_up160_down147;
-      filt_len = FIR_FILT_UP160_DOWN147_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && down_factor*44100/48000 == up_factor) {  /* 48 to 44.1, 24 to 22.05, etc */
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_up147_down160_float;
-      else pFilt = fir_filt_up147_down160;
-      filt_len = FIR_FILT_UP147_DOWN160_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && up_factor*44100/16000 == down_factor) {  /* 44.1 to 16, 22.05 to 8, useful for wideband and narrowband codec testing */
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_up160_down441_float;
-      else pFilt = fir_filt_up160_down441;
-      filt_len = FIR_FILT_UP160_DOWN441_SIZE;
-   }
-   else if (!fDivisionOfOrByZero && down_factor*44100/16000 == up_factor) {  /* 16 to 44.1, 8 to 22.05, useful for wideband and narrowband codec testing */
-      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = fir_filt_up441_down160_float;
-      else pFilt = fir_filt_up441_down160;
-      filt_len = FIR_FILT_UP441_DOWN160_SIZE;
+   else {  /* built-in filters, see select_filter() */
+      filt_len = select_filter(up_factor, down_factor, &pFilt_sel, &pFilt_f_sel);
+      if (uFlags & DS_FSCONV_FLOATING_POINT) pFilt_f = pFilt_f_sel;
+      else pFilt = pFilt_sel;
    }
 
    if (!pFilt && up_factor != down_factor && !(uFlags & DS_FSCONV_NO_FILTER)) Log_RT(3, "WARNING: DSConvertFs() says no filter defined for sampling rate conversion ratio %d:%d \n", up_factor, down_factor);  /* apps can avoid this warning by (i) specifing DS_FSCONV_NO_FILTER or (ii) supplying user-defined filter coefficients (pFilt), JHB Mar 2022 */
@@ -282,6 +834,13 @@ float* pData_f = NULL, *pDelay_f = NULL;
          return -1;
       }
 
+   #if defined(_X86) || defined(_ARM)
+      if (pFilt && !(uFlags & (DS_FSCONV_NO_FILTER | DS_FSCONV_NO_INTERPOLATE | DS_FSCONV_NO_DECIMATE)) && (pState = get_thread_state(up_factor, down_factor, pFilt, NULL, filt_len, false, pFilt_user != NULL))) {
+
+         return polyphase_int16(pState, pData, pDelay, data_len, num_chan, uFlags);  /* polyphase method, see comments above, JHB Oct 2026 */
+      }
+   #endif
+
    /* interpolation */
 
       if (up_factor > 1 && !(uFlags & DS_FSCONV_NO_INTERPOLATE)) {
@@ -385,8 +944,6 @@ float* pData_f = NULL, *pDelay_f = NULL;
    }
    else {  /* floating-point implementation */
 
-      (void)pDelay_f;
-
    /* make sure pointers are valid before continuing */
 
       if (pData_f == NULL) {
@@ -398,6 +955,15 @@ float* pData_f = NULL, *pDelay_f = NULL;
          Log_RT(2, "ERROR: DSConvertFs() says no floating-point filter specified, up_factor = %d, down_factor = %d \n", up_factor, down_factor);
          return -1;
       }
+
+   #if defined(_X86) || defined(_ARM)
+      if (pFilt_f && !(uFlags & (DS_FSCONV_NO_FILTER | DS_FSCONV_NO_INTERPOLATE | DS_FSCONV_NO_DECIMATE)) && (pState = get_thread_state(up_factor, down_factor, pFilt_sel, pFilt_f, filt_len, true, pFilt_user != NULL))) {
+
+         return polyphase_float(pState, pData_f, pDelay_f, data_len, num_chan);  /* floating-point uses polyphase method only, JHB Oct 2026 */
+      }
+   #else
+      (void)pDelay_f;
+   #endif
    }
 
 #if defined(_X86) || defined(_ARM)
@@ -85,6 +85,16 @@
   Modified May 2025 JHB, remove "DTX" packet labeling which was based only on payload size. No assumptions should be based only on payload size, we need to go by DS_PKT_PYLD_CONTENT_XXX flags only
   Modified Aug 2025 JHB, fix bug where all media packet types were not checked for repair flag
   Modified Aug 2025 JHB, add uPktNumber param to DSGetPacketInfo() calls per mod in pktlib.h
+  Modified Oct 2026 JHB, in DSPktStatsAddEntries() get all packet items with one DSGetPacketInfo() DS_PKT_INFO_PKTINFO call (see add_entry()), fix pkt_stats increment for num_pkts > 1, add DSPktStatsAddEntriesBatch()
+  Modified Oct 2026 JHB, in DSFindSSRCGroups() use hash table for SSRC lookup and stable counting sort for stream collation, instead of linear search and memmove() collation. Previous method is still used if hash table or scratch buffer allocation fails. Fix seq_wrap[] overflow with more than 128 SSRCs
+  Modified Oct 2026 JHB, move per SSRC group analysis in DSPktStatsLogSeqnums() to log_ssrc_seqnums(), implement DS_PKTSTATS_LOG_PARALLEL flag to analyze SSRC groups with a worker thread pool (see log_ssrc_seqnums_parallel()). Fix seq_wrap[] and max_consec_missing[] overflow in DSPktStatsLogSeqnums() with more than 128 SSRCs
+  Modified Oct 2026 JHB, add DSPktStatsArenaXxx() APIs (chunked, bounded packet stats history storage with optional spill to disk), implement DS_PKTSTATS_LOG_ARENA flag in DSPktStatsWriteLogFile()
+  Modified Oct 2026 JHB, in add_entry() use PKTINFO RTP items only for UDP packets with RTP version 2, otherwise use per-item DSGetPacketInfo() calls as before. Remove DSPktStatsAddEntriesBatch(), it had no callers; DSPktStatsAddEntries() with num_pkts > 1 is the batched form
+  Modified Oct 2026 JHB, DSFindSSRCGroups() returns -1 if seq_wrap[] allocation fails (was 0), DSPktStatsLogSeqnums() and DSPktStatsWriteLogFile() propagate the error. Add PKTSTATS_BENCH hook used by pktstats_bench.cpp
+  Modified Oct 2026 JHB, arena_spill() writes only the oldest block per DSPktStatsArenaReserve() call instead of all in-memory blocks, to bound time spent holding arena->lock
+  Modified Oct 2026 JHB, lock packet stats arenas (see PKT_STATS_ARENA lock in diaglib.h). Reset, read, and entry count no longer race with reserve/commit and spill file writes. arena_gather() uses a temporary file mapping instead of a heap array if entries have been spilled, spill file is read in chunks. Commit counts stream group entries (num_group_entries)
+  Modified Oct 2026 JHB, restore DSPktStatsAddEntriesBatch(), now used by packet/media threads to add input and pulled packet stats with one arena reserve per batch
+  Modified Oct 2026 JHB, arena_gather() holds arena->lock only to take entry and spill counts and to copy in-memory entries, spilled entries are read without the lock (see arena_read_spill()). DSPktStatsArenaReset() increments num_resets
 */
 
 /* Linux includes */
@@ -92,6 +102,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>  /* gettimeofday() */
+#include <unistd.h>    /* sysconf() */
+#include <pthread.h>
+#include <sys/mman.h>  /* mmap() */
 #include <algorithm>   /* std::min and std::max */
 
 using namespace std;
@@ -124,6 +137,56 @@ extern LOGGING_THREAD_INFO Logging_Thread_Info[];
 
 #define DS_PKT_PYLD_CONTENT_DTMF_END  1  /* DTMF Event End, determined in DSPktStatsAddEntries and then passed thru to other functions, JHB Jun 2019 */
 
+/* add one packet stats entry. All items are taken from one DSGetPacketInfo() DS_PKT_INFO_PKTINFO call, which parses IP/UDP/RTP headers once, instead of one call per item (up to 6 calls per packet). PKTINFO RTP items are undefined for non-RTP packets, so they are used only for UDP packets with RTP version 2. Otherwise, or if PKTINFO parsing fails, we fall back to per-item calls, which preserves previous return values (e.g. per-item errors for non-RTP packets). Return value is packet length, JHB Oct 2026 */
+
+static inline int add_entry(PKT_STATS* pkt_stats, unsigned int uFlags, uint8_t* pkt, int len, unsigned int* pkt_info) {
+
+PKTINFO PktInfo;
+
+/* note we are not applying DS_PKTLIB_SUPPRESS_XXX flags here, as we assume caller is providing already-error-checked packets */
+
+   PktInfo.protocol = 0;
+   PktInfo.rtp_version = 0;  /* RTP items may not be filled in, see comments above */
+
+   if (DSGetPacketInfo(-1, DS_PKT_INFO_PKTINFO | uFlags, pkt, len, &PktInfo, NULL, 0) >= 0 && PktInfo.protocol == UDP && PktInfo.rtp_version == 2 && PktInfo.rtp_pyld_ofs > 0 && PktInfo.rtp_pyld_len >= 0 && PktInfo.rtp_pyld_ofs + PktInfo.rtp_pyld_len <= PktInfo.pkt_len) {
+
+      pkt_stats->rtp_seqnum = PktInfo.rtp_seqnum;
+      pkt_stats->rtp_timestamp = PktInfo.rtp_timestamp;
+      pkt_stats->rtp_ssrc = PktInfo.rtp_ssrc;
+      pkt_stats->rtp_pyldlen = PktInfo.rtp_pyld_len;
+
+      if (pkt_info) {
+
+         pkt_stats->content_flags = *pkt_info;
+         if ((pkt_stats->content_flags & DS_PKT_PYLD_CONTENT_ITEM_MASK) == DS_PKT_PYLD_CONTENT_DTMF && (pkt[PktInfo.rtp_pyld_ofs + 1] & 0x80)) pkt_stats->content_flags |= DS_PKT_PYLD_CONTENT_DTMF_END;
+      }
+
+      if (len <= 0) len = PktInfo.pkt_len;
+   }
+   else {
+
+      pkt_stats->rtp_seqnum = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_SEQNUM | uFlags, pkt, len, NULL, NULL, 0);
+      pkt_stats->rtp_timestamp = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_TIMESTAMP | uFlags, pkt, len, NULL, NULL, 0);
+      pkt_stats->rtp_ssrc = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_SSRC | uFlags, pkt, len, NULL, NULL, 0);
+      pkt_stats->rtp_pyldlen = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_PYLDLEN | uFlags, pkt, len, NULL, NULL, 0);
+
+      if (pkt_info) {
+
+         pkt_stats->content_flags = *pkt_info;
+
+         if ((pkt_stats->content_flags & DS_PKT_PYLD_CONTENT_ITEM_MASK) == DS_PKT_PYLD_CONTENT_DTMF) {
+
+            unsigned int rtp_pyld_ofs = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_PYLDOFS | uFlags, pkt, len, NULL, NULL, 0);
+            if (pkt[rtp_pyld_ofs + 1] & 0x80) pkt_stats->content_flags |= DS_PKT_PYLD_CONTENT_DTMF_END;
+         }
+      }
+
+      if (len <= 0) len = DSGetPacketInfo(-1, DS_PKT_INFO_PKTLEN | uFlags, pkt, -1, NULL, NULL, 0);
+   }
+
+   return len;
+}
+
 int DSPktStatsAddEntries(PKT_STATS* pkt_stats, unsigned int uFlags, int num_pkts, uint8_t* pkt_buffer, int pkt_length[], unsigned int pkt_info[]) {
 
 int j, len;
@@ -138,32 +201,388 @@ unsigned int offset = 0;
       if (!pkt_length || pkt_length[j] <= 0) len = -1;
       else len = pkt_length[j];
 
-   /* note we are not applying DS_PKTLIB_SUPPRESS_XXX flags here, as we assume caller is providing already-error-checked packets */
+      len = add_entry(pkt_stats, uFlags, pkt_buffer + offset, len, pkt_info ? &pkt_info[j] : NULL);  /* single-pass header parse, JHB Oct 2026 */
 
-      pkt_stats->rtp_seqnum = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_SEQNUM | uFlags, pkt_buffer + offset, len, NULL, NULL, 0);
-      pkt_stats->rtp_timestamp = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_TIMESTAMP | uFlags, pkt_buffer + offset, len, NULL, NULL, 0);
-      pkt_stats->rtp_ssrc = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_SSRC | uFlags, pkt_buffer + offset, len, NULL, NULL, 0);
-      pkt_stats->rtp_pyldlen = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_PYLDLEN | uFlags, pkt_buffer + offset, len, NULL, NULL, 0);
+      offset += max(0, len);
 
-      if (pkt_info) {
+      pkt_stats++;  /* was pkt_stats += sizeof(PKT_STATS), which skipped entries for num_pkts > 1, JHB Oct 2026 */
+   }
 
-         pkt_stats->content_flags = pkt_info[j];
+   return j;  /* return number of entries added */
+}
 
-         if ((pkt_stats->content_flags & DS_PKT_PYLD_CONTENT_ITEM_MASK) == DS_PKT_PYLD_CONTENT_DTMF) {
+/* batched version of DSPktStatsAddEntries(), takes an array of packet pointers instead of consecutive packets in one buffer, for example packets held by a p/m thread and added to a packet stats arena with one DSPktStatsArenaReserve() per batch. Entries are written to pkt_stats[0..num_pkts-1], JHB Oct 2026 */
 
-            unsigned int rtp_pyld_ofs = DSGetPacketInfo(-1, DS_PKT_INFO_RTP_PYLDOFS | uFlags, pkt_buffer + offset, len, NULL, NULL, 0);
-            if (pkt_buffer[offset + rtp_pyld_ofs + 1] & 0x80) pkt_stats->content_flags |= DS_PKT_PYLD_CONTENT_DTMF_END;
-         }
+int DSPktStatsAddEntriesBatch(PKT_STATS* pkt_stats, unsigned int uFlags, int num_pkts, uint8_t* pkts[], int pkt_length[], unsigned int pkt_info[]) {
+
+int j;
+
+   if (!DSGetPacketInfo) return -2;
+
+   if (!pkt_stats || !pkts) return -1;
+
+   for (j=0; j<num_pkts; j++) {
+
+      if (j+1 < num_pkts) __builtin_prefetch(pkts[j+1]);  /* next packet headers */
+
+      add_entry(&pkt_stats[j], uFlags, pkts[j], pkt_length && pkt_length[j] > 0 ? pkt_length[j] : -1, pkt_info ? &pkt_info[j] : NULL);  /* one header parse per packet */
+   }
+
+   return j;
+}
+
+/* packet stats arena APIs, see notes in diaglib.h. arena->lock is held from DSPktStatsArenaReserve() to DSPktStatsArenaCommit() and by APIs that read or reset the arena, so entries, block lengths, and the spill file are not changed or closed while another thread is using them, JHB Oct 2026 */
+
+int DSPktStatsArenaInit(PKT_STATS_ARENA* arena, unsigned int uFlags, uint32_t max_entries, const char* szSpillFile) {
+
+   if (!arena) return -1;
+
+   memset(arena, 0, sizeof(PKT_STATS_ARENA));
+
+   int max_blocks = max(1, (int)((max_entries + PKT_STATS_ARENA_BLOCK_LEN-1)/PKT_STATS_ARENA_BLOCK_LEN));
+
+   arena->blocks = (PKT_STATS**)calloc(max_blocks, sizeof(PKT_STATS*));
+   arena->block_len = (uint32_t*)calloc(max_blocks, sizeof(uint32_t));
+
+   if (!arena->blocks || !arena->block_len) {
+
+      Log_RT(2, "ERROR: DSPktStatsArenaInit() says unable to allocate block table for %d blocks \n", max_blocks);
+      DSPktStatsArenaFree(arena);
+      return -1;
+   }
+
+   arena->uFlags = uFlags;
+   if (szSpillFile) strncpy(arena->szSpillFile, szSpillFile, sizeof(arena->szSpillFile)-1);
+
+   pthread_mutex_init(&arena->lock, NULL);
+
+   __atomic_store_n(&arena->max_blocks, max_blocks, __ATOMIC_RELEASE);  /* set last, non-zero indicates initialized */
+
+   return 1;
+}
+
+static int arena_spill(PKT_STATS_ARENA* arena) {  /* append oldest in-memory block to spill file, called with arena->lock held. Only one block is written per call, so the time the lock is held while writing is bounded by one block regardless of max_entries, JHB Oct 2026 */
+
+int b = arena->first_block;
+size_t len;
+
+   if (!arena->fp_spill) {
+
+      if (strlen(arena->szSpillFile)) arena->fp_spill = fopen(arena->szSpillFile, "wb+");
+      else arena->fp_spill = tmpfile();
+
+      if (!arena->fp_spill) {
+         Log_RT(2, "ERROR: DSPktStatsArenaReserve() says unable to open packet stats spill file %s, errno = %d, oldest entries will be discarded \n", strlen(arena->szSpillFile) ? arena->szSpillFile : "(tmp file)", errno);
+         arena->uFlags &= ~DS_PKTSTATS_ARENA_SPILL;
+         return -1;
       }
+   }
 
-      if (len <= 0) len = DSGetPacketInfo(-1, DS_PKT_INFO_PKTLEN | uFlags, pkt_buffer + offset, -1, NULL, NULL, 0);
+   len = arena->block_len[b]*sizeof(PKT_STATS);
 
-      offset += max(0, len);
+   if (pwrite(fileno(arena->fp_spill), arena->blocks[b], len, arena->num_spilled*sizeof(PKT_STATS)) != (ssize_t)len) {
+      Log_RT(2, "ERROR: DSPktStatsArenaReserve() says packet stats spill file write failed, errno = %d, oldest entries will be discarded \n", errno);
+      arena->uFlags &= ~DS_PKTSTATS_ARENA_SPILL;
+      return -1;
+   }
+
+   arena->num_spilled += arena->block_len[b];
+   arena->block_len[b] = 0;
+   arena->first_block = (arena->first_block + 1) % arena->max_blocks;
+   arena->num_used_blocks--;
+
+   return 1;
+}
+
+PKT_STATS* DSPktStatsArenaReserve(PKT_STATS_ARENA* arena, int num_entries) {
+
+int cur;
+
+   if (!arena || !arena->max_blocks || num_entries <= 0 || num_entries > PKT_STATS_ARENA_BLOCK_LEN) return NULL;
+
+   pthread_mutex_lock(&arena->lock);  /* released by DSPktStatsArenaCommit(), or below if returning NULL */
+
+   cur = (arena->first_block + arena->num_used_blocks - 1) % arena->max_blocks;
 
-      pkt_stats += sizeof(PKT_STATS);
+   if (arena->num_used_blocks && arena->block_len[cur] + num_entries <= PKT_STATS_ARENA_BLOCK_LEN) return &arena->blocks[cur][arena->block_len[cur]];  /* fits in current block */
+
+/* need a new block. If all blocks are in use either spill the oldest to disk or discard it */
+
+   if (arena->num_used_blocks == arena->max_blocks) {
+
+      if (!(arena->uFlags & DS_PKTSTATS_ARENA_SPILL) || arena_spill(arena) < 0) {
+
+         if (!arena->num_dropped) Log_RT(4, "INFO: packet stats arena exceeds %d entries, discarding oldest entries. Packet log will likely show missing SSRCs and/or packets \n", arena->max_blocks*PKT_STATS_ARENA_BLOCK_LEN);
+
+         arena->num_dropped += arena->block_len[arena->first_block];
+         arena->block_len[arena->first_block] = 0;
+         arena->first_block = (arena->first_block + 1) % arena->max_blocks;
+         arena->num_used_blocks--;
+      }
    }
 
-   return j;  /* return number of entries added */
+   cur = (arena->first_block + arena->num_used_blocks) % arena->max_blocks;
+
+   if (!arena->blocks[cur] && !(arena->blocks[cur] = (PKT_STATS*)malloc(PKT_STATS_ARENA_BLOCK_LEN*sizeof(PKT_STATS)))) {  /* blocks are allocated once and re-used */
+
+      pthread_mutex_unlock(&arena->lock);
+      return NULL;
+   }
+
+   arena->block_len[cur] = 0;
+   arena->num_used_blocks++;
+
+   return arena->blocks[cur];
+}
+
+void DSPktStatsArenaCommit(PKT_STATS_ARENA* arena, int num_entries) {
+
+int i;
+
+   if (!arena || !arena->max_blocks) return;
+
+   if (arena->num_used_blocks && num_entries > 0) {
+
+      int cur = (arena->first_block + arena->num_used_blocks - 1) % arena->max_blocks;
+      PKT_STATS* pkt_stats = &arena->blocks[cur][arena->block_len[cur]];
+
+      for (i=0; i<num_entries; i++) if (pkt_stats[i].idx >= 0) arena->num_group_entries++;
+
+      arena->block_len[cur] += num_entries;
+      arena->num_entries += num_entries;
+   }
+
+   pthread_mutex_unlock(&arena->lock);  /* locked by DSPktStatsArenaReserve() */
+}
+
+static int64_t arena_num_entries(PKT_STATS_ARENA* arena) {  /* called with arena->lock held */
+
+int i;
+int64_t num = arena->num_spilled;
+
+   for (i=0; i<arena->num_used_blocks; i++) num += arena->block_len[(arena->first_block + i) % arena->max_blocks];
+
+   return num;
+}
+
+int64_t DSPktStatsArenaNumEntries(PKT_STATS_ARENA* arena) {
+
+int64_t num;
+
+   if (!arena || !arena->max_blocks) return 0;
+
+   pthread_mutex_lock(&arena->lock);
+   num = arena_num_entries(arena);
+   pthread_mutex_unlock(&arena->lock);
+
+   return num;
+}
+
+static int arena_read_spill(int fd, PKT_STATS* pkt_stats, int64_t start, int64_t end) {  /* read spill file entries start to end-1 into pkt_stats[start] to pkt_stats[end-1]. The spill file is append-only, so entries below a num_spilled value taken with arena->lock held can be read without the lock */
+
+/* read in chunks so a large spill file isn't read with one pread() */
+
+   while (start < end) {
+
+      int64_t chunk = min(end - start, (int64_t)PKT_STATS_ARENA_BLOCK_LEN);
+
+      if (pread(fd, &pkt_stats[start], chunk*sizeof(PKT_STATS), start*sizeof(PKT_STATS)) != (ssize_t)(chunk*sizeof(PKT_STATS))) {
+         Log_RT(2, "ERROR: DSPktStatsArenaRead() says packet stats spill file read failed, errno = %d \n", errno);
+         return -1;
+      }
+
+      start += chunk;
+   }
+
+   return 1;
+}
+
+static int64_t arena_read_blocks(PKT_STATS_ARENA* arena, PKT_STATS* pkt_stats, int64_t num, int64_t max_entries) {  /* copy in-memory entries oldest first to pkt_stats[num], called with arena->lock held */
+
+int i, b;
+int64_t len;
+
+   for (i=0; i<arena->num_used_blocks && num < max_entries; i++) {
+
+      b = (arena->first_block + i) % arena->max_blocks;
+      len = min((int64_t)arena->block_len[b], max_entries - num);
+
+      memcpy(&pkt_stats[num], arena->blocks[b], len*sizeof(PKT_STATS));
+      num += len;
+   }
+
+   return num;
+}
+
+static int64_t arena_read(PKT_STATS_ARENA* arena, PKT_STATS* pkt_stats, int64_t max_entries) {  /* copy entries oldest first, called with arena->lock held */
+
+int64_t num = 0;
+
+/* spilled entries first, they are oldest */
+
+   if (arena->fp_spill) {
+
+      num = min((int64_t)arena->num_spilled, max_entries);
+      if (arena_read_spill(fileno(arena->fp_spill), pkt_stats, 0, num) < 0) return -1;
+   }
+
+   return arena_read_blocks(arena, pkt_stats, num, max_entries);
+}
+
+int64_t DSPktStatsArenaRead(PKT_STATS_ARENA* arena, PKT_STATS* pkt_stats, int64_t max_entries) {
+
+int64_t num;
+
+   if (!arena || !pkt_stats || !arena->max_blocks) return 0;
+
+   pthread_mutex_lock(&arena->lock);
+   num = arena_read(arena, pkt_stats, max_entries);
+   pthread_mutex_unlock(&arena->lock);
+
+   return num;
+}
+
+void DSPktStatsArenaReset(PKT_STATS_ARENA* arena) {
+
+   if (!arena || !arena->max_blocks) return;
+
+   pthread_mutex_lock(&arena->lock);  /* wait for any in-progress reserve/commit, spill, or read */
+
+   if (arena->fp_spill) { fclose(arena->fp_spill); arena->fp_spill = NULL; }  /* tmpfile() spill files are deleted on close, named spill files are truncated if re-opened */
+
+   memset(arena->block_len, 0, arena->max_blocks*sizeof(uint32_t));
+
+   arena->first_block = 0;
+   arena->num_used_blocks = 0;
+   arena->num_entries = 0;
+   arena->num_spilled = 0;
+   arena->num_dropped = 0;
+   arena->num_group_entries = 0;
+   arena->num_resets++;
+
+   pthread_mutex_unlock(&arena->lock);
+}
+
+void DSPktStatsArenaFree(PKT_STATS_ARENA* arena) {
+
+int i;
+
+   if (!arena) return;
+
+   if (arena->fp_spill) fclose(arena->fp_spill);
+
+   if (arena->max_blocks) pthread_mutex_destroy(&arena->lock);
+
+   if (arena->blocks) {
+      for (i=0; i<arena->max_blocks; i++) if (arena->blocks[i]) free(arena->blocks[i]);
+      free(arena->blocks);
+   }
+
+   if (arena->block_len) free(arena->block_len);
+
+   memset(arena, 0, sizeof(PKT_STATS_ARENA));
+}
+
+/* read arena into a temporary array for DSPktStatsWriteLogFile(). pArena is a PKT_STATS_ARENA* given as a PKT_STATS* param. Notes, JHB Oct 2026:
+
+  -in-memory entries are bounded by the arena's max_entries, so if nothing has been spilled the array is allocated from the heap
+  -if entries have been spilled, history size is not bounded and a heap array could exceed available memory. Instead the array is a shared mapping of a temporary file, filled from the spill file and in-memory blocks in chunks, so the kernel can write back and evict pages as needed
+  -the arena is locked only to take entry and spill counts and to copy in-memory entries. Spilled entries are read without the lock from a dup() of the spill file descriptor (the spill file is append-only, and the dup keeps the file open if the arena is reset meanwhile), so p/m threads adding entries don't wait for spill file reads. Entries spilled after the counts are taken are read from the spill file with the lock held, which is at most a few blocks
+  -if the arena is reset while spilled entries are being read, the array holds only the entries read from the spill file
+  -caller releases the array with arena_release()
+*/
+
+static PKT_STATS* arena_gather(void* pArena, uint32_t* num_pkts, size_t* map_len) {
+
+PKT_STATS_ARENA* arena = (PKT_STATS_ARENA*)pArena;
+PKT_STATS* pkt_stats = NULL;
+int64_t num, num_spilled;
+uint32_t num_resets;
+int fd = -1;
+
+   *num_pkts = 0;
+   *map_len = 0;
+
+   if (!arena || !arena->max_blocks) return NULL;
+
+/* take entry and spill counts */
+
+   pthread_mutex_lock(&arena->lock);
+
+   num = min(arena_num_entries(arena), (int64_t)INT_MAX);  /* packet log indexes are int */
+   num_spilled = min((int64_t)arena->num_spilled, num);
+   num_resets = arena->num_resets;
+
+   if (num_spilled > 0 && arena->fp_spill && (fd = dup(fileno(arena->fp_spill))) < 0) Log_RT(2, "ERROR: DSPktStatsWriteLogFile() says unable to dup packet stats spill file descriptor, errno = %d \n", errno);
+
+   pthread_mutex_unlock(&arena->lock);
+
+   if (num <= 0 || (num_spilled > 0 && fd < 0)) goto cleanup;
+
+   if (num_spilled > 0) {
+
+      size_t len = (num+1)*sizeof(PKT_STATS);  /* +1 for RFC7198 debug look-ahead */
+      FILE* fp_tmp = tmpfile();
+      void* p = MAP_FAILED;
+
+      if (fp_tmp && !ftruncate(fileno(fp_tmp), len)) p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(fp_tmp), 0);
+      if (fp_tmp) fclose(fp_tmp);  /* mapping remains valid, temporary file is deleted when unmapped */
+
+      if (p == MAP_FAILED) {
+         Log_RT(2, "ERROR: DSPktStatsWriteLogFile() says unable to create temporary file mapping for %lld packet stats entries, errno = %d \n", (long long)num, errno);
+         goto cleanup;
+      }
+
+      pkt_stats = (PKT_STATS*)p;
+      *map_len = len;
+   }
+   else if (!(pkt_stats = (PKT_STATS*)malloc((num+1)*sizeof(PKT_STATS)))) {
+      Log_RT(2, "ERROR: DSPktStatsWriteLogFile() says unable to allocate %lld packet stats entries for arena read \n", (long long)num);
+      goto cleanup;
+   }
+
+/* read spilled entries without the lock */
+
+   if (num_spilled > 0 && arena_read_spill(fd, pkt_stats, 0, num_spilled) < 0) num = -1;
+
+/* re-lock to read entries spilled since counts were taken, if any, and copy in-memory entries */
+
+   else {
+
+      pthread_mutex_lock(&arena->lock);
+
+      if (arena->num_resets != num_resets) num = num_spilled;  /* arena was reset, keep only entries read from the spill file */
+      else {
+
+         int64_t num_read = min((int64_t)arena->num_spilled, num);
+
+         if (num_read > num_spilled && arena_read_spill(fileno(arena->fp_spill), pkt_stats, num_spilled, num_read) < 0) num = -1;
+         else num = arena_read_blocks(arena, pkt_stats, num_read, num);
+      }
+
+      pthread_mutex_unlock(&arena->lock);
+   }
+
+   if (num < 0) {
+      if (*map_len) munmap(pkt_stats, *map_len);
+      else free(pkt_stats);
+      pkt_stats = NULL;
+      *map_len = 0;
+   }
+   else *num_pkts = (uint32_t)num;
+
+cleanup:
+   if (fd >= 0) close(fd);
+
+   return pkt_stats;
+}
+
+static void arena_release(PKT_STATS* pkt_stats, size_t map_len) {
+
+   if (!pkt_stats) return;
+
+   if (map_len) munmap(pkt_stats, map_len);
+   else free(pkt_stats);
 }
 
 // #define SIMULATE_SLOW_TIME 1  /* turn this on to simulate time-consuming packet logging, for example if app debug is needed when aborting during packet logging, JHB Jan 2023 */
@@ -173,6 +592,54 @@ unsigned int offset = 0;
 #define OMIT_REDUNDANT_SEARCH  /* experimental mod that reduces total search iterations by more than 1/2 but total time by only 17% or so. Still not sure whether to keep this, JHB Aug 2024 */
 //#define USE_EXPECT_BUILTIN  /* __builtin_expect() can be used deep inside inner loops to optimize if-conditions where one path is much less probable. But, seems with x86 branch-prediction technology and/or g++ 4.8 and higher it's not helping (it should be noted that I tested it by flipping the path priority which substantially reduced performance). This can be enabled with other CPU types and compilers to see if it makes a difference, JHB Aug 2024 */
 
+/* SSRC hash table used by DSFindSSRCGroups(), JHB Oct 2026. Notes:
+
+  -key is SSRC, or SSRC and chnum if DS_PKTSTATS_MATCH_CHNUM is given. Open addressing with linear probing, table size is a power of 2 at least 4x the max number of SSRCs
+  -entries are validated against ssrcs[] and chnum[], so if ssrcs[] entries are overwritten (more than MAX_SSRCS SSRCs) lookups behave the same as a linear search of ssrcs[]
+*/
+
+typedef struct {
+
+  uint32_t ssrc;
+  int32_t  chnum;
+  int32_t  idx;  /* index into ssrcs[], -1 if empty */
+
+} SSRC_HASH_ENTRY;
+
+static inline uint32_t ssrc_hash(uint32_t ssrc, int chnum, bool fChannelMatch, uint32_t mask) {
+
+   return ((ssrc ^ (fChannelMatch ? (uint32_t)chnum*0x85ebca6bU : 0))*0x9e3779b1U >> 7) & mask;
+}
+
+static inline int find_ssrc(SSRC_HASH_ENTRY* table, uint32_t mask, uint32_t ssrc, int ch, bool fChannelMatch, uint32_t ssrcs[], uint16_t chnum[]) {
+
+uint32_t h = ssrc_hash(ssrc, ch, fChannelMatch, mask);
+
+   for (; table[h].idx >= 0; h = (h+1) & mask) {
+
+      int i = table[h].idx;
+
+      if (table[h].ssrc == ssrc && (!fChannelMatch || table[h].chnum == ch) && ssrcs[i] == ssrc && (!fChannelMatch || chnum[i] == ch)) return i;
+   }
+
+   return -1;
+}
+
+static inline void insert_ssrc(SSRC_HASH_ENTRY* table, uint32_t mask, uint32_t ssrc, int ch, bool fChannelMatch, int idx) {
+
+uint32_t h = ssrc_hash(ssrc, ch, fChannelMatch, mask);
+
+   while (table[h].idx >= 0) h = (h+1) & mask;
+
+   table[h].ssrc = ssrc;
+   table[h].chnum = ch;
+   table[h].idx = idx;
+}
+
+#ifdef PKTSTATS_BENCH
+bool fPktStatsBenchLegacy = false;  /* set by pktstats_bench.cpp (diaglib Makefile bench target) to time the linear search and memmove() collation path, JHB Oct 2026 */
+#endif
+
 /* group data by unique SSRCs */
 
 int DSFindSSRCGroups(PKT_STATS* pkts, unsigned int uFlags, int num_pkts, uint32_t ssrcs[], uint16_t chnum[], int first_pkt_idx[], int last_pkt_idx[], uint32_t first_rtp_seqnum[], uint32_t last_rtp_seqnum[]) {
@@ -182,15 +649,31 @@ uint32_t   first_seqnum, last_seqnum;
 bool       fCollated = false;
 int        sorted_point;
 PKT_STATS __attribute((aligned(64))) temp_pkts;
-int        seq_wrap[MAX_SSRC_TRANSITIONS] = { 0 };  /* MAX_SSRC_TRANSITIONS defined in shared_include/session.h, currently 128 */
-int        ssrc_idx = 0, num_ssrcs;
+int*       seq_wrap;  /* indexed by ssrc_idx, so size is MAX_SSRCS. Was int seq_wrap[MAX_SSRC_TRANSITIONS] on the stack, which overflowed with more than 128 SSRCs, JHB Oct 2026 */
+int        ssrc_idx = 0, num_ssrcs = 0;
 bool       fDebug = lib_dbg_cfg.uLogLevel > 8;  /* lib_dbg_cfg is in event_logging.cpp */
+SSRC_HASH_ENTRY* hash_table;  /* SSRC hash table, JHB Oct 2026 */
+uint32_t   hash_mask;
+uint32_t   hash_count;
 
 #define SEARCH_WINDOW        30
 #define MAX_MISSING_SEQ_GAP  20000  /* max missing seq number gap we can tolerate */
 
    int nThreadIndex = GetThreadIndex(true);
 
+   if (!(seq_wrap = (int*)calloc(MAX_SSRCS, sizeof(int)))) {
+      Log_RT(2, "ERROR: DSFindSSRCGroups (diaglib packet logging) says unable to allocate seq_wrap[] mem, errno = %d \n", errno);
+      return -1;
+   }
+
+   for (hash_mask = 1; hash_mask < 4*(uint32_t)min((long)num_pkts, MAX_SSRCS); hash_mask <<= 1);  /* hash table size is power of 2 >= 4x max possible number of SSRCs, so load is <= 25% after any rebuild (see below) */
+   hash_table = (SSRC_HASH_ENTRY*)malloc(hash_mask*sizeof(SSRC_HASH_ENTRY));  /* if malloc fails, we fall back to linear search and memmove() collation */
+   hash_mask--;
+
+   #ifdef PKTSTATS_BENCH
+   if (fPktStatsBenchLegacy && hash_table) { free(hash_table); hash_table = NULL; }
+   #endif
+
 /* SSRC and channel number discovery and indexing */
 
 group_ssrcs:
@@ -208,19 +691,26 @@ group_ssrcs:
    num_ssrcs = 0;
    bool fChannelMatch = (uFlags & DS_PKTSTATS_MATCH_CHNUM) != 0;  /* if channel number matching requested, JHB Jul 2024 */
 
+   if (hash_table) for (j=0; j<=(int)hash_mask; j++) hash_table[j].idx = -1;
+   hash_count = 0;
+
    for (j=0; j<num_pkts; j++) {
 
       #ifdef SIMULATE_SLOW_TIME
       usleep(SIMULATE_SLOW_TIME);
       #endif
-      if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto exit;  /* see if abort flag set, JHB Jan 2023 */
+      if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto cleanup;  /* see if abort flag set, JHB Jan 2023 */
 
    /* first check if we've already seen this SSRC and chnum (channel number) combination */
 
       bool fExistingSSRC = false;
       uint32_t rtp_ssrc = pkts[j].rtp_ssrc;
 
-      for (i=0; i<num_ssrcs; i++) {
+      if (hash_table) {  /* hash lookup instead of linear search, JHB Oct 2026 */
+
+         if ((i = find_ssrc(hash_table, hash_mask, rtp_ssrc, pkts[j].chnum, fChannelMatch, ssrcs, chnum)) >= 0) { ssrc_idx = i; fExistingSSRC = true; }
+      }
+      else for (i=0; i<num_ssrcs; i++) {
 
          if (rtp_ssrc == ssrcs[i] && (!fChannelMatch || pkts[j].chnum == chnum[i])) {  /* add chnum comparison, JHB Jul 2024 */
 
@@ -241,6 +731,19 @@ group_ssrcs:
 
          ssrcs[ssrc_idx] = rtp_ssrc;
          chnum[ssrc_idx] = pkts[j].chnum;  /* note we save chnum regardless of flags, so they can be printed in log summaries, JHB Jul 2024 */
+
+         if (hash_table) {
+
+            if (++hash_count > (hash_mask+1)/2) {  /* can only happen if number of SSRCs exceeds MAX_SSRCS and ssrcs[] entries are being overwritten. Rebuild table from ssrcs[] to remove stale entries */
+
+               for (i=0; i<=(int)hash_mask; i++) hash_table[i].idx = -1;
+               for (i=0; i<ssrc_idx; i++) insert_ssrc(hash_table, hash_mask, ssrcs[i], chnum[i], fChannelMatch, i);
+               hash_count = ssrc_idx+1;
+            }
+
+            insert_ssrc(hash_table, hash_mask, rtp_ssrc, pkts[j].chnum, fChannelMatch, ssrc_idx);
+         }
+
          first_pkt_idx[ssrc_idx] = j;
          last_pkt_idx[ssrc_idx] = j;
          seq_wrap[ssrc_idx] = 0;
@@ -342,88 +845,132 @@ group_ssrcs:
 
    if ((uFlags & DS_PKTSTATS_LOG_COLLATE_STREAMS) && !fCollated) {  /* use discovered SSRC groups to perform stream collation */
 
-   /* with number of unique SSRCs known, collate streams. NB -- took a while to get exactly right combination of j, i, and sorted_point. Adjusting any of these by +/- 1 will break things, for example it might cause resorting of already sorted entries, which can make it hard to see what happened. So debug carefully and use the #if 0 debug helpers if needed ... JHB Sep 2017 */
+   /* stable counting sort into a scratch buffer, JHB Oct 2026. Notes:
 
-      sorted_point = 0;
+      -bucket k (k < num_ssrcs-1) holds packets matching ssrcs[k] / chnum[k], in their original order. All other packets (the last SSRC group, plus any SSRCs overwritten if MAX_SSRCS was exceeded) follow in their original order. This is the same result as the memmove() collation below, which moves each of the first N-1 groups into place and leaves the rest in order
+      -two passes over pkts[] (count, then scatter) instead of O(packets x SSRCs) search and memmove() data movement
+      -abort flag is checked in both passes. On abort pkts[] is unchanged
+      -if the hash table or scratch buffer can't be allocated, we fall back to memmove() collation
+   */
 
-      #if 0  /* debug helper */
-      int fOnce[10] = {0}, xcount[10] = {0}, nonmatch[10] = {0};
-      #endif
+      PKT_STATS* sorted_pkts = NULL;
+      int* bucket_ofs = NULL;
+
+      if (hash_table && num_ssrcs > 1 && (sorted_pkts = (PKT_STATS*)malloc(num_pkts*sizeof(PKT_STATS))) && (bucket_ofs = (int*)calloc(num_ssrcs+1, sizeof(int)))) {
+
+         #define SSRC_BUCKET(p) ((k = find_ssrc(hash_table, hash_mask, (p).rtp_ssrc, (p).chnum, fChannelMatch, ssrcs, chnum)) >= 0 && k < num_ssrcs-1 ? k : num_ssrcs-1)
 
-      for (k=0; k<num_ssrcs-1; k++) {  /* collate N-1 unique SSRCs, last one ends up collated by default (if there is only one, no collation is needed) */
+         for (j=0; j<num_pkts; j++) {
 
-         #if 0
-         if (fOnce[k] < 10) { printf("before sort, sorted_point = %d, num_pkts = %d, ssrc = 0x%x\n", sorted_point, num_pkts, unique_ssrcs[k]); fOnce[k]++; }
+            if ((j & 1023) == 0 && (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT)) { free(sorted_pkts); free(bucket_ofs); goto cleanup; }  /* see if abort flag set */
+
+            bucket_ofs[SSRC_BUCKET(pkts[j])+1]++;  /* count packets in each bucket */
+         }
+
+         for (k=1; k<=num_ssrcs; k++) bucket_ofs[k] += bucket_ofs[k-1];  /* bucket start offsets */
+
+         for (j=0; j<num_pkts; j++) {
+
+            if ((j & 1023) == 0 && (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT)) { free(sorted_pkts); free(bucket_ofs); goto cleanup; }
+
+            i = SSRC_BUCKET(pkts[j]);
+            sorted_pkts[bucket_ofs[i]++] = pkts[j];
+         }
+
+         #undef SSRC_BUCKET
+
+         memcpy(pkts, sorted_pkts, num_pkts*sizeof(PKT_STATS));
+
+         free(sorted_pkts);
+         free(bucket_ofs);
+      }
+      else {  /* memmove() collation */
+
+         if (sorted_pkts) free(sorted_pkts);
+
+      /* with number of unique SSRCs known, collate streams. NB -- took a while to get exactly right combination of j, i, and sorted_point. Adjusting any of these by +/- 1 will break things, for example it might cause resorting of already sorted entries, which can make it hard to see what happened. So debug carefully and use the #if 0 debug helpers if needed ... JHB Sep 2017 */
+
+         sorted_point = 0;
+
+         #if 0  /* debug helper */
+         int fOnce[10] = {0}, xcount[10] = {0}, nonmatch[10] = {0};
          #endif
 
-         int ch = chnum[k];
-         uint32_t ssrc = ssrcs[k];
+         for (k=0; k<num_ssrcs-1; k++) {  /* collate N-1 unique SSRCs, last one ends up collated by default (if there is only one, no collation is needed) */
+
+            #if 0
+            if (fOnce[k] < 10) { printf("before sort, sorted_point = %d, num_pkts = %d, ssrc = 0x%x\n", sorted_point, num_pkts, unique_ssrcs[k]); fOnce[k]++; }
+            #endif
+
+            int ch = chnum[k];
+            uint32_t ssrc = ssrcs[k];
 
 find_transition:
 
-         i = 0;
+            i = 0;
 
-         for (j=sorted_point+1; j<num_pkts; j++) {
+            for (j=sorted_point+1; j<num_pkts; j++) {
 
-            #ifdef SIMULATE_SLOW_TIME
-            usleep(SIMULATE_SLOW_TIME);
-            #endif
-            if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto exit;  /* see if abort flag set, JHB Jan 2023 */
+               #ifdef SIMULATE_SLOW_TIME
+               usleep(SIMULATE_SLOW_TIME);
+               #endif
+               if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto cleanup;  /* see if abort flag set, JHB Jan 2023 */
+
+               if (pkts[j].rtp_ssrc != ssrc || (fChannelMatch && pkts[j].chnum != ch)) {  /* add chnum comparison, JHB Jul 2024 */
 
-            if (pkts[j].rtp_ssrc != ssrc || (fChannelMatch && pkts[j].chnum != ch)) {  /* add chnum comparison, JHB Jul 2024 */
+                  if (!i) {  /* find first non-matching SSRC or chnum, mark sorted point */
 
-               if (!i) {  /* find first non-matching SSRC or chnum, mark sorted point */
+                     i = j;
+                     sorted_point = i-1;  /* adjust sorted point. Note -- added this to fix the "orphan SSRC" number of SSRC groups problem, see comments below near in_ssrc_start and out_ssrc_start. Also makes the sort faster, avoids unnecessary moving of already sorted enrties, JHB Feb 2019 */
 
-                  i = j;
-                  sorted_point = i-1;  /* adjust sorted point. Note -- added this to fix the "orphan SSRC" number of SSRC groups problem, see comments below near in_ssrc_start and out_ssrc_start. Also makes the sort faster, avoids unnecessary moving of already sorted enrties, JHB Feb 2019 */
+                     #if 0
+                     nonmatch[k]++;
+                     printf("non-matching SSRC = 0x%x, current ssrc = 0x%x, i = %d\n", pkts[j].rtp_ssrc, unique_ssrcs[k], i);
+                     #endif
+                  }
+               }
+               #ifdef USE_EXPECT_BUILTIN
+               else if (__builtin_expect(i > sorted_point, 1)) {  /* found a not-yet-sorted match, move it up to just after last match, and move anything in between down */
+               #else
+               else if (i > sorted_point) {  /* found a not-yet-sorted match, move it up to just after last match, and move anything in between down */
+               #endif
 
                   #if 0
-                  nonmatch[k]++;
-                  printf("non-matching SSRC = 0x%x, current ssrc = 0x%x, i = %d\n", pkts[j].rtp_ssrc, unique_ssrcs[k], i);
+                  printf("moving pkts[%d] %u up to pkts[%d] %u\n", j, pkts[j].rtp_ssrc, i, pkts[i].rtp_ssrc);
                   #endif
-               }
-            }
-            #ifdef USE_EXPECT_BUILTIN
-            else if (__builtin_expect(i > sorted_point, 1)) {  /* found a not-yet-sorted match, move it up to just after last match, and move anything in between down */
-            #else
-            else if (i > sorted_point) {  /* found a not-yet-sorted match, move it up to just after last match, and move anything in between down */
-            #endif
 
-               #if 0
-               printf("moving pkts[%d] %u up to pkts[%d] %u\n", j, pkts[j].rtp_ssrc, i, pkts[i].rtp_ssrc);
-               #endif
+                  sorted_point = i;  /* save point of progress to prevent repeat sorting */
 
-               sorted_point = i;  /* save point of progress to prevent repeat sorting */
+                  //#define SORT_SANITY_CHECKS
 
-               //#define SORT_SANITY_CHECKS
+                  #ifdef SORT_SANITY_CHECKS
+                  if (j > i)
+                  #endif
+                  {
 
-               #ifdef SORT_SANITY_CHECKS
-               if (j > i)
-               #endif
-               {
+                     memcpy(&temp_pkts, &pkts[j], sizeof(PKT_STATS));
 
-                  memcpy(&temp_pkts, &pkts[j], sizeof(PKT_STATS));
+                     #ifdef USE_MEMMOVE  /* on average, for a very long input with 2 streams, single memmove() is faster by around 2.3x than multiple memcpy(). For multiple streams, performance gain would be higher, JHB Aug 2024 */
+                     memmove(&pkts[i+1], &pkts[i], (j-i)*sizeof(PKT_STATS));
+                     #else
+                     int l;
+                     for (l=j; l>i; l--) memcpy(&pkts[l], &pkts[l-1], sizeof(PKT_STATS));
+                     #endif
 
-                  #ifdef USE_MEMMOVE  /* on average, for a very long input with 2 streams, single memmove() is faster by around 2.3x than multiple memcpy(). For multiple streams, performance gain would be higher, JHB Aug 2024 */
-                  memmove(&pkts[i+1], &pkts[i], (j-i)*sizeof(PKT_STATS));
-                  #else
-                  int l;
-                  for (l=j; l>i; l--) memcpy(&pkts[l], &pkts[l-1], sizeof(PKT_STATS));
+                     memcpy(&pkts[i], &temp_pkts, sizeof(PKT_STATS));
+                  }
+                  #ifdef SORT_SANITY_CHECKS
+                  else printf("\n *** j (%d) <= i (%d) \n", j, i);
                   #endif
 
-                  memcpy(&pkts[i], &temp_pkts, sizeof(PKT_STATS));
+                  goto find_transition;  /* restart the search, continue looking for non-matching SSRCs */
                }
                #ifdef SORT_SANITY_CHECKS
-               else printf("\n *** j (%d) <= i (%d) \n", j, i);
+               else printf("\n *** i (%d) <= sorted_point (%d) \n", i, sorted_point);
                #endif
-
-               goto find_transition;  /* restart the search, continue looking for non-matching SSRCs */
             }
-            #ifdef SORT_SANITY_CHECKS
-            else printf("\n *** i (%d) <= sorted_point (%d) \n", i, sorted_point);
-            #endif
          }
-      }
+      }  /* end of memmove() collation */
 
       #ifdef ENABLE_PROFILING
       uint64_t t3;
@@ -445,7 +992,10 @@ find_transition:
       goto group_ssrcs;  /* re-do packet indexing after collation */
    }
 
-exit:
+cleanup:
+
+   if (hash_table) free(hash_table);
+   free(seq_wrap);
 
    return num_ssrcs;  /* return number of SSRC groups found */
 }
@@ -475,229 +1025,368 @@ void print_packet_type(FILE* fp_log, unsigned int content_flags, int rtp_pyldlen
 }
 
 
-int DSPktStatsLogSeqnums(FILE* fp_log, unsigned int uFlags, PKT_STATS* pkts, int num_pkts, const char* label, uint32_t ssrcs[], uint16_t chnum[], int first_pkt_idx[], int last_pkt_idx[], uint32_t first_rtp_seqnum[], uint32_t last_rtp_seqnum[], PKT_STREAM_STATS StreamStats[]) {
+/* analyze and log one SSRC group, called by DSPktStatsLogSeqnums(). Analysis of each SSRC group is independent: pkts[] and SSRC group arrays are read-only and only StreamStats[i] is written, so groups can be handled by worker threads (see DS_PKTSTATS_LOG_PARALLEL). seq_wrap and max_consec_missing were arrays indexed by SSRC group (size MAX_SSRC_TRANSITIONS), they are now per group local vars, JHB Oct 2026 */
+
+static void log_ssrc_seqnums(int i, FILE* fp_log, unsigned int uFlags, PKT_STATS* pkts, const char* label, int num_ssrcs, uint32_t ssrcs[], uint16_t chnum[], int first_pkt_idx[], int last_pkt_idx[], uint32_t first_rtp_seqnum[], uint32_t last_rtp_seqnum[], PKT_STREAM_STATS StreamStats[], int nThreadIndex) {
 
-int           i, j, k, nSpaces;
+int           j, k, nSpaces;
 bool          fFound_sn, fDup_sn, fOoo_sn;
 unsigned int  rtp_seqnum, dup_rtp_seqnum, ooo_rtp_seqnum, numDTX, numSIDNoData;
 char          seqstr[100], tmpstr[200];
-int           num_ssrcs;
-int           seq_wrap[MAX_SSRC_TRANSITIONS] = { 0 };
-uint32_t      max_consec_missing[MAX_SSRC_TRANSITIONS] = { 0 };
+int           seq_wrap = 0;
+uint32_t      max_consec_missing = 0;
 char          szLastSeq[100];
 
-   int nThreadIndex = GetThreadIndex(true);
+   #if 0  /* debug output */
+   printf("num_ssrcs = %d, i = %d, first j = %d, last j = %d, first seq num = %u, last seq num = %u\n", num_ssrcs, i, first_pkt_idx[i], last_pkt_idx[i], first_rtp_seqnum[i], last_rtp_seqnum[i]);
+   #endif
+ 
+   strcpy(tmpstr, "");
+   for (k=i-1; k >= 0; k--) {
+      if (ssrcs[i] == ssrcs[k] && (!(uFlags & DS_PKTSTATS_MATCH_CHNUM) || chnum[i] == chnum[k])) {  /* add chnum comparison, JHB Jul 2024 */
+         strcpy(tmpstr, " (cont)");  /* annotate if this SSRC and chnum combination have appeared before */
+         break;
+      }
+   }
 
-/* first group data by unique SSRCs */
+   if (fp_log) {
+      if (label) fprintf(fp_log, "%s ", label);
+      sprintf(szLastSeq, "%u", last_rtp_seqnum[i]);
+      if (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) sprintf(&szLastSeq[strlen(szLastSeq)], " (%u)", last_rtp_seqnum[i] & 0xffff);
+      fprintf(fp_log, "Packet info for SSRC = 0x%x chnum = %d%s, first seq num = %u, last seq num = %s ...\n\n", ssrcs[i], chnum[i], tmpstr, first_rtp_seqnum[i], szLastSeq);
+   }
 
-   num_ssrcs = DSFindSSRCGroups(pkts, uFlags, num_pkts, ssrcs, chnum, first_pkt_idx, last_pkt_idx, first_rtp_seqnum, last_rtp_seqnum);
+   j = first_pkt_idx[i];
 
-   #ifdef SIMULATE_SLOW_TIME
-   usleep(SIMULATE_SLOW_TIME);
-   #endif
-   if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto exit;  /* see if abort flag set, JHB Jan 2023 */
+   numDTX = 0, numSIDNoData = 0;
 
-   #if 0  /* debug -- see if sort looks ok */
-   fprintf(fp_log, "%s sorted by SSRC (no analysis), numpkts = %d\n", label, num_pkts);
-   for (j=0; j<num_pkts; j++) {
+   rtp_seqnum = first_rtp_seqnum[i];
 
-      fprintf(fp_log, "seq = %u, ssrc = 0x%x", pkts[j].rtp_seqnum, pkts[j].rtp_ssrc);
+   while (rtp_seqnum <= last_rtp_seqnum[i] && j <= last_pkt_idx[i]) {
 
-      print_packet_type(fp_log, pkts[j].content_flags, -1, -1);
-   }
-   fprintf(fp_log, "\n");
-   #endif
+      #ifdef SIMULATE_SLOW_TIME
+      usleep(SIMULATE_SLOW_TIME);
+      #endif
+      if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) return;  /* see if abort flag set, JHB Jan 2023 */
 
-   for (i=0; i<num_ssrcs; i++) memset(StreamStats[i].chnum, 0xff, sizeof(StreamStats[0].chnum));
+      if (StreamStats[i].chnum[max(StreamStats[i].num_chnum - 1, 0)] != pkts[j].chnum) {  /* handle "dormant SSRCs" that are taken over by another channel, JHB Jan 2020 */
 
-/* for each SSRC group, fill in StreamStats[], and write stats to log file if fp_log not NULL */
+         if (StreamStats[i].num_chnum < MAX_CHAN_PER_SSRC) {  /* need to review this now that we're handling SSRCs shared across streams, JHB Jul 2024 */
+            StreamStats[i].chnum[StreamStats[i].num_chnum] = pkts[j].chnum;
+            StreamStats[i].num_chnum++;;
+         }
+      }
 
-   for (i=0; i<num_ssrcs; i++) {
+      StreamStats[i].idx = pkts[j].idx;
 
-      #if 0  /* debug output */
-      printf("num_ssrcs = %d, i = %d, first j = %d, last j = %d, first seq num = %u, last seq num = %u\n", num_ssrcs, i, first_pkt_idx[i], last_pkt_idx[i], first_rtp_seqnum[i], last_rtp_seqnum[i]);
-      #endif
- 
+      fFound_sn = false;
+      fDup_sn = false;
+      fOoo_sn = false;
+      ooo_rtp_seqnum = 0;
+      dup_rtp_seqnum = 0;
+
+   /* first check for duplicated seq numbers. We use a very narrow definition:  2 consecutive identical seq numbers. If a seq number randomly repeats somewhere, we don't currently look for that */
+
+      if (j > 0 && pkts[j].rtp_seqnum == pkts[j-1].rtp_seqnum) {  /* is it duplicated ? */
+
+//  printf("dup, pkts[j].rtp_seqnum = %u, next seq_num = %d, pyldlen = %d\n", pkts[j].rtp_seqnum, rtp_seqnum, pkts[j].rtp_pyldlen);
+
+         fDup_sn = true;  /* duplicated seq number found */
+
+         if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_DTMF && !(uFlags & DS_PKTSTATS_LOG_MARK_DTMF_DUPLICATE)) fFound_sn = true;  /* if it's a DTMF event packet we don't label it duplicated (DTMF events can have several duplicated packets) */
+      }
+      else if (pkts[j].rtp_seqnum + seq_wrap*65536L != rtp_seqnum) {  /* recorded seq number matches next (expected) seq number ? */
+
+         #define OOO_SEARCH_WINDOW 30  /* possibly this should be something users can set ?  JHB Dec2019 */
+
+         for (k=max(j-(OOO_SEARCH_WINDOW-1), first_pkt_idx[i]); k<min(j+OOO_SEARCH_WINDOW, last_pkt_idx[i]+1); k++) {  /* search +/- OOO_SEARCH_WINDOW number of packets to find ooo packets. Allow for 2x consecutive duplicates, this is a window of +/- 1/2x ptime */
+
+            if (pkts[k].rtp_seqnum + seq_wrap*65536L == rtp_seqnum) {
+
+               StreamStats[i].ooo_max = max(StreamStats[i].ooo_max, (unsigned int)abs(k-j));  /* record max ooo */
+               fOoo_sn = true;  /* found ooo seq num */
+               break;
+            }
+         }
+      }
+      else fFound_sn = true;
+
+      if (fFound_sn) strcpy(seqstr, "");
       strcpy(tmpstr, "");
-      for (k=i-1; k >= 0; k--) {
-         if (ssrcs[i] == ssrcs[k] && (!(uFlags & DS_PKTSTATS_MATCH_CHNUM) || chnum[i] == chnum[k])) {  /* add chnum comparison, JHB Jul 2024 */
-            strcpy(tmpstr, " (cont)");  /* annotate if this SSRC and chnum combination have appeared before */
-            break;
+
+      if (fOoo_sn) {
+
+         ooo_rtp_seqnum = pkts[j].rtp_seqnum + seq_wrap*65536L;
+         sprintf(seqstr, "ooo %u", (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) ? rtp_seqnum & 0xffff : rtp_seqnum);
+         StreamStats[i].ooo_seqnum++;
+         max_consec_missing = 0;
+      }
+      else if (fDup_sn) {
+
+         if (!fFound_sn) {
+            strcpy(seqstr, "dup");
+            StreamStats[i].dup_seqnum++;
          }
+
+         dup_rtp_seqnum = pkts[j].rtp_seqnum + seq_wrap*65536L;
+         max_consec_missing = 0;
       }
+      else if (!fFound_sn) {
 
-      if (fp_log) {
-         if (label) fprintf(fp_log, "%s ", label);
-         sprintf(szLastSeq, "%u", last_rtp_seqnum[i]);
-         if (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) sprintf(&szLastSeq[strlen(szLastSeq)], " (%u)", last_rtp_seqnum[i] & 0xffff);
-         fprintf(fp_log, "Packet info for SSRC = 0x%x chnum = %d%s, first seq num = %u, last seq num = %s ...\n\n", ssrcs[i], chnum[i], tmpstr, first_rtp_seqnum[i], szLastSeq);
+         strcpy(seqstr, "nop");
+         StreamStats[i].missing_seqnum++;
+         max_consec_missing++;
+         StreamStats[i].max_consec_missing_seqnum = max(StreamStats[i].max_consec_missing_seqnum, max_consec_missing);
       }
+      else max_consec_missing = 0;
 
-      j = first_pkt_idx[i];
+      nSpaces = max(1, 12-(int)strlen(seqstr));
+      for (k=0; k<nSpaces; k++) strcat(seqstr, " ");
 
-      numDTX = 0, numSIDNoData = 0;
+      if (ooo_rtp_seqnum) sprintf(&tmpstr[strlen(tmpstr)], "Seq num %u %s", (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) ? ooo_rtp_seqnum & 0xffff : ooo_rtp_seqnum, seqstr);
+      else if (fDup_sn) sprintf(&tmpstr[strlen(tmpstr)], "Seq num %u %s", (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) ? dup_rtp_seqnum & 0xffff : dup_rtp_seqnum, seqstr);
+      else sprintf(&tmpstr[strlen(tmpstr)], "Seq num %u %s", (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) ? rtp_seqnum & 0xffff : rtp_seqnum, seqstr);
 
-      rtp_seqnum = first_rtp_seqnum[i];
+      if (fFound_sn || fDup_sn || fOoo_sn) {
 
-      while (rtp_seqnum <= last_rtp_seqnum[i] && j <= last_pkt_idx[i]) {
+         sprintf(&tmpstr[strlen(tmpstr)], " timestamp = %u, rtp pyld len = %u", pkts[j].rtp_timestamp, pkts[j].rtp_pyldlen);  /* changed from "pkt len =", JHB Jun 2023 */
 
-         #ifdef SIMULATE_SLOW_TIME
-         usleep(SIMULATE_SLOW_TIME);
+         if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_SID) {
+            StreamStats[i].numSID++;
+            sprintf(&tmpstr[strlen(tmpstr)], " SID");
+         }
+         else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_SID_REUSE) {
+            StreamStats[i].numSIDReuse++;
+            sprintf(&tmpstr[strlen(tmpstr)], " SID CNG-R");
+         }
+         else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_MEDIA_REUSE) {
+            StreamStats[i].numMediaReuse++;
+            sprintf(&tmpstr[strlen(tmpstr)], " media-R");
+         }
+         else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_SID_NODATA) {
+            numSIDNoData++;
+            sprintf(&tmpstr[strlen(tmpstr)], " SID NoData");
+         }
+         else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_DTMF) {
+            StreamStats[i].numDTMFEvent++;
+            if (pkts[j].content_flags & DS_PKT_PYLD_CONTENT_DTMF_END) sprintf(&tmpstr[strlen(tmpstr)], " DTMF Event End");
+            sprintf(&tmpstr[strlen(tmpstr)], " DTMF Event");
+         }
+         #if 0  /* no assumptions should be based only on payload size, we need to go by DS_PKT_PYLD_CONTENT_XXX flags only, JHB May 2025 */
+         else if (pkts[j].rtp_pyldlen > 0 && pkts[j].rtp_pyldlen <= 7) {
+         #else
+         else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_DTX) {
          #endif
-         if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto exit;  /* see if abort flag set, JHB Jan 2023 */
+            numDTX++;
+            sprintf(&tmpstr[strlen(tmpstr)], " DTX");
+         }
+         else sprintf(&tmpstr[strlen(tmpstr)], " media");  /* added JHB Jun 2023 */
 
-         if (StreamStats[i].chnum[max(StreamStats[i].num_chnum - 1, 0)] != pkts[j].chnum) {  /* handle "dormant SSRCs" that are taken over by another channel, JHB Jan 2020 */
+         if (pkts[j].content_flags & DS_PKT_PYLD_CONTENT_REPAIR) {
 
-            if (StreamStats[i].num_chnum < MAX_CHAN_PER_SSRC) {  /* need to review this now that we're handling SSRCs shared across streams, JHB Jul 2024 */
-               StreamStats[i].chnum[StreamStats[i].num_chnum] = pkts[j].chnum;
-               StreamStats[i].num_chnum++;;
-            }
+            unsigned int uContent = pkts[j].content_flags & DS_PKT_PYLD_CONTENT_ITEM_MASK;
+
+            if (uContent == DS_PKT_PYLD_CONTENT_MEDIA || uContent == DS_PKT_PYLD_CONTENT_MEDIA_REUSE) StreamStats[i].numMediaRepair++;  /* check all media content types for repair flag, JHB Aug 2025 */
+            else StreamStats[i].numSIDRepair++;
+
+            sprintf(&tmpstr[strlen(tmpstr)], ", repaired");
          }
 
-         StreamStats[i].idx = pkts[j].idx;
+         j++;
+      }
+
+      if (fp_log) fprintf(fp_log, "%s\n", tmpstr);
 
-         fFound_sn = false;
-         fDup_sn = false;
-         fOoo_sn = false;
-         ooo_rtp_seqnum = 0;
-         dup_rtp_seqnum = 0;
+      if (!fDup_sn) {
+         rtp_seqnum++;  /* advance to next expected seq number */
+         if ((rtp_seqnum & 0xffff) == 0) seq_wrap++;  /* check for wrap after incrementing, JHB Jan2020 */
+      }
+   }
 
-      /* first check for duplicated seq numbers. We use a very narrow definition:  2 consecutive identical seq numbers. If a seq number randomly repeats somewhere, we don't currently look for that */
+   if (fp_log) {
+
+      fprintf(fp_log, "\n%s SSRC 0x%x chnum %d out-of-order seq numbers = %u, duplicate seq numbers = %u, missing seq numbers = %u, max consec missing seq numbers = %u", label, ssrcs[i], chnum[i], StreamStats[i].ooo_seqnum, StreamStats[i].dup_seqnum, StreamStats[i].missing_seqnum, StreamStats[i].max_consec_missing_seqnum);
+      if (StreamStats[i].numSID) fprintf(fp_log, ", SID packets = %u", StreamStats[i].numSID);
+      if (StreamStats[i].numSIDReuse) fprintf(fp_log, ", SID CNG-R packets = %u", StreamStats[i].numSIDReuse);
+      if (StreamStats[i].numSIDRepair) fprintf(fp_log, ", repaired SID packets = %u", StreamStats[i].numSIDRepair);
+      if (StreamStats[i].numMediaRepair) fprintf(fp_log, ", repaired media packets = %u", StreamStats[i].numMediaRepair);
+      if (StreamStats[i].numMediaReuse) fprintf(fp_log, ", media-R packets = %u", StreamStats[i].numMediaReuse);
+      if (numSIDNoData) fprintf(fp_log, ", SID CNG-N packets = %u", numSIDNoData);
+      if (!StreamStats[i].numSID && !StreamStats[i].numSIDReuse && !numSIDNoData) fprintf(fp_log, ", DTX packets = %u", numDTX);
+      if (StreamStats[i].numDTMFEvent) fprintf(fp_log, ", DTMF Event packets = %u", StreamStats[i].numDTMFEvent);
+      fprintf(fp_log, "\n");
 
-         if (j > 0 && pkts[j].rtp_seqnum == pkts[j-1].rtp_seqnum) {  /* is it duplicated ? */
+      if (i+1 < num_ssrcs) fprintf(fp_log, "\n");
+   }
+}
 
-//  printf("dup, pkts[j].rtp_seqnum = %u, next seq_num = %d, pyldlen = %d\n", pkts[j].rtp_seqnum, rtp_seqnum, pkts[j].rtp_pyldlen);
+/* worker pool for DS_PKTSTATS_LOG_PARALLEL mode, JHB Oct 2026. Notes:
 
-            fDup_sn = true;  /* duplicated seq number found */
+  -workers take the next SSRC group index from a shared counter and write log text for that group to a memory stream (open_memstream())
+  -the calling thread writes completed group text to fp_log in SSRC group order as soon as it's available, so output is identical to sequential mode and no more than a few groups are held in memory
+  -abort flag is checked by each worker before taking the next SSRC group, and by the calling thread after writing each group, as in sequential mode. On abort no further group headers or stats are written
+*/
 
-            if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_DTMF && !(uFlags & DS_PKTSTATS_LOG_MARK_DTMF_DUPLICATE)) fFound_sn = true;  /* if it's a DTMF event packet we don't label it duplicated (DTMF events can have several duplicated packets) */
-         }
-         else if (pkts[j].rtp_seqnum + seq_wrap[i]*65536L != rtp_seqnum) {  /* recorded seq number matches next (expected) seq number ? */
+#define PKTLOG_MAX_WORKERS  8
 
-            #define OOO_SEARCH_WINDOW 30  /* possibly this should be something users can set ?  JHB Dec2019 */
+typedef struct {
 
-            for (k=max(j-(OOO_SEARCH_WINDOW-1), first_pkt_idx[i]); k<min(j+OOO_SEARCH_WINDOW, last_pkt_idx[i]+1); k++) {  /* search +/- OOO_SEARCH_WINDOW number of packets to find ooo packets. Allow for 2x consecutive duplicates, this is a window of +/- 1/2x ptime */
+  FILE*             fp_log;
+  unsigned int      uFlags;
+  PKT_STATS*        pkts;
+  const char*       label;
+  int               num_ssrcs;
+  uint32_t*         ssrcs;
+  uint16_t*         chnum;
+  int*              first_pkt_idx;
+  int*              last_pkt_idx;
+  uint32_t*         first_rtp_seqnum;
+  uint32_t*         last_rtp_seqnum;
+  PKT_STREAM_STATS* StreamStats;
+  int               nThreadIndex;
+
+  int               next_ssrc;  /* next SSRC group to analyze, incremented atomically */
+  char**            text;       /* per SSRC group log text */
+  size_t*           text_len;
+  bool*             fDone;      /* per SSRC group done flags, protected by mutex */
+  bool              fAbort;     /* set by a worker that sees the abort flag, protected by mutex */
+  pthread_mutex_t   mutex;
+  pthread_cond_t    cond;
+
+} PKTLOG_WORK;
+
+static void* pktlog_worker(void* arg) {
+
+PKTLOG_WORK* w = (PKTLOG_WORK*)arg;
+int i;
+
+   while (1) {
+
+      if (Logging_Thread_Info[w->nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) {  /* see if abort flag set before taking next group */
+
+         pthread_mutex_lock(&w->mutex);
+         w->fAbort = true;
+         pthread_cond_broadcast(&w->cond);
+         pthread_mutex_unlock(&w->mutex);
+         break;
+      }
 
-               if (pkts[k].rtp_seqnum + seq_wrap[i]*65536L == rtp_seqnum) {
+      if ((i = __sync_fetch_and_add(&w->next_ssrc, 1)) >= w->num_ssrcs) break;
 
-                  StreamStats[i].ooo_max = max(StreamStats[i].ooo_max, (unsigned int)abs(k-j));  /* record max ooo */
-                  fOoo_sn = true;  /* found ooo seq num */
-                  break;
-               }
-            }
-         }
-         else fFound_sn = true;
+      FILE* fp = w->fp_log ? open_memstream(&w->text[i], &w->text_len[i]) : NULL;  /* if open_memstream() fails the group is still analyzed, but without log text */
 
-         if (fFound_sn) strcpy(seqstr, "");
-         strcpy(tmpstr, "");
+      log_ssrc_seqnums(i, fp, w->uFlags, w->pkts, w->label, w->num_ssrcs, w->ssrcs, w->chnum, w->first_pkt_idx, w->last_pkt_idx, w->first_rtp_seqnum, w->last_rtp_seqnum, w->StreamStats, w->nThreadIndex);
 
-         if (fOoo_sn) {
+      if (fp) fclose(fp);
 
-            ooo_rtp_seqnum = pkts[j].rtp_seqnum + seq_wrap[i]*65536L;
-            sprintf(seqstr, "ooo %u", (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) ? rtp_seqnum & 0xffff : rtp_seqnum);
-            StreamStats[i].ooo_seqnum++;
-            max_consec_missing[i] = 0;
-         }
-         else if (fDup_sn) {
+      pthread_mutex_lock(&w->mutex);
+      w->fDone[i] = true;
+      pthread_cond_broadcast(&w->cond);
+      pthread_mutex_unlock(&w->mutex);
+   }
 
-            if (!fFound_sn) {
-               strcpy(seqstr, "dup");
-               StreamStats[i].dup_seqnum++;
-            }
+   return NULL;
+}
 
-            dup_rtp_seqnum = pkts[j].rtp_seqnum + seq_wrap[i]*65536L;
-            max_consec_missing[i] = 0;
-         }
-         else if (!fFound_sn) {
+static void log_ssrc_seqnums_parallel(FILE* fp_log, unsigned int uFlags, PKT_STATS* pkts, const char* label, int num_ssrcs, uint32_t ssrcs[], uint16_t chnum[], int first_pkt_idx[], int last_pkt_idx[], uint32_t first_rtp_seqnum[], uint32_t last_rtp_seqnum[], PKT_STREAM_STATS StreamStats[], int nThreadIndex) {
 
-            strcpy(seqstr, "nop");
-            StreamStats[i].missing_seqnum++;
-            max_consec_missing[i]++;
-            StreamStats[i].max_consec_missing_seqnum = max(StreamStats[i].max_consec_missing_seqnum, max_consec_missing[i]);
-         }
-         else max_consec_missing[i] = 0;
+PKTLOG_WORK w;
+pthread_t threads[PKTLOG_MAX_WORKERS];
+int i, num_threads = 0, num_workers = min(num_ssrcs, min(PKTLOG_MAX_WORKERS, max((int)sysconf(_SC_NPROCESSORS_ONLN), 1)));
 
-         nSpaces = max(1, 12-(int)strlen(seqstr));
-         for (k=0; k<nSpaces; k++) strcat(seqstr, " ");
+   w.fp_log = fp_log; w.uFlags = uFlags; w.pkts = pkts; w.label = label; w.num_ssrcs = num_ssrcs;
+   w.ssrcs = ssrcs; w.chnum = chnum; w.first_pkt_idx = first_pkt_idx; w.last_pkt_idx = last_pkt_idx; w.first_rtp_seqnum = first_rtp_seqnum; w.last_rtp_seqnum = last_rtp_seqnum;
+   w.StreamStats = StreamStats; w.nThreadIndex = nThreadIndex;
+   w.next_ssrc = 0;
+   w.fAbort = false;
+   w.text = (char**)calloc(num_ssrcs, sizeof(char*));
+   w.text_len = (size_t*)calloc(num_ssrcs, sizeof(size_t));
+   w.fDone = (bool*)calloc(num_ssrcs, sizeof(bool));
+   pthread_mutex_init(&w.mutex, NULL);
+   pthread_cond_init(&w.cond, NULL);
 
-         if (ooo_rtp_seqnum) sprintf(&tmpstr[strlen(tmpstr)], "Seq num %u %s", (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) ? ooo_rtp_seqnum & 0xffff : ooo_rtp_seqnum, seqstr);
-         else if (fDup_sn) sprintf(&tmpstr[strlen(tmpstr)], "Seq num %u %s", (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) ? dup_rtp_seqnum & 0xffff : dup_rtp_seqnum, seqstr);
-         else sprintf(&tmpstr[strlen(tmpstr)], "Seq num %u %s", (uFlags & DS_PKTSTATS_LOG_SHOW_WRAPPED_SEQNUMS) ? rtp_seqnum & 0xffff : rtp_seqnum, seqstr);
+   if (w.text && w.text_len && w.fDone) for (i=0; i<num_workers; i++) if (!pthread_create(&threads[num_threads], NULL, pktlog_worker, &w)) num_threads++;
 
-         if (fFound_sn || fDup_sn || fOoo_sn) {
+   if (!num_threads) {  /* allocation or thread creation failed, analyze sequentially */
 
-            sprintf(&tmpstr[strlen(tmpstr)], " timestamp = %u, rtp pyld len = %u", pkts[j].rtp_timestamp, pkts[j].rtp_pyldlen);  /* changed from "pkt len =", JHB Jun 2023 */
+      for (i=0; i<num_ssrcs; i++) {
 
-            if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_SID) {
-               StreamStats[i].numSID++;
-               sprintf(&tmpstr[strlen(tmpstr)], " SID");
-            }
-            else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_SID_REUSE) {
-               StreamStats[i].numSIDReuse++;
-               sprintf(&tmpstr[strlen(tmpstr)], " SID CNG-R");
-            }
-            else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_MEDIA_REUSE) {
-               StreamStats[i].numMediaReuse++;
-               sprintf(&tmpstr[strlen(tmpstr)], " media-R");
-            }
-            else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_SID_NODATA) {
-               numSIDNoData++;
-               sprintf(&tmpstr[strlen(tmpstr)], " SID NoData");
-            }
-            else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_DTMF) {
-               StreamStats[i].numDTMFEvent++;
-               if (pkts[j].content_flags & DS_PKT_PYLD_CONTENT_DTMF_END) sprintf(&tmpstr[strlen(tmpstr)], " DTMF Event End");
-               sprintf(&tmpstr[strlen(tmpstr)], " DTMF Event");
-            }
-            #if 0  /* no assumptions should be based only on payload size, we need to go by DS_PKT_PYLD_CONTENT_XXX flags only, JHB May 2025 */
-            else if (pkts[j].rtp_pyldlen > 0 && pkts[j].rtp_pyldlen <= 7) {
-            #else
-            else if ((pkts[j].content_flags & DS_PKT_INFO_ITEM_MASK) == DS_PKT_PYLD_CONTENT_DTX) {
-            #endif
-               numDTX++;
-               sprintf(&tmpstr[strlen(tmpstr)], " DTX");
-            }
-            else sprintf(&tmpstr[strlen(tmpstr)], " media");  /* added JHB Jun 2023 */
+         log_ssrc_seqnums(i, fp_log, uFlags, pkts, label, num_ssrcs, ssrcs, chnum, first_pkt_idx, last_pkt_idx, first_rtp_seqnum, last_rtp_seqnum, StreamStats, nThreadIndex);
 
-            if (pkts[j].content_flags & DS_PKT_PYLD_CONTENT_REPAIR) {
+         if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) break;  /* see if abort flag set */
+      }
+   }
+   else for (i=0; i<num_ssrcs; i++) {  /* write log text in SSRC group order */
 
-               unsigned int uContent = pkts[j].content_flags & DS_PKT_PYLD_CONTENT_ITEM_MASK;
+      pthread_mutex_lock(&w.mutex);
+      while (!w.fDone[i] && !w.fAbort) pthread_cond_wait(&w.cond, &w.mutex);
+      bool fDone = w.fDone[i];
+      pthread_mutex_unlock(&w.mutex);
 
-               if (uContent == DS_PKT_PYLD_CONTENT_MEDIA || uContent == DS_PKT_PYLD_CONTENT_MEDIA_REUSE) StreamStats[i].numMediaRepair++;  /* check all media content types for repair flag, JHB Aug 2025 */
-               else StreamStats[i].numSIDRepair++;
+      if (!fDone) break;  /* aborted before this group was taken */
 
-               sprintf(&tmpstr[strlen(tmpstr)], ", repaired");
-            }
+      if (fp_log && w.text[i]) fwrite(w.text[i], 1, w.text_len[i], fp_log);
+      else if (fp_log) fprintf(fp_log, "%s SSRC 0x%x chnum %d packet info not available (memory stream allocation failed)\n", label, ssrcs[i], chnum[i]);
 
-            j++;
-         }
+      free(w.text[i]);
+      w.text[i] = NULL;
 
-         if (fp_log) fprintf(fp_log, "%s\n", tmpstr);
+      if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) break;  /* see if abort flag set */
+   }
 
-         if (!fDup_sn) {
-            rtp_seqnum++;  /* advance to next expected seq number */
-            if ((rtp_seqnum & 0xffff) == 0) seq_wrap[i]++;  /* check for wrap after incrementing, JHB Jan2020 */
-         }
-      }
+   for (i=0; i<num_threads; i++) pthread_join(threads[i], NULL);
 
-      if (fp_log) {
-
-         fprintf(fp_log, "\n%s SSRC 0x%x chnum %d out-of-order seq numbers = %u, duplicate seq numbers = %u, missing seq numbers = %u, max consec missing seq numbers = %u", label, ssrcs[i], chnum[i], StreamStats[i].ooo_seqnum, StreamStats[i].dup_seqnum, StreamStats[i].missing_seqnum, StreamStats[i].max_consec_missing_seqnum);
-         if (StreamStats[i].numSID) fprintf(fp_log, ", SID packets = %u", StreamStats[i].numSID);
-         if (StreamStats[i].numSIDReuse) fprintf(fp_log, ", SID CNG-R packets = %u", StreamStats[i].numSIDReuse);
-         if (StreamStats[i].numSIDRepair) fprintf(fp_log, ", repaired SID packets = %u", StreamStats[i].numSIDRepair);
-         if (StreamStats[i].numMediaRepair) fprintf(fp_log, ", repaired media packets = %u", StreamStats[i].numMediaRepair);
-         if (StreamStats[i].numMediaReuse) fprintf(fp_log, ", media-R packets = %u", StreamStats[i].numMediaReuse);
-         if (numSIDNoData) fprintf(fp_log, ", SID CNG-N packets = %u", numSIDNoData);
-         if (!StreamStats[i].numSID && !StreamStats[i].numSIDReuse && !numSIDNoData) fprintf(fp_log, ", DTX packets = %u", numDTX);
-         if (StreamStats[i].numDTMFEvent) fprintf(fp_log, ", DTMF Event packets = %u", StreamStats[i].numDTMFEvent);
-         fprintf(fp_log, "\n");
+   if (w.text) for (i=0; i<num_ssrcs; i++) if (w.text[i]) free(w.text[i]);  /* text of groups finished by workers but not written due to abort */
 
-         if (i+1 < num_ssrcs) fprintf(fp_log, "\n");
-      }
+   pthread_mutex_destroy(&w.mutex);
+   pthread_cond_destroy(&w.cond);
+
+   if (w.text) free(w.text);
+   if (w.text_len) free(w.text_len);
+   if (w.fDone) free(w.fDone);
+}
+
+int DSPktStatsLogSeqnums(FILE* fp_log, unsigned int uFlags, PKT_STATS* pkts, int num_pkts, const char* label, uint32_t ssrcs[], uint16_t chnum[], int first_pkt_idx[], int last_pkt_idx[], uint32_t first_rtp_seqnum[], uint32_t last_rtp_seqnum[], PKT_STREAM_STATS StreamStats[]) {
+
+int           i;
+int           num_ssrcs;
+
+   int nThreadIndex = GetThreadIndex(true);
+
+/* first group data by unique SSRCs */
+
+   if ((num_ssrcs = DSFindSSRCGroups(pkts, uFlags, num_pkts, ssrcs, chnum, first_pkt_idx, last_pkt_idx, first_rtp_seqnum, last_rtp_seqnum)) < 0) return num_ssrcs;  /* error condition, JHB Oct 2026 */
+
+   #ifdef SIMULATE_SLOW_TIME
+   usleep(SIMULATE_SLOW_TIME);
+   #endif
+   if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto cleanup;  /* see if abort flag set, JHB Jan 2023 */
+
+   #if 0  /* debug -- see if sort looks ok */
+   fprintf(fp_log, "%s sorted by SSRC (no analysis), numpkts = %d\n", label, num_pkts);
+   for (j=0; j<num_pkts; j++) {
+
+      fprintf(fp_log, "seq = %u, ssrc = 0x%x", pkts[j].rtp_seqnum, pkts[j].rtp_ssrc);
+
+      print_packet_type(fp_log, pkts[j].content_flags, -1, -1);
+   }
+   fprintf(fp_log, "\n");
+   #endif
+
+   for (i=0; i<num_ssrcs; i++) memset(StreamStats[i].chnum, 0xff, sizeof(StreamStats[0].chnum));
+
+/* for each SSRC group, fill in StreamStats[], and write stats to log file if fp_log not NULL */
+
+   if ((uFlags & DS_PKTSTATS_LOG_PARALLEL) && num_ssrcs > 1) log_ssrc_seqnums_parallel(fp_log, uFlags, pkts, label, num_ssrcs, ssrcs, chnum, first_pkt_idx, last_pkt_idx, first_rtp_seqnum, last_rtp_seqnum, StreamStats, nThreadIndex);  /* SSRC groups analyzed by worker threads, JHB Oct 2026 */
+
+   else for (i=0; i<num_ssrcs; i++) {
+
+      log_ssrc_seqnums(i, fp_log, uFlags, pkts, label, num_ssrcs, ssrcs, chnum, first_pkt_idx, last_pkt_idx, first_rtp_seqnum, last_rtp_seqnum, StreamStats, nThreadIndex);  /* moved per SSRC group analysis and logging to log_ssrc_seqnums(), JHB Oct 2026 */
+
+      if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto cleanup;  /* see if abort flag set */
    }
 
-exit:
+cleanup:
 
    return num_ssrcs;
 }
@@ -937,7 +1626,7 @@ int nGroupIndex = 0, stream_count = 0, nNumGroups = 0;
          #ifdef SIMULATE_SLOW_TIME
          usleep(SIMULATE_SLOW_TIME);
          #endif
-         if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto exit;  /* see if abort flag set, JHB Jan 2023 */
+         if (Logging_Thread_Info[nThreadIndex].uFlags & DS_CONFIG_LOGGING_PKTLOG_ABORT) goto cleanup;  /* see if abort flag set, JHB Jan 2023 */
 
          unsigned int rtp_seqnum_chk = input_pkts[j].rtp_seqnum + in_seq_wrap[i]*65536L;  /* input seq number */
 
@@ -1227,7 +1916,7 @@ check_for_reuse:
 
    } while ((nNumGroups && nGroupIndex < MAX_GROUPS) || ++i < num_ssrcs);  /* continue with stream group map search (if applicable), when that expires increment ssrc index for non-group streams, JHB Sep 2024 */
 
-exit:
+cleanup:
 
    if (GroupMap) free(GroupMap);
 
@@ -1290,6 +1979,11 @@ PKT_STREAM_STATS*  OutputStreamStats = NULL;
 uint64_t       t1, t2;
 int            nThreadIndex;
 
+PKT_STATS*     arena_input_pkts = NULL;  /* DS_PKTSTATS_LOG_ARENA items, JHB Oct 2026 */
+PKT_STATS*     arena_output_pkts = NULL;
+size_t         arena_input_map_len = 0, arena_output_map_len = 0;
+PKT_COUNTERS   arena_pkt_counters;
+
 /* error condition checks */
 
    if (!pkt_counters) {
@@ -1297,6 +1991,20 @@ int            nThreadIndex;
       goto cleanup;
    }
 
+/* if input_pkts and output_pkts are arenas, read their entries (including any spilled to disk) into temporary arrays. Counts are taken from the arenas, other counters are unchanged, JHB Oct 2026 */
+
+   if (uFlags & DS_PKTSTATS_LOG_ARENA) {
+
+      arena_pkt_counters = *pkt_counters;
+
+      arena_input_pkts = arena_gather(input_pkts, &arena_pkt_counters.num_input_pkts, &arena_input_map_len);
+      arena_output_pkts = arena_gather(output_pkts, &arena_pkt_counters.num_pulled_pkts, &arena_output_map_len);
+
+      input_pkts = arena_input_pkts;
+      output_pkts = arena_output_pkts;
+      pkt_counters = &arena_pkt_counters;
+   }
+
    if (!szLogFile || !strlen(szLogFile)) {
       Log_RT(2, "ERROR: DSPktStatsWriteLogFile() says log path / file is %s \n", !szLogFile ? "NULL" : "empty string");
       goto cleanup;
@@ -1421,6 +2129,8 @@ int            nThreadIndex;
 
       in_ssrc_groups = DSPktStatsLogSeqnums(fp_log, uFlags, input_pkts, input_idx, "Ingress", in_ssrcs, in_chnum, in_first_pkt_idx, in_last_pkt_idx, in_first_rtp_seqnum, in_last_rtp_seqnum, InputStreamStats);
 
+      if (in_ssrc_groups < 0) goto cleanup;  /* error condition, ret_code is still -1, JHB Oct 2026 */
+
       #ifdef SIMULATE_SLOW_TIME
       usleep(SIMULATE_SLOW_TIME);
       #endif
@@ -1474,6 +2184,8 @@ int            nThreadIndex;
 
       out_ssrc_groups = DSPktStatsLogSeqnums(fp_log, uFlags, output_pkts, output_idx, "Jitter Buffer", out_ssrcs, out_chnum, out_first_pkt_idx, out_last_pkt_idx, out_first_rtp_seqnum, out_last_rtp_seqnum, OutputStreamStats);
 
+      if (out_ssrc_groups < 0) goto cleanup;
+
       #ifdef SIMULATE_SLOW_TIME
       usleep(SIMULATE_SLOW_TIME);
       #endif
@@ -1652,5 +2364,8 @@ cleanup:
    if (InputStreamStats) free(InputStreamStats);
    if (OutputStreamStats) free(OutputStreamStats);
 
+   arena_release(arena_input_pkts, arena_input_map_len);
+   arena_release(arena_output_pkts, arena_output_map_len);
+
    return ret_code;
 }
@@ -14,11 +14,14 @@
    Modified Jan 2023 JHB, remove reference to set_api_status()
    Modified Jan 2023 JHB, add items to support DSConfigPktLogging() API
    Modified Jul 2024 JHB, change comment reference lib_logging.cpp to event_logging.cpp
+   Modified Oct 2026 JHB, add binary event log functions in event_log_binary.cpp
 */
  
 #ifndef _DIAGLIB_PRIV_H_
 #define _DIAGLIB_PRIV_H_
 
+#include <stdarg.h>  /* va_list */
+
 #if 1  /* moved here from pktlib_priv.h, JHB Sep2017 */
 //#define DNUM                  0  /* moved to std_rtaf.h */
 #define Dsp_Log(a, ...)       Log_RT(a, __VA_ARGS__)
@@ -45,6 +48,12 @@ typedef struct {
 
 __attribute__((visibility("hidden"))) int GetThreadIndex(bool fUseSem);
 
+/* binary event log, called by Log_RT() and DSCloseLogging(). Defined in event_log_binary.cpp, JHB Oct 2026 */
+
+__attribute__((visibility("hidden"))) int binary_event_log_write(uint32_t loglevel, const char* fmt, va_list va);
+__attribute__((visibility("hidden"))) int binary_event_log_write_text(uint32_t loglevel, const char* str, int len);
+__attribute__((visibility("hidden"))) void binary_event_log_close();
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,847 @@
+/*
+ $Header: /root/Signalogic/DirectCore/lib/diaglib/event_log_binary.cpp
+
+ Description: SigSRF and EdgeStream binary event log writer and offline formatter
+
+ Project: SigSRF, DirectCore
+
+ Copyright Signalogic Inc. 2026
+
+ Use and distribution of this source code is subject to terms and conditions of the Github SigSRF License v1.1, published at https://github.com/signalogic/SigSRF_SDK/blob/master/LICENSE.md. Absolutely prohibited for AI language or programming model training use
+
+ Revision History
+
+  Created Oct 2026 JHB
+  Modified Oct 2026 JHB, in get_format() look up format strings by contents (hash and strcmp) instead of pointer, keep a copy of each format string. Format strings in reused buffers were matched to stale table entries. binary_event_log_write() holds binlog_writers during format lookup so binary_event_log_close() doesn't free format strings in use. reserve_record() doesn't wait on binlog_lock if the binary event log is being closed
+  Modified Oct 2026 JHB, intern only literal format strings (located in read-only segments of loaded objects, see is_literal()). Dynamic format strings, e.g. preformatted strings passed as Log_RT(level, str), are written as BINLOG_RECORD_INLINE records containing the format string followed by args, so they don't fill the format table. binary_event_log_close() uses seq_cst ordering between clearing binlog_cur_segment and checking binlog_writers
+*/
+
+/* binary event log notes, JHB Oct 2026:
+
+  -enabled by DS_EVENT_LOG_BINARY flag in uEventLogMode (shared_include/config.h). Log_RT() event log file output is written as binary records to "<event log path>.bin" instead of text to the event log file. Console output is not affected
+  -Log_RT() does not call vsnprintf() or DSGetTimestamp() for binary records; instead each record contains a format string id, gettimeofday() time, thread index, log level, and raw args. Format strings are written once per run as format records, the first time a format string is seen
+  -only literal format strings (those located in a read-only segment of the executable or a shared lib loaded when the binary event log is opened) are added to the format table. Format strings in writable memory (e.g. sprintf() to a local string followed by Log_RT(level, str)) are written as inline records that contain the format string followed by args. This keeps the format table from filling up with one-time strings on long runs
+  -format strings are looked up by content (hash and strcmp), not by pointer, and the format table keeps a copy of each format string
+  -args are captured by parsing the format string once when first seen. Format strings with specifiers that can't be captured (%n, %m, long double, wide strings, more than BINLOG_MAX_ARGS args) and DS_LOG_LEVEL_APPEND_STRING strings are formatted as text and written as text records
+  -the file is memory mapped in BINLOG_SEGMENT_SIZE segments. Writers reserve record space with an atomic add, so no lock is taken except when a new segment is mapped. Records never span segments; unused space at the end of a segment is zero
+  -record length is written last, so a partially written record (e.g. after a crash) has zero length and the reader skips to the next segment
+  -DSFormatBinaryEventLog() renders a binary event log as text, in the same format as Log_RT() text output (timestamps, leading newline handling, WEC substitution, etc). The eventLogFormat app (apps/eventLogFormat) calls DSFormatBinaryEventLog()
+  -uEventLog_max_size and uEventLog_fflush_size do not apply to binary event logs
+*/
+
+/* Linux includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>  /* gettimeofday() */
+#include <link.h>      /* dl_iterate_phdr() */
+#include <algorithm>   /* std::min and std::max */
+
+using namespace std;
+
+/* SigSRF includes */
+
+#include "diaglib.h"
+#include "shared_include/config.h"
+
+/* private includes */
+
+#include "diaglib_priv.h"
+
+extern DEBUG_CONFIG lib_dbg_cfg;  /* in event_logging.cpp */
+extern uint64_t usec_base;
+
+/* binary event log file format */
+
+#define BINLOG_MAGIC            "SIGBLOG"
+#define BINLOG_VERSION          1
+#define BINLOG_SEGMENT_SIZE     (16*1024*1024)  /* must be a multiple of page size */
+#define BINLOG_MAX_SEGMENTS     16384           /* 256 GB max binary event log size per run */
+#define BINLOG_MAX_ARGS         32
+
+enum {  /* record types */
+
+  BINLOG_RECORD_SESSION = 1,  /* start of a logging run, followed by BINLOG_SESSION. Always first record in a segment */
+  BINLOG_RECORD_FORMAT,       /* format string definition, followed by zero-terminated format string */
+  BINLOG_RECORD_EVENT,        /* Log_RT() event, followed by args */
+  BINLOG_RECORD_TEXT,         /* Log_RT() event preformatted as text, followed by zero-terminated string */
+  BINLOG_RECORD_INLINE        /* Log_RT() event with a non-literal format string, followed by zero-terminated format string padded to 8 bytes, then args */
+};
+
+enum {  /* arg types. Each arg takes 8 bytes, except strings which take a 4 byte length followed by string chars, padded to 8 bytes */
+
+  BINLOG_ARG_INT = 1,
+  BINLOG_ARG_LONG,
+  BINLOG_ARG_DOUBLE,
+  BINLOG_ARG_STR,
+  BINLOG_ARG_PTR
+};
+
+typedef struct {
+
+  uint32_t len;           /* record length in bytes including header, multiple of 8. Zero indicates end of records in a segment */
+  uint16_t type;          /* BINLOG_RECORD_xxx */
+  uint16_t thread_index;  /* Logging_Thread_Info[] index of thread calling Log_RT() */
+  uint32_t id;            /* format string id */
+  uint32_t loglevel;      /* Log_RT() loglevel param, including DS_LOG_LEVEL_xxx flags */
+  uint64_t usec;          /* gettimeofday() time in usec */
+
+} BINLOG_RECORD_HEADER;
+
+typedef struct {
+
+  char     magic[8];
+  uint32_t version;
+  uint32_t segment_size;
+  uint64_t usec_base;     /* Log_RT() uptime timestamp reference */
+  uint32_t uEventLogMode;
+  uint32_t reserved;
+
+} BINLOG_SESSION;
+
+/* format string specifier parsing, used by both writer and formatter */
+
+typedef struct {
+
+  int len;        /* specifier length, starting at % */
+  int num_star;   /* number of '*' width and precision args */
+  int type;       /* BINLOG_ARG_xxx, or 0 for %% */
+
+} BINLOG_SPEC;
+
+static const char* parse_spec(const char* p, BINLOG_SPEC* spec) {  /* p points at '%'. Returns NULL if specifier is not supported */
+
+const char* start = p;
+int length = 0;  /* 0 = none, 1 = h or hh, 2 = l, ll, q, j, z, or t, 3 = L */
+
+   spec->num_star = 0;
+   p++;
+
+   if (*p == '%') { spec->type = 0; spec->len = 2; return p+1; }
+
+   while (*p && strchr("-+ #0'", *p)) p++;  /* flags */
+
+   if (*p == '*') { spec->num_star++; p++; }
+   else while (*p >= '0' && *p <= '9') p++;  /* width */
+
+   if (*p == '.') {  /* precision */
+      p++;
+      if (*p == '*') { spec->num_star++; p++; }
+      else while (*p >= '0' && *p <= '9') p++;
+   }
+
+   while (*p && strchr("hlqjztL", *p)) { length = max(length, *p == 'h' ? 1 : (*p == 'L' ? 3 : 2)); p++; }
+
+   switch (*p) {
+
+      case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+         spec->type = length == 2 ? BINLOG_ARG_LONG : BINLOG_ARG_INT;
+         if (length == 3) return NULL;
+         break;
+
+      case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+         if (length == 3) return NULL;  /* long double not supported */
+         spec->type = BINLOG_ARG_DOUBLE;
+         break;
+
+      case 's':
+         if (length) return NULL;  /* wide strings not supported */
+         spec->type = BINLOG_ARG_STR;
+         break;
+
+      case 'p':
+         spec->type = BINLOG_ARG_PTR;
+         break;
+
+      default:  /* %n, %m, and anything else */
+         return NULL;
+   }
+
+   spec->len = p+1 - start;
+
+   return p+1;
+}
+
+/* binary event log writer */
+
+typedef struct {
+
+  char* fmt;                /* copy of format string */
+  uint32_t hash;            /* hash of format string contents */
+  volatile uint8_t state;   /* 0 = empty, 1 = being initialized, 2 = ready */
+  uint8_t  num_args;        /* 0xff if format string not supported */
+  uint8_t  arg_types[BINLOG_MAX_ARGS];
+  uint32_t id;
+
+} BINLOG_FORMAT;
+
+#define BINLOG_FORMAT_TABLE_SIZE  8192  /* power of 2, more than number of Log_RT() format strings in SigSRF libs and apps */
+
+static BINLOG_FORMAT binlog_formats[BINLOG_FORMAT_TABLE_SIZE];
+static uint32_t binlog_num_formats = 0;
+
+typedef struct {
+
+  uint8_t* base;
+  volatile uint64_t used;
+
+} BINLOG_SEGMENT;
+
+static BINLOG_SEGMENT binlog_segments[BINLOG_MAX_SEGMENTS];
+static volatile int binlog_cur_segment = -1;
+static volatile uint32_t binlog_writers = 0;  /* number of threads currently writing records, checked by binary_event_log_close() before unmapping segments */
+static int binlog_fd = -1;
+static bool fBinlogOpenFailed = false;
+static bool fBinlogReopen = false;  /* set after binary_event_log_close(). If Log_RT() is called after DSCloseLogging() the binary event log is appended, not overwritten */
+static uint64_t binlog_file_base = 0;  /* file offset of first segment, non-zero if appending to an existing binary event log */
+static uint8_t binlog_lock = 0;
+
+typedef struct {
+
+  uintptr_t start;
+  uintptr_t end;
+
+} BINLOG_RO_RANGE;
+
+typedef struct {
+
+  BINLOG_RO_RANGE* ranges;  /* NULL when counting */
+  int num_ranges;
+
+} BINLOG_RO_RANGES;
+
+static BINLOG_RO_RANGES binlog_ro = { NULL, 0 };  /* read-only segments of loaded objects, built when the binary event log is opened and freed when it's closed */
+
+static int add_ro_ranges(struct dl_phdr_info* info, size_t size, void* data) {  /* dl_iterate_phdr() callback */
+
+BINLOG_RO_RANGES* ro = (BINLOG_RO_RANGES*)data;
+int i;
+
+   (void)size;
+
+   for (i=0; i<info->dlpi_phnum; i++) if (info->dlpi_phdr[i].p_type == PT_LOAD && !(info->dlpi_phdr[i].p_flags & PF_W)) {
+
+      if (ro->ranges) {
+         ro->ranges[ro->num_ranges].start = info->dlpi_addr + info->dlpi_phdr[i].p_vaddr;
+         ro->ranges[ro->num_ranges].end = ro->ranges[ro->num_ranges].start + info->dlpi_phdr[i].p_memsz;
+      }
+
+      ro->num_ranges++;
+   }
+
+   return 0;
+}
+
+static void find_ro_ranges() {  /* called with binlog_lock held */
+
+BINLOG_RO_RANGES count = { NULL, 0 };
+
+   dl_iterate_phdr(add_ro_ranges, &count);
+
+   if (count.num_ranges && (binlog_ro.ranges = (BINLOG_RO_RANGE*)malloc(count.num_ranges*sizeof(BINLOG_RO_RANGE)))) {
+
+      binlog_ro.num_ranges = 0;
+      dl_iterate_phdr(add_ro_ranges, &binlog_ro);
+      binlog_ro.num_ranges = min(binlog_ro.num_ranges, count.num_ranges);  /* in case a lib was loaded between the two calls */
+   }
+}
+
+static bool is_literal(const char* fmt) {  /* true if fmt is in a read-only segment, i.e. a string literal. If ranges aren't available all format strings are treated as non-literal */
+
+int i;
+
+   for (i=0; i<binlog_ro.num_ranges; i++) if ((uintptr_t)fmt >= binlog_ro.ranges[i].start && (uintptr_t)fmt < binlog_ro.ranges[i].end) return true;
+
+   return false;
+}
+
+static bool map_segment(int k) {  /* called with binlog_lock held */
+
+   if (k >= BINLOG_MAX_SEGMENTS || ftruncate(binlog_fd, binlog_file_base + (uint64_t)(k+1)*BINLOG_SEGMENT_SIZE) < 0) return false;
+
+   void* base = mmap(NULL, BINLOG_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, binlog_fd, binlog_file_base + (uint64_t)k*BINLOG_SEGMENT_SIZE);
+   if (base == MAP_FAILED) return false;
+
+   binlog_segments[k].base = (uint8_t*)base;
+   binlog_segments[k].used = 0;
+
+   return true;
+}
+
+static bool open_binary_event_log() {
+
+char szFilename[MAX_EVENT_LOG_PATHNAME_LEN + 10];
+bool fAppend = (lib_dbg_cfg.uEventLogMode & DS_EVENT_LOG_APPEND) || fBinlogReopen;
+struct stat st;
+
+   while (__sync_lock_test_and_set(&binlog_lock, 1) != 0);  /* wait until the lock is zero then write 1 to it */
+
+   if (binlog_cur_segment < 0 && !fBinlogOpenFailed && lib_dbg_cfg.szEventLogFilePath[0]) {
+
+      sprintf(szFilename, "%s.bin", lib_dbg_cfg.szEventLogFilePath);
+
+      binlog_fd = open(szFilename, O_RDWR | O_CREAT | (fAppend ? 0 : O_TRUNC), 0644);
+
+      if (binlog_fd >= 0 && fAppend && !fstat(binlog_fd, &st)) binlog_file_base = (st.st_size + BINLOG_SEGMENT_SIZE-1) / BINLOG_SEGMENT_SIZE * BINLOG_SEGMENT_SIZE;  /* append starts at next segment boundary */
+      else binlog_file_base = 0;
+
+      if (binlog_fd >= 0 && map_segment(0)) {
+
+      /* first record is session info */
+
+         BINLOG_RECORD_HEADER* hdr = (BINLOG_RECORD_HEADER*)binlog_segments[0].base;
+         BINLOG_SESSION* session = (BINLOG_SESSION*)&hdr[1];
+
+         memcpy(session->magic, BINLOG_MAGIC, sizeof(session->magic));
+         session->version = BINLOG_VERSION;
+         session->segment_size = BINLOG_SEGMENT_SIZE;
+         session->usec_base = usec_base;
+         session->uEventLogMode = lib_dbg_cfg.uEventLogMode;
+
+         hdr->type = BINLOG_RECORD_SESSION;
+         hdr->len = sizeof(BINLOG_RECORD_HEADER) + sizeof(BINLOG_SESSION);
+         binlog_segments[0].used = hdr->len;
+
+         find_ro_ranges();
+
+         __atomic_store_n(&binlog_cur_segment, 0, __ATOMIC_RELEASE);
+      }
+      else {
+
+         fprintf(stderr, "\nERROR: Log_RT() says unable to create binary event log file %s, errno = %d, using text event log \n", szFilename, errno);
+         if (binlog_fd >= 0) { close(binlog_fd); binlog_fd = -1; }
+         fBinlogOpenFailed = true;
+      }
+   }
+
+   __sync_lock_release(&binlog_lock);
+
+   return binlog_cur_segment >= 0;
+}
+
+static uint8_t* reserve_record(int len) {  /* reserve record space, caller must have incremented binlog_writers */
+
+   for (;;) {
+
+      int k = __atomic_load_n(&binlog_cur_segment, __ATOMIC_SEQ_CST);  /* seq_cst, pairs with binary_event_log_close(). Caller has incremented binlog_writers */
+      if (k < 0) return NULL;
+
+      uint64_t offset = __sync_fetch_and_add(&binlog_segments[k].used, len);
+      if (offset + len <= BINLOG_SEGMENT_SIZE) return binlog_segments[k].base + offset;
+
+   /* segment is full, map next segment if another thread hasn't already */
+
+      while (__sync_lock_test_and_set(&binlog_lock, 1) != 0) if (__atomic_load_n(&binlog_cur_segment, __ATOMIC_ACQUIRE) < 0) return NULL;  /* binary_event_log_close() holds binlog_lock while waiting for writers */
+
+      bool fOk = true;
+      if (binlog_cur_segment == k) {
+         if ((fOk = map_segment(k+1))) __atomic_store_n(&binlog_cur_segment, k+1, __ATOMIC_RELEASE);
+      }
+
+      __sync_lock_release(&binlog_lock);
+
+      if (!fOk) return NULL;
+   }
+}
+
+static void commit_record(uint8_t* rec, int len, int type, uint32_t id, uint32_t loglevel, uint64_t usec) {
+
+BINLOG_RECORD_HEADER* hdr = (BINLOG_RECORD_HEADER*)rec;
+
+   hdr->type = type;
+   hdr->thread_index = GetThreadIndex(false);
+   hdr->id = id;
+   hdr->loglevel = loglevel;
+   hdr->usec = usec;
+
+   __atomic_store_n(&hdr->len, len, __ATOMIC_RELEASE);  /* length is written last, see notes above */
+}
+
+static int write_record(int type, uint32_t id, uint32_t loglevel, uint64_t usec, const void* data, int data_len) {
+
+int len = sizeof(BINLOG_RECORD_HEADER) + ((data_len + 7) & ~7);
+int ret_val = -1;
+
+   __sync_fetch_and_add(&binlog_writers, 1);
+
+   uint8_t* rec = reserve_record(len);
+
+   if (rec) {
+      memcpy(rec + sizeof(BINLOG_RECORD_HEADER), data, data_len);
+      commit_record(rec, len, type, id, loglevel, usec);
+      ret_val = data_len;
+   }
+
+   __sync_fetch_and_sub(&binlog_writers, 1);
+
+   return ret_val;
+}
+
+static uint8_t parse_format(const char* fmt, uint8_t arg_types[]) {  /* fill arg_types[] from format string specifiers. Returns number of args, or 0xff if format string not supported */
+
+BINLOG_SPEC spec;
+const char* p = fmt;
+int n, num_args = 0;
+
+   while ((p = strchr(p, '%'))) {
+
+      if (!(p = parse_spec(p, &spec)) || num_args + spec.num_star + 1 > BINLOG_MAX_ARGS) return 0xff;
+
+      for (n=0; n<spec.num_star; n++) arg_types[num_args++] = BINLOG_ARG_INT;
+      if (spec.type) arg_types[num_args++] = spec.type;
+   }
+
+   return num_args;
+}
+
+static BINLOG_FORMAT* get_format(const char* fmt) {  /* look up literal format string by contents, add it if not found. Caller must have incremented binlog_writers */
+
+uint32_t i, h, hash = 2166136261U;  /* FNV-1a */
+const char* p;
+
+   for (p=fmt; *p; p++) hash = (hash ^ (uint8_t)*p) * 16777619U;
+
+   for (i=0, h = hash & (BINLOG_FORMAT_TABLE_SIZE-1); i<BINLOG_FORMAT_TABLE_SIZE; i++, h = (h+1) & (BINLOG_FORMAT_TABLE_SIZE-1)) {
+
+      BINLOG_FORMAT* f = &binlog_formats[h];
+
+      if (!f->state && __sync_bool_compare_and_swap(&f->state, 0, 1)) {  /* empty slot, add format string */
+
+         if (!(f->fmt = strdup(fmt))) { __atomic_store_n(&f->state, 0, __ATOMIC_RELEASE); return NULL; }
+
+         f->hash = hash;
+         f->num_args = parse_format(fmt, f->arg_types);
+
+         f->id = __sync_fetch_and_add(&binlog_num_formats, 1);
+
+         write_record(BINLOG_RECORD_FORMAT, f->id, 0, 0, f->fmt, strlen(f->fmt) + 1);
+
+         __atomic_store_n(&f->state, 2, __ATOMIC_RELEASE);
+         return f;
+      }
+
+      uint8_t state;
+      while ((state = __atomic_load_n(&f->state, __ATOMIC_ACQUIRE)) == 1);  /* another thread is adding this slot */
+
+      if (!state) { i--; h = (h-1) & (BINLOG_FORMAT_TABLE_SIZE-1); continue; }  /* slot add was abandoned (strdup() failed), retry slot */
+
+      if (f->hash == hash && !strcmp(f->fmt, fmt)) return f;
+   }
+
+   return NULL;  /* table full */
+}
+
+/* write a Log_RT() event as a binary record. Returns -1 if the event can't be written as binary, in which case Log_RT() formats it as text and calls binary_event_log_write_text() */
+
+int binary_event_log_write(uint32_t loglevel, const char* fmt, va_list va) {
+
+uint8_t args[2*MAX_APP_STR_LEN + BINLOG_MAX_ARGS*8];  /* inline format string (if any) followed by args */
+uint8_t inline_arg_types[BINLOG_MAX_ARGS];
+const uint8_t* arg_types;
+int i, num_args, type, len = 0;
+uint32_t id = 0;
+struct timeval tv;
+
+   if (binlog_cur_segment < 0 && !open_binary_event_log()) return -1;
+
+   __sync_fetch_and_add(&binlog_writers, 1);  /* held during format table lookup, binary_event_log_close() frees format string copies */
+
+   if (__atomic_load_n(&binlog_cur_segment, __ATOMIC_SEQ_CST) < 0) { __sync_fetch_and_sub(&binlog_writers, 1); return -1; }  /* closed after the above check */
+
+   if (is_literal(fmt)) {  /* literal format strings are written once as format records and referenced by id */
+
+      BINLOG_FORMAT* f = get_format(fmt);
+      if (!f || f->num_args == 0xff) { __sync_fetch_and_sub(&binlog_writers, 1); return -1; }
+
+      type = BINLOG_RECORD_EVENT;
+      id = f->id;
+      num_args = f->num_args;
+      arg_types = f->arg_types;
+   }
+   else {  /* dynamic format strings are written inline, see notes above */
+
+      int fmt_len = strlen(fmt) + 1;
+
+      if (fmt_len > MAX_APP_STR_LEN || (num_args = parse_format(fmt, inline_arg_types)) == 0xff) { __sync_fetch_and_sub(&binlog_writers, 1); return -1; }
+
+      type = BINLOG_RECORD_INLINE;
+      arg_types = inline_arg_types;
+      memcpy(args, fmt, fmt_len);
+      memset(&args[fmt_len], 0, ((fmt_len + 7) & ~7) - fmt_len);
+      len = (fmt_len + 7) & ~7;
+   }
+
+   for (i=0; i<num_args; i++) {
+
+      int64_t val;
+      double dval;
+
+      switch (arg_types[i]) {
+
+         case BINLOG_ARG_INT:
+            val = va_arg(va, int);
+            memcpy(&args[len], &val, 8);
+            len += 8;
+            break;
+
+         case BINLOG_ARG_LONG:
+            val = va_arg(va, long long);
+            memcpy(&args[len], &val, 8);
+            len += 8;
+            break;
+
+         case BINLOG_ARG_PTR:
+            val = (int64_t)(uintptr_t)va_arg(va, void*);
+            memcpy(&args[len], &val, 8);
+            len += 8;
+            break;
+
+         case BINLOG_ARG_DOUBLE:
+            dval = va_arg(va, double);
+            memcpy(&args[len], &dval, 8);
+            len += 8;
+            break;
+
+         case BINLOG_ARG_STR:
+         {
+            const char* s = va_arg(va, const char*);
+            if (!s) s = "(null)";
+            uint32_t slen = max(0, min((int)strlen(s), (int)sizeof(args) - len - 8*(num_args - i) - 4));  /* truncate if needed to leave space for remaining args */
+            memcpy(&args[len], &slen, 4);
+            memcpy(&args[len+4], s, slen);
+            len += (4 + slen + 7) & ~7;
+            break;
+         }
+      }
+   }
+
+   gettimeofday(&tv, NULL);
+
+   int ret_val = write_record(type, id, loglevel, tv.tv_sec*1000000ULL + tv.tv_usec, args, len);
+
+   __sync_fetch_and_sub(&binlog_writers, 1);
+
+   return ret_val;
+}
+
+int binary_event_log_write_text(uint32_t loglevel, const char* str, int len) {
+
+struct timeval tv;
+char text[MAX_APP_STR_LEN + 100];
+
+   if (binlog_cur_segment < 0 && !open_binary_event_log()) return -1;
+
+   len = min(len, (int)sizeof(text)-1);
+   memcpy(text, str, len);
+   text[len] = 0;
+
+   gettimeofday(&tv, NULL);
+
+   return write_record(BINLOG_RECORD_TEXT, 0, loglevel, tv.tv_sec*1000000ULL + tv.tv_usec, text, len + 1);
+}
+
+void binary_event_log_close() {
+
+int k;
+
+   while (__sync_lock_test_and_set(&binlog_lock, 1) != 0);
+
+   int cur_segment = binlog_cur_segment;
+
+   if (cur_segment >= 0) {
+
+      __atomic_store_n(&binlog_cur_segment, -1, __ATOMIC_SEQ_CST);  /* new Log_RT() calls will use text event log */
+
+   /* store to binlog_cur_segment followed by load of binlog_writers is a StoreLoad pattern, which acquire/release doesn't order. Writers increment binlog_writers (full barrier) before loading binlog_cur_segment, so with seq_cst here either a writer sees -1 or we see the writer */
+
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+      while (__atomic_load_n(&binlog_writers, __ATOMIC_SEQ_CST));  /* wait for any in-progress writes */
+
+      uint64_t used = min((uint64_t)binlog_segments[cur_segment].used, (uint64_t)BINLOG_SEGMENT_SIZE);
+
+      for (k=0; k<=cur_segment; k++) munmap(binlog_segments[k].base, BINLOG_SEGMENT_SIZE);
+
+      if (ftruncate(binlog_fd, binlog_file_base + (uint64_t)cur_segment*BINLOG_SEGMENT_SIZE + used) < 0) fprintf(stderr, "\nWARNING: Log_RT() says unable to truncate binary event log file, errno = %d \n", errno);
+
+      close(binlog_fd);
+      binlog_fd = -1;
+      fBinlogReopen = true;
+
+      if (binlog_ro.ranges) free(binlog_ro.ranges);  /* no writers in progress */
+      binlog_ro.ranges = NULL;
+      binlog_ro.num_ranges = 0;
+   }
+
+   for (k=0; k<BINLOG_FORMAT_TABLE_SIZE; k++) if (binlog_formats[k].fmt) free(binlog_formats[k].fmt);  /* no writers in progress, see binlog_writers wait above */
+
+   memset(binlog_formats, 0, sizeof(binlog_formats));  /* format ids restart for each binary event log run */
+   binlog_num_formats = 0;
+   fBinlogOpenFailed = false;
+
+   __sync_lock_release(&binlog_lock);
+}
+
+/* binary event log formatter */
+
+typedef struct {
+
+  BINLOG_SESSION* info;
+  const char** fmts;  /* format strings indexed by id */
+  uint32_t num_fmts;
+
+} BINLOG_SESSION_FORMATS;
+
+static int format_timestamp(char* str, uint64_t usec, const BINLOG_SESSION* session) {  /* same formatting as DSGetTimestamp() default uptime and wall clock timestamps */
+
+uint64_t uptime = usec - session->usec_base;
+int len = 0;
+
+   if (session->uEventLogMode & DS_EVENT_LOG_WALLCLOCK_TIMESTAMPS) {
+
+      time_t ltime = usec/1000000L;
+      struct tm tm;
+      localtime_r(&ltime, &tm);
+      len = strftime(str, 100, "%m/%d/%Y %H:%M:%S", &tm);
+      if (session->uEventLogMode & DS_EVENT_LOG_TIMEVAL_PRECISION_MSEC) len += sprintf(&str[len], ".%03d", (int)(usec/1000) % 1000);
+      len += sprintf(&str[len], " (");
+   }
+
+   len += sprintf(&str[len], "%02d:%02d:%02d.%03d.%03d", (int)(uptime/3600000000L), (int)(uptime/60000000L) % 60, (int)(uptime/1000000L) % 60, (int)(uptime/1000) % 1000, (int)(uptime % 1000));
+
+   if (session->uEventLogMode & DS_EVENT_LOG_WALLCLOCK_TIMESTAMPS) len += sprintf(&str[len], ")");
+
+   return len;
+}
+
+static int render_event(char* out, int maxlen, const char* fmt, const uint8_t* args, int args_len) {  /* render format string with captured args. Returns length of rendered string */
+
+const char* p = fmt;
+int len = 0, a = 0, n;
+char spec_str[64];
+BINLOG_SPEC spec;
+
+   while (*p && len < maxlen-1) {
+
+      if (*p != '%') { out[len++] = *p++; continue; }
+
+      const char* next = parse_spec(p, &spec);
+      if (!next || spec.len >= (int)sizeof(spec_str)) break;  /* can't happen for formats accepted by get_format() */
+
+      if (!spec.type) { out[len++] = '%'; p = next; continue; }
+
+      int star[2] = { 0, 0 };
+      for (n=0; n<spec.num_star; n++) {
+         if (a + 8 > args_len) return len;
+         int64_t v; memcpy(&v, &args[a], 8); a += 8;
+         star[n] = (int)v;
+      }
+
+      memcpy(spec_str, p, spec.len);
+      spec_str[spec.len] = 0;
+
+      int remain = maxlen - len, ret = 0;
+
+      if (spec.type == BINLOG_ARG_STR) {
+
+         uint32_t slen;
+         if (a + 4 > args_len) return len;
+         memcpy(&slen, &args[a], 4);
+         if (a + 4 + (int)slen > args_len) return len;
+
+         char* s = (char*)malloc(slen + 1);
+         memcpy(s, &args[a+4], slen);
+         s[slen] = 0;
+         a += (4 + slen + 7) & ~7;
+
+         if (spec.num_star == 2) ret = snprintf(&out[len], remain, spec_str, star[0], star[1], s);
+         else if (spec.num_star == 1) ret = snprintf(&out[len], remain, spec_str, star[0], s);
+         else ret = snprintf(&out[len], remain, spec_str, s);
+
+         free(s);
+      }
+      else {
+
+         if (a + 8 > args_len) return len;
+         int64_t v; double d;
+         memcpy(&v, &args[a], 8);
+         memcpy(&d, &args[a], 8);
+         a += 8;
+
+         #define RENDER_ARG(x) (spec.num_star == 2 ? snprintf(&out[len], remain, spec_str, star[0], star[1], x) : spec.num_star == 1 ? snprintf(&out[len], remain, spec_str, star[0], x) : snprintf(&out[len], remain, spec_str, x))
+
+         #pragma GCC diagnostic push
+         #pragma GCC diagnostic ignored "-Wformat-nonliteral"
+         #pragma GCC diagnostic ignored "-Wformat-security"
+         if (spec.type == BINLOG_ARG_INT) ret = RENDER_ARG((int)v);
+         else if (spec.type == BINLOG_ARG_LONG) ret = RENDER_ARG((long long)v);
+         else if (spec.type == BINLOG_ARG_PTR) ret = RENDER_ARG((void*)(uintptr_t)v);
+         else ret = RENDER_ARG(d);
+         #pragma GCC diagnostic pop
+      }
+
+      len += max(0, min(ret, remain-1));
+      p = next;
+   }
+
+   out[min(len, maxlen-1)] = 0;
+
+   return len;
+}
+
+static void substitute_wec(char* str, int maxlen) {  /* same as Log_RT() WEC substitution, see comments in event_logging.cpp */
+
+char* p;
+int slen = strlen(str);
+
+   do {
+      p = strcasestr(str, "warning");
+      if (!p) p = strcasestr(str, "error");
+      if (!p) p = strcasestr(str, "critical");
+
+      if (p && slen+1 < maxlen) { memmove(p+2, p+1, strlen(p+1)+1); *(p+1) = '|'; slen++; }
+      else p = NULL;
+
+   } while (p);
+}
+
+int DSFormatBinaryEventLog(const char* szBinaryEventLog, FILE* fp_out, unsigned int uFlags) {
+
+int fd, i, num_sessions = 0, num_records = 0;
+struct stat st;
+uint64_t pos, size;
+uint8_t* base;
+BINLOG_SESSION_FORMATS* sessions = NULL;
+char* str = NULL;
+const int maxlen = MAX_APP_STR_LEN + 200;
+unsigned int max_loglevel = uFlags & DS_LOG_LEVEL_MASK;
+
+   if (!szBinaryEventLog || !fp_out) return -1;
+
+   if ((fd = open(szBinaryEventLog, O_RDONLY)) < 0 || fstat(fd, &st) < 0 || !st.st_size) {
+      if (fd >= 0) close(fd);
+      fprintf(stderr, "DSFormatBinaryEventLog() says unable to open binary event log %s \n", szBinaryEventLog);
+      return -1;
+   }
+
+   size = st.st_size;
+   base = (uint8_t*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+
+   if (base == MAP_FAILED) return -1;
+
+/* two passes: (i) collect format strings for each session, (ii) render events. Format and event records for a session always follow the session record */
+
+   for (int pass=0; pass<2; pass++) {
+
+      int session = -1;
+      pos = 0;
+
+      while (pos + sizeof(BINLOG_RECORD_HEADER) <= size) {
+
+         BINLOG_RECORD_HEADER* hdr = (BINLOG_RECORD_HEADER*)&base[pos];
+         uint64_t seg_end = min((pos/BINLOG_SEGMENT_SIZE + 1)*BINLOG_SEGMENT_SIZE, size);
+
+         if (!hdr->len || (hdr->len & 7) || hdr->len < sizeof(BINLOG_RECORD_HEADER) || pos + hdr->len > seg_end) {  /* end of records in this segment */
+            pos = seg_end;
+            continue;
+         }
+
+         uint8_t* data = (uint8_t*)&hdr[1];
+         int data_len = hdr->len - sizeof(BINLOG_RECORD_HEADER);
+
+         if (hdr->type == BINLOG_RECORD_SESSION) {
+
+            if (data_len < (int)sizeof(BINLOG_SESSION) || memcmp(((BINLOG_SESSION*)data)->magic, BINLOG_MAGIC, sizeof(BINLOG_MAGIC)) || ((BINLOG_SESSION*)data)->segment_size != BINLOG_SEGMENT_SIZE) {
+               fprintf(stderr, "DSFormatBinaryEventLog() says %s has invalid session record at offset %llu \n", szBinaryEventLog, (unsigned long long)pos);
+               break;
+            }
+
+            session++;
+
+            if (!pass) {
+               sessions = (BINLOG_SESSION_FORMATS*)realloc(sessions, (session+1)*sizeof(BINLOG_SESSION_FORMATS));
+               sessions[session].info = (BINLOG_SESSION*)data;
+               sessions[session].fmts = NULL;
+               sessions[session].num_fmts = 0;
+               num_sessions = session+1;
+            }
+         }
+         else if (session < 0) {}  /* records before first session record are ignored */
+
+         else if (hdr->type == BINLOG_RECORD_FORMAT && !pass) {
+
+            BINLOG_SESSION_FORMATS* s = &sessions[session];
+
+            if (hdr->id >= s->num_fmts) {
+               uint32_t num_fmts = max(hdr->id + 1, 2*s->num_fmts);
+               s->fmts = (const char**)realloc(s->fmts, num_fmts*sizeof(char*));
+               memset(&s->fmts[s->num_fmts], 0, (num_fmts - s->num_fmts)*sizeof(char*));
+               s->num_fmts = num_fmts;
+            }
+
+            if (memchr(data, 0, data_len)) s->fmts[hdr->id] = (const char*)data;
+         }
+         else if ((hdr->type == BINLOG_RECORD_EVENT || hdr->type == BINLOG_RECORD_INLINE || hdr->type == BINLOG_RECORD_TEXT) && pass && (!max_loglevel || (hdr->loglevel & DS_LOG_LEVEL_MASK) <= max_loglevel)) {
+
+            BINLOG_SESSION_FORMATS* s = &sessions[session];
+            int len = 0, ts_len = 0;
+
+            if (!str) str = (char*)malloc(maxlen);
+
+            if (!(hdr->loglevel & DS_LOG_LEVEL_NO_TIMESTAMP) && hdr->type != BINLOG_RECORD_TEXT) {
+               ts_len = format_timestamp(str, hdr->usec, s->info);
+               str[ts_len++] = ' ';
+            }
+
+            if (hdr->type == BINLOG_RECORD_TEXT) len = snprintf(str, maxlen, "%s", memchr(data, 0, data_len) ? (const char*)data : "");  /* text records are already complete, including timestamp */
+            else if (hdr->type == BINLOG_RECORD_INLINE) {  /* format string is in the record, followed by args */
+
+               uint8_t* fmt_end = (uint8_t*)memchr(data, 0, data_len);
+               int fmt_len = fmt_end ? ((fmt_end - data + 1 + 7) & ~7) : 0;
+
+               if (fmt_end && fmt_len <= data_len) len = ts_len + render_event(&str[ts_len], maxlen - ts_len - 2, (const char*)data, data + fmt_len, data_len - fmt_len);
+               else len = ts_len + sprintf(&str[ts_len], "DSFormatBinaryEventLog() says inline record format string is invalid");
+            }
+            else if (hdr->id < s->num_fmts && s->fmts[hdr->id]) len = ts_len + render_event(&str[ts_len], maxlen - ts_len - 2, s->fmts[hdr->id], data, data_len);
+            else len = ts_len + sprintf(&str[ts_len], "DSFormatBinaryEventLog() says format id %u not found", hdr->id);
+
+            len = min(len, maxlen-3);
+
+            if (hdr->type != BINLOG_RECORD_TEXT) {
+
+               if (str[ts_len] == '\n' && ts_len) {  /* leading newline handling, same as Log_RT() */
+                  memmove(&str[1], str, ts_len);
+                  str[0] = '\n';
+               }
+
+               if (!(hdr->loglevel & DS_LOG_LEVEL_DONT_ADD_NEWLINE) && (!len || str[len-1] != '\n')) str[len++] = '\n';
+               str[len] = 0;
+
+               if (hdr->loglevel & DS_LOG_LEVEL_SUBSITUTE_WEC) substitute_wec(str, maxlen);
+            }
+
+            fputs(str, fp_out);
+            num_records++;
+         }
+
+         pos += hdr->len;
+      }
+   }
+
+   for (i=0; i<num_sessions; i++) if (sessions[i].fmts) free(sessions[i].fmts);
+   if (sessions) free(sessions);
+   if (str) free(str);
+
+   munmap(base, size);
+
+   return num_records;
+}
@@ -48,6 +48,14 @@
   Modified Jul 2025 JHB, in Log_RT() call console_out(), which calls isStdoutReady() before printf() to avoid blocking if stdout has loss of connectivity
   Modified Aug 2025 JHB, in DSInitLogging() add terminal color initialization (white)
   Modified Sep 2025 JHB, in Log_RT() use MAX_APP_STR_LEN (defined in diaglib.h) for max string size instead of local definition
+  Modified Oct 2026 JHB, cache per-thread Logging_Thread_Info[] index in thread-local storage, bump version number. GetThreadIndex() no longer obtains diaglib_sem or searches Logging_Thread_Info[]; DSInitLogging() and DSCloseLogging() register and clean up the calling thread's index
+  Modified Oct 2026 JHB, bump version number for DSPktStatsAddEntries() single-pass header parse and DSPktStatsAddEntriesBatch() in diaglib.cpp
+  Modified Oct 2026 JHB, bump version number for DS_PKTSTATS_LOG_PARALLEL flag (parallel SSRC group analysis in DSPktStatsLogSeqnums())
+  Modified Oct 2026 JHB, implement DS_EVENT_LOG_ASYNC flag (shared_include/config.h). Log_RT() event log file writes are done by a background writer thread draining per-thread lock-free ring buffers, see async event log writer comments. Move Log_RT() file write, recreate, flush_size and max_size handling to write_event_log(). Log_RT() takes usec_init_lock only if usec_base is not yet initialized. Bump version number
+  Modified Oct 2026 JHB, implement DS_EVENT_LOG_BINARY flag (shared_include/config.h). Log_RT() writes binary event log records (see event_log_binary.cpp) and skips string formatting if console output and API status parsing are not needed. Move output flag and lifespan stats code ahead of formatting. Bump version number
+  Modified Oct 2026 JHB, bump version number for removal of DSPktStatsAddEntriesBatch() and add_entry() RTP validity check in diaglib.cpp
+  Modified Oct 2026 JHB, async event log writer thread sleeps on a condition variable instead of polling, stop requested by DSCloseLogging() is final (Log_RT() no longer restarts the writer thread while the event log file is being closed), writer thread creation failure is not retried. Correct cross-thread ordering and fClosed comments. Bump version number
+  Modified Oct 2026 JHB, bump version number for restored DSPktStatsAddEntriesBatch() in diaglib.cpp
 */
 
 /* Linux and/or other OS includes */
@@ -62,6 +70,9 @@
 #include <sys/time.h>  /* gettimeofday() */
 #include <semaphore.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>  /* usleep() */
+#include <sched.h>  /* sched_yield() */
 #include <stdbool.h>
 #include <dlfcn.h>  /* dlsym(), RTLD_DEFAULT definition */
 #include <algorithm>  /* bring in std::min and std::max */
@@ -84,7 +95,7 @@ using namespace std;
 #include "diaglib_priv.h"
 
 /* diaglib version string */
-const char DIAGLIB_VERSION[256] = "1.9.11";
+const char DIAGLIB_VERSION[256] = "1.9.19";
 
 /* semaphores for thread safe logging init and close. Logging itself is lockless */
 
@@ -124,15 +135,18 @@ __attribute__((visibility("hidden"))) get_time_t* get_time = NULL;  /* get_time_
   -pre-thread indexes are created by DSInitLogging() which calls private CreateThreadIndex(), and deleted by DSCloseLogging() which calls private DeleteThreadIndex(). Both use diaglib_sem to control multithread access
   -pktlib packet/media threads and mediaMin and mediaTest app threads call DSInitLogging() and DSCloseLogging()
   -the "zeroth" index is reserved for any applications or threads not calling DSInitLogging(); i.e. if GetThreadIndex() does not find a thread index, these share a thread index
+  -as of Oct 2026 each thread's index is cached in thread-local storage when created, so GetThreadIndex() (called on every API status update) takes no semaphore and does no search
 */
 
 LOGGING_THREAD_INFO Logging_Thread_Info[MAXTHREADS] = {{ 0 }};  /* LOGGING_THREAD_INFO struct defined in diaglib_priv.h. Also referenced in diaglib.cpp */
 
+static __thread int logging_thread_index = -1;  /* current thread's Logging_Thread_Info[] index, cached by CreateThreadIndex() so GetThreadIndex() needs no semaphore or search, JHB Oct 2026 */
+
 static int CreateThreadIndex(void) {  /* create a thread index from its Id */
 
 int i;
 
-   for (i=1; i<MAXTHREADS; i++) if (Logging_Thread_Info[i].ThreadId == pthread_self()) return i;  /* first check to see if current thread already has a slot */
+   if (logging_thread_index > 0) return logging_thread_index;  /* current thread already has a slot */
 
    for (i=1; i<MAXTHREADS; i++) if (Logging_Thread_Info[i].ThreadId == 0) {  /* get a new slot */
 
@@ -141,29 +155,22 @@ int i;
       break;
    }
 
-   if (i < MAXTHREADS) return i;
+   if (i < MAXTHREADS) return (logging_thread_index = i);
    else return -1;
 }
 
 __attribute__((visibility("hidden"))) int GetThreadIndex(bool fUseSem) {  /* Get a thread index from its Id. This is a diaglib-private API, also called by functions in diaglib.cpp */
 
-int i, ret_val = 0;
-bool fUseSemLocal = false;
-
-   if (fUseSem && diaglib_sem_init) { fUseSemLocal = true; sem_wait(&diaglib_sem); }
-
-   for (i=1; i<MAXTHREADS; i++) if (Logging_Thread_Info[i].ThreadId == pthread_self()) { ret_val = i; break; }
-
-   if (fUseSemLocal) sem_post(&diaglib_sem);
+   (void)fUseSem;  /* no longer needed; a thread's index is created and deleted only by the thread itself, so its cached index is always current, JHB Oct 2026 */
 
-   return ret_val;  /* return zeroth slot -- any/all apps or threads not calling DSInitLogging() */
+   return logging_thread_index > 0 ? logging_thread_index : 0;  /* return zeroth slot -- any/all apps or threads not calling DSInitLogging() */
 }
 
 static int DeleteThreadIndex(void) {  /* clear a thread index */
 
-int nIndex = GetThreadIndex(false);  /* note - DeleteThreadIndex() called only from DSCloseLogging() which obtains the diaglib_sem semaphore */
+int nIndex = logging_thread_index;  /* note - DeleteThreadIndex() called only from DSCloseLogging() which obtains the diaglib_sem semaphore */
 
-   if (nIndex >= 0) { Logging_Thread_Info[nIndex].ThreadId = 0; return nIndex; }
+   if (nIndex > 0) { Logging_Thread_Info[nIndex].ThreadId = 0; logging_thread_index = -1; return nIndex; }
    else return -1;
 }
 
@@ -292,6 +299,380 @@ bool fUseSemLocal = false;
    return 1;
 }
 
+/* write a string to the event log file, creating or recreating the file if needed. Called by Log_RT() and by the async event log writer thread (below), JHB Oct 2026 */
+
+static int write_event_log(const char* str, int len) {
+
+bool fAllowAppend = true;
+bool fUseSem = true;
+
+create_log_file_if_needed:
+
+   open_log_file(fAllowAppend, fUseSem);
+
+   if (!lib_dbg_cfg.uEventLogFile) return -1;
+
+   int ret_val = fwrite(str, len, 1, lib_dbg_cfg.uEventLogFile);
+
+   if (ret_val != 1) {  /* we call fwrite() with number of "elements" = 1, not bytes */
+
+      fprintf(stderr, "\nERROR: Log_RT() says not able to write to event log file %s, errno = %d \n", lib_dbg_cfg.szEventLogFilePath, errno);
+      return -1;
+   }
+   else if (isFileDeleted(lib_dbg_cfg.uEventLogFile)) {  /* fwrite() won't show an error if file has been deleted, so we always call isFileDeleted() which calls fstat(), JHB Jan 2023 */
+
+      fprintf(stderr, "\nERROR: Log_RT() says event log file %s may have been deleted, errno = %d, attempting to recreate file ... \n", lib_dbg_cfg.szEventLogFilePath, errno);
+      lib_dbg_cfg.uEventLogFile = NULL;
+      fAllowAppend = false;
+      goto create_log_file_if_needed;
+   }
+   else {  /* log file operating normally, check for flush_size and/or max_size in effect */
+
+      if (lib_dbg_cfg.uEventLog_fflush_size) {
+
+         uint64_t fsize = ftell(lib_dbg_cfg.uEventLogFile);
+
+         if (fsize > lib_dbg_cfg.uEventLog_fflush_size) {
+            last_size = fsize;
+            fflush(lib_dbg_cfg.uEventLogFile);
+         }
+      }
+
+      if (lib_dbg_cfg.uEventLog_max_size) {
+
+         uint64_t fsize = ftell(lib_dbg_cfg.uEventLogFile);
+
+         if (fsize > lib_dbg_cfg.uEventLog_max_size) rewind(lib_dbg_cfg.uEventLogFile);
+      }
+   }
+
+   return len;
+}
+
+/* async event log writer, JHB Oct 2026. Notes:
+
+  -enabled by DS_EVENT_LOG_ASYNC flag in uEventLogMode (shared_include/config.h)
+  -each thread calling Log_RT() has its own single-producer, single-consumer ring buffer. Log_RT() formats log strings as usual (timestamp, WEC substitution, etc) and copies them into the calling thread's ring; no lock is taken and no file I/O is done
+  -one background writer thread drains all rings, merging strings by sequence number, and writes them in batches with write_event_log(). With batching, isFileDeleted() (fstat) and ftell() calls are per batch instead of per log string
+  -file order follows Log_RT() call order for strings from the same thread. Across threads order is approximate: a sequence number is assigned before a string is published to its ring, so if the writer thread drains while a string is being copied, strings from other threads with higher sequence numbers may be written first
+  -when all rings are empty the writer thread sleeps on a condition variable. Log_RT() signals only if the writer thread is sleeping, so the condition variable mutex is not taken per log string
+  -if a thread's ring is full the string is dropped and counted in event_log_async_drops (diaglib.h). The writer thread notes drops in the event log. If no ring is available (more than MAX_LOG_RINGS threads) Log_RT() writes synchronously
+  -console output is not affected, it's still done by the calling thread to preserve line cursor coordination between app threads and p/m threads
+  -DSCloseLogging() stops the writer thread when closing the event log file. The writer thread drains all rings before exiting, so apps should call DSCloseLogging() before exit to avoid losing log strings still in rings. Once stop is requested, Log_RT() writes synchronously and does not restart the writer thread; DSInitLogging() re-enables async writes
+  -if the writer thread can't be created, Log_RT() writes synchronously and doesn't retry
+  -a thread's ring is freed by the writer thread after the thread exits and the ring is empty
+*/
+
+#define LOG_RING_SIZE         (128*1024)  /* per-thread ring size in bytes, must be a power of 2 */
+#define MAX_LOG_RINGS         MAXTHREADS
+#define LOG_WRITE_BATCH_SIZE  (256*1024)  /* max bytes per async writer fwrite() */
+
+typedef struct {
+
+  uint64_t seq;  /* sequence number, determines file order across rings */
+  uint32_t len;  /* string length, string follows the header padded to 8-byte alignment */
+  uint32_t reserved;
+
+} LOG_RECORD_HEADER;
+
+typedef struct {
+
+  volatile uint64_t head;     /* write position, advanced only by owner thread */
+  volatile uint64_t tail;     /* read position, advanced only by writer thread */
+  volatile uint32_t drops;    /* strings dropped due to full ring */
+  uint32_t drops_reported;    /* accessed only by writer thread */
+  volatile uint8_t fClosed;   /* set by LOG_RING_OWNER destructor when owner thread exits */
+  uint8_t buf[LOG_RING_SIZE];
+
+} LOG_RING;
+
+uint32_t event_log_async_drops = 0;
+
+static LOG_RING* volatile log_rings[MAX_LOG_RINGS] = { NULL };
+
+struct LOG_RING_OWNER {  /* calling thread's ring. Note thread_local instead of __thread so the destructor marks the ring closed when the thread exits, whether or not the thread calls DSCloseLogging() */
+
+  LOG_RING* ring = NULL;
+  ~LOG_RING_OWNER() { if (ring) ring->fClosed = 1; }
+};
+
+static thread_local LOG_RING_OWNER log_ring_owner;
+static uint64_t log_seq = 0;
+static pthread_t log_writer_thread_id;
+
+enum { LOG_WRITER_NOT_STARTED, LOG_WRITER_RUNNING, LOG_WRITER_STOP_REQUESTED, LOG_WRITER_STOPPED, LOG_WRITER_CREATE_FAILED };  /* log_writer_state values. STOPPED and CREATE_FAILED are final (Log_RT() writes synchronously), STOPPED is reset by DSInitLogging() */
+
+static volatile uint8_t log_writer_state = LOG_WRITER_NOT_STARTED;
+static uint8_t log_writer_lock = 0;
+static volatile uint32_t log_async_writers = 0;   /* number of Log_RT() calls in log_async_write(), writer thread doesn't exit until zero */
+static volatile uint8_t log_writer_sleeping = 0;  /* set by writer thread before waiting on log_writer_cond */
+static pthread_mutex_t log_writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_writer_cond = PTHREAD_COND_INITIALIZER;
+
+static inline void ring_copy_in(LOG_RING* ring, uint64_t pos, const void* src, int len) {
+
+int offset = pos & (LOG_RING_SIZE-1), len1 = min(len, LOG_RING_SIZE - offset);
+
+   memcpy(&ring->buf[offset], src, len1);
+   if (len > len1) memcpy(ring->buf, (uint8_t*)src + len1, len - len1);
+}
+
+static inline void ring_copy_out(LOG_RING* ring, uint64_t pos, void* dst, int len) {
+
+int offset = pos & (LOG_RING_SIZE-1), len1 = min(len, LOG_RING_SIZE - offset);
+
+   memcpy(dst, &ring->buf[offset], len1);
+   if (len > len1) memcpy((uint8_t*)dst + len1, ring->buf, len - len1);
+}
+
+/* drain rings, merging by sequence number, and write to event log file. Returns number of bytes written */
+
+static int log_writer_drain(char* batch) {
+
+int i, len = 0, total_len = 0;
+LOG_RECORD_HEADER hdr;
+
+   for (;;) {
+
+      LOG_RING* ring = NULL;
+      uint64_t min_seq = UINT64_MAX, next_seq = UINT64_MAX;
+
+   /* find ring with lowest sequence number string, and next lowest sequence number in any other ring */
+
+      for (i=0; i<MAX_LOG_RINGS; i++) {
+
+         LOG_RING* r = log_rings[i];
+         if (!r || r->tail == __atomic_load_n(&r->head, __ATOMIC_ACQUIRE)) continue;
+
+         ring_copy_out(r, r->tail, &hdr, sizeof(hdr));
+
+         if (hdr.seq < min_seq) { next_seq = min_seq; min_seq = hdr.seq; ring = r; }
+         else if (hdr.seq < next_seq) next_seq = hdr.seq;
+      }
+
+      if (!ring) break;
+
+   /* take strings from ring until another ring has a lower sequence number */
+
+      uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE), tail = ring->tail;
+
+      while (tail != head) {
+
+         ring_copy_out(ring, tail, &hdr, sizeof(hdr));
+         if (hdr.seq > next_seq) break;
+
+         if (len + (int)hdr.len > LOG_WRITE_BATCH_SIZE) { write_event_log(batch, len); total_len += len; len = 0; }
+
+         ring_copy_out(ring, tail + sizeof(hdr), &batch[len], hdr.len);
+         len += hdr.len;
+         tail += sizeof(hdr) + ((hdr.len + 7) & ~7);
+      }
+
+      __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+   }
+
+/* note any dropped strings, free rings of closed threads */
+
+   for (i=0; i<MAX_LOG_RINGS; i++) {
+
+      LOG_RING* r = log_rings[i];
+      if (!r) continue;
+
+      uint32_t drops = r->drops;
+
+      if (drops != r->drops_reported && len + 200 < LOG_WRITE_BATCH_SIZE) {
+
+         if (DSGetTimestamp(&batch[len], (unsigned int)lib_dbg_cfg.uEventLogMode, 100, 0)) strcat(&batch[len], " ");
+         len += strlen(&batch[len]);
+         len += sprintf(&batch[len], "WARNING: Log_RT() async event log ring full, %u log strings dropped \n", drops - r->drops_reported);
+         r->drops_reported = drops;
+      }
+
+      if (r->fClosed && r->tail == __atomic_load_n(&r->head, __ATOMIC_ACQUIRE)) {
+
+         log_rings[i] = NULL;
+         free(r);
+      }
+   }
+
+   if (len) write_event_log(batch, len);
+
+   return total_len + len;
+}
+
+static bool rings_empty() {
+
+   for (int i=0; i<MAX_LOG_RINGS; i++) {
+
+      LOG_RING* r = log_rings[i];
+      if (r && r->tail != __atomic_load_n(&r->head, __ATOMIC_ACQUIRE)) return false;
+   }
+
+   return true;
+}
+
+static void* log_writer_thread(void* arg) {
+
+char* batch = (char*)malloc(LOG_WRITE_BATCH_SIZE);
+
+   (void)arg;
+
+   for (;;) {
+
+   /* read stop request and in-progress Log_RT() count before draining. After stop is requested Log_RT() calls no longer enter log_async_write(), so if the count is zero here, everything written before DSCloseLogging() is drained below */
+
+      bool fStop = __atomic_load_n(&log_writer_state, __ATOMIC_SEQ_CST) == LOG_WRITER_STOP_REQUESTED;
+      bool fIdle = __atomic_load_n(&log_async_writers, __ATOMIC_SEQ_CST) == 0;
+
+      if (log_writer_drain(batch)) continue;
+
+      if (fStop) {
+
+         if (fIdle) break;
+         sched_yield();  /* wait for in-progress Log_RT() calls, this is brief */
+         continue;
+      }
+
+   /* sleep until signaled by log_async_write() or stop_log_writer(). Setting log_writer_sleeping and then checking rings, together with log_async_write() publishing and then checking log_writer_sleeping, ensures a wakeup is not missed */
+
+      pthread_mutex_lock(&log_writer_mutex);
+
+      __atomic_store_n(&log_writer_sleeping, 1, __ATOMIC_SEQ_CST);
+
+      if (rings_empty() && __atomic_load_n(&log_writer_state, __ATOMIC_SEQ_CST) == LOG_WRITER_RUNNING) pthread_cond_wait(&log_writer_cond, &log_writer_mutex);
+
+      __atomic_store_n(&log_writer_sleeping, 0, __ATOMIC_SEQ_CST);
+
+      pthread_mutex_unlock(&log_writer_mutex);
+   }
+
+   free(batch);
+
+   return NULL;
+}
+
+static void wake_log_writer() {
+
+   pthread_mutex_lock(&log_writer_mutex);
+   pthread_cond_signal(&log_writer_cond);
+   pthread_mutex_unlock(&log_writer_mutex);
+}
+
+static bool start_log_writer() {
+
+   while (__sync_lock_test_and_set(&log_writer_lock, 1) != 0);  /* wait until the lock is zero then write 1 to it */
+
+   if (log_writer_state == LOG_WRITER_NOT_STARTED) {
+
+      __atomic_store_n(&log_writer_state, LOG_WRITER_RUNNING, __ATOMIC_SEQ_CST);  /* set before creating the thread, otherwise the writer thread could see NOT_STARTED and not sleep */
+
+      int ret_val = pthread_create(&log_writer_thread_id, NULL, log_writer_thread, NULL);
+
+      if (ret_val) {  /* remember the failure so Log_RT() doesn't retry on every call */
+
+         __atomic_store_n(&log_writer_state, LOG_WRITER_CREATE_FAILED, __ATOMIC_SEQ_CST);
+         fprintf(stderr, "\nERROR: Log_RT() says unable to create async event log writer thread, error = %d, using synchronous event log writes \n", ret_val);
+      }
+   }
+
+   __sync_lock_release(&log_writer_lock);
+
+   return log_writer_state == LOG_WRITER_RUNNING;
+}
+
+static void stop_log_writer() {
+
+bool fJoin = false;
+
+   while (__sync_lock_test_and_set(&log_writer_lock, 1) != 0);
+
+   if (log_writer_state == LOG_WRITER_RUNNING) {
+
+      __atomic_store_n(&log_writer_state, LOG_WRITER_STOP_REQUESTED, __ATOMIC_SEQ_CST);  /* from here on Log_RT() writes synchronously */
+      fJoin = true;
+   }
+
+   __sync_lock_release(&log_writer_lock);  /* release before joining; Log_RT() calls in start_log_writer() must be able to return to let the writer thread exit */
+
+   if (!fJoin) return;
+
+   wake_log_writer();
+   pthread_join(log_writer_thread_id, NULL);
+
+   __atomic_store_n(&log_writer_state, LOG_WRITER_STOPPED, __ATOMIC_SEQ_CST);
+}
+
+static void reset_log_writer() {  /* called by DSInitLogging(), allows async writes after a previous DSCloseLogging() */
+
+   while (__sync_lock_test_and_set(&log_writer_lock, 1) != 0);
+
+   if (log_writer_state == LOG_WRITER_STOPPED) log_writer_state = LOG_WRITER_NOT_STARTED;
+
+   __sync_lock_release(&log_writer_lock);
+}
+
+/* copy a string to calling thread's ring, allocating the ring on first use. Returns length copied, 0 if ring is full, or -1 if no ring available */
+
+static int log_ring_write(const char* str, int len) {
+
+int i;
+LOG_RECORD_HEADER hdr;
+
+   LOG_RING* log_ring = log_ring_owner.ring;
+
+   if (!log_ring) {  /* first async Log_RT() call for this thread, find a ring slot */
+
+      for (i=0; i<MAX_LOG_RINGS; i++) if (!log_rings[i]) break;
+      if (i == MAX_LOG_RINGS) return -1;
+
+      LOG_RING* ring = (LOG_RING*)calloc(1, sizeof(LOG_RING));
+      if (!ring) return -1;
+
+      for (; i<MAX_LOG_RINGS; i++) if (__sync_bool_compare_and_swap(&log_rings[i], NULL, ring)) break;
+      if (i == MAX_LOG_RINGS) { free(ring); return -1; }
+
+      log_ring_owner.ring = log_ring = ring;
+   }
+
+   int rec_len = sizeof(hdr) + ((len + 7) & ~7);
+   uint64_t head = log_ring->head;
+
+   if (rec_len > LOG_RING_SIZE - (int)(head - __atomic_load_n(&log_ring->tail, __ATOMIC_ACQUIRE))) {  /* ring full, drop */
+
+      __sync_fetch_and_add(&log_ring->drops, 1);
+      __sync_fetch_and_add(&event_log_async_drops, 1);
+      return 0;
+   }
+
+   hdr.seq = __sync_fetch_and_add(&log_seq, 1);
+   hdr.len = len;
+   hdr.reserved = 0;
+
+   ring_copy_in(log_ring, head, &hdr, sizeof(hdr));
+   ring_copy_in(log_ring, head + sizeof(hdr), str, len);
+
+   __atomic_store_n(&log_ring->head, head + rec_len, __ATOMIC_RELEASE);  /* publish to writer thread */
+
+   return len;
+}
+
+/* copy a formatted string to calling thread's ring. Returns length copied, 0 if dropped, or -1 if async logging not available and the caller should write synchronously */
+
+static int log_async_write(const char* str, int len) {
+
+   __atomic_add_fetch(&log_async_writers, 1, __ATOMIC_SEQ_CST);  /* count must be incremented before checking writer state, see log_writer_thread() */
+
+   if (__atomic_load_n(&log_writer_state, __ATOMIC_SEQ_CST) != LOG_WRITER_RUNNING && !start_log_writer()) { __atomic_sub_fetch(&log_async_writers, 1, __ATOMIC_SEQ_CST); return -1; }
+
+   int ret_val = log_ring_write(str, len);
+
+   __atomic_sub_fetch(&log_async_writers, 1, __ATOMIC_SEQ_CST);
+
+   if (ret_val > 0 && __atomic_load_n(&log_writer_sleeping, __ATOMIC_SEQ_CST)) wake_log_writer();
+
+   return ret_val;
+}
+
 /* public APIs */
 
 int DSGetAPIStatus(unsigned int uFlags) {  /* per-thread API status */
@@ -402,6 +783,8 @@ static uint8_t lock = 0;
    if (!dbg_cfg && !fLogFileRelatedFlags) ret_val = diaglib_sem_init == 2 ? 1 : 0;  /* handle initialization status request (dbg_cfg NULL and uFlags zero):  if any thread has made it past this point then at least one full initialization has happened */
    else ret_val = open_log_file(true, false);
 
+   reset_log_writer();  /* re-enable async event log writes if stopped by a prior DSCloseLogging(), JHB Oct 2026 */
+
    diaglib_sem_init = 2;  /* set to fully initialized */
 
    sem_post(&diaglib_sem);
@@ -468,10 +851,14 @@ int DSCloseLogging(unsigned int uFlags) {
 
    (void)uFlags;
 
+   if (lib_dbg_cfg.uEventLogFile && app_log_file_count == 1) stop_log_writer();  /* drain async event log rings before closing the event log file. This is done before obtaining diaglib_sem as the writer thread may need it to recreate the event log file. After stop_log_writer() returns the writer thread is not restarted by Log_RT() calls from other threads */
+
    sem_wait(&diaglib_sem);
 
    if (lib_dbg_cfg.uEventLogFile && --app_log_file_count == 0) {
 
+      binary_event_log_close();  /* close binary event log if open, JHB Oct 2026 */
+
       fclose(lib_dbg_cfg.uEventLogFile);
       lib_dbg_cfg.uEventLogFile = NULL;
    }
@@ -504,16 +891,19 @@ int slen = 0, fmt_start = 0;
 
 /* set a memory barrier, prevent multiple uncoordinated threads from initializing usec_base more than once. Note this same lock also protects usec_base initialization in DSGetTimestamp() (in diaglib_util.cpp), JHB May 2024 */
 
-   while (__sync_lock_test_and_set(&usec_init_lock, 1) != 0);  /* wait until the lock is zero then write 1 to it. While waiting keep writing a 1 */
+   if (!__atomic_load_n(&usec_base, __ATOMIC_ACQUIRE)) {  /* take the lock only if usec_base is not yet initialized, JHB Oct 2026 */
 
-   if (!usec_base) {  /* initialize usec_base if needed. Log_RT() makes the same check, JHB May 2024 */
+      while (__sync_lock_test_and_set(&usec_init_lock, 1) != 0);  /* wait until the lock is zero then write 1 to it. While waiting keep writing a 1 */
 
-      struct timeval tv;
-      gettimeofday(&tv, NULL);
-      usec_base = tv.tv_sec*1000000L + tv.tv_usec;
-   }
+      if (!usec_base) {  /* initialize usec_base if needed. Log_RT() makes the same check, JHB May 2024 */
+
+         struct timeval tv;
+         gettimeofday(&tv, NULL);
+         usec_base = tv.tv_sec*1000000L + tv.tv_usec;
+      }
 
-   __sync_lock_release(&usec_init_lock);  /* clear the mem barrier (write 0 to the lock) */
+      __sync_lock_release(&usec_init_lock);  /* clear the mem barrier (write 0 to the lock) */
+   }
 
    log_string[0] = (char)0;  /* ensure strlen(log_string) is zero */
 
@@ -530,6 +920,46 @@ int slen = 0, fmt_start = 0;
   
    if ((loglevel & DS_LOG_LEVEL_MASK) < lib_dbg_cfg.uLogLevel) {
 
+   /* implement updated flags in shared_include/config.h and diaglib.h to control output to console and/or event log file, JHB Nov 2024 */
+
+      bool fOutputConsole = lib_dbg_cfg.uEventLogMode & LOG_CONSOLE;  /* LOG_CONSOLE_FILE flag in diaglib.h will set both */
+      bool fOutputFile = lib_dbg_cfg.uEventLogMode & LOG_FILE;
+
+   /* check for overrides in loglevel */
+
+      if ((loglevel & DS_LOG_LEVEL_OUTPUT_FILE) && (loglevel & DS_LOG_LEVEL_OUTPUT_CONSOLE)) { fOutputFile = true; fOutputConsole = true; }  /* DS_LOG_LEVEL_OUTPUT_FILE_CONSOLE flag in config.h will set both */
+      else if (loglevel & DS_LOG_LEVEL_OUTPUT_FILE) { fOutputFile = true; fOutputConsole = false; }
+      else if (loglevel & DS_LOG_LEVEL_OUTPUT_CONSOLE) { fOutputFile = false; fOutputConsole = true; }
+
+   /* record lifespan stats */
+
+      if ((loglevel & DS_LOG_LEVEL_MASK) < 2) __sync_add_and_fetch(&event_log_critical_errors, 1);
+      else if ((loglevel & DS_LOG_LEVEL_MASK) == 2) __sync_add_and_fetch(&event_log_errors, 1);
+      else if ((loglevel & DS_LOG_LEVEL_MASK) == 3) __sync_add_and_fetch(&event_log_warnings, 1);
+
+   /* binary event log: if the event is written as a binary record and console output and API status parsing are not needed, no formatting is done. See notes in event_log_binary.cpp, JHB Oct 2026 */
+
+      bool fBinaryEventLog = (lib_dbg_cfg.uEventLogMode & DS_EVENT_LOG_BINARY) && fOutputFile && !(loglevel & DS_LOG_LEVEL_APPEND_STRING);
+
+      if (fBinaryEventLog) {
+
+         va_start(va, fmt);
+         int ret_val = binary_event_log_write(loglevel, fmt, va);
+         va_end(va);
+
+         if (ret_val >= 0) {
+
+            fOutputFile = false;  /* event log file output is done */
+
+            bool fApiStatusCheck = false;
+            #ifdef ERROR_PARSE_LOGMSG
+            fApiStatusCheck = !(loglevel & DS_LOG_LEVEL_NO_API_CHECK) && (lib_dbg_cfg.uEventLogMode & LOG_SET_API_STATUS) && (loglevel & DS_LOG_LEVEL_MASK) < 4;
+            #endif
+
+            if (!fOutputConsole && !fApiStatusCheck) return 0;
+         }
+      }
+
    /* get timestamp */
 
       if (!(loglevel & DS_LOG_LEVEL_NO_TIMESTAMP)) {
@@ -567,12 +997,6 @@ int slen = 0, fmt_start = 0;
 
       if (!(loglevel & DS_LOG_LEVEL_DONT_ADD_NEWLINE) && log_string[strlen(log_string)-1] != '\n') strcat(log_string, "\n");
 
-   /* record lifespan stats */
-
-      if ((loglevel & DS_LOG_LEVEL_MASK) < 2) __sync_add_and_fetch(&event_log_critical_errors, 1);
-      else if ((loglevel & DS_LOG_LEVEL_MASK) == 2) __sync_add_and_fetch(&event_log_errors, 1);
-      else if ((loglevel & DS_LOG_LEVEL_MASK) == 3) __sync_add_and_fetch(&event_log_warnings, 1);
-
    /* error / warning parsing if (i) enabled and (ii) level is below INFO */
 
 #ifdef ERROR_PARSE_LOGMSG
@@ -619,27 +1043,13 @@ int slen = 0, fmt_start = 0;
       }
 #endif  /* ERROR_PARSE_LOGMSG */
 
-   /* implement updated flags in shared_include/config.h and diaglib.h to control output to console and/or event log file, JHB Nov 2024 */
-
-      bool fOutputConsole = lib_dbg_cfg.uEventLogMode & LOG_CONSOLE;  /* LOG_CONSOLE_FILE flag in diaglib.h will set both */
-      bool fOutputFile = lib_dbg_cfg.uEventLogMode & LOG_FILE;
-
-   /* check for overrides in loglevel */
-
-      if ((loglevel & DS_LOG_LEVEL_OUTPUT_FILE) && (loglevel & DS_LOG_LEVEL_OUTPUT_CONSOLE)) { fOutputFile = true; fOutputConsole = true; }  /* DS_LOG_LEVEL_OUTPUT_FILE_CONSOLE flag in config.h will set both */
-      else if (loglevel & DS_LOG_LEVEL_OUTPUT_FILE) { fOutputFile = true; fOutputConsole = false; }
-      else if (loglevel & DS_LOG_LEVEL_OUTPUT_CONSOLE) { fOutputFile = false; fOutputConsole = true; }
- 
       if (fOutputFile) {
 
-         bool fAllowAppend = true;
-         bool fUseSem = true;
+         bool fAsync = (lib_dbg_cfg.uEventLogMode & DS_EVENT_LOG_ASYNC) != 0;  /* with async event log writes, file open/recreate is handled by writer thread, JHB Oct 2026 */
 
-create_log_file_if_needed:
-
-         open_log_file(fAllowAppend, fUseSem);
+         if (!fAsync) open_log_file(true, true);
 
-         if (lib_dbg_cfg.uEventLogFile) {
+         if (lib_dbg_cfg.uEventLogFile || (fAsync && lib_dbg_cfg.szEventLogFilePath[0])) {
 
          /* check for WEC substitution, notes:  JHB Jan 2021
 
@@ -672,37 +1082,11 @@ create_log_file_if_needed:
                p = log_string_copy;
             }
 
-            int ret_val = fwrite(p, strlen(p), 1, lib_dbg_cfg.uEventLogFile);
-
-            if (ret_val != 1) {  /* we call fwrite() with number of "elements" = 1, not bytes */
-
-               fprintf(stderr, "\nERROR: Log_RT() says not able to write to event log file %s, errno = %d \n", lib_dbg_cfg.szEventLogFilePath, errno);
-            }
-            else if (isFileDeleted(lib_dbg_cfg.uEventLogFile)) {  /* fwrite() won't show an error if file has been deleted, so we always call isFileDeleted() which calls fstat(), JHB Jan 2023 */
-
-               fprintf(stderr, "\nERROR: Log_RT() says event log file %s may have been deleted, errno = %d, attempting to recreate file ... \n", lib_dbg_cfg.szEventLogFilePath, errno);
-               lib_dbg_cfg.uEventLogFile = NULL;
-               fAllowAppend = false;
-               goto create_log_file_if_needed;
-            }
-            else {  /* log file operating normally, check for flush_size and/or max_size in effect */
-
-               if (lib_dbg_cfg.uEventLog_fflush_size) {
-
-                  uint64_t fsize = ftell(lib_dbg_cfg.uEventLogFile);
-
-                  if (fsize > lib_dbg_cfg.uEventLog_fflush_size) {
-                     last_size = fsize;
-                     fflush(lib_dbg_cfg.uEventLogFile);
-                  }
-               }
-
-               if (lib_dbg_cfg.uEventLog_max_size) {
+            int len = strlen(p);
 
-                  uint64_t fsize = ftell(lib_dbg_cfg.uEventLogFile);
+            if (!fBinaryEventLog || binary_event_log_write_text(loglevel, p, len) < 0) {  /* if event couldn't be written as a binary record, write as a text record in the binary event log, otherwise write to text event log, JHB Oct 2026 */
 
-                  if (fsize > lib_dbg_cfg.uEventLog_max_size) rewind(lib_dbg_cfg.uEventLogFile);
-               }
+               if (!fAsync || log_async_write(p, len) < 0) write_event_log(p, len);  /* fwrite(), recreate file if deleted, and flush_size and max_size handling moved to write_event_log(), JHB Oct 2026 */
             }
          }
       }
@@ -0,0 +1,182 @@
+/*
+ $Header: /root/Signalogic/DirectCore/lib/diaglib/pktstats_bench.cpp
+
+ Copyright (C) Signalogic Inc. 2026
+
+ License
+
+  Use and distribution of this source code is subject to terms and conditions of the Github SigSRF License v1.1, published at https://github.com/signalogic/SigSRF_SDK/blob/master/LICENSE.md. Absolutely prohibited for AI language or programming model training use
+
+ Description
+
+  benchmark for DSFindSSRCGroups() stream collation with synthetic PKT_STATS arrays. Compares hash lookup and counting sort collation with the linear search and memmove() collation used prior to Oct 2026 (still used as a fallback if allocation fails)
+
+ Notes
+
+  -build with "make bench" in the diaglib folder. diaglib sources are compiled with PKTSTATS_BENCH defined, which allows the benchmark to force the previous method (see fPktStatsBenchLegacy in diaglib.cpp)
+  -run with ./pktstats_bench [-n num_entries] [-l max_legacy_entries]. Default num_entries is 10M. The previous method is O(packets x SSRCs) with large data movement and takes minutes at 10M entries, so by default it's run only up to 100k entries; use -l to change
+  -entries are interleaved across streams with random burst lengths (similar to packet history logs of calls with several streams), sequence numbers wrap. Each stream has a unique SSRC and channel number
+  -collated output is checked against std::stable_sort() by order of first appearance, and for sizes where both methods run, outputs and SSRC group arrays are compared. Return value is non-zero on any mismatch
+
+ Revision History
+
+  Created Oct 2026 JHB
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+
+#include "diaglib.h"
+
+extern bool fPktStatsBenchLegacy;
+
+typedef struct {  /* DSFindSSRCGroups() output arrays */
+
+   uint32_t ssrcs[MAX_SSRCS];
+   uint16_t chnum[MAX_SSRCS];
+   int first_pkt_idx[MAX_SSRCS];
+   int last_pkt_idx[MAX_SSRCS];
+   uint32_t first_rtp_seqnum[MAX_SSRCS];
+   uint32_t last_rtp_seqnum[MAX_SSRCS];
+
+} SSRC_GROUPS;
+
+static double bench_sec(void) {
+
+struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void make_pkts(PKT_STATS* pkts, int num_pkts, int num_streams) {
+
+std::vector<uint32_t> ssrc(num_streams);
+std::vector<uint16_t> seqnum(num_streams);
+int j = 0, k, burst;
+
+   for (k=0; k<num_streams; k++) { ssrc[k] = (uint32_t)rand() << 16 ^ rand(); seqnum[k] = rand() & 0xffff; }
+
+   while (j < num_pkts) {
+
+      k = rand() % num_streams;
+
+      for (burst = 1 + rand() % 4; burst > 0 && j < num_pkts; burst--, j++) {
+
+         memset(&pkts[j], 0, sizeof(PKT_STATS));
+         pkts[j].rtp_ssrc = ssrc[k];
+         pkts[j].rtp_seqnum = seqnum[k]++;
+         pkts[j].rtp_timestamp = pkts[j].rtp_seqnum*160;
+         pkts[j].rtp_pyldlen = 33;
+         pkts[j].chnum = k;
+         pkts[j].idx = -1;
+      }
+   }
+}
+
+static bool check_collation(PKT_STATS* orig, PKT_STATS* collated, int num_pkts) {  /* reference: stable sort by order of first appearance of SSRC + chnum */
+
+std::vector<int> first(65536, -1), order(num_pkts);
+int j, n = 0;
+
+   for (j=0; j<num_pkts; j++) if (first[(uint16_t)orig[j].chnum] < 0) first[(uint16_t)orig[j].chnum] = n++;
+   for (j=0; j<num_pkts; j++) order[j] = j;
+
+   std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return first[(uint16_t)orig[a].chnum] < first[(uint16_t)orig[b].chnum]; });
+
+   for (j=0; j<num_pkts; j++) if (memcmp(&orig[order[j]], &collated[j], sizeof(PKT_STATS))) return false;
+
+   return true;
+}
+
+static int run(PKT_STATS* pkts, PKT_STATS* work, int num_pkts, bool fLegacy, SSRC_GROUPS* groups, double* elapsed) {
+
+int num_ssrcs;
+
+   memcpy(work, pkts, num_pkts*sizeof(PKT_STATS));
+
+   fPktStatsBenchLegacy = fLegacy;
+
+   double t = bench_sec();
+   num_ssrcs = DSFindSSRCGroups(work, DS_PKTSTATS_LOG_COLLATE_STREAMS | DS_PKTSTATS_MATCH_CHNUM, num_pkts, groups->ssrcs, groups->chnum, groups->first_pkt_idx, groups->last_pkt_idx, groups->first_rtp_seqnum, groups->last_rtp_seqnum);
+   *elapsed = bench_sec() - t;
+
+   fPktStatsBenchLegacy = false;
+
+   return num_ssrcs;
+}
+
+static bool compare_groups(SSRC_GROUPS* a, SSRC_GROUPS* b, int num_ssrcs) {
+
+   return !memcmp(a->ssrcs, b->ssrcs, num_ssrcs*sizeof(uint32_t)) && !memcmp(a->chnum, b->chnum, num_ssrcs*sizeof(uint16_t)) && !memcmp(a->first_pkt_idx, b->first_pkt_idx, num_ssrcs*sizeof(int)) &&
+          !memcmp(a->last_pkt_idx, b->last_pkt_idx, num_ssrcs*sizeof(int)) && !memcmp(a->first_rtp_seqnum, b->first_rtp_seqnum, num_ssrcs*sizeof(uint32_t)) && !memcmp(a->last_rtp_seqnum, b->last_rtp_seqnum, num_ssrcs*sizeof(uint32_t));
+}
+
+int main(int argc, char* argv[]) {
+
+int num_entries = 10000000, max_legacy_entries = 100000, num_errors = 0, i, n;
+const int num_streams[] = { 2, 8, 32, 128 };
+PKT_STATS *pkts, *work, *work_legacy;
+SSRC_GROUPS *groups, *groups_legacy;
+
+   for (i=1; i<argc; i++) {
+      if (!strcmp(argv[i], "-n") && i+1 < argc) num_entries = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-l") && i+1 < argc) max_legacy_entries = atoi(argv[++i]);
+      else { printf("usage: %s [-n num_entries] [-l max_legacy_entries] \n", argv[0]); return 1; }
+   }
+
+   pkts = (PKT_STATS*)malloc(num_entries*sizeof(PKT_STATS));
+   work = (PKT_STATS*)malloc(num_entries*sizeof(PKT_STATS));
+   work_legacy = (PKT_STATS*)malloc(std::min(num_entries, max_legacy_entries)*sizeof(PKT_STATS) + 1);
+   groups = (SSRC_GROUPS*)malloc(sizeof(SSRC_GROUPS));
+   groups_legacy = (SSRC_GROUPS*)malloc(sizeof(SSRC_GROUPS));
+
+   if (!pkts || !work || !work_legacy || !groups || !groups_legacy) { printf("unable to allocate mem for %d entries \n", num_entries); return 1; }
+
+   printf("DSFindSSRCGroups() collation benchmark, diaglib version %s, sizeof(PKT_STATS) = %d \n", DIAGLIB_VERSION, (int)sizeof(PKT_STATS));
+
+   srand(1);
+
+   for (i=0; i<(int)(sizeof(num_streams)/sizeof(num_streams[0])); i++) {
+
+      int sizes[2] = { num_entries, std::min(num_entries, max_legacy_entries) };
+
+      for (n=0; n<(sizes[1] < sizes[0] ? 2 : 1); n++) {
+
+         double t_new, t_legacy;
+         int num_pkts = sizes[n];
+
+         make_pkts(pkts, num_pkts, num_streams[i]);
+
+         int num_ssrcs = run(pkts, work, num_pkts, false, groups, &t_new);
+         bool fOk = num_ssrcs == num_streams[i] && check_collation(pkts, work, num_pkts);
+
+         printf("  %9d entries %4d streams  hash + counting sort %8.3f sec  %s", num_pkts, num_streams[i], t_new, fOk ? "ok" : "MISMATCH");
+         if (!fOk) num_errors++;
+
+         if (num_pkts <= max_legacy_entries) {
+
+            int num_ssrcs_legacy = run(pkts, work_legacy, num_pkts, true, groups_legacy, &t_legacy);
+            bool fMatch = num_ssrcs_legacy == num_ssrcs && !memcmp(work, work_legacy, num_pkts*sizeof(PKT_STATS)) && compare_groups(groups, groups_legacy, num_ssrcs);
+
+            printf("  previous method %8.3f sec  speedup %7.1fx  %s", t_legacy, t_new > 0 ? t_legacy/t_new : 0.0, fMatch ? "identical" : "MISMATCH");
+            if (!fMatch) num_errors++;
+         }
+         else printf("  previous method skipped (> %d entries, see -l option)", max_legacy_entries);
+
+         printf(" \n");
+      }
+   }
+
+   if (num_errors) printf("%d test(s) with mismatch \n", num_errors);
+
+   free(pkts); free(work); free(work_legacy); free(groups); free(groups_legacy);
+
+   return num_errors ? 1 : 0;
+}
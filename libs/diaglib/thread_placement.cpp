@@ -0,0 +1,292 @@
+/*
+ $Header: /root/Signalogic/DirectCore/lib/diaglib/thread_placement.cpp
+
+ Description: SigSRF and EdgeStream thread placement -- CPU core lists, SMT sibling avoidance, and NUMA node local memory policy for packet/media and application threads
+
+ Project: SigSRF, DirectCore
+
+ Copyright Signalogic Inc. 2026
+
+ Use and distribution of this source code is subject to terms and conditions of the Github SigSRF License v1.1, published at https://github.com/signalogic/SigSRF_SDK/blob/master/LICENSE.md. Absolutely prohibited for AI language or programming model training use
+
+ Revision History
+
+  Created Oct 2026 JHB
+  Modified Oct 2026 JHB, with DS_THREAD_PLACEMENT_APP_EXCLUDE_PKTMEDIA_CORES app threads are restricted to CPUs on the NUMA node(s) of the p/m thread cores. If those nodes have no free CPUs, app threads use the remaining CPUs and with DS_THREAD_PLACEMENT_NUMA_LOCAL_MEM their memory policy prefers a p/m thread node
+*/
+
+/* thread placement notes, JHB Oct 2026:
+
+  -DSConfigThreadPlacement() sets core lists for packet/media (p/m) threads and application threads, and default placement flags. Core lists are either comma separated CPUs and CPU ranges (e.g. "2-15,34-47") or a hex bit mask (e.g. "0xfffc"). Apps typically call it once before starting p/m threads
+  -DSSetThreadPlacement() places the calling thread. Thread N is pinned to the Nth eligible CPU in its core list (wrapping if there are more threads than CPUs). CPUs not in the process affinity mask are not eligible
+  -with DS_THREAD_PLACEMENT_AVOID_SMT_SIBLINGS, CPUs whose SMT (hyperthread) sibling is also in the core list are ordered last, so threads are placed one per physical core before any two share a core
+  -with DS_THREAD_PLACEMENT_NODE_AFFINITY, the thread is allowed to run on all eligible CPUs on the NUMA node of its selected CPU, instead of only the selected CPU
+  -with DS_THREAD_PLACEMENT_NUMA_LOCAL_MEM, the thread's memory policy is set to prefer its NUMA node. Pages first touched by the thread (including jitter buffers, stream group buffers, and packet queues initialized by p/m threads) are then allocated on the local node, avoiding cross-node memory traffic on multi-socket servers. Memory allocated and first touched by other threads is not affected, so app threads that create sessions should be placed on the same node(s) as p/m threads
+  -with DS_THREAD_PLACEMENT_APP_EXCLUDE_PKTMEDIA_CORES and no app thread core list, app threads use CPUs not in the p/m thread core list on the NUMA node(s) of p/m thread cores, so session buffers first touched by app threads are on p/m thread nodes. If p/m threads use all CPUs on their nodes, app threads use remaining CPUs on other nodes, and with DS_THREAD_PLACEMENT_NUMA_LOCAL_MEM their memory policy prefers a p/m thread node (app thread N prefers the Nth p/m node, wrapping) instead of their own node
+  -topology is read from /sys/devices/system/cpu. If not available, SMT sibling and NUMA node info is not used and placement is CPU pinning only
+  -libnuma is not required, the memory policy is set with the set_mempolicy() system call
+*/
+
+/* Linux includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/syscall.h>
+
+/* SigSRF includes */
+
+#include "diaglib.h"
+
+#ifndef MPOL_PREFERRED
+  #define MPOL_PREFERRED 1  /* from linux/mempolicy.h */
+#endif
+
+#define MAX_CORE_LIST_LEN  1024
+#define MAX_NUMA_NODES     1024
+
+static char szPktMediaThreadCoreList[MAX_CORE_LIST_LEN] = "";
+static char szAppThreadCoreList[MAX_CORE_LIST_LEN] = "";
+static unsigned int uPlacementFlags = 0;  /* default flags set by DSConfigThreadPlacement() */
+static cpu_set_t process_cpus;  /* CPUs allowed when DSConfigThreadPlacement() was called. Threads inherit affinity from their creator, so after placement a thread's own affinity mask can't be used to find eligible CPUs for threads it creates */
+static bool fProcessCpusInit = false;
+
+/* parse core list string into a cpu set, returns number of CPUs or -1 on syntax error */
+
+static int parse_core_list(const char* szCoreList, cpu_set_t* cpuset) {
+
+const char* p = szCoreList;
+char* endptr;
+int i, len, cpu, first, last;
+
+   CPU_ZERO(cpuset);
+
+   while (isspace(*p)) p++;
+
+   if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {  /* hex bit mask, rightmost digit is CPUs 0-3 */
+
+      p += 2;
+      for (len=0; isxdigit(p[len]); len++);
+
+      for (i=0; i<len; i++) {
+
+         int digit = isdigit(p[len-1-i]) ? p[len-1-i] - '0' : tolower(p[len-1-i]) - 'a' + 10;
+
+         for (cpu=0; cpu<4; cpu++) if ((digit & (1 << cpu)) && i*4 + cpu < CPU_SETSIZE) CPU_SET(i*4 + cpu, cpuset);
+      }
+
+      return len ? CPU_COUNT(cpuset) : -1;
+   }
+
+   while (*p) {  /* comma separated CPUs and CPU ranges */
+
+      first = strtol(p, &endptr, 10);
+      if (endptr == p || first < 0) return -1;
+      p = endptr;
+
+      if (*p == '-') {
+         p++;
+         last = strtol(p, &endptr, 10);
+         if (endptr == p || last < first) return -1;
+         p = endptr;
+      }
+      else last = first;
+
+      for (cpu=first; cpu<=last && cpu<CPU_SETSIZE; cpu++) CPU_SET(cpu, cpuset);
+
+      while (isspace(*p)) p++;
+      if (*p == ',') p++;
+      else if (*p) return -1;
+      while (isspace(*p)) p++;
+   }
+
+   return CPU_COUNT(cpuset);
+}
+
+/* return lowest numbered SMT sibling of a CPU (which may be the CPU itself), or the CPU if topology info is not available */
+
+static int get_smt_sibling(int cpu) {
+
+char szPath[128];
+FILE* fp;
+int sibling = cpu;
+
+   sprintf(szPath, "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+
+   if ((fp = fopen(szPath, "r"))) {
+      if (fscanf(fp, "%d", &sibling) != 1) sibling = cpu;  /* first entry in the list is the lowest numbered sibling, e.g. "0,32" or "0-1" */
+      fclose(fp);
+   }
+
+   return sibling;
+}
+
+/* return NUMA node of a CPU, or -1 if not known */
+
+int DSGetCpuNumaNode(int cpu) {
+
+char szPath[128];
+DIR* dir;
+struct dirent* entry;
+int node = -1;
+
+   sprintf(szPath, "/sys/devices/system/cpu/cpu%d", cpu);
+
+   if (!(dir = opendir(szPath))) return -1;
+
+   while ((entry = readdir(dir))) if (!strncmp(entry->d_name, "node", 4) && isdigit(entry->d_name[4])) { node = atoi(&entry->d_name[4]); break; }  /* sysfs cpuN folder has a nodeM link */
+
+   closedir(dir);
+
+   return node;
+}
+
+int DSConfigThreadPlacement(const char* szPktMediaCoreList, const char* szAppCoreList, unsigned int uFlags) {
+
+cpu_set_t cpuset;
+
+   if (szPktMediaCoreList && strlen(szPktMediaCoreList) && parse_core_list(szPktMediaCoreList, &cpuset) <= 0) {
+      Log_RT(2, "ERROR: DSConfigThreadPlacement() says invalid or empty p/m thread core list %s \n", szPktMediaCoreList);
+      return -1;
+   }
+
+   if (szAppCoreList && strlen(szAppCoreList) && parse_core_list(szAppCoreList, &cpuset) <= 0) {
+      Log_RT(2, "ERROR: DSConfigThreadPlacement() says invalid or empty app thread core list %s \n", szAppCoreList);
+      return -1;
+   }
+
+   if (!fProcessCpusInit) fProcessCpusInit = sched_getaffinity(0, sizeof(process_cpus), &process_cpus) == 0;
+
+   strncpy(szPktMediaThreadCoreList, szPktMediaCoreList ? szPktMediaCoreList : "", MAX_CORE_LIST_LEN-1);
+   strncpy(szAppThreadCoreList, szAppCoreList ? szAppCoreList : "", MAX_CORE_LIST_LEN-1);
+   uPlacementFlags = uFlags;
+
+   Log_RT(4, "INFO: DSConfigThreadPlacement() says p/m thread core list = %s, app thread core list = %s, flags = 0x%x \n", strlen(szPktMediaThreadCoreList) ? szPktMediaThreadCoreList : "none", strlen(szAppThreadCoreList) ? szAppThreadCoreList : (uFlags & DS_THREAD_PLACEMENT_APP_EXCLUDE_PKTMEDIA_CORES) && strlen(szPktMediaThreadCoreList) ? "cores not used by p/m threads" : "none", uFlags);
+
+   return 1;
+}
+
+int DSSetThreadPlacement(int nThread, unsigned int uFlags, const char* szCoreList, THREAD_PLACEMENT* pPlacement) {
+
+cpu_set_t cpuset, allowed, mask, secondary;
+int i, n = 0, cpu, node, numCpus, mem_node = -1, num_pm_nodes = 0;
+int cpus[CPU_SETSIZE], pm_nodes[MAX_NUMA_NODES];
+bool fPmNode[MAX_NUMA_NODES] = { false };
+const char* szThreadType = (uFlags & DS_THREAD_PLACEMENT_PKTMEDIA_THREAD) ? "p/m thread" : (uFlags & DS_THREAD_PLACEMENT_APP_THREAD) ? "app thread" : "thread";
+char tmpstr[200] = "";
+
+   if (pPlacement) { memset(pPlacement, 0, sizeof(THREAD_PLACEMENT)); pPlacement->cpu = -1; pPlacement->node = -1; }
+
+   if (nThread < 0) return -1;
+
+/* get core list */
+
+   if (!szCoreList) {
+
+      uFlags |= uPlacementFlags;
+
+      if (uFlags & DS_THREAD_PLACEMENT_PKTMEDIA_THREAD) szCoreList = szPktMediaThreadCoreList;
+      else if (uFlags & DS_THREAD_PLACEMENT_APP_THREAD) szCoreList = szAppThreadCoreList;
+      else return 0;
+   }
+
+   if (fProcessCpusInit) memcpy(&allowed, &process_cpus, sizeof(cpu_set_t));
+   else if (sched_getaffinity(0, sizeof(allowed), &allowed) < 0) CPU_ZERO(&allowed);
+
+   if (strlen(szCoreList)) {
+      if (parse_core_list(szCoreList, &cpuset) < 0) { Log_RT(2, "ERROR: DSSetThreadPlacement() says invalid core list %s \n", szCoreList); return -1; }
+   }
+   else if ((uFlags & DS_THREAD_PLACEMENT_APP_THREAD) && (uFlags & DS_THREAD_PLACEMENT_APP_EXCLUDE_PKTMEDIA_CORES) && strlen(szPktMediaThreadCoreList) && parse_core_list(szPktMediaThreadCoreList, &mask) > 0) {
+
+      CPU_XOR(&cpuset, &allowed, &mask);  /* app threads use CPUs not used by p/m threads */
+      CPU_AND(&cpuset, &cpuset, &allowed);
+      CPU_AND(&mask, &mask, &allowed);
+
+   /* restrict to NUMA node(s) of p/m thread cores, so session buffers first touched by app threads are local to p/m threads */
+
+      for (cpu=0; cpu<CPU_SETSIZE; cpu++) if (CPU_ISSET(cpu, &mask) && (node = DSGetCpuNumaNode(cpu)) >= 0 && node < MAX_NUMA_NODES && !fPmNode[node]) { fPmNode[node] = true; pm_nodes[num_pm_nodes++] = node; }
+
+      if (num_pm_nodes) {
+
+         memcpy(&secondary, &cpuset, sizeof(cpu_set_t));
+
+         for (cpu=0; cpu<CPU_SETSIZE; cpu++) if (CPU_ISSET(cpu, &secondary) && ((node = DSGetCpuNumaNode(cpu)) < 0 || node >= MAX_NUMA_NODES || !fPmNode[node])) CPU_CLR(cpu, &secondary);
+
+         if (CPU_COUNT(&secondary)) memcpy(&cpuset, &secondary, sizeof(cpu_set_t));
+         else mem_node = pm_nodes[nThread % num_pm_nodes];  /* no free CPUs on p/m thread nodes, app thread runs on another node but prefers p/m thread node memory */
+      }
+   }
+   else return 0;  /* no placement configured */
+
+   CPU_AND(&cpuset, &cpuset, &allowed);  /* CPUs not in the process affinity mask (e.g. taskset, cgroup cpusets) are not eligible */
+
+/* order eligible CPUs. With SMT sibling avoidance, CPUs with a lower numbered sibling also in the list go last */
+
+   CPU_ZERO(&secondary);
+
+   for (cpu=0; cpu<CPU_SETSIZE; cpu++) {
+
+      if (!CPU_ISSET(cpu, &cpuset)) continue;
+
+      int sibling = (uFlags & DS_THREAD_PLACEMENT_AVOID_SMT_SIBLINGS) ? get_smt_sibling(cpu) : cpu;
+
+      if (sibling == cpu || !CPU_ISSET(sibling, &cpuset)) cpus[n++] = cpu;
+      else CPU_SET(cpu, &secondary);
+   }
+
+   for (cpu=0; cpu<CPU_SETSIZE; cpu++) if (CPU_ISSET(cpu, &secondary)) cpus[n++] = cpu;
+
+   if (!n) {
+      Log_RT(3, "WARNING: DSSetThreadPlacement() says no eligible CPUs for %s %d, core list %s not in process affinity mask \n", szThreadType, nThread, strlen(szCoreList) ? szCoreList : "(all)");
+      return -1;
+   }
+
+   cpu = cpus[nThread % n];
+   node = DSGetCpuNumaNode(cpu);
+
+/* set affinity: selected CPU, or all eligible CPUs on its node */
+
+   CPU_ZERO(&mask);
+
+   if ((uFlags & DS_THREAD_PLACEMENT_NODE_AFFINITY) && node >= 0) {
+      for (i=0; i<n; i++) if (DSGetCpuNumaNode(cpus[i]) == node) CPU_SET(cpus[i], &mask);
+   }
+   else CPU_SET(cpu, &mask);
+
+   numCpus = CPU_COUNT(&mask);
+
+   if ((i = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mask))) {
+      Log_RT(3, "WARNING: DSSetThreadPlacement() says pthread_setaffinity_np() failed for %s %d, CPU %d, errno = %s \n", szThreadType, nThread, cpu, strerror(i));
+      return -1;
+   }
+
+   if (pPlacement) { pPlacement->cpu = cpu; pPlacement->node = node; pPlacement->num_cpus = numCpus; pPlacement->uFlags = uFlags; }
+
+/* set memory policy to prefer local NUMA node, or p/m thread node for app threads placed off p/m thread nodes */
+
+   if (mem_node < 0) mem_node = node;
+
+   if ((uFlags & DS_THREAD_PLACEMENT_NUMA_LOCAL_MEM) && mem_node >= 0 && mem_node < MAX_NUMA_NODES) {
+
+      unsigned long nodemask[MAX_NUMA_NODES/(8*sizeof(unsigned long))] = { 0 };
+
+      nodemask[mem_node/(8*sizeof(unsigned long))] = 1UL << (mem_node % (8*sizeof(unsigned long)));
+
+      if (!syscall(SYS_set_mempolicy, MPOL_PREFERRED, nodemask, MAX_NUMA_NODES)) {
+         if (pPlacement) pPlacement->fNumaLocalMem = true;
+         if (mem_node == node) strcpy(tmpstr, ", local node memory");
+         else sprintf(tmpstr, ", no free CPUs on p/m thread node(s), node %d memory", mem_node);
+      }
+      else sprintf(tmpstr, ", set_mempolicy() failed, errno = %s", strerror(errno));  /* e.g. ENOSYS if kernel built without NUMA support */
+   }
+
+   Log_RT(4, "INFO: DSSetThreadPlacement() says %s %d placed on CPU %d, NUMA node %d%s%s \n", szThreadType, nThread, cpu, node, numCpus > 1 ? ", node affinity" : "", tmpstr);
+
+   return 1;
+}
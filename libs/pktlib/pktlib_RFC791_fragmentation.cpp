@@ -48,12 +48,18 @@ Revision History
   Modified Aug 2025 JHB, add uPktNumber param to DSGetPacketInfo() calls per mod in pktlib.h
   Modified Aug 2025 JHB, add IPv6 fragmentation and reassembly support per RFC 8200
   Modified Aug 2025 JHB, in DSIsPacketDuplicate() packet lengths check pulled out of TCP and UDP sections and moved to on-entry
+  Modified Oct 2026 JHB, replace per-thread fragment linked list with per-thread datagram hash table (key is 3-way tuple + identifier) and fixed-size fragment/buffer pool. Add reassembly timeout and pool eviction, add DSConfigPktFragmentation() and DSGetPktFragmentStats() APIs. See comments near FRAGMENT_DATAGRAM
+  Modified Oct 2026 JHB, cache App_Thread_Info[] slot index in thread-local storage; GetThreadIndex() no longer takes a lock or searches on every call. Add DSPktFragmentThreadRegister() and DSPktFragmentThreadCleanup() APIs. See comments near thread_slot
+  Modified Oct 2026 JHB, DSGetPktFragmentStats() with DS_PKT_FRAGMENT_STATS_ALL_THREADS holds the App_Thread_Info[] lock while reading other threads' stats and fragment state
+  Modified Oct 2026 JHB, DSPktFragmentThreadCleanup() detaches fragment state under the App_Thread_Info[] lock and frees it after releasing the lock
 */
 
 /* Linux and/or other OS includes */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <pthread.h>
 
 #include <algorithm>
@@ -68,14 +74,16 @@ using namespace std;
 
 /* Internal fragmentation functions and stats. Notes, JHB Jun 2024:
 
-   -fragments are managed as per app thread linked lists; a simple mem barrier lock coordinates critical section thread access and modification of App_Thread_Info[]. This method works as long as the caller has a unique thread Id; for example, p/m threads could also call DSGetPacketInfo() with fragmented packets
-   -each linked list fragment entry includes 3-way tuple info (protocol, IP src addr, IP dst addr), IP header identifier (Identification field), and fragment offset. See PKT_FRAGMENT struct in pktlib.h
-   -each linked list entry also includes packet info: flags, identifier, fragment offset, and saved IP header and packet data
-   -performance wise, the worst case is an app thread with a high number of streams each with large packets of size 4500 to 6000 bytes, in which case the thread's linked list length could grow to around N*3 or N*4, where N is number of streams
-   -theoretically performance could be improved by adding a per stream linked list (as a sub list under the thread list) based on the 3-way tuple, but that involves creating a unique key or hash for each tuple. That step is time-consuming, involving memcmp's of 30+ bytes, so potential performance gain is unclear at the expense of increase in coding complexity and maintenance resources **
-   -we maintain a "highest used location" (max_search_limit) to reduce search time for existing thread Ids. The search loop isn't doing much, just comparing 64-bit thread Id values
-   
-** I actually tried this in pktlib_new_frag_list.c ... I didn't get it completely working, some debug needed. But after seeing the amount of critical section code for the sub linked list, I put the effort on hold
+   -fragments are managed per app thread; a simple mem barrier lock coordinates critical section thread access and modification of App_Thread_Info[] (as of Oct 2026 only on thread registration and cleanup). This method works as long as the caller has a unique thread Id; for example, p/m threads could also call DSGetPacketInfo() with fragmented packets
+   -each fragment entry includes 3-way tuple info (protocol, IP src addr, IP dst addr), IP header identifier (Identification field), and fragment offset. See PKT_FRAGMENT struct in pktlib.h
+   -each fragment entry also includes packet info: flags, identifier, fragment offset, and saved IP header and packet data
+
+   Notes on hash table, buffer pool, and timeouts, JHB Oct 2026:
+
+   -previously each thread had one linked list of all fragments, so add/find/status/reassemble were all O(n) list walks, with a calloc and two mallocs per fragment. With heavily fragmented SIP and lawful intercept streams that became significant, and fragments orphaned by packet loss stayed on the list until app cleanup
+   -fragments are now grouped by datagram (3-way tuple + identifier, see FRAGMENT_DATAGRAM below). Datagrams are kept in a per-thread hash table, so finding a datagram costs a hash and a short chain walk. Each datagram has its own short fragment list and keeps a running sum of fragment lengths
+   -fragment entries, datagram entries, and fragment data buffers come from a per-thread fixed-size pool, allocated on first fragment. Fragments that don't fit in a pool buffer (IP header + data > FRAGMENT_POOL_BUF_SIZE) get a heap buffer. If the pool is full the oldest datagram is evicted; if there is nothing to evict, heap memory is used
+   -datagrams older than the reassembly timeout are removed when new fragments arrive (RFC 791 "timer", default FRAGMENT_DEFAULT_TIMEOUT_MSEC). Timeout and pool size are set with DSConfigPktFragmentation(); stats are available from DSGetPktFragmentStats()
 
    Parameters:
    
@@ -101,15 +109,59 @@ int PktReassemble(uint8_t* pkt, uint8_t* pFragHdrIPv6, unsigned int uFlags);
 
 //#define FRAGMENTATION_DEBUG
 
-#define MAX_APP_THREADS 128
+#define MAX_APP_THREADS                  128
+
+#define FRAGMENT_HASH_SIZE              1024  /* per-thread datagram hash table size, must be a power of 2 */
+#define FRAGMENT_DEFAULT_POOL_SIZE      1024  /* default number of per-thread pooled fragment entries and buffers */
+#define FRAGMENT_POOL_BUF_SIZE          1600  /* pooled fragment buffer size, holds IP header + data of MTU size fragments */
+#define FRAGMENT_DEFAULT_TIMEOUT_MSEC  30000  /* default reassembly timeout, same as Linux ipfrag_time */
+
+typedef struct FRAGMENT_DATAGRAM {  /* fragments of one IP datagram, JHB Oct 2026 */
+
+   uint8_t            protocol;     /* 3-way tuple and identifier, same as PKT_FRAGMENT items */
+   unsigned __int128  ip_src_addr;
+   unsigned __int128  ip_dst_addr;
+   uint32_t           identifier;
+
+   PKT_FRAGMENT*      pFragmentList;  /* fragments in arrival order */
+   int                num_fragments;
+   int                reassembled_len;  /* sum of fragment data lengths */
+   uint64_t           first_time;       /* arrival time of first fragment, in usec */
+
+   struct FRAGMENT_DATAGRAM* hash_next;  /* hash chain */
+   struct FRAGMENT_DATAGRAM* age_prev;   /* age list, oldest first. Used for timeouts and pool eviction */
+   struct FRAGMENT_DATAGRAM* age_next;
+
+} FRAGMENT_DATAGRAM;
+
+typedef struct {  /* per-thread fragment state, allocated on first fragment */
+
+   FRAGMENT_DATAGRAM*  hash_table[FRAGMENT_HASH_SIZE];
+   FRAGMENT_DATAGRAM*  age_head;
+   FRAGMENT_DATAGRAM*  age_tail;
+
+   int                 pool_size;
+   PKT_FRAGMENT*       frag_nodes;       /* pool_size fragment entries */
+   uint8_t*            frag_bufs;        /* pool_size fragment buffers, FRAGMENT_POOL_BUF_SIZE bytes each */
+   FRAGMENT_DATAGRAM*  dgram_nodes;      /* pool_size datagram entries */
+   PKT_FRAGMENT*       free_frags;       /* free lists */
+   FRAGMENT_DATAGRAM*  free_dgrams;
+
+   int                 active_datagrams;
+
+} FRAGMENT_STATE;
 
 typedef struct {
 
-   pthread_t      ThreadId;               /* unique thread Id */
-   PKT_FRAGMENT*  pPktFragmentList;       /* per thread packet fragment list */
-   int            total_fragment_count;   /* total fragments handled by the app thread */
-   int            active_fragment_count;  /* fragments currently active at any one time. DSPktRemoveFragment() can be called by an app thread during cleanup to get number of "orphan" fragments remaining on the thread's linked list */
-   int            max_fragment_count;     /* max active fragments on the thread's link list */
+   pthread_t           ThreadId;               /* unique thread Id */
+   FRAGMENT_STATE*     pFragmentState;         /* per thread hash table and pool, JHB Oct 2026 */
+   int                 total_fragment_count;   /* total fragments handled by the app thread */
+   int                 active_fragment_count;  /* fragments currently active at any one time. DSPktRemoveFragment() can be called by an app thread during cleanup to get number of "orphan" fragments remaining */
+   int                 max_fragment_count;     /* max active fragments */
+   uint64_t            num_reassembled;        /* stats, see PKT_FRAGMENT_STATS in pktlib.h, JHB Oct 2026 */
+   uint64_t            num_timed_out;
+   uint64_t            num_evicted;
+   uint64_t            num_pool_overflow;
 
 } APP_THREAD_INFO;
 
@@ -118,46 +170,52 @@ static int max_search_limit = 0;
 
 static uint8_t app_thread_lock = 0;  /* mem barrier lock used for app thread synchronization */
 
+static int reassembly_timeout_msec = FRAGMENT_DEFAULT_TIMEOUT_MSEC;  /* set by DSConfigPktFragmentation() */
+static int fragment_pool_size = FRAGMENT_DEFAULT_POOL_SIZE;
+
 /* local static APIs */
 
-static int GetThreadIndex(bool fDelete) {  /* get thread Id index; create if not existing yet */
+/* per-thread App_Thread_Info[] slot, JHB Oct 2026. Notes:
 
-int i;
+  -a thread's slot index is cached in thread-local storage after first registration, so PktXxxFragment() calls take no lock and do no search. The mem barrier lock is used only when registering or cleaning up a slot
+  -threads can register explicitly with DSPktFragmentThreadRegister(), or are registered automatically on first call to a fragmentation API. DSPktFragmentThreadCleanup() frees the thread's fragments and pool and releases its slot for reuse
+*/
 
-/* start critical section. Section is short and conflict with other threads will be rare */
+static __thread int thread_slot = -1;
 
-   while (__sync_lock_test_and_set(&app_thread_lock, 1) != 0);  /* set a memory barrier to coordinate concurrent app thread access to App_Thread_Info[]. __sync_lock_test_and_set() does atomic test and write 1. Repeat until lock is zero; i.e. no other thread has the lock (https://gcc.gnu.org/onlinedocs/gcc-4.1.0/gcc/Atomic-Builtins.html) */
+static int RegisterThread(void) {  /* find an available slot for the current thread and cache it */
 
-   for (i=0; i<max_search_limit; i++) if (App_Thread_Info[i].ThreadId == pthread_self()) {  /* look for existing thread id */
+int i;
 
-      if (fDelete) App_Thread_Info[i].ThreadId = 0;  /* delete if requested */
-      goto exit;
-   }
+/* start critical section. Section is short and only occurs once per thread */
 
-   if (i == max_search_limit) {  /* create if not found */
+   while (__sync_lock_test_and_set(&app_thread_lock, 1) != 0);  /* set a memory barrier to coordinate concurrent app thread access to App_Thread_Info[]. __sync_lock_test_and_set() does atomic test and write 1. Repeat until lock is zero; i.e. no other thread has the lock (https://gcc.gnu.org/onlinedocs/gcc-4.1.0/gcc/Atomic-Builtins.html) */
 
-      for (i=0; i<MAX_APP_THREADS; i++) if (App_Thread_Info[i].ThreadId == 0) {  /* find first available index */
+   for (i=0; i<MAX_APP_THREADS; i++) if (App_Thread_Info[i].ThreadId == 0) {  /* find first available index */
 
-         App_Thread_Info[i].ThreadId = pthread_self();  /* initialize the new index */
-         max_search_limit = max(max_search_limit, i+1);  /* adjust max search limit */
-         #if 0
-         printf("\n *** creating linked list node, max_search_limit = %d \n", max_search_limit);
-         #endif
-         goto exit;
-      }
+      App_Thread_Info[i].ThreadId = pthread_self();  /* initialize the new index */
+      max_search_limit = max(max_search_limit, i+1);  /* adjust max search limit, used by DSGetPktFragmentStats() */
+      #if 0
+      printf("\n *** registering thread slot %d, max_search_limit = %d \n", i, max_search_limit);
+      #endif
+      break;
    }
 
-   if (i >= MAX_APP_THREADS) i = -1;  /* return error condition - too many app threads */
-
-exit:
 /* end critical section */
    __sync_lock_release(&app_thread_lock);  /* clear the mem barrier (write 0 to the lock) */
-   return i;  /* return thread Id index */
+
+   if (i >= MAX_APP_THREADS) return -1;  /* return error condition - too many app threads */
+
+   thread_slot = i;
+
+   return i;
 }
 
-__attribute__ ((unused)) static int DeleteThreadIndex(void) {  /* delete thread index (currently unused) */
+static inline int GetThreadIndex(void) {  /* get thread Id index; register if not existing yet */
+
+   if (thread_slot >= 0) return thread_slot;
 
-   return GetThreadIndex(true);
+   return RegisterThread();
 }
 
 /* inline helper functions for PktXxxFragment() functions */
@@ -215,40 +273,208 @@ static inline void get_identifier_and_offset(uint8_t* pkt, uint8_t* pFragHdrIPv6
    }
 }
 
-/* private fragment management APIs */
+/* datagram hash table, pool, and timeout helpers, JHB Oct 2026 */
 
-/* add packet fragment to app thread's fragment list */
+static inline uint64_t get_time_usec(void) {
 
-int PktAddFragment(uint8_t* pkt, uint8_t* pFragHdrIPv6, int pkt_len, int ip_hdr_len, int ext_hdr_len, unsigned int uFlags) {
+struct timespec ts;
 
-   if (!pkt) return -1;  /* error condition */
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec*1000000L + ts.tv_nsec/1000;
+}
+
+static inline uint32_t datagram_hash(uint8_t protocol, unsigned __int128 ip_src_addr, unsigned __int128 ip_dst_addr, uint32_t identifier) {
+
+   uint64_t h = (uint64_t)ip_src_addr ^ (uint64_t)(ip_src_addr >> 64) ^ (((uint64_t)ip_dst_addr ^ (uint64_t)(ip_dst_addr >> 64)) * 0x9e3779b97f4a7c15ULL) ^ ((uint64_t)identifier << 8) ^ protocol;
+
+   h *= 0xff51afd7ed558ccdULL;
+
+   return (uint32_t)(h >> 32) & (FRAGMENT_HASH_SIZE-1);
+}
+
+static FRAGMENT_STATE* create_fragment_state(void) {
+
+   FRAGMENT_STATE* pState = (FRAGMENT_STATE*)calloc(1, sizeof(FRAGMENT_STATE));
+
+   if (!pState) return NULL;
+
+   int pool_size = fragment_pool_size;
+
+   if (pool_size > 0) {
+
+      pState->frag_nodes = (PKT_FRAGMENT*)calloc(pool_size, sizeof(PKT_FRAGMENT));
+      pState->frag_bufs = (uint8_t*)malloc((size_t)pool_size*FRAGMENT_POOL_BUF_SIZE);
+      pState->dgram_nodes = (FRAGMENT_DATAGRAM*)calloc(pool_size, sizeof(FRAGMENT_DATAGRAM));
+
+      if (!pState->frag_nodes || !pState->frag_bufs || !pState->dgram_nodes) {  /* no pool; everything will come from the heap */
+
+         if (pState->frag_nodes) free(pState->frag_nodes);
+         if (pState->frag_bufs) free(pState->frag_bufs);
+         if (pState->dgram_nodes) free(pState->dgram_nodes);
+
+         pState->frag_nodes = NULL; pState->frag_bufs = NULL; pState->dgram_nodes = NULL;
+         pool_size = 0;
+      }
+
+      for (int i=pool_size-1; i>=0; i--) {  /* build free lists */
+
+         pState->frag_nodes[i].next = pState->free_frags;
+         pState->free_frags = &pState->frag_nodes[i];
+
+         pState->dgram_nodes[i].hash_next = pState->free_dgrams;
+         pState->free_dgrams = &pState->dgram_nodes[i];
+      }
+   }
+
+   pState->pool_size = max(pool_size, 0);
+
+   return pState;
+}
+
+static inline bool isPoolFragment(FRAGMENT_STATE* pState, PKT_FRAGMENT* pFrag) { return pFrag >= pState->frag_nodes && pFrag < pState->frag_nodes + pState->pool_size; }
+static inline bool isPoolDatagram(FRAGMENT_STATE* pState, FRAGMENT_DATAGRAM* pDgram) { return pDgram >= pState->dgram_nodes && pDgram < pState->dgram_nodes + pState->pool_size; }
+static inline uint8_t* getPoolBuffer(FRAGMENT_STATE* pState, PKT_FRAGMENT* pFrag) { return pState->frag_bufs + (size_t)(pFrag - pState->frag_nodes)*FRAGMENT_POOL_BUF_SIZE; }
+
+static void free_fragment(FRAGMENT_STATE* pState, PKT_FRAGMENT* pFrag) {
 
-/* allocate linked list fragment struct mem */
+   if (isPoolFragment(pState, pFrag)) {
 
-   PKT_FRAGMENT* pPktFrag = (PKT_FRAGMENT*)calloc(1, sizeof(PKT_FRAGMENT));  /* create new fragment list item, initialize all items to zero (especially fragment list head and IP src/dst addrs) */
+      if (pFrag->ip_hdr_buf != getPoolBuffer(pState, pFrag)) free(pFrag->ip_hdr_buf);  /* oversize fragment, buffer was malloc'd */
 
-   if (!pPktFrag) return -1;  /* error condition */
+      pFrag->next = pState->free_frags;
+      pState->free_frags = pFrag;
+   }
+   else {
+      free(pFrag->ip_hdr_buf);  /* IP header and packet data share one buffer */
+      free(pFrag);
+   }
+}
+
+static FRAGMENT_DATAGRAM* find_datagram(FRAGMENT_STATE* pState, uint8_t protocol, unsigned __int128 ip_src_addr, unsigned __int128 ip_dst_addr, uint32_t identifier, FRAGMENT_DATAGRAM*** pp_hash_prev) {
+
+   FRAGMENT_DATAGRAM** pp = &pState->hash_table[datagram_hash(protocol, ip_src_addr, ip_dst_addr, identifier)];
+
+   while (*pp) {
+
+      if (protocol == (*pp)->protocol && ip_src_addr == (*pp)->ip_src_addr && ip_dst_addr == (*pp)->ip_dst_addr && identifier == (*pp)->identifier) break;  /* 3-way tuple and identifier have to match */
+
+      pp = &(*pp)->hash_next;
+   }
+
+   if (pp_hash_prev) *pp_hash_prev = pp;  /* if not found, points to end of chain */
+
+   return *pp;
+}
+
+/* remove a datagram and all its fragments, return number of fragments removed */
+
+static int remove_datagram(int thread_index, FRAGMENT_DATAGRAM* pDgram) {
+
+FRAGMENT_STATE* pState = App_Thread_Info[thread_index].pFragmentState;
+FRAGMENT_DATAGRAM** pp;
+int nRemoved = 0;
+
+   find_datagram(pState, pDgram->protocol, pDgram->ip_src_addr, pDgram->ip_dst_addr, pDgram->identifier, &pp);
+   if (*pp == pDgram) *pp = pDgram->hash_next;  /* unlink from hash chain */
+
+   if (pDgram->age_prev) pDgram->age_prev->age_next = pDgram->age_next;  /* unlink from age list */
+   else pState->age_head = pDgram->age_next;
+   if (pDgram->age_next) pDgram->age_next->age_prev = pDgram->age_prev;
+   else pState->age_tail = pDgram->age_prev;
+
+   PKT_FRAGMENT* pList = pDgram->pFragmentList;
+
+   while (pList) {
+
+      PKT_FRAGMENT* pListNext = pList->next;
+      free_fragment(pState, pList);
+      nRemoved++;
+      pList = pListNext;
+   }
+
+   if (isPoolDatagram(pState, pDgram)) {
+      pDgram->hash_next = pState->free_dgrams;
+      pState->free_dgrams = pDgram;
+   }
+   else free(pDgram);
+
+   pState->active_datagrams--;
+   App_Thread_Info[thread_index].active_fragment_count -= nRemoved;
+
+   return nRemoved;
+}
+
+/* remove datagrams older than reassembly timeout. Age list is in arrival order so we only look at the head */
+
+static void expire_datagrams(int thread_index, uint64_t cur_time) {
 
-/* populate fields of new fragment struct */
+FRAGMENT_STATE* pState = App_Thread_Info[thread_index].pFragmentState;
+uint64_t timeout = (uint64_t)reassembly_timeout_msec*1000;
+
+   if (!timeout) return;
+
+   while (pState->age_head && cur_time - pState->age_head->first_time > timeout) {
+
+      #ifdef FRAGMENTATION_DEBUG
+      printf("\n *** removing timed out datagram, identifier = %d, fragments = %d \n", pState->age_head->identifier, pState->age_head->num_fragments);
+      #endif
+
+      App_Thread_Info[thread_index].num_timed_out += remove_datagram(thread_index, pState->age_head);
+   }
+}
+
+/* if the pool is empty, make room by evicting the oldest datagram (other than pKeep). Returns false if nothing could be evicted */
+
+static bool evict_datagram(int thread_index, FRAGMENT_DATAGRAM* pKeep) {
+
+FRAGMENT_STATE* pState = App_Thread_Info[thread_index].pFragmentState;
+FRAGMENT_DATAGRAM* pDgram = pState->age_head;
+
+   if (pDgram == pKeep && pDgram) pDgram = pDgram->age_next;
+
+   if (!pDgram || !pState->pool_size) return false;
+
+   App_Thread_Info[thread_index].num_evicted += remove_datagram(thread_index, pDgram);
+
+   return true;
+}
+
+/* private fragment management APIs */
+
+/* add packet fragment to app thread's fragment hash table */
+
+int PktAddFragment(uint8_t* pkt, uint8_t* pFragHdrIPv6, int pkt_len, int ip_hdr_len, int ext_hdr_len, unsigned int uFlags) {
+
+PKT_FRAGMENT Frag = { 0 };  /* initialize all items to zero (especially IP src/dst addrs) */
+PKT_FRAGMENT* pPktFrag;
+FRAGMENT_DATAGRAM* pDgram;
+FRAGMENT_DATAGRAM** pp_hash;
+FRAGMENT_STATE* pState;
+int thread_index;
+
+   if (!pkt) return -1;  /* error condition */
+
+/* populate fields of new fragment */
 
 /* protocol + IP src addr + IP dst addr form a 3-way tuple used to uniquely identify stream / connection between endpoints. This prevents potential confusion of Identifiers (16-bit Identification field) between streams, especially after long durations where 16-bit Ids may wrap. Mentioned in RFCs 6864 and 6146 */
 
-   get_3way_tuple(pkt, pFragHdrIPv6, &pPktFrag->protocol, &pPktFrag->ip_src_addr, &pPktFrag->ip_dst_addr);
-   get_identifier_and_offset(pkt, pFragHdrIPv6, &pPktFrag->identifier, &pPktFrag->offset, uFlags);
+   get_3way_tuple(pkt, pFragHdrIPv6, &Frag.protocol, &Frag.ip_src_addr, &Frag.ip_dst_addr);
+   get_identifier_and_offset(pkt, pFragHdrIPv6, &Frag.identifier, &Frag.offset, uFlags);
 
    uint8_t version = pkt[0] >> 4;
 
    if (version == IPv4) {
-      pPktFrag->flags = ((pkt[(uFlags & DS_PKTLIB_HOST_BYTE_ORDER) ? 7 : 6] >> 5) & 1) ? DS_PKT_FRAGMENT_MF : 0;
+      Frag.flags = ((pkt[(uFlags & DS_PKTLIB_HOST_BYTE_ORDER) ? 7 : 6] >> 5) & 1) ? DS_PKT_FRAGMENT_MF : 0;
    }
    else if (version == IPv6) {
 
       if (!pFragHdrIPv6) return -1;  /* error condition */
 
-      pPktFrag->flags = (pFragHdrIPv6[(uFlags & DS_PKTLIB_HOST_BYTE_ORDER) ? 2 : 3] & 1) ? DS_PKT_FRAGMENT_MF : 0;
+      Frag.flags = (pFragHdrIPv6[(uFlags & DS_PKTLIB_HOST_BYTE_ORDER) ? 2 : 3] & 1) ? DS_PKT_FRAGMENT_MF : 0;
    }
 
-   if (pPktFrag->offset) pPktFrag->flags |= DS_PKT_FRAGMENT_OFS;
+   if (Frag.offset) Frag.flags |= DS_PKT_FRAGMENT_OFS;
 
 /* get packet and header length items if not given by caller */
 
@@ -258,108 +484,189 @@ int PktAddFragment(uint8_t* pkt, uint8_t* pFragHdrIPv6, int pkt_len, int ip_hdr_
 
    if (pkt_len <= 0 || ip_hdr_len <= 0 || ext_hdr_len < 0) return -1;
 
-   if (!(pPktFrag->pkt_buf = (uint8_t*)malloc(pkt_len))) return -1;  /* note - we malloc storage only *per fragment*. Reassembly copies/appends each fragment into a pkt[] buffer supplied by the calling app */
-   if (!(pPktFrag->ip_hdr_buf = (uint8_t*)malloc(ip_hdr_len - ext_hdr_len))) return -1;
+   Frag.ip_hdr_len = ip_hdr_len - ext_hdr_len;
+   Frag.len = pkt_len - ip_hdr_len;
 
-/* save IP header info in fragment list entry. Technically only the first fragment (with offset 0) needs to be copied but we can receive fragments out-of-order, so we give PktReassemble() all info it might need at time of reassembly */
+/* get App_Thread_Info[] index for current thread. If not existing GetThreadIndex() will create a new one */
 
-   pPktFrag->ip_hdr_len = ip_hdr_len - ext_hdr_len;
-   memcpy(pPktFrag->ip_hdr_buf, pkt, pPktFrag->ip_hdr_len);
+   if ((thread_index = GetThreadIndex()) < 0) return -1;
 
-/* save packet data in fragment list entry */
+   if (!(pState = App_Thread_Info[thread_index].pFragmentState) && !(pState = App_Thread_Info[thread_index].pFragmentState = create_fragment_state())) return -1;
 
-   pPktFrag->len = pkt_len - ip_hdr_len;
-   memcpy(pPktFrag->pkt_buf, &pkt[ip_hdr_len], pPktFrag->len);
+   uint64_t cur_time = get_time_usec();
 
-/* get App_Thread_Info[] index for current thread. If not existing GetThreadIndex() will create a new one */
+   expire_datagrams(thread_index, cur_time);  /* age out orphans before adding */
 
-   int thread_index = GetThreadIndex(false), list_count = 1;
+/* find or create datagram */
 
-   #ifdef FRAGMENTATION_DEBUG
-   printf("\n *** inside pkt_frag_add, active fragments = %d, flags = 0x%x, identifier = %d, offset = %d, pkt len = %d \n", App_Thread_Info[thread_index].active_fragment_count, pPktFrag->flags, pPktFrag->identifier, pPktFrag->offset, pPktFrag->len);
-   #endif
+   if (!(pDgram = find_datagram(pState, Frag.protocol, Frag.ip_src_addr, Frag.ip_dst_addr, Frag.identifier, &pp_hash))) {
 
-   if (!App_Thread_Info[thread_index].pPktFragmentList) App_Thread_Info[thread_index].pPktFragmentList = pPktFrag;  /* empty list: add as first fragment */
-   else {
+      if (!pState->free_dgrams && evict_datagram(thread_index, NULL)) find_datagram(pState, Frag.protocol, Frag.ip_src_addr, Frag.ip_dst_addr, Frag.identifier, &pp_hash);  /* eviction may have changed the hash chain */
+
+      if (pState->free_dgrams) { pDgram = pState->free_dgrams; pState->free_dgrams = pDgram->hash_next; }
+      else if ((pDgram = (FRAGMENT_DATAGRAM*)malloc(sizeof(FRAGMENT_DATAGRAM)))) App_Thread_Info[thread_index].num_pool_overflow++;
+      else return -1;
+
+      memset(pDgram, 0, sizeof(FRAGMENT_DATAGRAM));
+      pDgram->protocol = Frag.protocol;
+      pDgram->ip_src_addr = Frag.ip_src_addr;
+      pDgram->ip_dst_addr = Frag.ip_dst_addr;
+      pDgram->identifier = Frag.identifier;
+      pDgram->first_time = cur_time;
+
+      *pp_hash = pDgram;  /* add to end of hash chain */
+
+      pDgram->age_prev = pState->age_tail;  /* add to end of age list */
+      if (pState->age_tail) pState->age_tail->age_next = pDgram;
+      else pState->age_head = pDgram;
+      pState->age_tail = pDgram;
+
+      pState->active_datagrams++;
+   }
+
+/* get fragment entry and buffer from pool. IP header and packet data are stored in one buffer */
+
+   int buf_len = Frag.ip_hdr_len + Frag.len;
+
+   if (!pState->free_frags) evict_datagram(thread_index, pDgram);
 
-      PKT_FRAGMENT* pList = App_Thread_Info[thread_index].pPktFragmentList;
+   if ((pPktFrag = pState->free_frags)) {
 
-      while (pList->next) { pList = pList->next; list_count++; }  /* find end of list, count number of list nodes */
+      pState->free_frags = pPktFrag->next;
 
-      pList->next = pPktFrag;  /* add to end of list */
+      *pPktFrag = Frag;
+      if (buf_len <= FRAGMENT_POOL_BUF_SIZE) pPktFrag->ip_hdr_buf = getPoolBuffer(pState, pPktFrag);
+      else { pPktFrag->ip_hdr_buf = (uint8_t*)malloc(buf_len); App_Thread_Info[thread_index].num_pool_overflow++; }
    }
+   else if ((pPktFrag = (PKT_FRAGMENT*)malloc(sizeof(PKT_FRAGMENT)))) {
+
+      *pPktFrag = Frag;
+      pPktFrag->ip_hdr_buf = (uint8_t*)malloc(buf_len);
+      App_Thread_Info[thread_index].num_pool_overflow++;
+   }
+
+   if (!pPktFrag || !pPktFrag->ip_hdr_buf) {
+
+      if (pPktFrag) { pPktFrag->ip_hdr_buf = NULL; if (isPoolFragment(pState, pPktFrag)) { pPktFrag->next = pState->free_frags; pState->free_frags = pPktFrag; } else free(pPktFrag); }
+      if (!pDgram->pFragmentList) remove_datagram(thread_index, pDgram);
+      return -1;
+   }
+
+   pPktFrag->pkt_buf = pPktFrag->ip_hdr_buf + pPktFrag->ip_hdr_len;
+   pPktFrag->next = NULL;
+
+/* save IP header info in fragment entry. Technically only the first fragment (with offset 0) needs to be copied but we can receive fragments out-of-order, so we give PktReassemble() all info it might need at time of reassembly */
+
+   memcpy(pPktFrag->ip_hdr_buf, pkt, pPktFrag->ip_hdr_len);
+
+/* save packet data in fragment entry */
+
+   memcpy(pPktFrag->pkt_buf, &pkt[ip_hdr_len], pPktFrag->len);
+
+/* add to end of datagram's fragment list */
+
+   PKT_FRAGMENT** ppList = &pDgram->pFragmentList;
+   while (*ppList) ppList = &(*ppList)->next;
+   *ppList = pPktFrag;
+
+   pDgram->num_fragments++;
+   pDgram->reassembled_len += pPktFrag->len;
+
+   #ifdef FRAGMENTATION_DEBUG
+   printf("\n *** inside pkt_frag_add, active fragments = %d, flags = 0x%x, identifier = %d, offset = %d, pkt len = %d \n", App_Thread_Info[thread_index].active_fragment_count, pPktFrag->flags, pPktFrag->identifier, pPktFrag->offset, pPktFrag->len);
+   #endif
 
    App_Thread_Info[thread_index].active_fragment_count++;  /* increment fragment counts */
    App_Thread_Info[thread_index].total_fragment_count++;
 
-   if (list_count > App_Thread_Info[thread_index].max_fragment_count) App_Thread_Info[thread_index].max_fragment_count = list_count;  /* update max_fragment_count */
+   if (App_Thread_Info[thread_index].active_fragment_count > App_Thread_Info[thread_index].max_fragment_count) App_Thread_Info[thread_index].max_fragment_count = App_Thread_Info[thread_index].active_fragment_count;  /* update max_fragment_count */
 
-   return DS_PKT_INFO_RETURN_FRAGMENT | DS_PKT_INFO_RETURN_FRAGMENT_SAVED;  /* return applicable DS_PKT_INFO_RETURN_xxx flags. To-do: add error checking, what can go wrong here */
+   return DS_PKT_INFO_RETURN_FRAGMENT | DS_PKT_INFO_RETURN_FRAGMENT_SAVED;  /* return applicable DS_PKT_INFO_RETURN_xxx flags */
 }
 
-/* walk app thread's fragment list and look for existing fragment, uniquely identified by Identification field and fragment offset */
+/* look for existing fragment, uniquely identified by 3-way tuple, Identification field, and fragment offset */
 
 int PktFindFragment(uint8_t* pkt, uint8_t* pFragHdrIPv6, unsigned int uFlags) {
 
-PKT_FRAGMENT* pList = App_Thread_Info[GetThreadIndex(false)].pPktFragmentList;
+int thread_index = GetThreadIndex();
+FRAGMENT_STATE* pState;
+FRAGMENT_DATAGRAM* pDgram;
 
 uint8_t protocol = 0;  /* don't need to be initialized, only to avoid compiler warnings */
 unsigned __int128 ip_src_addr = 0, ip_dst_addr = 0;  /* be sure to init IP addrs to zero as IPv4 uses only 4 out of 16 bytes */
 uint32_t identifier = 0;
 uint16_t fragment_offset = 0;
 
+   if (thread_index < 0 || !(pState = App_Thread_Info[thread_index].pFragmentState)) return 0;
+
    get_3way_tuple(pkt, pFragHdrIPv6, &protocol, &ip_src_addr, &ip_dst_addr);
 
    get_identifier_and_offset(pkt, pFragHdrIPv6, &identifier, &fragment_offset, uFlags);
 
-   while (pList) {
-
-      if (protocol == pList->protocol && ip_src_addr == pList->ip_src_addr && ip_dst_addr == pList->ip_dst_addr && identifier == pList->identifier && fragment_offset == pList->offset) return DS_PKT_INFO_RETURN_FRAGMENT;  /* fragment found if 3-way tuple, identifier, and offset all match */
+   if ((pDgram = find_datagram(pState, protocol, ip_src_addr, ip_dst_addr, identifier, NULL))) {
 
-      pList = pList->next;
+      for (PKT_FRAGMENT* pList = pDgram->pFragmentList; pList; pList = pList->next) if (fragment_offset == pList->offset) return DS_PKT_INFO_RETURN_FRAGMENT;  /* fragment found if 3-way tuple, identifier, and offset all match */
    }
 
    return 0;  /* not found */
 }
 
-/* remove a fragment from app thread's fragment list. If pkt is NULL, remove all fragments */
+/* remove a fragment from app thread's fragments. If pkt is NULL, remove all fragments */
 
 int DSPktRemoveFragment(uint8_t* pkt, uint8_t* pFragHdrIPv6, unsigned int uFlags, unsigned int* max_list_fragments) {
 
-int thread_index = GetThreadIndex(false), nRemoved = 0;
-PKT_FRAGMENT *pList = App_Thread_Info[thread_index].pPktFragmentList, *pListPrev = NULL, *pListNext = NULL;
+int thread_index = GetThreadIndex(), nRemoved = 0;
+FRAGMENT_STATE* pState;
+FRAGMENT_DATAGRAM* pDgram;
 
 uint8_t protocol = 0;  /* don't need to be initialized, only to avoid compiler warnings */
 unsigned __int128 ip_src_addr = 0, ip_dst_addr = 0;
 uint32_t identifier = 0;
 uint16_t fragment_offset = 0;
 
-   if (pkt) get_3way_tuple(pkt, pFragHdrIPv6, &protocol, &ip_src_addr, &ip_dst_addr);
+   if (thread_index < 0) return pkt ? 0 : -1;
 
-   if (pkt) get_identifier_and_offset(pkt, pFragHdrIPv6, &identifier, &fragment_offset, uFlags);
+   if ((pState = App_Thread_Info[thread_index].pFragmentState)) {
 
-/* remove fragment(s) with matching identifier and offset, free allocated mem */
+      if (!pkt) {  /* remove all remaining datagrams (cleanup) */
 
-   while (pList) {
+         while (pState->age_head) nRemoved += remove_datagram(thread_index, pState->age_head);
+      }
+      else {
 
-      pListNext = pList->next;  /* save next ptr in case pList is freed */
+         get_3way_tuple(pkt, pFragHdrIPv6, &protocol, &ip_src_addr, &ip_dst_addr);
 
-      if (!pkt || (protocol == pList->protocol && ip_src_addr == pList->ip_src_addr && ip_dst_addr == pList->ip_dst_addr && identifier == pList->identifier && fragment_offset == pList->offset)) {  /* 3-way tuple, identifier, and offset all have to match. Note pkt can be NULL, in which case we remove all remaining nodes (cleanup) */
+         get_identifier_and_offset(pkt, pFragHdrIPv6, &identifier, &fragment_offset, uFlags);
 
-         if (pListPrev) pListPrev->next = pList->next;  /* remove fragment from the list and update last non-matching fragment to point to next fragment */ 
-         else App_Thread_Info[thread_index].pPktFragmentList = pList->next;  /* if fragment was at start of the list then move the list head */
+         if ((pDgram = find_datagram(pState, protocol, ip_src_addr, ip_dst_addr, identifier, NULL))) {
 
-         free(pList->ip_hdr_buf);  /* free IP header buffer */
-         free(pList->pkt_buf);  /* free packet data buffer */
-         free(pList);  /* free fragment list entry */
+         /* remove fragment(s) with matching offset */
 
-         nRemoved++;
+            PKT_FRAGMENT** ppList = &pDgram->pFragmentList;
 
-         App_Thread_Info[thread_index].active_fragment_count--;  /* decrement fragment count */
-      }
-      else pListPrev = pList;  /* update last non-matching fragment */
+            while (*ppList) {
 
-      pList = pListNext;
+               PKT_FRAGMENT* pList = *ppList;
+
+               if (fragment_offset == pList->offset) {  /* 3-way tuple, identifier, and offset all have to match */
+
+                  *ppList = pList->next;
+
+                  pDgram->num_fragments--;
+                  pDgram->reassembled_len -= pList->len;
+
+                  free_fragment(pState, pList);
+
+                  nRemoved++;
+
+                  App_Thread_Info[thread_index].active_fragment_count--;  /* decrement fragment count */
+               }
+               else ppList = &pList->next;
+            }
+
+            if (!pDgram->pFragmentList) remove_datagram(thread_index, pDgram);
+         }
+      }
    }
 
    #ifdef FRAGMENTATION_DEBUG
@@ -375,67 +682,44 @@ uint16_t fragment_offset = 0;
 
 int PktGetReassemblyStatus(uint8_t* pkt, uint8_t* pFragHdrIPv6, unsigned int uFlags) {
 
-int thread_index = GetThreadIndex(false), ret_val = 0;
-PKT_FRAGMENT* pList = App_Thread_Info[thread_index].pPktFragmentList;
-uint16_t reassembled_len = 0;
-#if 0
-uint16_t matching_fragments = 0;
-#endif
+int thread_index = GetThreadIndex(), ret_val = 0;
+FRAGMENT_STATE* pState;
+FRAGMENT_DATAGRAM* pDgram;
 
 uint8_t protocol = 0;  /* don't need to be initialized, only to avoid compiler warnings */
 unsigned __int128 ip_src_addr = 0, ip_dst_addr = 0;
 uint32_t identifier = 0;
 
+   if (thread_index < 0 || !(pState = App_Thread_Info[thread_index].pFragmentState)) return 0;
+
    get_3way_tuple(pkt, pFragHdrIPv6, &protocol, &ip_src_addr, &ip_dst_addr);
 
    get_identifier_and_offset(pkt, pFragHdrIPv6, &identifier, NULL, uFlags);
 
-/* first sum lengths of currently available fragments */
-
-   while (pList) {
-
-      if (protocol == pList->protocol && ip_src_addr == pList->ip_src_addr && ip_dst_addr == pList->ip_dst_addr && identifier == pList->identifier) {  /* 3-way tuple and identifier have to match, but not offsets, which can be in any order */
-
-         reassembled_len += pList->len;
-         ret_val |= DS_PKT_INFO_RETURN_FRAGMENT;
-         #if 0
-         matching_fragments++;
-         #endif
-      }
-
-      pList = pList->next;
-   }
-
-/* second check if all fragments have arrived and math of total lengths vs final offset checks out */
+   if (!(pDgram = find_datagram(pState, protocol, ip_src_addr, ip_dst_addr, identifier, NULL)) || !pDgram->pFragmentList) return 0;
 
-   pList = App_Thread_Info[thread_index].pPktFragmentList;
+   ret_val |= DS_PKT_INFO_RETURN_FRAGMENT;
 
- int i = 0;
+/* if last fragment has arrived, and its offset matches sum of lengths received, then we have all fragments. The datagram keeps a running sum of fragment lengths */
 
-   while (pList) {  /* if last fragment has arrived, and its offset matches sum of lengths received, then we have all fragments */
+   for (PKT_FRAGMENT* pList = pDgram->pFragmentList; pList; pList = pList->next) {
 
-      if (protocol == pList->protocol && ip_src_addr == pList->ip_src_addr && ip_dst_addr == pList->ip_dst_addr && identifier == pList->identifier) {  /* 3-way tuple and identifier have to match */
-
-         if (!(pList->flags & DS_PKT_FRAGMENT_MF)) {
-
-            if (pList->offset*8 + pList->len == reassembled_len) { ret_val |= DS_PKT_INFO_RETURN_REASSEMBLED_PACKET_AVAILABLE; break; }  /* all fragments received */
-         }
-      }
-      i++;
-
-      pList = pList->next;
+      if (!(pList->flags & DS_PKT_FRAGMENT_MF) && pList->offset*8 + pList->len == pDgram->reassembled_len) { ret_val |= DS_PKT_INFO_RETURN_REASSEMBLED_PACKET_AVAILABLE; break; }  /* all fragments received */
    }
 
    return ret_val;
 }
 
-/* walk app thread's fragment list to find matching identifiers, copy IP header and reassembled packet data, remove fragments from list, return total packet length */
+/* find datagram matching identifiers, copy IP header and reassembled packet data, remove datagram and its fragments, return total packet length */
   
 int PktReassemble(uint8_t* pkt, uint8_t* pFragHdrIPv6, unsigned int uFlags) {
 
-int thread_index = GetThreadIndex(false), matching_fragments = 0;
-PKT_FRAGMENT *pList = App_Thread_Info[thread_index].pPktFragmentList, *pListPrev = NULL, *pListNext = NULL;
-uint16_t reassembled_len = 0, ip_hdr_len = 0;
+int thread_index = GetThreadIndex(), matching_fragments = 0;
+FRAGMENT_STATE* pState;
+FRAGMENT_DATAGRAM* pDgram;
+PKT_FRAGMENT* pList;
+int reassembled_len = 0;
+uint16_t ip_hdr_len = 0;
 
 uint8_t protocol = 0;  /* doesn't need to be initialized, only to avoid compiler warnings */
 unsigned __int128 ip_src_addr = 0, ip_dst_addr = 0;
@@ -443,31 +727,23 @@ uint32_t identifier = 0;
 
    if (!pkt) return -1;
 
+   if (thread_index < 0 || !(pState = App_Thread_Info[thread_index].pFragmentState)) return 1;
+
    get_3way_tuple(pkt, pFragHdrIPv6, &protocol, &ip_src_addr, &ip_dst_addr);
 
    get_identifier_and_offset(pkt, pFragHdrIPv6, &identifier, NULL, uFlags);
 
    uint8_t version = pkt[0] >> 4;
 
-/* reassemble full packet from matching fragment saved data, free allocated mem */
-
-   while (pList) {  /* first locate fragment 0 IP header len, in case fragments are received out of order and have different IP header lens */
-
-      if (protocol == pList->protocol && ip_src_addr == pList->ip_src_addr && ip_dst_addr == pList->ip_dst_addr && identifier == pList->identifier) {  /* 3-way tuple and identifier have to match */
+   if (!(pDgram = find_datagram(pState, protocol, ip_src_addr, ip_dst_addr, identifier, NULL))) return 1;
 
-         if (pList->offset == 0) { ip_hdr_len = pList->ip_hdr_len; break; }
-      }
-
-      pList = pList->next;
-   }
-
-   pList = App_Thread_Info[thread_index].pPktFragmentList;
+/* reassemble full packet from matching fragment saved data */
 
-   if (ip_hdr_len) while (pList) {  /* then run the loop again and reassemble packet data */
+   for (pList = pDgram->pFragmentList; pList; pList = pList->next) if (pList->offset == 0) { ip_hdr_len = pList->ip_hdr_len; break; }  /* first locate fragment 0 IP header len, in case fragments are received out of order and have different IP header lens */
 
-      pListNext = pList->next;  /* save next ptr in case pList is freed */
+   if (ip_hdr_len) {
 
-      if (protocol == pList->protocol && ip_src_addr == pList->ip_src_addr && ip_dst_addr == pList->ip_dst_addr && identifier == pList->identifier) {  /* 3-way tuple and identifier have to match */
+      for (pList = pDgram->pFragmentList; pList; pList = pList->next) {  /* then reassemble packet data */
 
          matching_fragments++;
 
@@ -475,17 +751,10 @@ uint32_t identifier = 0;
 
          if (pList->offset == 0) memcpy(pkt, pList->ip_hdr_buf, ip_hdr_len);  /* copy IP header from first fragment (note extended headers are not included; see PktAddFragment() */
          memcpy(&pkt[pList->ip_hdr_len + pList->offset*8], pList->pkt_buf, pList->len);  /* copy packet data into reassembly position given by fragment offset. Fragment 0 (first fragment) contains correct UDP payload header/length */
-
-         if (pListPrev) pListPrev->next = pList->next;  /* remove fragment from the list and update last non-matching fragment to point to next fragment */ 
-         else App_Thread_Info[thread_index].pPktFragmentList = pList->next;  /* if fragment was at start of the list then move the list head */
-
-         free(pList->ip_hdr_buf);  /* free IP header buffer */
-         free(pList->pkt_buf);  /* free packet data buffer */
-         free(pList);  /* free fragment list entry */
       }
-      else pListPrev = pList;  /* update last non-matching fragment */
 
-      pList = pListNext;
+      remove_datagram(thread_index, pDgram);  /* free fragments and datagram, reduces active count by number of reassembly fragments */
+      App_Thread_Info[thread_index].num_reassembled++;
    }
 
    int pkt_len = reassembled_len;
@@ -514,16 +783,112 @@ uint32_t identifier = 0;
       pkt[len_ofs] = (uFlags & DS_PKTLIB_HOST_BYTE_ORDER) ? pkt_len & 0xff : pkt_len >> 8;  /* update packet length (payload length for IPv6) */
       pkt[len_ofs+1] = (uFlags & DS_PKTLIB_HOST_BYTE_ORDER) ? pkt_len >> 8 : pkt_len & 0xff;
 
-      App_Thread_Info[thread_index].active_fragment_count -= matching_fragments;  /* reduce active count by number of reassembly fragments */
-
       #ifdef FRAGMENTATION_DEBUG
-      printf("\n *** reassembled packet returned, identifier = %d, total fragments = %d, active fragments = %d, pkt len = %d, pFragmentList = %p \n", identifier, App_Thread_Info[thread_index].total_fragment_count, App_Thread_Info[thread_index].active_fragment_count, pkt_len, App_Thread_Info[thread_index].pPktFragmentList);
+      printf("\n *** reassembled packet returned, identifier = %d, fragments = %d, total fragments = %d, active fragments = %d, pkt len = %d \n", identifier, matching_fragments, App_Thread_Info[thread_index].total_fragment_count, App_Thread_Info[thread_index].active_fragment_count, pkt_len);
       #endif
    }
 
    return 1;  /* return Ok */
 }
 
+/* DSConfigPktFragmentation() sets reassembly timeout and per-thread pool size. Values < 0 are ignored (not changed). Pool size applies to threads that haven't yet saved a fragment, JHB Oct 2026 */
+
+int DSConfigPktFragmentation(unsigned int uFlags, int timeout_msec, int pool_size) {
+
+   (void)uFlags;  /* reserved */
+
+   if (timeout_msec >= 0) reassembly_timeout_msec = timeout_msec;
+   if (pool_size >= 0) fragment_pool_size = pool_size;
+
+   return 1;
+}
+
+/* DSGetPktFragmentStats() returns fragment stats for the calling thread, or summed over all threads if uFlags includes DS_PKT_FRAGMENT_STATS_ALL_THREADS, JHB Oct 2026 */
+
+int DSGetPktFragmentStats(unsigned int uFlags, PKT_FRAGMENT_STATS* pStats) {
+
+int i, start, end;
+
+   if (!pStats) return -1;
+
+   memset(pStats, 0, sizeof(PKT_FRAGMENT_STATS));
+
+   bool fAllThreads = (uFlags & DS_PKT_FRAGMENT_STATS_ALL_THREADS) != 0;
+
+   if (fAllThreads) {
+
+   /* other threads may be running DSPktFragmentThreadCleanup(), which frees pFragmentState. Hold the App_Thread_Info[] lock while reading; cleanup detaches pFragmentState under the same lock before freeing it */
+
+      while (__sync_lock_test_and_set(&app_thread_lock, 1) != 0);
+
+      start = 0; end = max_search_limit;
+   }
+   else {
+      if ((start = GetThreadIndex()) < 0) return -1;
+      end = start + 1;
+   }
+
+   for (i=start; i<end; i++) {  /* for other threads values are a snapshot; they may be changing */
+
+      pStats->active_fragments += App_Thread_Info[i].active_fragment_count;
+      FRAGMENT_STATE* pState = App_Thread_Info[i].pFragmentState;
+      if (pState) pStats->active_datagrams += pState->active_datagrams;
+      pStats->max_fragments = max(pStats->max_fragments, (uint32_t)App_Thread_Info[i].max_fragment_count);
+      pStats->total_fragments += App_Thread_Info[i].total_fragment_count;
+      pStats->reassembled += App_Thread_Info[i].num_reassembled;
+      pStats->timed_out += App_Thread_Info[i].num_timed_out;
+      pStats->evicted += App_Thread_Info[i].num_evicted;
+      pStats->pool_overflow += App_Thread_Info[i].num_pool_overflow;
+   }
+
+   if (fAllThreads) __sync_lock_release(&app_thread_lock);
+
+   return 1;
+}
+
+/* DSPktFragmentThreadRegister() registers the calling thread for fragment handling and returns its slot index, or -1 if MAX_APP_THREADS are already registered. Calling it is optional, as PktXxxFragment() functions register on first use, but it moves the one-time locked registration out of packet processing, JHB Oct 2026 */
+
+int DSPktFragmentThreadRegister(unsigned int uFlags) {
+
+   (void)uFlags;  /* reserved */
+
+   return GetThreadIndex();
+}
+
+/* DSPktFragmentThreadCleanup() removes the calling thread's remaining fragments, frees its hash table and pool, and releases its slot. Returns number of orphan fragments removed, or -1 if the thread was not registered. Must be called by the thread being cleaned up, JHB Oct 2026 */
+
+int DSPktFragmentThreadCleanup(unsigned int uFlags) {
+
+int thread_index = thread_slot, nRemoved = 0;
+FRAGMENT_STATE* pState;
+
+   (void)uFlags;  /* reserved */
+
+   if (thread_index < 0) return -1;
+
+   if ((pState = App_Thread_Info[thread_index].pFragmentState)) while (pState->age_head) nRemoved += remove_datagram(thread_index, pState->age_head);
+
+/* detach fragment state and release the slot under the App_Thread_Info[] lock. DSGetPktFragmentStats() holds the same lock when reading other threads' state, so once we release it no reader can still be using pState */
+
+   while (__sync_lock_test_and_set(&app_thread_lock, 1) != 0);
+
+   memset(&App_Thread_Info[thread_index], 0, sizeof(APP_THREAD_INFO));  /* clears pFragmentState and ThreadId, making the slot available */
+
+   __sync_lock_release(&app_thread_lock);
+
+   if (pState) {
+
+      if (pState->frag_nodes) free(pState->frag_nodes);
+      if (pState->frag_bufs) free(pState->frag_bufs);
+      if (pState->dgram_nodes) free(pState->dgram_nodes);
+      free(pState);
+   }
+
+   thread_slot = -1;
+
+   return nRemoved;
+}
+
 
 /* DSIsReservedUDP() returns true if UDP port is reserved (https://en.wikipedia.org/wiki/List_of_TCP_and_UDP_port_numbers). Note this function is public (mediaMin.cpp calls it, in addition to DSIsPacketDuplicate() below) */
 
@@ -77,6 +77,10 @@ Revision History
   Modified Aug 2025 JHB, add uPktNumber param to DSGetPacketInfo() calls per mod in pktlib.h
   Modified Sep 2025 JHB, add LINKTYPE_IEEE802_11 and LINKTYPE_LINUX_SLL2
   Modified Sep 2025 JHB, support pcap and pcapng big-endian format files, look for IO_TYPE_PCAP_BE, IO_TYPE_PCAPNG_BE, and convert_to_le(). Test with dhcp_big_endian.pcapng, big_endian_udp4.pcap
+  Modified Oct 2026 JHB, add memory-mapped input option. DSOpenPcap() with DS_OPEN_PCAP_MMAP maps pcap and pcapng files, DSReadPcapView() returns a pointer into the mapping instead of copying, DSReadPcap() on a mapped handle copies from the mapping (no stdio calls). See comments near PCAP_MMAP
+  Modified Oct 2026 JHB, memory-mapped input table entries record FILE*, device, and inode; stale entries left by closing a mapped handle with fclose() instead of DSClosePcap() are detected and released on fd reuse
+  Modified Oct 2026 JHB, DSFindPcapPacket() uses a packet index (hash on SSRC and RTP timestamp) instead of re-reading the pcap on each call. The index is created on first call and saved in a sidecar file, which is re-created if the pcap changes. See comments near PCAP_INDEX. Fix DSFilterPacket() with NULL fp not returning -1 for filtered packets
+  Modified Oct 2026 JHB, getPcapMmap() no longer calls fstat() on each DSReadPcap() and DSReadPcapView() call. Stale memory-mapped input entries are dropped by DSOpenPcap() when a file is opened, and on FILE* mismatch. Remove device and inode from table entries
 */
 
 /* Linux or other OS includes */
@@ -84,6 +88,10 @@ Revision History
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <algorithm>
 using namespace std;
@@ -142,6 +150,110 @@ static int convert_to_le(void* pVal, int size) {
    return -1;
 }
 
+/* memory-mapped pcap input, notes JHB Oct 2026:
+
+  -DSOpenPcap() with DS_OPEN_PCAP_MMAP maps the whole file read/write MAP_PRIVATE. Writes (e.g. TSO length fix) go to copy-on-write pages and never reach the file
+  -mappings are kept in a table indexed by file descriptor, which is unique while the file is open. This keeps lookup O(1) and lock-free; no two threads can hold the same fd at the same time
+  -an fd can be reused if an app closes a mapped handle with fclose() instead of DSClosePcap(). DSOpenPcap() drops any entry left over for a newly opened file's fd, so the fd/mapping association is validated once at open time. Each entry also records its FILE*, and getPcapMmap() drops an entry that doesn't match (the stale mapping is released at that point). Per read lookup is a table check only, with no system calls
+  -read position is kept in the table entry, the FILE* file position is not updated after DSOpenPcap() returns. Use DSReadPcap() or DSReadPcapView() to read records; don't mix with direct stdio calls on a mapped handle
+  -.rtpXXX files are not mapped (each record is converted to an IPv4 packet, so there is nothing to gain)
+*/
+
+#define MAX_PCAP_MMAP_FDS  4096  /* fds beyond this are not mapped; DSOpenPcap() falls back to stdio */
+
+typedef struct {
+
+  uint8_t*  base;        /* start of mapping */
+  uint64_t  size;        /* file size */
+  uint64_t  pos;         /* current read position */
+  FILE*     fp;          /* handle the mapping belongs to, used to detect stale entries after fd reuse */
+
+} PCAP_MMAP;
+
+static PCAP_MMAP* pcap_mmap[MAX_PCAP_MMAP_FDS] = { NULL };
+
+static void pcap_mmap_release(int fd) {
+
+   PCAP_MMAP* mm = pcap_mmap[fd];
+
+   pcap_mmap[fd] = NULL;
+   munmap(mm->base, mm->size);
+   free(mm);
+}
+
+static void pcap_mmap_drop_stale(FILE* fp_pcap) {
+
+   int fd = fileno(fp_pcap);
+
+   if (fd >= 0 && fd < MAX_PCAP_MMAP_FDS && pcap_mmap[fd]) pcap_mmap_release(fd);
+}
+
+static inline PCAP_MMAP* getPcapMmap(FILE* fp_pcap) {
+
+   if (!fp_pcap) return NULL;
+
+   int fd = fileno(fp_pcap);
+
+   if (fd < 0 || fd >= MAX_PCAP_MMAP_FDS || !pcap_mmap[fd]) return NULL;
+
+   PCAP_MMAP* mm = pcap_mmap[fd];
+
+   if (mm->fp == fp_pcap) return mm;
+
+   pcap_mmap_release(fd);  /* stale entry: previous mapped handle was closed without DSClosePcap() and its fd has been reused */
+
+   return NULL;
+}
+
+static int pcap_mmap_open(FILE* fp_pcap) {
+
+struct stat st;
+
+   int fd = fileno(fp_pcap);
+
+   if (fd < 0 || fd >= MAX_PCAP_MMAP_FDS || fstat(fd, &st) || st.st_size <= 0) return -1;
+
+   void* base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+   if (base == MAP_FAILED) return -1;
+
+   madvise(base, st.st_size, MADV_SEQUENTIAL);  /* we read front to back; let the kernel read ahead aggressively */
+
+   PCAP_MMAP* mm = (PCAP_MMAP*)calloc(1, sizeof(PCAP_MMAP));
+   if (!mm) { munmap(base, st.st_size); return -1; }
+
+   mm->base = (uint8_t*)base;
+   mm->size = st.st_size;
+   mm->pos = ftell(fp_pcap);  /* file header(s) already read by DSOpenPcap() */
+   mm->fp = fp_pcap;
+
+   pcap_mmap[fd] = mm;
+
+   return 1;
+}
+
+static void pcap_mmap_close(FILE* fp_pcap) {
+
+   if (getPcapMmap(fp_pcap)) pcap_mmap_release(fileno(fp_pcap));
+}
+
+static inline uint64_t pcap_tell(FILE* fp_pcap) {  /* ftell() that also works for mapped handles */
+
+   PCAP_MMAP* mm = getPcapMmap(fp_pcap);
+
+   return mm ? mm->pos : (uint64_t)ftell(fp_pcap);
+}
+
+static inline uint32_t get_uint32(const uint8_t* p, bool fBigEndian) {  /* unaligned reads from mapped file data */
+
+   uint32_t val;
+   memcpy(&val, p, sizeof(val));
+   if (fBigEndian) convert_to_le(&val, sizeof(val));
+
+   return val;
+}
+
+static inline uint16_t get_uint16_be(const uint8_t* p) { return (p[0] << 8) | p[1]; }  /* Ethernet header types are always big-endian */
+
 //#define DEBUG_PCAPNG  /* enable for pcapng format debug, JHB Oct 2020 */
 
 int DSOpenPcap(const char* pcap_file, unsigned int uFlags, FILE** fp_pcap, pcap_hdr_t* pcap_file_hdr, const char* pErrstr) {
@@ -156,7 +268,9 @@ pcapng_idb_t file_idb_pcapng;
 char errstr[MAX_INPUT_LEN] = "";
 char tmpstr[2*MAX_INPUT_LEN];
 
-   if (!pcap_file || !strlen(pcap_file) || !fp_pcap) {  /* look for NULL path/filename, empty string, or NULL file pointer, JHB Jul 2024 */
+   bool fReset = (uFlags & DS_OPEN_PCAP_RESET) && !(uFlags & DS_WRITE);  /* reset operates on an already open handle, so path/filename is not needed, JHB Oct 2026 */
+
+   if ((!fReset && (!pcap_file || !strlen(pcap_file))) || !fp_pcap) {  /* look for NULL path/filename, empty string, or NULL file pointer, JHB Jul 2024 */
 
       Log_RT(2, "ERROR: DSOpenPcap() says %s %s is %s \n", uFlags & DS_READ ? "input" : "output", !pcap_file || !strlen(pcap_file) ? "path and/or filename" : "file pointer", pcap_file && !strlen(pcap_file) ? "empty string" : "NULL");
       return ret_val;
@@ -167,7 +281,8 @@ char tmpstr[2*MAX_INPUT_LEN];
    if (errstrlen > 0) errstr[errstrlen-1] = 0;
 
    char extstr[20] = "";
-   if (strcasestr(pcap_file, ".pcapng")) strcpy(extstr, " pcapng");
+   if (!pcap_file) {}
+   else if (strcasestr(pcap_file, ".pcapng")) strcpy(extstr, " pcapng");
    else if (strcasestr(pcap_file, ".pcap")) strcpy(extstr, " pcap");
    else if (strcasestr(pcap_file, ".rtp")) strcpy(extstr, " rtp");
 
@@ -523,6 +638,24 @@ wr_ret:
       }  /* end of pcap and pcapng handling */
 
 rd_ret:
+
+   /* memory-map input if specified. On reset we only need to re-sync the read position of an existing mapping, JHB Oct 2026 */
+
+      if (ret_val > 0 && *fp_pcap && getIOType(ret_val) != IO_TYPE_RTP && !(uFlags & DS_OPEN_PCAP_DONT_READ_HEADER)) {
+
+         PCAP_MMAP* mm = NULL;
+
+         if (fReset) mm = getPcapMmap(*fp_pcap);
+         else pcap_mmap_drop_stale(*fp_pcap);  /* file was just opened, so any entry for its fd is left over from a handle closed without DSClosePcap() */
+
+         if (mm) { mm->pos = ftell(*fp_pcap); ret_val |= LINK_LAYER_MMAP; }
+         else if ((uFlags & DS_OPEN_PCAP_MMAP) && !fReset) {
+
+            if (pcap_mmap_open(*fp_pcap) > 0) ret_val |= LINK_LAYER_MMAP;
+            else Log_RT(3, "WARNING: DSOpenPcap() unable to memory-map input%s file %s, errno = %d, using standard file I/O \n", extstr, pcap_file, errno);
+         }
+      }
+
       return ret_val;
    }
 }
@@ -543,6 +676,281 @@ typedef struct {
 
 #endif
 
+/* read_pcap_mmap() is the mapped input equivalent of DSReadPcap(). It parses one record at the current mapping position and returns a pointer to packet data inside the mapping. Behavior follows DSReadPcap() (block types, link layer handling, TSO length fix, info/warning messages) with these differences, JHB Oct 2026:
+
+  -a truncated final record is treated as end of file (DSReadPcap() sees the same thing as an feof() after a short fread())
+  -pcapng blocks are always advanced by block length, so padding and trailing options are skipped without separate reads
+  -additional SHBs are skipped as non-packet blocks
+*/
+
+static int read_pcap_mmap(FILE* fp_pcap, PCAP_MMAP* mm, unsigned int uFlags, uint8_t** p_pkt_data, pcaprec_hdr_t* p_pkt_hdr, int link_layer_info, uint16_t* p_eth_protocol, uint16_t* p_block_type, unsigned int uPktNumber, const char* szUserMsgString, const char* szFunc) {
+
+uint64_t pos = mm->pos, next_pos;
+uint8_t* rec;  /* start of record */
+uint8_t* data;  /* start of record data (link layer followed by packet) */
+uint64_t data_avail;
+int packet_length;
+uint16_t eth_protocol = 0, block_type;
+bool fUnusedBlockType = false;
+char errstr[1024] = "";
+char szPktNumber[30] = "";
+
+   if (uPktNumber) sprintf(szPktNumber, ", pkt# %u", uPktNumber);
+
+   uint16_t input_type = getIOType(link_layer_info);
+   uint16_t link_type = getLinkType(link_layer_info);
+   int link_len = getLinkLayerLen(link_layer_info);
+
+   if (pos >= mm->size) return 0;  /* end of file */
+
+   rec = mm->base + pos;
+
+   if (input_type == IO_TYPE_LIBPCAP || input_type == IO_TYPE_LIBPCAP_BE) {
+
+      bool fBE = input_type == IO_TYPE_LIBPCAP_BE;
+
+      if (mm->size - pos < sizeof(pcaprec_hdr_t)) goto mmap_eof;
+
+      p_pkt_hdr->ts_sec = get_uint32(rec, fBE);
+      p_pkt_hdr->ts_usec = get_uint32(rec + 4, fBE);
+      p_pkt_hdr->incl_len = get_uint32(rec + 8, fBE);
+      p_pkt_hdr->orig_len = get_uint32(rec + 12, fBE);
+
+      block_type = PCAP_PB_TYPE;
+
+      data = rec + sizeof(pcaprec_hdr_t);
+      data_avail = mm->size - pos - sizeof(pcaprec_hdr_t);
+
+      if (p_pkt_hdr->incl_len > data_avail) goto mmap_eof;
+
+      next_pos = pos + sizeof(pcaprec_hdr_t) + p_pkt_hdr->incl_len;
+   }
+   else if (input_type == IO_TYPE_PCAPNG || input_type == IO_TYPE_PCAPNG_BE) {
+
+      bool fBE = input_type == IO_TYPE_PCAPNG_BE;
+      uint32_t block_length;
+
+      if (mm->size - pos < sizeof(pcapng_block_header_t)) goto mmap_eof;
+
+      uint32_t block_type_ng = get_uint32(rec, false);  /* SHB magic number is the same in either byte order */
+      if (block_type_ng != 0x0a0d0d0a) block_type_ng = get_uint32(rec, fBE);
+      block_length = get_uint32(rec + 4, fBE);
+
+      if (block_length < sizeof(pcapng_block_header_t) + 4 || block_length > mm->size - pos) {
+
+         if (block_length > mm->size - pos) goto mmap_eof;
+
+         sprintf(errstr, "invalid pcapng block length %u for block type %u", block_length, block_type_ng);
+         goto mmap_read_error;
+      }
+
+      block_type = block_type_ng;
+      next_pos = pos + block_length;
+
+      if (block_type_ng == PCAPNG_EPB_TYPE) {
+
+         if (block_length < sizeof(pcapng_epb_t) + 4) { sprintf(errstr, "unable to read enhanced block data"); goto mmap_read_error; }
+
+         uint64_t usec = ((uint64_t)get_uint32(rec + offsetof(pcapng_epb_t, timestamp_hi), fBE) << 32) | get_uint32(rec + offsetof(pcapng_epb_t, timestamp_lo), fBE);
+
+         p_pkt_hdr->incl_len = get_uint32(rec + offsetof(pcapng_epb_t, captured_pkt_len), fBE);
+         p_pkt_hdr->orig_len = get_uint32(rec + offsetof(pcapng_epb_t, original_pkt_len), fBE);
+         p_pkt_hdr->ts_sec = usec / 1000000L;
+         p_pkt_hdr->ts_usec = usec - 1000000L * p_pkt_hdr->ts_sec;
+
+         data = rec + sizeof(pcapng_epb_t);
+         data_avail = block_length - sizeof(pcapng_epb_t) - 4;
+      }
+      else if (block_type_ng == PCAPNG_SPB_TYPE) {
+
+         if (block_length < sizeof(pcapng_spb_t) + 4) { sprintf(errstr, "unable to read simple block packet length"); goto mmap_read_error; }
+
+         p_pkt_hdr->orig_len = p_pkt_hdr->incl_len = get_uint32(rec + offsetof(pcapng_spb_t, original_pkt_len), fBE);
+         p_pkt_hdr->ts_sec = 0;  /* simple blocks don't have timestamps, see comments in DSReadPcap() */
+         p_pkt_hdr->ts_usec = 0;
+
+         data = rec + sizeof(pcapng_spb_t);
+         data_avail = block_length - sizeof(pcapng_spb_t) - 4;
+
+         if (p_pkt_hdr->incl_len > data_avail) p_pkt_hdr->incl_len = data_avail;  /* SPB packet data may be truncated to snaplen */
+      }
+      else if (block_type_ng == PCAPNG_IDB_TYPE) {
+
+         if (block_length < sizeof(pcapng_idb_t) + 4) { sprintf(errstr, "unable to read interface description block data"); goto mmap_read_error; }
+
+         p_pkt_hdr->incl_len = block_length - sizeof(pcapng_idb_t) - 4;
+
+         data = rec + sizeof(pcapng_idb_t);
+         data_avail = p_pkt_hdr->incl_len;
+
+         if (!(uFlags & DS_READ_PCAP_SUPPRESS_INFO_MSG)) {
+
+            char szLastPktNumber[50] = "";
+            if (uPktNumber > 1) sprintf(szLastPktNumber, ", last transmitted data pkt# %u", uPktNumber-1);
+
+            char* p = NULL, *szFilepath = getFilePathFromFilePointer(fp_pcap);  /* in diaglib.h */
+            if (szFilepath) { p = strrchr(szFilepath, '/'); if (!p) p = szFilepath; else p++; }
+
+            Log_RT(4, "INFO: %s says reading interface description block (type = %d)%s%s, ignoring data, block len = %d, link len = %d, uFlags = 0x%x%s%s%s \n", szFunc, block_type_ng, p ? " in " : "", p ? p : "error in getFilePathFromFilePointer()", (int)p_pkt_hdr->incl_len - link_len, link_len, uFlags, szUserMsgString ? ", " : "", szUserMsgString ? szUserMsgString : "", szLastPktNumber);
+            if (szFilepath) free(szFilepath);
+         }
+      }
+      else {  /* SHB, ISB, NRB, and other non-packet blocks. See "unused/unknown block type notes" in DSReadPcap() */
+
+         char blkstr[50] = "";
+         bool fWarn = false;
+
+         p_pkt_hdr->incl_len = block_length - sizeof(pcapng_block_header_t) - 4;
+
+         data = rec + sizeof(pcapng_block_header_t);
+         data_avail = p_pkt_hdr->incl_len;
+
+         fUnusedBlockType = true;
+
+         switch (block_type_ng) {
+
+            case 0x0a0d0d0a:
+               strcpy(blkstr, "2 or more SHBs");
+               break;
+
+            case 4:
+               strcpy(blkstr, "name resolution");
+               break;
+
+            case 5:  /* interface statistics block (ISB) */
+               if (data_avail < sizeof(uint32_t)) { sprintf(errstr, "unable to read statistics block interface Id"); goto mmap_read_error; }
+               sprintf(blkstr, "interface #%u statistics", get_uint32(data, fBE));
+               break;
+
+            case 9:
+               strcpy(blkstr, "journal");
+               break;
+
+            case 10:
+               strcpy(blkstr, "decryption");
+               break;
+
+            default:
+               strcpy(blkstr, "unknown / custom");
+               fWarn = true;
+               break;
+         }
+
+         if (!(uFlags & (fWarn ? DS_READ_PCAP_SUPPRESS_WARNING_ERROR_MSG : DS_READ_PCAP_SUPPRESS_INFO_MSG))) {
+
+            char szLastPktNumber[50] = "";
+            if (uPktNumber > 1) sprintf(szLastPktNumber, ", last transmitted data pkt# %u", uPktNumber-1);
+
+            char* p = NULL, *szFilepath = getFilePathFromFilePointer(fp_pcap);  /* in diaglib.h */
+            if (szFilepath) { p = strrchr(szFilepath, '/'); if (!p) p = szFilepath; else p++; }
+
+            Log_RT(fWarn ? 3 : 4, "%s: %s says reading %s block (type = %d)%s%s, ignoring data, block len = %d, link len = %d, uFlags = 0x%x%s%s%s \n", fWarn ? "WARNING" : "INFO", szFunc, blkstr, block_type_ng, p ? " in " : "", p ? p : " error in getFilePathFromFilePointer()", (int)p_pkt_hdr->incl_len, link_len, uFlags, szUserMsgString ? ", " : "", szUserMsgString ? szUserMsgString : "", szLastPktNumber);
+            if (szFilepath) free(szFilepath);
+         }
+
+         link_len = 0;  /* non-packet blocks have no link layer, see DSReadPcap() */
+      }
+
+      if (p_pkt_hdr->incl_len > data_avail) { sprintf(errstr, "packet length %u exceeds block data length %llu", p_pkt_hdr->incl_len, (unsigned long long)data_avail); goto mmap_read_error; }
+   }
+   else {
+      sprintf(errstr, "input type %d not supported for mapped input", input_type);
+      goto mmap_read_error;
+   }
+
+/* link layer handling, same as DSReadPcap() */
+
+   if (link_len == sizeof(ethhdr)) {
+
+      if (p_pkt_hdr->incl_len < sizeof(ethhdr)) { sprintf(errstr, "unable to read link layer %d bytes", (int)sizeof(ethhdr)); goto mmap_read_error; }
+
+      uint32_t null_loopback_af_inet = get_uint32(data, false);  /* first 4 bytes of link layer could be Null/Loopback protocol ID */
+
+      if (!(uFlags & DS_READ_PCAP_DISABLE_NULL_LOOPBACK_PROTOCOL) && null_loopback_af_inet == 2) {
+
+         link_len = 4;
+         eth_protocol = ETH_P_IP;
+      }
+      else if (!(uFlags & DS_READ_PCAP_DISABLE_NULL_LOOPBACK_PROTOCOL) && (null_loopback_af_inet == 24 || null_loopback_af_inet == 28 || null_loopback_af_inet == 30)) {
+
+         link_len = 4;
+         eth_protocol = ETH_P_IPV6;
+      }
+      else {
+
+         eth_protocol = get_uint16_be(data + offsetof(struct ethhdr, h_proto));
+
+         if (eth_protocol == ETH_P_8021Q) {  /* VLAN header */
+
+            if (p_pkt_hdr->incl_len < sizeof(ethhdr) + sizeof(vlan_hdr_t)) goto mmap_eof;  /* DSReadPcap() returns 0 if it can't read the vlan header */
+            link_len += sizeof(vlan_hdr_t);
+         }
+      }
+   }
+   else if (link_len == LINKTYPE_LINUX_SLL_LEN) {
+
+      if (p_pkt_hdr->incl_len < LINKTYPE_LINUX_SLL_LEN) { sprintf(errstr, "unable to read Linux SLL link layer ethernet header type %d bytes", (int)sizeof(eth_protocol)); goto mmap_read_error; }
+      eth_protocol = get_uint16_be(data + sizeof(ethhdr));
+   }
+   else if (link_len == LINKTYPE_LINUX_SLL2_LEN) {
+
+      if (p_pkt_hdr->incl_len < LINKTYPE_LINUX_SLL2_LEN) { sprintf(errstr, "unable to read Linux SLL2 link layer ethernet header type %d bytes", (int)sizeof(eth_protocol)); goto mmap_read_error; }
+      eth_protocol = get_uint16_be(data);
+   }
+   else if (get_link_layer_len(link_type) < 0) {
+
+      Log_RT(3, "WARNING: %s says unexpected link type = %d, input_type = %d, link_len = %d%s%s%s \n", szFunc, link_type, input_type, link_len, szUserMsgString ? ", " : "", szUserMsgString ? szUserMsgString : "", szPktNumber);
+   }
+
+   if (p_eth_protocol) *p_eth_protocol = eth_protocol;
+   if (p_block_type) *p_block_type = block_type;
+
+   if ((packet_length = (int)p_pkt_hdr->incl_len - link_len) <= 0) { sprintf(errstr, "incl_len %d - link_len %d <= 0 when reading", p_pkt_hdr->incl_len, link_len); goto mmap_read_error; }
+
+   *p_pkt_data = data + link_len;
+
+/* TSO "zero length" fix, see comments in DSReadPcap(). The mapping is MAP_PRIVATE so the fix is applied to a private copy of the page */
+
+   if (!fUnusedBlockType && !(uFlags & DS_READ_PCAP_DISABLE_TSO_LENGTH_FIX) && (block_type == PCAP_PB_TYPE || block_type == PCAPNG_EPB_TYPE || block_type == PCAPNG_SPB_TYPE) && packet_length >= 10) {
+
+      uint8_t* pkt_ptr = *p_pkt_data;
+
+      if ((pkt_ptr[0] >> 4) == IPV4 && pkt_ptr[9] == TCP && !((pkt_ptr[2] << 8) | pkt_ptr[3])) {
+
+         pkt_ptr[2] = p_pkt_hdr->incl_len >> 8;
+         pkt_ptr[3] = p_pkt_hdr->incl_len & 0xff;
+
+         if ((uFlags & DS_READ_PCAP_REPORT_TSO_LENGTH_FIX) && !(uFlags & DS_READ_PCAP_SUPPRESS_INFO_MSG)) {
+
+            char* p = NULL, *szFilepath = getFilePathFromFilePointer(fp_pcap);  /* in diaglib.h */
+            if (szFilepath) { p = strrchr(szFilepath, '/'); if (!p) p = szFilepath; else p++; }
+
+            Log_RT(4, "INFO: %s says TSO zero length fixed to %d for file %s, uFlags = 0x%x%s%s%s \n", szFunc, (pkt_ptr[2] << 8) | pkt_ptr[3], p ? p : "error in getFilePathFromFilePointer()", uFlags, szUserMsgString ? ", " : "", szUserMsgString ? szUserMsgString : "", szPktNumber);
+            if (szFilepath) free(szFilepath);
+         }
+      }
+   }
+
+   if (!(uFlags & DS_READ_PCAP_COPY)) mm->pos = next_pos;
+
+   return packet_length;
+
+mmap_eof:
+
+   if (!(uFlags & DS_READ_PCAP_COPY)) mm->pos = mm->size;
+   return 0;
+
+mmap_read_error:
+
+   char* p = NULL, *szFilepath = getFilePathFromFilePointer(fp_pcap);
+   if (szFilepath) { p = strrchr(szFilepath, '/'); if (!p) p = szFilepath; else p++; }
+
+   Log_RT(2, "ERROR: %s says %s from mapped file %s, uFlags = 0x%x%s%s%s \n", szFunc, errstr, p ? p : "error in getFilePathFromPointer()", uFlags, szUserMsgString ? ", " : "", szUserMsgString ? szUserMsgString : "", szPktNumber);
+   if (szFilepath) free(szFilepath);
+
+   return -1;
+}
+
 /* DSReadPcap() reads one or more pcap records at the current file position of fp_pcap into pkt_buf, and fills in one or more pcaprec_hdr_t structs (defined in pktlib.h). Notes:
 
    -fp_pcap should point to a pcap, pcapng, or rtpXXX file previously opened by DSOpenPcap()
@@ -602,6 +1010,19 @@ a few useful constants from if_ether.h (one copy here https://github.com/spotify
 
    if (!p_block_type) p_block_type = &block_type_local;
 
+   PCAP_MMAP* mm;
+
+   if ((mm = getPcapMmap(fp_pcap))) {  /* mapped input, copy from the mapping. Non-packet block data is not copied, same as below, JHB Oct 2026 */
+
+      uint8_t* pkt_data;
+
+      packet_length = read_pcap_mmap(fp_pcap, mm, uFlags, &pkt_data, p_pkt_hdr, link_layer_info, p_eth_protocol, p_block_type, uPktNumber, szUserMsgString, "DSReadPcap()");
+
+      if (packet_length > 0 && (*p_block_type == PCAP_PB_TYPE || *p_block_type == PCAPNG_EPB_TYPE || *p_block_type == PCAPNG_SPB_TYPE || *p_block_type == PCAPNG_IDB_TYPE)) memcpy(pkt_ptr, pkt_data, packet_length);
+
+      return packet_length;
+   }
+
    if (uPktNumber) sprintf(szPktNumber, ", pkt# %u", uPktNumber);
 
 /* read pcap or rtp record header, link layer header, packet data */
@@ -1116,6 +1537,27 @@ pcap_read_error:
    return -1;  /* return error condition */
 }
 
+/* DSReadPcapView() is a zero-copy version of DSReadPcap() for handles opened with DS_OPEN_PCAP_MMAP. See comments in pktlib.h, JHB Oct 2026 */
+
+int DSReadPcapView(FILE* fp_pcap, unsigned int uFlags, uint8_t** p_pkt_data, pcaprec_hdr_t* pcap_pkt_hdr, int link_layer_info, uint16_t* p_eth_protocol, uint16_t* p_block_type, unsigned int uPktNumber, const char* szUserMsgString) {
+
+pcaprec_hdr_t pcap_pkt_hdr_local;
+uint16_t block_type_local = 0;
+PCAP_MMAP* mm;
+
+   if (!fp_pcap || !p_pkt_data) return -1;
+
+   *p_pkt_data = NULL;
+
+   if (!(mm = getPcapMmap(fp_pcap))) {
+
+      Log_RT(2, "ERROR: DSReadPcapView() says file handle %p is not memory-mapped; open with DS_OPEN_PCAP_MMAP flag or use DSReadPcap()%s%s \n", fp_pcap, szUserMsgString ? ", " : "", szUserMsgString ? szUserMsgString : "");
+      return -1;
+   }
+
+   return read_pcap_mmap(fp_pcap, mm, uFlags, p_pkt_data, pcap_pkt_hdr ? pcap_pkt_hdr : &pcap_pkt_hdr_local, link_layer_info, p_eth_protocol, p_block_type ? p_block_type : &block_type_local, uPktNumber, szUserMsgString, "DSReadPcapView()");
+}
+
 /* write a pcap record */
 
 int DSWritePcap(FILE* fp_pcap, unsigned int uFlags, uint8_t* pkt_buffer, int packet_length, pcaprec_hdr_t* pcap_pkt_hdr, struct ethhdr* eth_hdr, pcap_hdr_t* pcap_file_hdr
@@ -1220,6 +1662,7 @@ struct timespec       ts = { 0 };
   -fills a packet buffer if both fp and pktbuf are given. If pktbuf is given but not pktlen then we get pktlen using DSGetPacketInfo() 
   -fills in a PKTINFO struct with packet info, if specified
   -pNumRead is returned in records or in bytes if DS_FIND_PCAP_PACKET_USE_SEEK_OFFSET is given in uFlags
+  -if fp is NULL the packet in pktbuf is checked against filter specs and -1 returned if it's filtered out. Previously the filtered result was overwritten by the packet length, JHB Oct 2026
 
   -returns packet length if packet search succeeds, 0 if not, or < 0 for error condition
 */
@@ -1250,6 +1693,7 @@ uint64_t cur_pos = 0;
    }
 
    if (!PktInfo) PktInfo = &PktInfo_local;
+   if (!fp && pNumRead) *pNumRead = 0;  /* nothing is read from file when a packet buffer is given, JHB Oct 2026 */
 
    if (p_pcap_rec_hdr) p_pkt_hdr = p_pcap_rec_hdr;
    else p_pkt_hdr = &pcap_pkt_hdr_local;
@@ -1257,7 +1701,7 @@ uint64_t cur_pos = 0;
    if (pktbuf) pkt_in_buf = pktbuf;
    else pkt_in_buf = pktbuf_local;
    
-   uint16_t pkt_type, block_type, input_type = (link_layer_info & LINK_LAYER_IO_TYPE_MASK) >> 16;
+   uint16_t pkt_type = 0, block_type = PCAP_PB_TYPE, input_type = (link_layer_info & LINK_LAYER_IO_TYPE_MASK) >> 16;  /* if fp is NULL, pktbuf is assumed to contain an IP packet; initialize so only IP header and protocol filters apply, JHB Oct 2026 */
 
    #ifdef PROFILE
    uint64_t start_time = 0;
@@ -1266,7 +1710,7 @@ uint64_t cur_pos = 0;
 
    if (input_type == IO_TYPE_LIBPCAP || input_type == IO_TYPE_LIBPCAP_BE || input_type == IO_TYPE_PCAPNG || input_type == IO_TYPE_PCAPNG_BE) {  /* .rtpXXX format files not supported */
 
-      if (fp && (uFlags & DS_FIND_PCAP_PACKET_USE_SEEK_OFFSET)) cur_pos = ftell(fp);
+      if (fp && (uFlags & DS_FIND_PCAP_PACKET_USE_SEEK_OFFSET)) cur_pos = pcap_tell(fp);
 
 read_packet:
 
@@ -1286,7 +1730,7 @@ read_packet:
 
          if (uFlags & DS_FIND_PCAP_PACKET_USE_SEEK_OFFSET) {
 
-            uint64_t new_pos = ftell(fp);
+            uint64_t new_pos = pcap_tell(fp);
             num_read += new_pos - cur_pos;  /* increment by bytes read */
             cur_pos = new_pos;
          }
@@ -1299,7 +1743,7 @@ read_packet:
          if (block_type != PCAP_PB_TYPE && block_type != PCAPNG_EPB_TYPE && block_type != PCAPNG_SPB_TYPE) {  /* ignore IDB, NRB, and other non-packet data block types. See definitions in pktlib.h */
 
             if (fp) goto read_packet;
-            else ret_val = -1;
+            else return -1;
          }
 
          if ((uFlags & DS_FILTER_PKT_ARP) && (pkt_type == ETH_P_ARP)) {  /* ignore ARP packets (ETH_P_ARP defined in if_ether.h Linux header file, typically value of 0x0806) */
@@ -1307,7 +1751,7 @@ read_packet:
             printf(" ************* ignoring ARP pkt \n");
             #endif
             if (fp) goto read_packet;
-            else ret_val = -1;
+            else return -1;
          }
 
          if ((uFlags & DS_FILTER_PKT_802) && (pkt_type >= 82 && pkt_type <= 1536)) { /* ignore 802.2 LLC frames (https://networkengineering.stackexchange.com/questions/50586/eth-ii-vs-802-2-llc-snap). Note - added the lower range check of 82 after some .pcapng test files with Ethernet prototype value of zero were misinterpreted as 802.2, JHB Sep 2022 */
@@ -1315,7 +1759,7 @@ read_packet:
             printf(" ************* ignoring LLC frame, pkt_type = %d \n", pkt_type);
             #endif
             if (fp) goto read_packet;
-            else ret_val = -1;
+            else return -1;
          }
 
       /* fill in PktInfo struct with IP, UDP, and RTP header items */
@@ -1332,19 +1776,19 @@ read_packet:
             printf("************* invalid IP version or malformed packet, pkt type = %d, pkt len = %d \n", pkt_type, pktlen);
             #endif
             if (fp) goto read_packet;
-            else ret_val = -1;
+            else return -1;
          }
 
          uint8_t protocol = PktInfo->protocol;
 
          if ((uFlags & DS_FILTER_PKT_TCP) && protocol == TCP_PROTOCOL) {
             if (fp) goto read_packet;
-            else ret_val = -1;
+            else return -1;
          }
 
          if ((uFlags & DS_FILTER_PKT_UDP) && protocol == UDP_PROTOCOL) {
             if (fp) goto read_packet;
-            else ret_val = -1;
+            else return -1;
          }
 
          if ((uFlags & DS_FILTER_PKT_UDP_SIP) && protocol == UDP_PROTOCOL) {
@@ -1358,7 +1802,7 @@ read_packet:
             if (PktInfo->dst_port == SIP_PORT || PktInfo->src_port == SIP_PORT) {
             #endif
                if (fp) goto read_packet;
-               else ret_val = -1;
+               else return -1;
             }
          }
 
@@ -1367,13 +1811,13 @@ read_packet:
             printf(" ************* ignoring non UDP or TCP pkt with protocol = %d \n", ret_val);
             #endif
             if (fp) goto read_packet;
-            else ret_val = -1;
+            else return -1;
          }
 
          if ((uFlags & DS_FILTER_PKT_RTCP) && protocol == UDP_PROTOCOL && (PktInfo->rtp_pyld_type >= RTCP_PYLD_TYPE_MIN && PktInfo->rtp_pyld_type <= RTCP_PYLD_TYPE_MAX)) {  /* skip over RTCP */
 
             if (fp) goto read_packet;
-            else ret_val = -1;
+            else return -1;
          }
 
          #ifdef PROFILE
@@ -1398,6 +1842,375 @@ read_packet:
 }
 
 
+/* DSFindPcapPacket() packet index, notes JHB Oct 2026:
+
+  -DSFindPcapPacket() is called repeatedly by DSProcessStreamGroupContributorsTSM() (streamlib) with the same pcap, and previously re-read the pcap from its start each time. For long recordings that makes timestamp-match mode quadratic
+  -on first call for a pcap we read it once and keep one PCAP_INDEX_ENTRY per packet that passes DSFindPcapPacket() filtering, in file order, with record position, record number, arrival time, and RTP items. Entries are hashed on (SSRC, RTP timestamp); after that a search is a hash lookup (or an in-memory scan if SSRC and timestamp are not both specified), no file I/O
+  -the index is saved as a sidecar file (pcap name + PCAP_INDEX_FILE_EXT) and re-used by later runs. The sidecar stores pcap size and modification time; if either changes the index is rebuilt. If the sidecar can't be written (e.g. read-only folder) the index is kept in memory only
+  -offset_start, offset_end, and pFoundOffset work as before, in bytes or records depending on DS_FIND_PCAP_PACKET_USE_SEEK_OFFSET. Results match the file-read search
+  -indexes are shared between threads and ref counted. A short spinlock protects the index table lookup; index builds happen outside the lock. Two threads building the same index at the same time is harmless (both are valid, one is found first)
+  -DS_FIND_PCAP_PACKET_DISABLE_INDEX gives the previous file-read search. DS_FILTER_PKT_UDP is not indexed (it would filter out all RTP) and also uses the file-read search
+*/
+
+#define PCAP_INDEX_FILE_EXT       ".pktidx"
+#define PCAP_INDEX_MAGIC          0x58494b50  /* "PKIX" */
+#define PCAP_INDEX_VERSION        1
+#define MAX_PCAP_INDEXES          64          /* max indexes kept in memory; least recently used is dropped when full */
+#define PCAP_INDEX_NONE           0xffffffff  /* hash chain end */
+
+#define PCAP_INDEX_FILTER_FLAGS   (DS_FILTER_PKT_ARP | DS_FILTER_PKT_802 | DS_FILTER_PKT_TCP | DS_FILTER_PKT_UDP_SIP | DS_FILTER_PKT_RTCP)  /* same filters DSFindPcapPacket() applies in its DSFilterPacket() calls */
+#define PCAP_INDEX_MSG_FLAGS      (DS_PKTLIB_SUPPRESS_WARNING_ERROR_MSG | DS_PKTLIB_SUPPRESS_RTP_WARNING_ERROR_MSG | DS_PKTLIB_SUPPRESS_INFO_MSG)
+
+typedef struct {  /* saved as-is in sidecar file */
+
+  uint64_t  rec_pos;        /* byte offset of record */
+  uint64_t  next_pos;       /* byte offset following record */
+  uint64_t  rec_num;        /* record number, counting from zero after file header. Includes non-packet pcapng blocks */
+  uint64_t  pkt_time;       /* arrival timestamp, in usec */
+  uint32_t  rtp_ssrc;
+  uint32_t  rtp_timestamp;
+  uint32_t  seqnum;
+  uint8_t   rtp_pyld_type;
+  uint8_t   reserved[3];
+
+} PCAP_INDEX_ENTRY;
+
+typedef struct {  /* sidecar file header */
+
+  uint32_t  magic;
+  uint16_t  version;
+  uint16_t  entry_size;
+  uint64_t  pcap_size;
+  int64_t   pcap_mtime_sec;
+  int64_t   pcap_mtime_nsec;
+  uint64_t  first_pos;      /* byte offset of first record */
+  uint64_t  num_entries;
+
+} PCAP_INDEX_FILE_HDR;
+
+typedef struct {
+
+  dev_t              dev;   /* identifies the pcap */
+  ino_t              ino;
+  PCAP_INDEX_FILE_HDR hdr;
+  PCAP_INDEX_ENTRY*  entries;
+  uint32_t           hash_mask;
+  uint32_t*          hash_head;
+  uint32_t*          hash_next;
+  int                ref_count;
+  uint64_t           last_used;
+
+} PCAP_INDEX;
+
+static PCAP_INDEX* pcap_index_table[MAX_PCAP_INDEXES] = { NULL };
+static volatile int pcap_index_lock = 0;
+static uint64_t pcap_index_use_count = 0;
+
+static inline uint32_t pcap_index_hash(uint32_t rtp_ssrc, uint32_t rtp_timestamp) {
+
+   uint32_t h = rtp_ssrc * 0x9e3779b1 ^ rtp_timestamp * 0x85ebca6b;
+
+   return h ^ (h >> 15);
+}
+
+static void pcap_index_free(PCAP_INDEX* idx) {
+
+   if (!idx) return;
+
+   if (idx->entries) free(idx->entries);
+   if (idx->hash_head) free(idx->hash_head);
+   if (idx->hash_next) free(idx->hash_next);
+   free(idx);
+}
+
+static inline void pcap_index_release(PCAP_INDEX* idx) {
+
+   if (__sync_sub_and_fetch(&idx->ref_count, 1) == 0) pcap_index_free(idx);
+}
+
+static int pcap_index_create_hash(PCAP_INDEX* idx) {
+
+uint32_t size = 64;
+
+   while (size < 2*idx->hdr.num_entries && size < 0x80000000) size <<= 1;
+
+   idx->hash_mask = size - 1;
+   idx->hash_head = (uint32_t*)malloc(size*sizeof(uint32_t));
+   idx->hash_next = (uint32_t*)malloc(max(idx->hdr.num_entries, (uint64_t)1)*sizeof(uint32_t));
+
+   if (!idx->hash_head || !idx->hash_next) return -1;
+
+   memset(idx->hash_head, 0xff, size*sizeof(uint32_t));  /* all chains empty (PCAP_INDEX_NONE) */
+
+   for (int64_t i = idx->hdr.num_entries-1; i >= 0; i--) {  /* insert at chain head in reverse so chains are in file order */
+
+      uint32_t h = pcap_index_hash(idx->entries[i].rtp_ssrc, idx->entries[i].rtp_timestamp) & idx->hash_mask;
+
+      idx->hash_next[i] = idx->hash_head[h];
+      idx->hash_head[h] = i;
+   }
+
+   return 1;
+}
+
+static PCAP_INDEX* pcap_index_build(const char* szInputPcap, struct stat* st, unsigned int uFlags) {
+
+FILE* fp_pcap = NULL;
+int link_layer_info, pktlen;
+uint8_t pktbuf[MAX_TCP_PACKET_LEN];
+pcaprec_hdr_t pcap_pkt_hdr;
+uint16_t pkt_type, block_type;
+PKTINFO PktInfo;
+uint64_t rec_pos, rec_num = 0, max_entries = 0;
+unsigned int uFlags_read = uFlags & PCAP_INDEX_MSG_FLAGS;
+PCAP_INDEX* idx;
+
+   if ((link_layer_info = DSOpenPcap(szInputPcap, DS_READ | DS_OPEN_PCAP_QUIET | DS_OPEN_PCAP_MMAP, &fp_pcap, NULL, "")) <= 0 || !fp_pcap) return NULL;
+
+   int input_type = getIOType(link_layer_info);
+
+   if ((input_type != IO_TYPE_LIBPCAP && input_type != IO_TYPE_LIBPCAP_BE && input_type != IO_TYPE_PCAPNG && input_type != IO_TYPE_PCAPNG_BE) || !(idx = (PCAP_INDEX*)calloc(1, sizeof(PCAP_INDEX)))) {  /* .rtpXXX files not supported, same as DSFilterPacket() */
+      DSClosePcap(fp_pcap, DS_CLOSE_PCAP_QUIET);
+      return NULL;
+   }
+
+   idx->dev = st->st_dev;
+   idx->ino = st->st_ino;
+   idx->hdr.magic = PCAP_INDEX_MAGIC;
+   idx->hdr.version = PCAP_INDEX_VERSION;
+   idx->hdr.entry_size = sizeof(PCAP_INDEX_ENTRY);
+   idx->hdr.pcap_size = st->st_size;
+   idx->hdr.pcap_mtime_sec = st->st_mtim.tv_sec;
+   idx->hdr.pcap_mtime_nsec = st->st_mtim.tv_nsec;
+   idx->hdr.first_pos = rec_pos = pcap_tell(fp_pcap);
+
+   while ((pktlen = DSReadPcap(fp_pcap, uFlags_read, pktbuf, &pcap_pkt_hdr, link_layer_info, &pkt_type, &block_type, NULL, 0, NULL)) > 0) {
+
+      uint64_t next_pos = pcap_tell(fp_pcap);
+
+   /* same block type and Ethernet protocol checks as DSFilterPacket(), then DSFilterPacket() applies IP and protocol filters to the packet buffer */
+
+      if ((block_type == PCAP_PB_TYPE || block_type == PCAPNG_EPB_TYPE || block_type == PCAPNG_SPB_TYPE) && pkt_type != ETH_P_ARP && !(pkt_type >= 82 && pkt_type <= 1536) &&
+          DSFilterPacket(NULL, uFlags_read | PCAP_INDEX_FILTER_FLAGS, link_layer_info, NULL, pktbuf, pktlen, &PktInfo, NULL) > 0) {
+
+         if (idx->hdr.num_entries >= max_entries) {
+
+            max_entries = max_entries ? 2*max_entries : 4096;
+            PCAP_INDEX_ENTRY* entries = (PCAP_INDEX_ENTRY*)realloc(idx->entries, max_entries*sizeof(PCAP_INDEX_ENTRY));
+            if (!entries) { pktlen = -1; break; }
+            idx->entries = entries;
+         }
+
+         PCAP_INDEX_ENTRY* e = &idx->entries[idx->hdr.num_entries++];
+
+         memset(e, 0, sizeof(PCAP_INDEX_ENTRY));
+         e->rec_pos = rec_pos;
+         e->next_pos = next_pos;
+         e->rec_num = rec_num;
+         e->pkt_time = (uint64_t)pcap_pkt_hdr.ts_sec*1000000L + pcap_pkt_hdr.ts_usec;
+         e->rtp_ssrc = PktInfo.rtp_ssrc;
+         e->rtp_timestamp = PktInfo.rtp_timestamp;
+         e->seqnum = PktInfo.seqnum;
+         e->rtp_pyld_type = PktInfo.rtp_pyld_type;
+      }
+
+      rec_num++;
+      rec_pos = next_pos;
+   }
+
+   DSClosePcap(fp_pcap, DS_CLOSE_PCAP_QUIET);
+
+   if (pktlen < 0 || idx->hdr.num_entries >= PCAP_INDEX_NONE || pcap_index_create_hash(idx) < 0) {
+      pcap_index_free(idx);
+      return NULL;
+   }
+
+   if (!(uFlags & DS_PKTLIB_SUPPRESS_INFO_MSG)) Log_RT(4, "INFO: DSFindPcapPacket() created packet index for %s, %llu indexed packets, %llu records \n", szInputPcap, (unsigned long long)idx->hdr.num_entries, (unsigned long long)rec_num);
+
+   return idx;
+}
+
+static PCAP_INDEX* pcap_index_load(const char* szIndexFile, struct stat* st) {
+
+FILE* fp;
+PCAP_INDEX* idx;
+bool fValid = false;
+
+   if (!(fp = fopen(szIndexFile, "rb"))) return NULL;
+
+   if (!(idx = (PCAP_INDEX*)calloc(1, sizeof(PCAP_INDEX)))) { fclose(fp); return NULL; }
+
+   if (fread(&idx->hdr, sizeof(PCAP_INDEX_FILE_HDR), 1, fp) == 1 &&
+       idx->hdr.magic == PCAP_INDEX_MAGIC && idx->hdr.version == PCAP_INDEX_VERSION && idx->hdr.entry_size == sizeof(PCAP_INDEX_ENTRY) &&
+       idx->hdr.pcap_size == (uint64_t)st->st_size && idx->hdr.pcap_mtime_sec == st->st_mtim.tv_sec && idx->hdr.pcap_mtime_nsec == st->st_mtim.tv_nsec &&  /* stale if pcap has changed since index was saved */
+       idx->hdr.num_entries < PCAP_INDEX_NONE && (idx->entries = (PCAP_INDEX_ENTRY*)malloc(max(idx->hdr.num_entries, (uint64_t)1)*sizeof(PCAP_INDEX_ENTRY)))) {
+
+      fValid = fread(idx->entries, sizeof(PCAP_INDEX_ENTRY), idx->hdr.num_entries, fp) == idx->hdr.num_entries;
+   }
+
+   fclose(fp);
+
+   if (!fValid || pcap_index_create_hash(idx) < 0) {
+      pcap_index_free(idx);
+      return NULL;
+   }
+
+   idx->dev = st->st_dev;
+   idx->ino = st->st_ino;
+
+   return idx;
+}
+
+static void pcap_index_save(const char* szIndexFile, PCAP_INDEX* idx) {
+
+char szTmpFile[PATH_MAX];
+FILE* fp;
+bool fWritten;
+
+   if (snprintf(szTmpFile, sizeof(szTmpFile), "%s.%d", szIndexFile, getpid()) >= (int)sizeof(szTmpFile) || !(fp = fopen(szTmpFile, "wb"))) return;  /* not an error; index is still used from memory */
+
+   fWritten = fwrite(&idx->hdr, sizeof(PCAP_INDEX_FILE_HDR), 1, fp) == 1 && fwrite(idx->entries, sizeof(PCAP_INDEX_ENTRY), idx->hdr.num_entries, fp) == idx->hdr.num_entries;
+
+   if (fclose(fp) || !fWritten || rename(szTmpFile, szIndexFile)) remove(szTmpFile);  /* write to temp file and rename, so concurrent readers never see a partial index */
+}
+
+static PCAP_INDEX* pcap_index_get(const char* szInputPcap, unsigned int uFlags) {
+
+struct stat st;
+char szIndexFile[PATH_MAX];
+PCAP_INDEX* idx = NULL;
+int i, slot = 0;
+
+   if (stat(szInputPcap, &st) || snprintf(szIndexFile, sizeof(szIndexFile), "%s%s", szInputPcap, PCAP_INDEX_FILE_EXT) >= (int)sizeof(szIndexFile)) return NULL;
+
+   while (__sync_lock_test_and_set(&pcap_index_lock, 1) != 0);  /* lock index table */
+
+   for (i=0; i<MAX_PCAP_INDEXES; i++) {
+
+      if (pcap_index_table[i] && pcap_index_table[i]->dev == st.st_dev && pcap_index_table[i]->ino == st.st_ino) {
+
+         if (pcap_index_table[i]->hdr.pcap_size == (uint64_t)st.st_size && pcap_index_table[i]->hdr.pcap_mtime_sec == st.st_mtim.tv_sec && pcap_index_table[i]->hdr.pcap_mtime_nsec == st.st_mtim.tv_nsec) {
+
+            idx = pcap_index_table[i];
+            __sync_fetch_and_add(&idx->ref_count, 1);  /* caller reference */
+            idx->last_used = ++pcap_index_use_count;
+         }
+         else {  /* pcap has changed, drop stale index */
+
+            pcap_index_release(pcap_index_table[i]);
+            pcap_index_table[i] = NULL;
+         }
+
+         break;
+      }
+   }
+
+   __sync_lock_release(&pcap_index_lock);
+
+   if (idx) return idx;
+
+/* not in memory, try sidecar file, otherwise read the pcap and create it */
+
+   if (!(idx = pcap_index_load(szIndexFile, &st))) {
+
+      if (!(idx = pcap_index_build(szInputPcap, &st, uFlags))) return NULL;
+
+      pcap_index_save(szIndexFile, idx);
+   }
+
+   idx->ref_count = 2;  /* index table reference + caller reference */
+
+   while (__sync_lock_test_and_set(&pcap_index_lock, 1) != 0);
+
+   for (i=0; i<MAX_PCAP_INDEXES; i++) {  /* use empty slot if available, otherwise least recently used */
+
+      if (!pcap_index_table[i]) { slot = i; break; }
+      if (pcap_index_table[i]->last_used < pcap_index_table[slot]->last_used) slot = i;
+   }
+
+   if (pcap_index_table[slot]) pcap_index_release(pcap_index_table[slot]);
+
+   idx->last_used = ++pcap_index_use_count;
+   pcap_index_table[slot] = idx;
+
+   __sync_lock_release(&pcap_index_lock);
+
+   return idx;
+}
+
+static inline uint64_t pcap_index_entry_end(PCAP_INDEX_ENTRY* e, bool fUseSeek) { return fUseSeek ? e->next_pos : e->rec_num + 1; }  /* offset following an entry, in bytes or records */
+
+/* search an index with the same offset and match rules as the file-read search in DSFindPcapPacket() */
+
+static uint64_t pcap_index_find(PCAP_INDEX* idx, unsigned int uFlags, PKTINFO* PktInfo, uint64_t offset_start, uint64_t offset_end, uint64_t* pFoundOffset) {
+
+bool fUseSeek = uFlags & DS_FIND_PCAP_PACKET_USE_SEEK_OFFSET, fFindFirstMatch = uFlags & DS_FIND_PCAP_PACKET_FIRST_MATCHING;
+bool fMatchSSRC = false, fMatchTimestamp = false, fMatchSeqnum = false, fMatchPyldType = false;
+uint64_t n = idx->hdr.num_entries, lo, hi, start_count, first, last;
+int64_t found = -1;
+
+   if (PktInfo) {
+      fMatchSSRC = uFlags & DS_FIND_PCAP_PACKET_RTP_SSRC;
+      fMatchTimestamp = uFlags & DS_FIND_PCAP_PACKET_RTP_TIMESTAMP;
+      fMatchSeqnum = uFlags & DS_FIND_PCAP_PACKET_SEQNUM;
+      fMatchPyldType = uFlags & DS_FIND_PCAP_PACKET_RTP_PYLDTYPE;
+   }
+
+/* first entry searched is the first packet at or after offset_start */
+
+   for (lo = 0, hi = n; lo < hi;) {
+      uint64_t mid = (lo + hi)/2;
+      if ((fUseSeek ? idx->entries[mid].rec_pos : idx->entries[mid].rec_num) < offset_start) lo = mid + 1;
+      else hi = mid;
+   }
+
+   first = lo;
+
+   start_count = fUseSeek && !offset_start ? idx->hdr.first_pos : offset_start;  /* offset before first search read */
+
+   if (first >= n || (offset_end && start_count > offset_end)) return 0;
+
+/* last entry searched is the first one that ends after offset_end; the file-read search checks offset_end before each read */
+
+   last = n - 1;
+
+   if (offset_end) {
+
+      for (lo = first, hi = n; lo < hi;) {
+         uint64_t mid = (lo + hi)/2;
+         if (pcap_index_entry_end(&idx->entries[mid], fUseSeek) <= offset_end) lo = mid + 1;
+         else hi = mid;
+      }
+
+      if (lo < n) last = lo;
+   }
+
+   #define PCAP_INDEX_MATCH(e) ((!fMatchSSRC || (e)->rtp_ssrc == PktInfo->rtp_ssrc) && (!fMatchTimestamp || (e)->rtp_timestamp == PktInfo->rtp_timestamp) && (!fMatchSeqnum || (e)->seqnum == PktInfo->seqnum) && (!fMatchPyldType || (e)->rtp_pyld_type == PktInfo->rtp_pyld_type))
+
+   if (fMatchSSRC && fMatchTimestamp) {  /* hash lookup. Chains are in file order */
+
+      for (uint32_t i = idx->hash_head[pcap_index_hash(PktInfo->rtp_ssrc, PktInfo->rtp_timestamp) & idx->hash_mask]; i != PCAP_INDEX_NONE && i <= last; i = idx->hash_next[i]) {
+
+         if (i >= first && PCAP_INDEX_MATCH(&idx->entries[i])) {
+            found = i;
+            if (fFindFirstMatch) break;
+         }
+      }
+   }
+   else if (fFindFirstMatch) {
+      for (uint64_t i = first; i <= last; i++) if (PCAP_INDEX_MATCH(&idx->entries[i])) { found = i; break; }
+   }
+   else {  /* last matching, which is also the default */
+      for (int64_t i = last; i >= (int64_t)first; i--) if (PCAP_INDEX_MATCH(&idx->entries[i])) { found = i; break; }
+   }
+
+   if (found < 0) return 0;
+
+   if (pFoundOffset) *pFoundOffset = pcap_index_entry_end(&idx->entries[found], fUseSeek);
+
+   return idx->entries[found].pkt_time - idx->entries[first].pkt_time;  /* relative to first packet searched, same as file-read search */
+}
+
 /* DSFindPcapPacket() finds specific packets in a pcap given packet matching specs */
 
 uint64_t DSFindPcapPacket(const char* szInputPcap, unsigned int uFlags, PKTINFO* PktInfo, uint64_t offset_start, uint64_t offset_end, uint64_t* pFoundOffset, int* error_cond) {
@@ -1421,6 +2234,21 @@ int ret_val = 0;
    pcapread_time = 0;
    #endif
 
+/* use packet index if possible, JHB Oct 2026 */
+
+   if (szInputPcap && !(uFlags & (DS_FIND_PCAP_PACKET_DISABLE_INDEX | DS_FILTER_PKT_UDP))) {
+
+      PCAP_INDEX* idx = pcap_index_get(szInputPcap, uFlags);
+
+      if (idx) {
+
+         packet_time = pcap_index_find(idx, uFlags, PktInfo, offset_start, offset_end, pFoundOffset);
+         pcap_index_release(idx);
+
+         return packet_time;
+      }
+   }
+
    fUseSeek = uFlags & DS_FIND_PCAP_PACKET_USE_SEEK_OFFSET;
    fFindFirstMatch = uFlags & DS_FIND_PCAP_PACKET_FIRST_MATCHING;
    uFlags_filter = uFlags | DS_FILTER_PKT_ARP | DS_FILTER_PKT_802 | DS_FILTER_PKT_TCP | DS_FILTER_PKT_UDP_SIP | DS_FILTER_PKT_RTCP;
@@ -1557,7 +2385,10 @@ int DSClosePcap(FILE* fp_pcap, unsigned int uFlags) {
 
 int ret_val = -1;
 
-   if (fp_pcap) ret_val = fclose(fp_pcap);
+   if (fp_pcap) {
+      pcap_mmap_close(fp_pcap);  /* unmap if mapped, JHB Oct 2026 */
+      ret_val = fclose(fp_pcap);
+   }
 
    if (!(uFlags & DS_CLOSE_PCAP_QUIET)) Log_RT(4, "INFO: DSClosePcap() closed pcap file, ret val = %d \n", ret_val);
 
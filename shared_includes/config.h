@@ -93,6 +93,12 @@
 
    Modified Apr 2025 JHB
     -change DS_EVENT_LOG_TIMEVAL_PRECISE flag to DS_EVENT_LOG_TIMEVAL_PRECISION_USEC and add DS_EVENT_LOG_TIMEVAL_PRECISION_MSEC flag. See DSGetLogTimestamp() in diaglib_util.cpp (diaglib)
+
+   Modified Oct 2026 JHB
+    -add DS_EVENT_LOG_ASYNC uEventLogMode flag. See async event log writer comments in event_logging.cpp (diaglib)
+    -add DS_EVENT_LOG_BINARY uEventLogMode flag. See binary event log notes in event_log_binary.cpp (diaglib)
+    -add DS_PACKET_STATS_HISTORY_SPILL_TO_DISK uPktStatsLogging flag. See PKT_STATS_ARENA notes in diaglib.h
+    -add uThreadLoadBalanceInterval in GLOBAL_CONFIG struct (no change in struct size, uses uReserved1)
 */
 
 #ifndef _CONFIG_H_
@@ -147,7 +153,8 @@ typedef struct {
 
    uint32_t uThreadPreemptionElapsedTimeAlarm;  /* amount of elapsed time (in msec) before p/m thread preemption warning will appear in the event log. If left at zero, DSConfigPktlib() will set to default of 40 msec */
 
-   uint32_t uReserved1;
+   uint32_t uThreadLoadBalanceInterval;  /* interval (in msec) at which packet/media thread loads are checked and sessions or stream groups are migrated from threads exceeding real-time to less loaded threads. A zero value disables load balancing (default). A typical value might be 2000 (2 sec). See ThreadLoadBalance() in packet_flow_media_proc.c */
+
    uint32_t uReserved2;
    uint32_t uReserved3;
    uint32_t uReserved4;
@@ -199,7 +206,8 @@ enum PACKET_STATS_LOGGING {  /* enums for uPktStatsLogging in DEBUG_CONFIG struc
   DS_ENABLE_PACKET_STATS_HISTORY_LOGGING = 1,  /* enable packet stats history logging for jitter buffer input and output. Enabling packet stats history logging allows end-of-call packet log file output, including detailed input vs. output analysis, to be performed by DSWritePacketStatsHistoryLog() (pktlib) or DSPktStatsWriteLogFile() (diaglib) */
   DS_LOG_BAD_PACKETS = 2,                      /* include in packet stats history packets rejected by DSBufferPackets() (add to jitter buffer) because they are malformed, have an out-of-range timestamp or seq number jump, etc.  Rejected packets will show in the input side of the packet log file output, but not output side, causing dropped packet entries in input vs. output analysis */
   DS_ENABLE_PACKET_TIME_STATS = 4,             /* enable run-time packet time stats, these can be displayed in the event log at any time using DSLogPacketTimeLossStats() (pktlib) */
-  DS_ENABLE_PACKET_LOSS_STATS = 8              /* enable run-time packet loss stats,  "" */
+  DS_ENABLE_PACKET_LOSS_STATS = 8,             /* enable run-time packet loss stats,  "" */
+  DS_PACKET_STATS_HISTORY_SPILL_TO_DISK = 0x10 /* when packet stats history memory limit is reached, spill older entries to disk instead of discarding them. Packet log file output still includes all entries. Intended for very long calls, JHB Oct 2026 */
 };
 
 enum PACKING_FORMAT {
@@ -226,7 +234,9 @@ enum EVENT_LOG_MODE {  /* uEventLogMode enums, these are in addition to LOG_xx c
   DS_EVENT_LOG_WARN_ERROR_ONLY = 0x80,         /* set event log to level 3 output and below. Intended for temporary purposes, for example file or screen I/O is taking a lot of system time */
   DS_EVENT_LOG_USER_TIMEVAL = 0x100,           /* user-supplied time value (in usec) when calling DSGetLogTimeStamp() in diaglib, JHB Feb 2024 */
   DS_EVENT_LOG_TIMEVAL_PRECISION_USEC = 0x200, /* specify msec and usec formatting (this is the default for wall-clock timestamps, which are fixed-width for event log use) */
-  DS_EVENT_LOG_TIMEVAL_PRECISION_MSEC = 0x400  /* specify msec formatting */
+  DS_EVENT_LOG_TIMEVAL_PRECISION_MSEC = 0x400, /* specify msec formatting */
+  DS_EVENT_LOG_ASYNC = 0x800,                  /* event log file writes are done by a background writer thread; Log_RT() callers copy formatted log strings to per-thread ring buffers and don't wait for file I/O. Console output is not affected. If a thread's ring buffer is full, log strings are dropped and counted in event_log_async_drops (diaglib.h), JHB Oct 2026 */
+  DS_EVENT_LOG_BINARY = 0x1000                 /* event log file output is written as binary records to "<szEventLogFilePath>.bin", with no string formatting by Log_RT() callers unless console output is also enabled. Use DSFormatBinaryEventLog() (diaglib.h) or the eventLogFormat app to render binary event logs as text, JHB Oct 2026 */
 };
 
 #define DS_LOG_LEVEL_MASK                         0x1f  /* up to 15 event log levels supported */